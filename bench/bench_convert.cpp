@@ -0,0 +1,122 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench/bench_data.h"
+#include "srec/srec.h"
+#include "srec/srec_parallel.h"
+
+namespace {
+
+using tierone::srec::SrecStreamParser;
+
+void BM_ParseStream(benchmark::State &state) {
+	const auto &input = bench::temp_files().srec(state.range(0));
+	for (auto _ : state) {
+		std::ifstream file(input.path, std::ios::binary);
+		size_t records = 0;
+		SrecStreamParser::parse_stream(file, [&records](const SrecStreamParser::ParsedRecord &) {
+			++records;
+			return true;
+		});
+		benchmark::DoNotOptimize(records);
+	}
+	bench::set_throughput(state, input.bytes, input.records);
+}
+BENCHMARK(BM_ParseStream)->Apply([](benchmark::internal::Benchmark *benchmark) {
+	for (const auto size : bench::file_sizes()) {
+		benchmark->Arg(size);
+	}
+})->Unit(benchmark::kMillisecond);
+
+void BM_ParseFile(benchmark::State &state) {
+	const auto &input = bench::temp_files().srec(state.range(0));
+	for (auto _ : state) {
+		size_t records = 0;
+		SrecStreamParser::parse_file(input.path, [&records](const SrecStreamParser::ParsedRecord &) {
+			++records;
+			return true;
+		});
+		benchmark::DoNotOptimize(records);
+	}
+	bench::set_throughput(state, input.bytes, input.records);
+}
+BENCHMARK(BM_ParseFile)->Apply([](benchmark::internal::Benchmark *benchmark) {
+	for (const auto size : bench::file_sizes()) {
+		benchmark->Arg(size);
+	}
+})->Unit(benchmark::kMillisecond);
+
+// Throughput is reported in S-record characters read
+void BM_ConvertSrecToBin(benchmark::State &state) {
+	const auto &input = bench::temp_files().srec(state.range(0));
+	const std::string output = bench::temp_files().path("srec_bench_output.bin");
+	for (auto _ : state) {
+		tierone::srec::convert_srec_to_bin(input.path, output);
+	}
+	bench::set_throughput(state, input.bytes, input.records);
+}
+BENCHMARK(BM_ConvertSrecToBin)->Apply([](benchmark::internal::Benchmark *benchmark) {
+	for (const auto size : bench::file_sizes()) {
+		benchmark->Arg(size);
+	}
+})->Unit(benchmark::kMillisecond);
+
+// Throughput is reported in binary bytes converted; the record count is
+// limited by SrecFile, hence the smaller sizes
+const std::vector<int64_t> binary_sizes{1 * bench::MiB, 64 * bench::MiB};
+
+void BM_ConvertStream(benchmark::State &state) {
+	const auto binary = bench::random_bytes(static_cast<size_t>(state.range(0)));
+	const std::string data(binary.begin(), binary.end());
+	const std::string output = bench::temp_files().path("srec_bench_output.srec");
+	const size_t records = (binary.size() + 244) / 245 + 2;
+	for (auto _ : state) {
+		std::istringstream input(data);
+		tierone::srec::SrecStreamConverter::convert_stream(input, output, tierone::srec::SrecFile::AddressSize::BITS32, 0,
+		                                                   false, nullptr, 65536, tierone::srec::SrecLimits::large());
+	}
+	bench::set_throughput(state, state.range(0), records);
+}
+BENCHMARK(BM_ConvertStream)->ArgsProduct({binary_sizes})->Unit(benchmark::kMillisecond);
+
+void BM_ConvertParallel(benchmark::State &state) {
+	const auto binary = bench::random_bytes(static_cast<size_t>(state.range(0)));
+	const std::string data(binary.begin(), binary.end());
+	const std::string output = bench::temp_files().path("srec_bench_output.srec");
+	const size_t records = (binary.size() + 244) / 245 + 2;
+	tierone::srec::SrecParallelConverter::Options options;
+	options.threads = static_cast<unsigned>(state.range(1));
+	for (auto _ : state) {
+		std::istringstream input(data);
+		tierone::srec::SrecFile sfile(output, tierone::srec::SrecFile::AddressSize::BITS32, 0,
+		                              tierone::srec::FlushPolicy::ON_CLOSE, tierone::srec::SrecLimits::large());
+		tierone::srec::SrecParallelConverter::write_data_records(input, sfile, options);
+		sfile.write_record_count();
+		sfile.write_record_termination();
+		sfile.close();
+	}
+	bench::set_throughput(state, state.range(0), records);
+}
+BENCHMARK(BM_ConvertParallel)->ArgsProduct({binary_sizes, {1, 2, 4}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
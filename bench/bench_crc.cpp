@@ -0,0 +1,75 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "bench/bench_data.h"
+#include "srec/crc32.h"
+#include "srec/srec_crc.h"
+
+namespace {
+
+using tierone::srec::CrcKernel;
+
+// A full S3 record payload, a large block and a whole chunk
+const std::vector<int64_t> sizes{245, 4096, 1024 * 1024};
+
+void BM_Xcrc32(benchmark::State &state) {
+	const auto data = bench::random_bytes(static_cast<size_t>(state.range(0)));
+	for (auto _ : state) {
+		const unsigned int sum = tierone::srec::xcrc32(data.data(), static_cast<unsigned long>(data.size()), 0);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Xcrc32)->ArgsProduct({sizes});
+
+void BM_Crc32Kernel(benchmark::State &state, const CrcKernel kernel) {
+	const auto data = bench::random_bytes(static_cast<size_t>(state.range(0)));
+	for (auto _ : state) {
+		const uint32_t sum = tierone::srec::crc32_update(kernel, data.data(), data.size(), 0);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+void BM_Crc32Combine(benchmark::State &state) {
+	const auto length = static_cast<uint64_t>(state.range(0));
+	uint32_t sum = 0x12345678;
+	for (auto _ : state) {
+		sum = tierone::srec::xcrc32_combine(sum, 0x9ABCDEF0, length);
+		benchmark::DoNotOptimize(sum);
+	}
+}
+BENCHMARK(BM_Crc32Combine)->Arg(245)->Arg(1024 * 1024);
+
+// Register one benchmark per kernel the build host supports
+const bool kernels_registered = [] {
+	for (const auto kernel : {CrcKernel::TABLE, CrcKernel::SLICING8, CrcKernel::SLICING16, CrcKernel::CLMUL,
+	                          CrcKernel::PMULL}) {
+		if (!tierone::srec::crc_kernel_supported(kernel)) {
+			continue;
+		}
+		const std::string name = tierone::srec::crc_kernel_name(kernel);
+		benchmark::RegisterBenchmark(("BM_Crc32Kernel/" + name).c_str(), BM_Crc32Kernel, kernel)->ArgsProduct({sizes});
+	}
+	return true;
+}();
+
+} // namespace
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Synthetic input shared by the benchmarks
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "srec/srec.h"
+
+namespace bench {
+
+constexpr int64_t MiB = 1024 * 1024;
+
+// File sizes for the end-to-end benchmarks. 1 GiB is only added when
+// SREC_BENCH_LARGE is set, as generating it takes a while.
+inline std::vector<int64_t> file_sizes() {
+	std::vector<int64_t> sizes{1 * MiB, 100 * MiB};
+	if (std::getenv("SREC_BENCH_LARGE") != nullptr) {
+		sizes.push_back(1024 * MiB);
+	}
+	return sizes;
+}
+
+struct SrecInput {
+	std::string path;
+	size_t records{0};
+	int64_t bytes{0};
+};
+
+inline std::vector<uint8_t> random_bytes(const size_t count, const unsigned seed = 42) {
+	std::mt19937 gen(seed);
+	std::vector<uint8_t> bytes(count);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const auto value = static_cast<uint32_t>(gen());
+		bytes[i] = static_cast<uint8_t>(value);
+		bytes[i + 1] = static_cast<uint8_t>(value >> 8);
+		bytes[i + 2] = static_cast<uint8_t>(value >> 16);
+		bytes[i + 3] = static_cast<uint8_t>(value >> 24);
+	}
+	for (; i < count; ++i) {
+		bytes[i] = static_cast<uint8_t>(gen());
+	}
+	return bytes;
+}
+
+// Temporary files created on first use and removed at exit
+class TempFiles {
+public:
+	TempFiles() = default;
+	TempFiles(const TempFiles &) = delete;
+	TempFiles &operator=(const TempFiles &) = delete;
+
+	~TempFiles() {
+		for (const auto &path : paths) {
+			std::error_code error;
+			std::filesystem::remove(path, error);
+		}
+	}
+
+	// S3 S-record file of roughly 'size' characters
+	const SrecInput &srec(const int64_t size) {
+		auto &input = inputs[size];
+		if (input.path.empty()) {
+			input.path = path("srec_bench_" + std::to_string(size / MiB) + "m.srec");
+			// Every payload byte takes two characters. Records are formatted
+			// directly as SrecFile caps the record count.
+			const auto binary = random_bytes(static_cast<size_t>(size / 2));
+			constexpr size_t record_size = 245;
+			std::ofstream output(input.path, std::ios::binary);
+			std::array<char, tierone::srec::MAX_RECORD_LINE_LENGTH + 1> line;
+			for (size_t offset = 0; offset < binary.size(); offset += record_size) {
+				const size_t length = tierone::srec::format_record(
+					tierone::srec::Srec::Type::S3, static_cast<uint32_t>(offset), binary.data() + offset,
+					std::min(record_size, binary.size() - offset), line.data());
+				line[length] = '\n';
+				output.write(line.data(), static_cast<std::streamsize>(length + 1));
+				++input.records;
+			}
+			const auto type = input.records <= 0xFFFF ? tierone::srec::Srec::Type::S5 : tierone::srec::Srec::Type::S6;
+			for (const auto &[record, value] : {std::pair{type, static_cast<uint32_t>(input.records)},
+			                                    std::pair{tierone::srec::Srec::Type::S7, uint32_t{0}}}) {
+				const size_t length = tierone::srec::format_record(record, value, nullptr, 0, line.data());
+				line[length] = '\n';
+				output.write(line.data(), static_cast<std::streamsize>(length + 1));
+				++input.records;
+			}
+			output.close();
+			input.bytes = static_cast<int64_t>(std::filesystem::file_size(input.path));
+		}
+		return input;
+	}
+
+	// Scratch file path, removed at exit
+	std::string path(const std::string &name) {
+		const std::string result = (std::filesystem::temp_directory_path() / name).string();
+		paths.push_back(result);
+		return result;
+	}
+
+private:
+	std::map<int64_t, SrecInput> inputs;
+	std::vector<std::string> paths;
+};
+
+inline TempFiles &temp_files() {
+	static TempFiles files;
+	return files;
+}
+
+// Report characters and records handled per second
+inline void set_throughput(benchmark::State &state, const int64_t bytes, const size_t records) {
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes);
+	state.counters["records"] = benchmark::Counter(static_cast<double>(state.iterations()) * static_cast<double>(records),
+	                                               benchmark::Counter::kIsRate);
+}
+
+} // namespace bench
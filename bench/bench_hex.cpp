@@ -0,0 +1,146 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "srec/srec_hex.h"
+
+namespace {
+
+using tierone::srec::HexKernel;
+
+// Byte counts: a small record, a full S3 record and a large block
+const std::vector<int64_t> sizes{32, 250, 4096};
+
+std::vector<uint8_t> random_bytes(const size_t count) {
+	std::mt19937 gen(42);
+	std::uniform_int_distribution<> dis(0, 255);
+	std::vector<uint8_t> bytes(count);
+	for (auto &byte : bytes) {
+		byte = static_cast<uint8_t>(dis(gen));
+	}
+	return bytes;
+}
+
+std::string hex_string(const std::vector<uint8_t> &bytes) {
+	std::string hex(bytes.size() * 2, '\0');
+	tierone::srec::hex_encode(HexKernel::SCALAR, bytes.data(), bytes.size(), hex.data());
+	return hex;
+}
+
+// The per-character decoder SrecStreamParser used before the hex kernels
+uint8_t legacy_hex_char_to_byte(const char c) {
+	if (c >= '0' && c <= '9') {
+		return static_cast<uint8_t>(c - '0');
+	} else if (c >= 'A' && c <= 'F') {
+		return static_cast<uint8_t>(c - 'A' + 10);
+	} else if (c >= 'a' && c <= 'f') {
+		return static_cast<uint8_t>(c - 'a' + 10);
+	}
+	throw std::invalid_argument("Invalid hex character");
+}
+
+uint8_t legacy_parse_hex_byte(const std::string &hex_str, const size_t offset) {
+	if (offset + 1 >= hex_str.size()) {
+		throw std::invalid_argument("Incomplete hex byte");
+	}
+	const uint8_t high = legacy_hex_char_to_byte(hex_str[offset]);
+	const uint8_t low = legacy_hex_char_to_byte(hex_str[offset + 1]);
+	return static_cast<uint8_t>((high << 4) | low);
+}
+
+void BM_HexDecodeLegacy(benchmark::State &state) {
+	const auto count = static_cast<size_t>(state.range(0));
+	const std::string hex = hex_string(random_bytes(count));
+	std::vector<uint8_t> out;
+	for (auto _ : state) {
+		out.clear();
+		uint32_t sum = 0;
+		for (size_t i = 0; i < count; ++i) {
+			const uint8_t byte = legacy_parse_hex_byte(hex, i * 2);
+			out.push_back(byte);
+			sum += byte;
+		}
+		benchmark::DoNotOptimize(out.data());
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_HexDecodeLegacy)->ArgsProduct({sizes});
+
+// The stringstream encoder Srec::toString used before the hex kernels
+void BM_HexEncodeLegacy(benchmark::State &state) {
+	const auto count = static_cast<size_t>(state.range(0));
+	const std::vector<uint8_t> bytes = random_bytes(count);
+	for (auto _ : state) {
+		std::stringstream ss;
+		for (const auto byte : bytes) {
+			ss << std::setfill('0') << std::setw(2) << std::uppercase << std::hex << static_cast<unsigned int>(byte);
+		}
+		std::string hex = ss.str();
+		benchmark::DoNotOptimize(hex.data());
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_HexEncodeLegacy)->ArgsProduct({sizes});
+
+void BM_HexDecode(benchmark::State &state, const HexKernel kernel) {
+	const auto count = static_cast<size_t>(state.range(0));
+	const std::string hex = hex_string(random_bytes(count));
+	std::vector<uint8_t> out(count);
+	for (auto _ : state) {
+		uint32_t sum = 0;
+		const bool valid = tierone::srec::hex_decode(kernel, hex.data(), count, out.data(), sum);
+		benchmark::DoNotOptimize(valid);
+		benchmark::DoNotOptimize(sum);
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+void BM_HexEncode(benchmark::State &state, const HexKernel kernel) {
+	const auto count = static_cast<size_t>(state.range(0));
+	const std::vector<uint8_t> bytes = random_bytes(count);
+	std::string out(count * 2, '\0');
+	for (auto _ : state) {
+		const uint32_t sum = tierone::srec::hex_encode(kernel, bytes.data(), count, out.data());
+		benchmark::DoNotOptimize(sum);
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+// Register one benchmark per kernel the build host supports
+const bool kernels_registered = [] {
+	for (const auto kernel : {HexKernel::SCALAR, HexKernel::SSE41, HexKernel::AVX2, HexKernel::NEON}) {
+		if (!tierone::srec::hex_kernel_supported(kernel)) {
+			continue;
+		}
+		const std::string name = tierone::srec::hex_kernel_name(kernel);
+		benchmark::RegisterBenchmark(("BM_HexDecode/" + name).c_str(), BM_HexDecode, kernel)->ArgsProduct({sizes});
+		benchmark::RegisterBenchmark(("BM_HexEncode/" + name).c_str(), BM_HexEncode, kernel)->ArgsProduct({sizes});
+	}
+	return true;
+}();
+
+} // namespace
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench/bench_data.h"
+#include "srec/srec.h"
+#include "srec/srec_mapped.h"
+
+namespace {
+
+using tierone::srec::SrecParseResult;
+using tierone::srec::SrecStreamParser;
+
+// Full data record per address size, as written by SrecFile
+std::unique_ptr<tierone::srec::Srec> make_record(const int address_bits) {
+	switch (address_bits) {
+		case 16:
+			return std::make_unique<tierone::srec::Srec1>(0x1000, bench::random_bytes(249));
+		case 24:
+			return std::make_unique<tierone::srec::Srec2>(0x100000, bench::random_bytes(247));
+		default:
+			return std::make_unique<tierone::srec::Srec3>(0x10000000, bench::random_bytes(245));
+	}
+}
+
+void BM_ToString(benchmark::State &state) {
+	const auto record = make_record(static_cast<int>(state.range(0)));
+	int64_t length = 0;
+	for (auto _ : state) {
+		std::string line = record->toString();
+		length = static_cast<int64_t>(line.size());
+		benchmark::DoNotOptimize(line.data());
+	}
+	bench::set_throughput(state, length, 1);
+}
+BENCHMARK(BM_ToString)->Arg(16)->Arg(24)->Arg(32);
+
+void BM_FormatRecord(benchmark::State &state) {
+	const auto data = bench::random_bytes(245);
+	std::array<char, tierone::srec::MAX_RECORD_LINE_LENGTH> line;
+	size_t length = 0;
+	for (auto _ : state) {
+		length = tierone::srec::format_record(tierone::srec::Srec::Type::S3, 0x10000000, data.data(), data.size(),
+		                                      line.data());
+		benchmark::DoNotOptimize(line.data());
+	}
+	bench::set_throughput(state, static_cast<int64_t>(length), 1);
+}
+BENCHMARK(BM_FormatRecord);
+
+void BM_ParseLine(benchmark::State &state) {
+	const std::string line = make_record(static_cast<int>(state.range(0)))->toString();
+	for (auto _ : state) {
+		auto record = SrecStreamParser::parse_line(line, 1, true);
+		benchmark::DoNotOptimize(record.data.data());
+	}
+	bench::set_throughput(state, static_cast<int64_t>(line.size()), 1);
+}
+BENCHMARK(BM_ParseLine)->Arg(16)->Arg(24)->Arg(32);
+
+void BM_ParseLineView(benchmark::State &state) {
+	const std::string line = make_record(static_cast<int>(state.range(0)))->toString();
+	std::array<uint8_t, SrecStreamParser::MAX_RECORD_DATA_SIZE> payload;
+	SrecStreamParser::ParsedRecordView record{};
+	for (auto _ : state) {
+		SrecStreamParser::parse_line(line, 1, true, payload.data(), record);
+		benchmark::DoNotOptimize(record.data);
+		benchmark::ClobberMemory();
+	}
+	bench::set_throughput(state, static_cast<int64_t>(line.size()), 1);
+}
+BENCHMARK(BM_ParseLineView)->Arg(16)->Arg(24)->Arg(32);
+
+void BM_TryParseLine(benchmark::State &state) {
+	const std::string line = make_record(static_cast<int>(state.range(0)))->toString();
+	std::array<uint8_t, SrecStreamParser::MAX_RECORD_DATA_SIZE> payload;
+	SrecStreamParser::ParsedRecordView record{};
+	for (auto _ : state) {
+		const SrecParseResult result = SrecStreamParser::try_parse_line(line, 1, true, payload.data(), record);
+		benchmark::DoNotOptimize(result);
+		benchmark::ClobberMemory();
+	}
+	bench::set_throughput(state, static_cast<int64_t>(line.size()), 1);
+}
+BENCHMARK(BM_TryParseLine)->Arg(16)->Arg(24)->Arg(32);
+
+// S3 record damaged in one way: 0 none, 1 bad hex at the end of the payload,
+// 2 bad checksum, 3 truncated, 4 unknown type
+std::string corrupt_record(const int64_t damage) {
+	std::string line = make_record(32)->toString();
+	switch (damage) {
+		case 1:
+			line[line.size() - 3] = 'G';
+			break;
+		case 2:
+			line[line.size() - 1] = line[line.size() - 1] == '0' ? '1' : '0';
+			break;
+		case 3:
+			line.resize(line.size() / 2);
+			break;
+		case 4:
+			line[1] = '4';
+			break;
+		default:
+			break;
+	}
+	return line;
+}
+
+// Rejecting a line through the result costs about as much as accepting one
+void BM_TryParseCorrupt(benchmark::State &state) {
+	const std::string line = corrupt_record(state.range(0));
+	std::array<uint8_t, SrecStreamParser::MAX_RECORD_DATA_SIZE> payload;
+	SrecStreamParser::ParsedRecordView record{};
+	for (auto _ : state) {
+		const SrecParseResult result = SrecStreamParser::try_parse_line(line, 1, true, payload.data(), record);
+		benchmark::DoNotOptimize(result);
+		benchmark::ClobberMemory();
+	}
+	bench::set_throughput(state, static_cast<int64_t>(line.size()), 1);
+}
+BENCHMARK(BM_TryParseCorrupt)->DenseRange(0, 4);
+
+// The same lines through the throwing wrapper, for comparison
+void BM_ParseCorrupt(benchmark::State &state) {
+	const std::string line = corrupt_record(state.range(0));
+	std::array<uint8_t, SrecStreamParser::MAX_RECORD_DATA_SIZE> payload;
+	SrecStreamParser::ParsedRecordView record{};
+	for (auto _ : state) {
+		try {
+			SrecStreamParser::parse_line(line, 1, true, payload.data(), record);
+		} catch (const tierone::srec::SrecException &e) {
+			benchmark::DoNotOptimize(e.what());
+		}
+		benchmark::ClobberMemory();
+	}
+	bench::set_throughput(state, static_cast<int64_t>(line.size()), 1);
+}
+BENCHMARK(BM_ParseCorrupt)->DenseRange(0, 4);
+
+// Reading text in which every Nth record is damaged (0: none), skipping the bad lines
+void BM_ReadCorrupt(benchmark::State &state) {
+	constexpr size_t records = 4096;
+	const auto every = static_cast<size_t>(state.range(0));
+	std::string text;
+	for (size_t i = 0; i < records; ++i) {
+		const bool damaged = every > 0 && i % every == 0;
+		text += corrupt_record(damaged ? static_cast<int64_t>(1 + (i / every) % 4) : 0);
+		text += '\n';
+	}
+	for (auto _ : state) {
+		tierone::srec::SrecMappedReader reader(text.data(), text.size());
+		SrecStreamParser::ParsedRecordView record{};
+		SrecParseResult result;
+		size_t count = 0;
+		while (reader.try_next(record, result) || !result.ok()) {
+			count += result.ok() ? 1U : 0U;
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	bench::set_throughput(state, static_cast<int64_t>(text.size()), records);
+}
+BENCHMARK(BM_ReadCorrupt)->Arg(0)->Arg(100)->Arg(10)->Arg(1);
+
+} // namespace
@@ -16,6 +16,8 @@
 
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -23,7 +25,40 @@
 
 #include "srec/srec.h"
 #include "srec/crc32.h"
+#include "srec/srec_batch.h"
+#include "srec/srec_compress.h"
+#include "srec/srec_incremental.h"
 
+namespace {
+
+// Convert one file of a batch
+tierone::srec::SrecBatchResult convert_file(const tierone::srec::SrecBatchJob &job,
+                                            const tierone::srec::SrecFile::AddressSize addrsize,
+                                            const tierone::srec::SrecLimits &limits,
+                                            const tierone::srec::SrecLayout &layout,
+                                            const tierone::srec::SrecFillSkip &skip,
+                                            const bool checksum,
+                                            tierone::srec::SrecStats *stats) {
+	std::ifstream input(job.input, std::ios::binary);
+	if (!input.is_open()) {
+		return {false, "Error opening input file"};
+	}
+	const std::string output = job.output.empty()
+		? tierone::srec::SrecBatchRunner::replace_extension(job.input, ".srec") : job.output;
+	tierone::srec::SrecFile sfile(tierone::srec::open_output_sink(output), addrsize, 0,
+	                              tierone::srec::FlushPolicy::ON_CLOSE, limits);
+	if (!sfile.is_open()) {
+		return {false, "Error opening output file " + output};
+	}
+	sfile.set_layout(layout);
+	sfile.set_skip_fill(skip);
+	sfile.set_stats(stats);
+	tierone::srec::convert_bin_to_srec(input, sfile, checksum, 1);
+	sfile.close();
+	return {true, output};
+}
+
+} // namespace
 
 int main(int argc, char *argv[]) {
 	std::string outputfilename;
@@ -33,6 +68,11 @@ int main(int argc, char *argv[]) {
 	argparse::ArgumentParser parser("bin2srec");
 	parser.add_argument("-i", "--input")
 		.help("Input file name");
+	parser.add_argument("inputs")
+		.help("Input files converted in one batch, each to <name>.srec")
+		.remaining();
+	parser.add_argument("-m", "--manifest")
+		.help("File listing batch inputs, one per line, each optionally followed by a tab and its output");
 	parser.add_argument("-o", "--output")
 		.help("Output file name")
 		.default_value("output.srec");
@@ -45,6 +85,54 @@ int main(int argc, char *argv[]) {
 		.help("Add a CRC32 checksum as the first S0 record")
 		.default_value(false)
 		.implicit_value(true);
+	parser.add_argument("-L", "--large")
+		.help("Raise the record count limit for multi-GB images")
+		.default_value(false)
+		.implicit_value(true);
+	parser.add_argument("-r", "--record-length")
+		.help("Data bytes per record, 0 for the most the address size allows")
+		.default_value(0)
+		.nargs(1)
+		.scan<'i', int>();
+	parser.add_argument("--align")
+		.help("Start records at addresses that are multiples of the record length")
+		.default_value(false)
+		.implicit_value(true);
+	parser.add_argument("--crlf")
+		.help("End lines with CR LF instead of LF")
+		.default_value(false)
+		.implicit_value(true);
+	parser.add_argument("--fixed-stride")
+		.help("Pad data records with spaces so every data line has the same length")
+		.default_value(false)
+		.implicit_value(true);
+	parser.add_argument("--skip-fill")
+		.help("Leave runs of the fill byte (erased flash) out of the data records")
+		.default_value(false)
+		.implicit_value(true);
+	parser.add_argument("--fill-byte")
+		.help("Fill byte left out by --skip-fill, e.g. 0xFF or 0")
+		.default_value(std::string("0xFF"));
+	parser.add_argument("--min-fill-run")
+		.help("Shortest fill run cut from the start or end of a record")
+		.default_value(static_cast<int>(tierone::srec::SrecFillSkip::DEFAULT_MIN_RUN))
+		.nargs(1)
+		.scan<'i', int>();
+	parser.add_argument("--fill-crc")
+		.help("What the --checksum CRC covers with --skip-fill: emitted (the written data) or image (all input)")
+		.default_value(std::string("emitted"));
+	parser.add_argument("-p", "--previous")
+		.help("Previous input and its output; text of unchanged records is reused from it")
+		.nargs(2);
+	parser.add_argument("--stats")
+		.help("Print byte, record and timing statistics to stderr")
+		.default_value(false)
+		.implicit_value(true);
+	parser.add_argument("-t", "--threads")
+		.help("Formatting threads, 0 for one per CPU; batch worker threads, one per CPU unless given")
+		.default_value(1)
+		.nargs(1)
+		.scan<'i', int>();
 
 	// Parse arguments
 	try {
@@ -56,6 +144,127 @@ int main(int argc, char *argv[]) {
 		return 1;
 	}
 
+	// Collect batch jobs
+	std::vector<tierone::srec::SrecBatchJob> jobs;
+	if (const auto listed = parser.present<std::vector<std::string>>("inputs")) {
+		for (const auto &name : *listed) {
+			jobs.push_back({name, std::string()});
+		}
+	}
+	const auto manifest = parser.present("--manifest");
+	if (manifest) {
+		try {
+			const auto listed = tierone::srec::SrecBatchRunner::read_manifest(*manifest);
+			jobs.insert(jobs.end(), listed.begin(), listed.end());
+		} catch (const std::exception &err) {
+			std::cerr << err.what() << std::endl;
+			return 1;
+		}
+	}
+
+	// Get address size
+	tierone::srec::SrecFile::AddressSize addrsize;
+	switch (parser.get<int>("--addrbits")) {
+		case 16:
+			addrsize = tierone::srec::SrecFile::AddressSize::BITS16;
+			break;
+		case 24:
+			addrsize = tierone::srec::SrecFile::AddressSize::BITS24;
+			break;
+		case 32:
+			addrsize = tierone::srec::SrecFile::AddressSize::BITS32;
+			break;
+		default:
+			std::cerr << "Invalid address size" << std::endl;
+			return 1;
+	}
+
+	// Get thread count
+	const int threads = parser.get<int>("--threads");
+	if (threads < 0) {
+		std::cerr << "Invalid thread count" << std::endl;
+		return 1;
+	}
+
+	// Get record count and output size limits
+	const tierone::srec::SrecLimits limits = parser.get<bool>("--large")
+		? tierone::srec::SrecLimits::large() : tierone::srec::SrecLimits::safe();
+
+	const bool want_stats = parser.get<bool>("--stats");
+
+	// Get the record layout
+	const int record_length = parser.get<int>("--record-length");
+	if (record_length < 0) {
+		std::cerr << "Invalid record length" << std::endl;
+		return 1;
+	}
+	tierone::srec::SrecLayout layout;
+	layout.record_length = static_cast<size_t>(record_length);
+	layout.align = parser.get<bool>("--align");
+	layout.line_ending = parser.get<bool>("--crlf") ? tierone::srec::LineEnding::CRLF : tierone::srec::LineEnding::LF;
+	layout.fixed_stride = parser.get<bool>("--fixed-stride");
+
+	// Get the fill left out of the records
+	tierone::srec::SrecFillSkip skip;
+	skip.enabled = parser.get<bool>("--skip-fill");
+	try {
+		const unsigned long fill_byte = std::stoul(parser.get<std::string>("--fill-byte"), nullptr, 0);
+		if (fill_byte > 0xFF) {
+			throw std::out_of_range("fill byte");
+		}
+		skip.fill_byte = static_cast<uint8_t>(fill_byte);
+	} catch (const std::exception &) {
+		std::cerr << "Invalid fill byte" << std::endl;
+		return 1;
+	}
+	const int min_fill_run = parser.get<int>("--min-fill-run");
+	if (min_fill_run < 0) {
+		std::cerr << "Invalid fill run length" << std::endl;
+		return 1;
+	}
+	skip.min_run = static_cast<size_t>(min_fill_run);
+	const std::string fill_crc = parser.get<std::string>("--fill-crc");
+	if (fill_crc == "emitted") {
+		skip.crc = tierone::srec::SrecFillCrc::EMITTED;
+	} else if (fill_crc == "image") {
+		skip.crc = tierone::srec::SrecFillCrc::IMAGE;
+	} else {
+		std::cerr << "Invalid fill CRC, expected emitted or image" << std::endl;
+		return 1;
+	}
+
+	// Convert a batch of files on a pool of workers
+	if (!jobs.empty()) {
+		if (parser.is_used("--output")) {
+			std::cerr << "--output does not support batch mode; list outputs in a manifest" << std::endl;
+			return 1;
+		}
+		if (parser.is_used("--previous")) {
+			std::cerr << "--previous does not support batch mode" << std::endl;
+			return 1;
+		}
+		tierone::srec::SrecBatchRunner runner(parser.is_used("--threads") ? static_cast<unsigned>(threads) : 0);
+		const bool checksum = parser.get<bool>("--checksum");
+		std::vector<tierone::srec::SrecStats> stats(runner.workers());
+		const size_t failures = runner.run(jobs.size(), [&](const size_t index, const unsigned worker) {
+			return convert_file(jobs[index], addrsize, limits, layout, skip, checksum, want_stats ? &stats[worker] : nullptr);
+		}, [&](const size_t index, const tierone::srec::SrecBatchResult &result) {
+			if (result.ok) {
+				std::cout << jobs[index].input << ": OK -> " << result.message << std::endl;
+			} else {
+				std::cout << jobs[index].input << ": FAILED: " << result.message << std::endl;
+			}
+		});
+		std::cout << (jobs.size() - failures) << " of " << jobs.size() << " files converted" << std::endl;
+		if (want_stats) {
+			for (size_t i = 1; i < stats.size(); ++i) {
+				stats[0].merge(stats[i]);
+			}
+			stats[0].print(std::cerr);
+		}
+		return failures == 0 ? 0 : 1;
+	}
+
 	// Check if input file is specified
 	try {
 		inputfilename = parser.get<std::string>("--input");
@@ -74,6 +283,37 @@ int main(int argc, char *argv[]) {
 		return 1;
 	}
 
+	// Reconvert against the previous build's input and output
+	if (parser.is_used("--previous")) {
+		if (record_length != 0 || !layout.is_plain()) {
+			std::cerr << "--previous only supports the default record layout" << std::endl;
+			return 1;
+		}
+		if (skip.enabled) {
+			std::cerr << "--previous does not support --skip-fill" << std::endl;
+			return 1;
+		}
+		if (tierone::srec::compression_for_filename(outputfilename) != tierone::srec::SrecCompression::NONE) {
+			std::cerr << "--previous does not support compressed output" << std::endl;
+			return 1;
+		}
+		const auto previous = parser.get<std::vector<std::string>>("--previous");
+		tierone::srec::SrecIncrementalConverter::Options options;
+		options.address_size = addrsize;
+		options.want_checksum = parser.get<bool>("--checksum");
+		options.limits = limits;
+		try {
+			const auto result = tierone::srec::SrecIncrementalConverter::convert(inputfilename, previous[0], previous[1],
+			                                                                     outputfilename, options);
+			std::cout << "Reused " << result.reused_records << " of "
+			          << (result.reused_records + result.formatted_records) << " records" << std::endl;
+		} catch (const std::exception &err) {
+			std::cerr << "Error converting binary file: " << err.what() << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
 	// Open input file
 	std::ifstream input(inputfilename, std::ios::binary);
 	if (!input.is_open()) {
@@ -81,34 +321,42 @@ int main(int argc, char *argv[]) {
 		return 1;
 	}
 
-	// Get address size
-	tierone::srec::SrecFile::AddressSize addrsize;
-	switch (parser.get<int>("--addrbits")) {
-		case 16:
-			addrsize = tierone::srec::SrecFile::AddressSize::BITS16;
-			break;
-		case 24:
-			addrsize = tierone::srec::SrecFile::AddressSize::BITS24;
-			break;
-		case 32:
-			addrsize = tierone::srec::SrecFile::AddressSize::BITS32;
-			break;
-		default:
-			std::cerr << "Invalid address size" << std::endl;
-			return 1;
+	// Open output file, compressed if its name ends in .gz or .zst
+	std::unique_ptr<tierone::srec::SrecSink> sink;
+	try {
+		sink = tierone::srec::open_output_sink(outputfilename);
+	} catch (const std::exception &err) {
+		std::cerr << "Error opening output file: " << err.what() << std::endl;
+		return 1;
 	}
-
-	// Open output file
-	tierone::srec::SrecFile sfile(outputfilename, addrsize);
+	tierone::srec::SrecFile sfile(std::move(sink), addrsize, 0, tierone::srec::FlushPolicy::ON_CLOSE, limits);
 	if (!sfile.is_open()) {
 		std::cerr << "Error opening output file" << std::endl;
 		return 1;
 	}
 
 	try {
-		tierone::srec::convert_bin_to_srec(input, sfile, parser.get<bool>("--checksum"));
+		sfile.set_layout(layout);
+		sfile.set_skip_fill(skip);
+	} catch (const std::exception &err) {
+		std::cerr << "Invalid record layout: " << err.what() << std::endl;
+		return 1;
+	}
+
+	tierone::srec::SrecStats stats;
+	if (want_stats) {
+		sfile.set_stats(&stats);
+	}
+
+	try {
+		tierone::srec::convert_bin_to_srec(input, sfile, parser.get<bool>("--checksum"),
+		                                    static_cast<unsigned>(threads));
 	} catch (const std::exception &err) {
 		std::cerr << "Error converting binary file: " << err.what() << std::endl;
+		return 1;
+	}
+	if (want_stats) {
+		stats.print(std::cerr);
 	}
 
 	return 0;
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// libFuzzer target for the S-record parsers.
+//
+// Every line of the input goes through SrecStreamParser::try_parse_line()
+// and is checked against the throwing wrapper, the fast data record decoder,
+// peek_record_fields() and, for accepted records, formatting the record
+// again. The whole input is then read with SrecMappedReader and scanned with
+// SrecMetadataScanner. Lines are copied into buffers of their exact size, so
+// the sanitizers catch any read past the end of a line.
+//
+// Built without libFuzzer (SREC_FUZZ_STANDALONE) the program replays the
+// files and directories given on the command line instead.
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "srec/srec.h"
+#include "srec/srec_codec.h"
+#include "srec/srec_mapped.h"
+#include "srec/srec_metadata.h"
+
+using namespace tierone::srec;
+
+namespace {
+
+void check(const bool condition) {
+	if (!condition) {
+		std::abort();
+	}
+}
+
+bool is_data(const Srec::Type type) {
+	return type == Srec::Type::S1 || type == Srec::Type::S2 || type == Srec::Type::S3;
+}
+
+bool same_text(const std::string_view a, const std::string_view b) {
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const char x, const char y) {
+		return std::toupper(static_cast<unsigned char>(x)) == std::toupper(static_cast<unsigned char>(y));
+	});
+}
+
+// Parse one line every way there is and compare the outcomes; true if accepted with checksums
+bool check_line(const std::string_view text, const size_t line_number) {
+	// Exactly sized copies, so reading past either end is reported
+	const std::vector<char> line(text.begin(), text.end());
+	const std::string_view view(line.data(), line.size());
+	std::vector<uint8_t> payload(SrecStreamParser::MAX_RECORD_DATA_SIZE);
+
+	bool accepted = false;
+	for (const bool validate : {true, false}) {
+		SrecStreamParser::ParsedRecordView record{};
+		const SrecParseResult result = SrecStreamParser::try_parse_line(view, line_number, validate, payload.data(),
+		                                                                record);
+		check(result.line == line_number);
+		check(result.column <= line.size());
+
+		// The throwing wrapper agrees with the result
+		SrecStreamParser::ParsedRecordView thrown{};
+		std::vector<uint8_t> thrown_payload(SrecStreamParser::MAX_RECORD_DATA_SIZE);
+		try {
+			SrecStreamParser::parse_line(view, line_number, validate, thrown_payload.data(), thrown);
+			check(result.ok());
+		} catch (const SrecValidationException &) {
+			check(result.error == SrecParseError::CHECKSUM_MISMATCH);
+		} catch (const SrecParseException &e) {
+			check(!result.ok() && result.error != SrecParseError::CHECKSUM_MISMATCH);
+			check(e.getLineNumber() == line_number && e.getColumn() == result.column);
+		}
+		if (!result.ok()) {
+			continue;
+		}
+		check(record.length <= SrecStreamParser::MAX_RECORD_DATA_SIZE);
+		check(record.data == payload.data());
+		check(thrown.length == record.length && std::memcmp(thrown_payload.data(), payload.data(), record.length) == 0);
+
+		// The fast data record decoder accepts the same records
+		const DataRecordParser fast = data_record_parser(record.type);
+		if (fast != nullptr) {
+			SrecStreamParser::ParsedRecordView quick{};
+			std::vector<uint8_t> quick_payload(SrecStreamParser::MAX_RECORD_DATA_SIZE);
+			check(fast(view, line_number, validate, quick_payload.data(), quick));
+			check(quick.type == record.type && quick.address == record.address);
+			check(quick.length == record.length);
+			check(std::memcmp(quick_payload.data(), payload.data(), record.length) == 0);
+		}
+
+		// Reading the fields alone gives the same record
+		if (is_data(record.type)) {
+			SrecRecordFields fields;
+			check(peek_record_fields(view, fields));
+			check(fields.type == record.type && fields.address == record.address && fields.length == record.length);
+		}
+
+		// A record with a valid checksum formats back to the same line
+		if (validate) {
+			accepted = true;
+			std::vector<char> formatted(MAX_RECORD_LINE_LENGTH);
+			const size_t length = format_record(record.type, record.address, record.data, record.length,
+			                                    formatted.data());
+			check(same_text(std::string_view(formatted.data(), length), view));
+		}
+	}
+	return accepted;
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+	const char *text = reinterpret_cast<const char *>(data);
+
+	// Line by line, split and trimmed as SrecMappedReader does
+	size_t records = 0;
+	size_t position = 0;
+	for (size_t line_number = 1; position < size; ++line_number) {
+		const char *start = text + position;
+		const auto *newline = static_cast<const char *>(std::memchr(start, '\n', size - position));
+		const size_t line_length = newline ? static_cast<size_t>(newline - start) : size - position;
+		position += line_length + (newline ? 1 : 0);
+
+		const std::string_view line(start, line_length);
+		if (!SrecStreamParser::is_blank(line) && check_line(SrecStreamParser::trim_trailing(line), line_number)) {
+			++records;
+		}
+	}
+
+	// The reader skips rejected lines and returns every accepted one
+	SrecMappedReader reader(text, size);
+	SrecMappedReader::ParsedRecordView record{};
+	SrecParseResult result;
+	size_t read = 0;
+	while (reader.offset() < reader.size()) {
+		if (reader.try_next(record, result)) {
+			check(record.length <= SrecStreamParser::MAX_RECORD_DATA_SIZE);
+			++read;
+		} else {
+			check(!result.ok() || reader.offset() == reader.size());
+		}
+	}
+	check(read == records);
+
+	try {
+		SrecMetadataScanner::scan(text, size);
+	} catch (const SrecException &) {
+		// Malformed input is reported, nothing more
+	}
+	return 0;
+}
+
+#if defined(SREC_FUZZ_STANDALONE)
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+void run_file(const std::filesystem::path &path) {
+	std::ifstream input(path, std::ios::binary);
+	const std::vector<char> contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	std::vector<uint8_t> bytes(contents.begin(), contents.end());
+	LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	size_t count = 0;
+	for (int i = 1; i < argc; ++i) {
+		const std::filesystem::path path(argv[i]);
+		if (std::filesystem::is_directory(path)) {
+			for (const auto &entry : std::filesystem::directory_iterator(path)) {
+				if (entry.is_regular_file()) {
+					run_file(entry.path());
+					++count;
+				}
+			}
+		} else {
+			run_file(path);
+			++count;
+		}
+	}
+	std::cout << "Ran " << count << " inputs" << std::endl;
+	return 0;
+}
+
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "srec_crc.h"
+
 namespace tierone::srec {
 
 /* For more information on CRC, see, e.g.,
@@ -81,16 +83,14 @@ static const unsigned int crc32_table[] =
    This differs from the "standard" CRC-32 algorithm in that the values
    are not reflected, and there is no final XOR value.  These differences
    make it easy to compose the values of multiple blocks.
+
+   The work is done by crc32_update(), which picks the fastest kernel for
+   the running CPU; see srec_crc.h and xcrc32_combine().
 */
 
 inline unsigned int xcrc32(const unsigned char *buf, unsigned long len, unsigned int init)
 {
-  unsigned int crc = init;
-  while (len--) {
-	crc = (crc << 8) ^ crc32_table[((crc >> 24) ^ *buf) & 0xff];
-	buf++;
-  }
-  return crc;
+  return crc32_update(buf, len, init);
 }
 
 } // namespace tierone::srec
@@ -14,232 +14,885 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <sstream>
 #include <iomanip>
 #include <memory>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include "srec.h"
 #include "crc32.h"
+#include "srec_binary.h"
+#include "srec_codec.h"
+#include "srec_compress.h"
+#include "srec_hex.h"
+#include "srec_mapped.h"
+#include "srec_parallel.h"
+#include "srec_reader.h"
 
 namespace tierone::srec {
 
+namespace {
+
+constexpr char record_type_char(const Srec::Type type) {
+	switch (type) {
+		case Srec::Type::S0: return '0';
+		case Srec::Type::S1: return '1';
+		case Srec::Type::S2: return '2';
+		case Srec::Type::S3: return '3';
+		case Srec::Type::S5: return '5';
+		case Srec::Type::S6: return '6';
+		case Srec::Type::S7: return '7';
+		case Srec::Type::S8: return '8';
+		case Srec::Type::S9: return '9';
+		default: return '0';
+	}
+}
+
+// Emit S<type>, then count + bytes + checksum as hex. 'bytes' holds the
+// count in bytes[0] followed by the address/data bytes.
+size_t format_counted_bytes(const char type_char, const uint8_t *bytes, const size_t length, char *out) {
+	out[0] = 'S';
+	out[1] = type_char;
+	const uint32_t sum = hex_encode(bytes, length, out + 2);
+	const auto checksum = static_cast<uint8_t>(~sum & 0xFF);
+	hex_encode(&checksum, 1, out + 2 + (length * 2));
+	return 2 + ((length + 1) * 2);
+}
+
+// CRC32 header payload: the CRC big-endian followed by a null byte
+std::array<uint8_t, 5> crc_header_bytes(const uint32_t sum) {
+	return {static_cast<uint8_t>((sum >> 24) & 0xFF), static_cast<uint8_t>((sum >> 16) & 0xFF),
+	        static_cast<uint8_t>((sum >> 8) & 0xFF), static_cast<uint8_t>(sum & 0xFF), 0};
+}
+
+// How a converter produces the CRC32 header
+enum class ChecksumHeader {
+	NONE,     // no header requested
+	RESERVED, // slot reserved, patch before closing
+	WRITTEN,  // CRC computed up front and already written
+	DEFERRED  // rewrite the file with write_checksum() after closing
+};
+
+// CRC of the rest of the input as the data records will cover it, for
+// records of at most record_size bytes. With fill left out of the CRC the
+// input is walked record by record, as the converter will split it.
+uint32_t input_crc(std::istream &input, const SrecFile &sfile, const size_t record_size) {
+	std::vector<uint8_t> buffer(std::max<size_t>(65536 / record_size, 1) * record_size);
+	uint32_t sum = 0;
+	uint64_t at = sfile.next_address();
+	size_t filled = 0;
+	for (bool end = false; !end || filled > 0;) {
+		if (!end) {
+			input.read(reinterpret_cast<char *>(buffer.data() + filled), static_cast<std::streamsize>(buffer.size() - filled));
+			filled += static_cast<size_t>(input.gcount());
+			end = filled < buffer.size();
+		}
+		size_t offset = 0;
+		while (offset < filled) {
+			size_t length = std::min(record_size, sfile.record_length_at(at));
+			if (filled - offset < length && !end) {
+				break; // completed by the next read
+			}
+			length = std::min(length, filled - offset);
+			size_t covered = 0;
+			sum = sfile.update_data_crc(sum, at, buffer.data() + offset, length, covered);
+			offset += length;
+			at += length;
+		}
+		std::memmove(buffer.data(), buffer.data() + offset, filled - offset);
+		filled -= offset;
+	}
+	return sum;
+}
+
+// Start a checksummed conversion. Patching a reserved slot is preferred;
+// if the sink cannot be patched the CRC is computed by reading a seekable
+// input ahead of time, so the S-record output is still written only once.
+// Only a plain file named by the SrecFile can be rewritten afterwards.
+ChecksumHeader begin_checksum_header(std::istream &input, SrecFile &sfile, const size_t record_size) {
+	if (sfile.is_open() && sfile.sink().can_patch()) {
+		sfile.reserve_checksum_header();
+		return ChecksumHeader::RESERVED;
+	}
+
+	const std::istream::pos_type start = input.tellg();
+	if (start == std::istream::pos_type(-1)) {
+		if (sfile.getFilename().empty()) {
+			throw SrecFileException("A CRC32 header needs a seekable input or a patchable output");
+		}
+		return ChecksumHeader::DEFERRED;
+	}
+	const uint32_t sum = input_crc(input, sfile, record_size);
+	input.clear();
+	input.seekg(start);
+	if (!input) {
+		throw SrecFileException("Failed to rewind input stream");
+	}
+	const auto bytes = crc_header_bytes(sum);
+	sfile.write_header(std::vector<uint8_t>(bytes.begin(), bytes.end()));
+	return ChecksumHeader::WRITTEN;
+}
+
+// Reads an input stream on a background thread into a ring of blocks,
+// so the next read overlaps processing of the current block
+class AsyncBlockReader {
+public:
+	AsyncBlockReader(std::istream &input_stream, const size_t block_size, const size_t block_count)
+		: input(input_stream),
+		  blocks(block_count)
+	{
+		for (auto &block : blocks) {
+			block.bytes.resize(block_size);
+		}
+		thread = std::thread([this] { run(); });
+	}
+
+	~AsyncBlockReader() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		changed.notify_all();
+		thread.join();
+	}
+
+	AsyncBlockReader(const AsyncBlockReader &) = delete;
+	AsyncBlockReader &operator=(const AsyncBlockReader &) = delete;
+
+	// Get the next block, handing the previous one back to the reader
+	bool next(const uint8_t *&data, size_t &length) {
+		std::unique_lock<std::mutex> lock(mutex);
+		if (holding) {
+			++consumed;
+			holding = false;
+			changed.notify_all();
+		}
+		changed.wait(lock, [this] { return produced > consumed || end; });
+		if (produced == consumed) {
+			return false;
+		}
+		const Block &block = blocks[consumed % blocks.size()];
+		data = block.bytes.data();
+		length = block.length;
+		holding = true;
+		return true;
+	}
+
+	// Whether reading stopped on an error; valid once next() returned false
+	bool failed() const {
+		return bad;
+	}
+
+private:
+	struct Block {
+		std::vector<uint8_t> bytes;
+		size_t length{0};
+	};
+
+	void run() {
+		for (;;) {
+			size_t slot = 0;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				changed.wait(lock, [this] { return stop || produced - consumed < blocks.size(); });
+				if (stop) {
+					return;
+				}
+				slot = produced % blocks.size();
+			}
+
+			// The slot is neither filled nor held, so it is read without the lock
+			Block &block = blocks[slot];
+			bool failure = false;
+			try {
+				input.read(reinterpret_cast<char *>(block.bytes.data()), static_cast<std::streamsize>(block.bytes.size()));
+				block.length = static_cast<size_t>(input.gcount());
+				failure = input.bad();
+			} catch (...) {
+				block.length = 0;
+				failure = true;
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			if (block.length > 0) {
+				++produced;
+			}
+			if (block.length < block.bytes.size() || failure) {
+				end = true;
+				bad = failure;
+				changed.notify_all();
+				return;
+			}
+			changed.notify_all();
+		}
+	}
+
+	std::istream &input;
+	std::vector<Block> blocks;
+	size_t produced{0}; // blocks filled so far
+	size_t consumed{0}; // blocks handed back so far
+	bool holding{false};
+	bool end{false};
+	bool bad{false};
+	bool stop{false};
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::thread thread;
+};
+
+// Number of leading bytes equal to 'fill'. Erased regions are long, so
+// they are compared 32 bytes at a time, as four words.
+size_t leading_fill(const uint8_t *data, const size_t length, const uint8_t fill) {
+	const uint64_t pattern = 0x0101010101010101ULL * fill;
+	size_t i = 0;
+	for (; i + 32 <= length; i += 32) {
+		std::array<uint64_t, 4> words;
+		std::memcpy(words.data(), data + i, sizeof(words));
+		if (((words[0] ^ pattern) | (words[1] ^ pattern) | (words[2] ^ pattern) | (words[3] ^ pattern)) != 0) {
+			break;
+		}
+	}
+	for (; i + 8 <= length; i += 8) {
+		uint64_t word;
+		std::memcpy(&word, data + i, sizeof(word));
+		if (word != pattern) {
+			break;
+		}
+	}
+	while (i < length && data[i] == fill) {
+		++i;
+	}
+	return i;
+}
+
+// Number of trailing bytes equal to 'fill'
+size_t trailing_fill(const uint8_t *data, const size_t length, const uint8_t fill) {
+	const uint64_t pattern = 0x0101010101010101ULL * fill;
+	size_t end = length;
+	for (; end >= 8; end -= 8) {
+		uint64_t word;
+		std::memcpy(&word, data + end - 8, sizeof(word));
+		if (word != pattern) {
+			break;
+		}
+	}
+	while (end > 0 && data[end - 1] == fill) {
+		--end;
+	}
+	return length - end;
+}
+
+} // namespace
+
 // Convert a std::string to a hex string
 std::string ASCIIToHexString(const std::string &buffer) {
-	// Pre-allocate result string for better performance
-	std::string result;
-	result.reserve(buffer.size() * 2);
-	
-	std::stringstream ss;
-	ss << std::uppercase << std::hex << std::setfill('0');
-	for (const auto &c : buffer) {
-		ss << std::setw(2) << static_cast<unsigned int>(static_cast<unsigned char>(c));
+	std::string result(buffer.size() * 2, '\0');
+	hex_encode(reinterpret_cast<const uint8_t *>(buffer.data()), buffer.size(), result.data());
+	return result;
+}
+
+std::string Srec::toString() {
+	return view().to_string();
+}
+
+size_t SrecView::format(char *out) const {
+	return format_record(type, address, data, length, out);
+}
+
+std::string SrecView::to_string() const {
+	std::array<char, MAX_RECORD_LINE_LENGTH> line;
+	return std::string(line.data(), format(line.data()));
+}
+
+uint8_t SrecView::checksum() const {
+	const size_t address_size = record_address_size(type);
+	unsigned long sum = address_size + length + 1; // byte count
+	for (size_t i = 0; i < address_size; ++i) {
+		sum += (address >> (i * 8)) & 0xFF;
+	}
+	for (size_t i = 0; i < length; ++i) {
+		sum += data[i];
+	}
+	return static_cast<uint8_t>(~sum & 0xFF);
+}
+
+bool SrecView::operator==(const SrecView &other) const {
+	return type == other.type && address == other.address && length == other.length &&
+	       (length == 0 || std::memcmp(data, other.data, length) == 0);
+}
+
+size_t format_record(const Srec::Type type, const uint32_t address, const uint8_t *data, const size_t length, char *out) {
+	const size_t address_size = record_address_size(type);
+	if (length > 254 - address_size) { // 255 - 1 for checksum
+		throw SrecValidationException(
+			"Record data size exceeds maximum of 254 bytes",
+			SrecValidationException::ValidationError::DATA_TOO_LARGE
+		);
+	}
+	if (address_size < 4 && (address >> (address_size * 8)) != 0) {
+		throw SrecAddressException(address, (1u << (address_size * 8)) - 1);
+	}
+
+	// Lay out count + address + data and hex encode them in one pass
+	std::array<uint8_t, 256> counted;
+	counted[0] = static_cast<uint8_t>(address_size + length + 1); // address + data + checksum
+	for (size_t i = 0; i < address_size; ++i) {
+		counted[address_size - i] = static_cast<uint8_t>((address >> (i * 8)) & 0xFF);
 	}
-	// Convert the string stream to a std::string and return it
-	return ss.str();
+	if (length > 0) {
+		std::memcpy(counted.data() + 1 + address_size, data, length);
+	}
+	return format_counted_bytes(record_type_char(type), counted.data(), 1 + address_size + length, out);
 }
 
 // Convert a binary file to a Srecord file
-void convert_bin_to_srec(std::ifstream &input, SrecFile &sfile, const bool want_checksum) {
-	// Get the max number the Srecord can store
-	unsigned int bytes_to_read = sfile.max_data_bytes_per_record();
-	// Buffer to store data from input file
-	std::vector<uint8_t> buffer(bytes_to_read);
+void convert_bin_to_srec(std::ifstream &input, SrecFile &sfile, const bool want_checksum, const unsigned threads) {
+	// Read a whole number of records at a time, so the records are the same
+	// as reading one record's worth per call
+	const size_t record_size = std::max<size_t>(sfile.max_data_bytes_per_record(), 1);
+	std::vector<uint8_t> buffer(std::max<size_t>(65536 / record_size, 1) * record_size);
+
+	const ChecksumHeader header = want_checksum ? begin_checksum_header(input, sfile, record_size) : ChecksumHeader::NONE;
 
 	// CRC32 checksum
 	unsigned int sum = 0;
 
-	// Read input file and write to Srecord file
-	while (input.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size())) || input.gcount() > 0) {
-		// resize buffer in case the last read was less than the 'bytes_to_read'
-		buffer.resize(static_cast<size_t>(input.gcount()));
+	if (threads != 1) {
+		SrecParallelConverter::Options options;
+		options.threads = threads;
+		sum = SrecParallelConverter::write_data_records(input, sfile, options);
+	} else {
+		SrecStats *stats = sfile.stats();
+		if (SrecStats::ENABLED && stats) {
+			stats->note_buffer(buffer.size());
+		}
+
+		// Read input file and write to Srecord file. An aligned layout that
+		// starts mid-record reads up to the next boundary first, so every
+		// later read ends on a record boundary too.
+		const size_t skew = record_size - std::min(sfile.next_record_length(), record_size);
+		size_t read_size = buffer.size() - skew;
+		auto read_chunk = [&] {
+			SrecStatsTimer timer(stats, SrecStats::Phase::READ);
+			const bool more = input.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(read_size)) ||
+			                  input.gcount() > 0;
+			read_size = buffer.size();
+			return more;
+		};
+		while (read_chunk()) {
+			// the last read may be shorter than the buffer
+			const auto bytes_read = static_cast<size_t>(input.gcount());
 
-		sfile.write_record_payload(buffer);
-		sum = xcrc32(buffer.data(), buffer.size(), sum);
-		buffer.resize(bytes_to_read);
+			const uint64_t start = sfile.next_address();
+			sfile.write_data(buffer.data(), bytes_read);
+			SrecStatsTimer timer(stats, SrecStats::Phase::CHECKSUM);
+			size_t covered = 0;
+			sum = sfile.update_data_crc(sum, start, buffer.data(), bytes_read, covered);
+			timer.stop();
+			if (SrecStats::ENABLED && stats) {
+				stats->bytes_in += bytes_read;
+			}
+		}
 	}
 
 	// Write record count and termination
 	sfile.write_record_count();
 	sfile.write_record_termination();
 
+	if (header == ChecksumHeader::RESERVED) {
+		sfile.write_checksum_header(sum);
+	}
 	sfile.close();
 	input.close();
 
 	// Write checksum if requested as the first line in the Srecord file
-	if (want_checksum) {
+	if (header == ChecksumHeader::DEFERRED) {
 		write_checksum(sfile, sum);
 	}
 }
 
 void write_checksum(const SrecFile &srecfile, const unsigned int sum) {
+	if (srecfile.getFilename().empty()) {
+		throw std::ios_base::failure("Output has no file name to rewrite with a checksum");
+	}
+
 	// Open a temp file
 	std::string tempfilename = srecfile.getFilename() + ".tmp";
 	SrecFile sfile(tempfilename, srecfile.addrsize());
 	if (!sfile.is_open()) {
 		throw std::ios_base::failure("Error opening output file: " + tempfilename);
 	}
-
-	// Convert crc32 to byte vector
-	std::vector<uint8_t> crc32bytes;
-	crc32bytes.push_back(static_cast<uint8_t>((sum >> 24) & 0xFF));
-	crc32bytes.push_back(static_cast<uint8_t>((sum >> 16) & 0xFF));
-	crc32bytes.push_back(static_cast<uint8_t>((sum >> 8) & 0xFF));
-	crc32bytes.push_back(static_cast<uint8_t>(sum & 0xFF));
-	crc32bytes.push_back(0); // null
+	sfile.set_layout(srecfile.layout());
 
 	// Write header
-	sfile.write_header(crc32bytes);
+	const auto crc32bytes = crc_header_bytes(sum);
+	sfile.write_header(std::vector<uint8_t>(crc32bytes.begin(), crc32bytes.end()));
 	sfile.close();
 
 	// Now append the original file to the temp file
 	std::ifstream ifs(srecfile.getFilename(), std::ios::binary);
 	std::ofstream ofs(tempfilename, std::ios::binary | std::ios::app);
-	ofs << ifs.rdbuf();
+	if (!ifs.is_open()) {
+		std::remove(tempfilename.c_str());
+		throw std::ios_base::failure("Error opening output file: " + srecfile.getFilename());
+	}
+	if (ifs.peek() != std::ifstream::traits_type::eof()) {
+		ofs << ifs.rdbuf();
+	}
 	ifs.close();
 	ofs.close();
-
-	// Rename the temp file to the original file
-	std::rename(tempfilename.c_str(), srecfile.getFilename().c_str());
-}
-
-void convert_srec_to_bin(const std::string &input_file, const std::string &output_file) {
-	std::ifstream input(input_file);
-	std::ofstream output(output_file, std::ios::binary);
-
-	if (!input.is_open()) {
-		throw std::ios_base::failure("Failed to open input file");
-	}
-
-	if (!output.is_open()) {
-		throw std::ios_base::failure("Failed to open output file");
+	if (ifs.bad() || !ofs) {
+		std::remove(tempfilename.c_str());
+		throw std::ios_base::failure("Error copying output file: " + srecfile.getFilename());
 	}
 
-	std::string line;
-	while (std::getline(input, line)) {
-		if (line.empty()) {
-			continue;
-		}
-
-		if (line[0] != 'S') {
-			continue;
-		}
-		if (line[1] != '1' && line[1] != '2' && line[1] != '3') {
-			continue;
-		}
-		std::string data;
-		if (line[1] == '1') {
-			data = line.substr(4+(Srec1::ADDRESS_SIZE*2)); // cut off S#, byte_count, and address
-			data = data.substr(0, data.size() - 2); // cut off checksum
-		} else if (line[1] == '2') {
-			data = line.substr(4+(Srec2::ADDRESS_SIZE*2)); // cut off S#, byte_count, and address
-			data = data.substr(0, data.size() - 2); // cut off checksum
-		} else if (line[1] == '3') {
-			data = line.substr(4+(Srec3::ADDRESS_SIZE*2));	// cut off S#, byte_count, and address
-			data = data.substr(0, data.size() - 2); // cut off checksum
-		}
-		// walk through the data string and covert each ASCII pair to a byte
-		// and write it to the output file
-		// e.g. "010203" -> 0x01, 0x02, 0x03
-		for (size_t i = 0; i < data.size(); i += 2) {
-			try {
-				auto byte = static_cast<uint8_t>(std::stoi(data.substr(i, 2), nullptr, 16));
-				output.write(reinterpret_cast<const char *>(&byte), 1);
-			} catch (const std::exception &e) {
-				//std::cerr << "Failed to parse hex data: " << e.what() << std::endl;
-				throw std::ios_base::failure("Failed to parse hex data: " + std::string(e.what()));
-			}
-		}
-		output.flush();
+	// Rename the temp file to the original file
+	if (std::rename(tempfilename.c_str(), srecfile.getFilename().c_str()) != 0) {
+		std::remove(tempfilename.c_str());
+		throw std::ios_base::failure("Error replacing output file: " + srecfile.getFilename());
 	}
+}
 
-	input.close();
-	output.close();
+void convert_srec_to_bin(const std::string &input_file, const std::string &output_file, uint8_t fill_byte) {
+	SrecBinaryOptions options;
+	options.fill_byte = fill_byte;
+	SrecBinaryConverter::convert(input_file, output_file, options);
 }
 
 // Parse an S-record string and return an Srec objec
-SrecFile::SrecFile(const std::string &file_name, SrecFile::AddressSize address_size, unsigned int start_address)
+SrecFile::SrecFile(const std::string &file_name, SrecFile::AddressSize address_size, unsigned int start_address,
+                   FlushPolicy flush_policy, const Limits &file_limits)
 	: filename(file_name),
+	  output(std::make_unique<SrecFileSink>(file_name)),
+	  flush_mode(flush_policy),
 	  address(start_address),
 	  exec_address(start_address),
-	  address_size_bits(address_size)
+	  address_size_bits(address_size),
+	  limit(file_limits)
 {
-	file.open(filename, std::ios::trunc | std::ios::in | std::ios::out);
+	select_codec();
+}
+
+SrecFile::SrecFile(std::unique_ptr<SrecSink> sink, SrecFile::AddressSize address_size, unsigned int start_address,
+                   FlushPolicy flush_policy, const Limits &file_limits)
+	: output(std::move(sink)),
+	  flush_mode(flush_policy),
+	  address(start_address),
+	  exec_address(start_address),
+	  address_size_bits(address_size),
+	  limit(file_limits)
+{
+	select_codec();
 }
 
 SrecFile::~SrecFile() {
-	file.close();
+	try {
+		close();
+	} catch (const SrecException &) {
+		// Destructors must not throw; call close() to observe errors
+	}
 }
 
 void SrecFile::close() {
-	file.flush();
-	file.close();
+	if (output) {
+		SrecStatsTimer timer(statistics, SrecStats::Phase::WRITE);
+		output->close();
+	}
+}
+
+void SrecFile::flush() {
+	if (output) {
+		SrecStatsTimer timer(statistics, SrecStats::Phase::WRITE);
+		output->flush();
+	}
 }
 
 bool SrecFile::is_open() {
-	return file.is_open();
+	return output && output->is_open();
 }
 
-unsigned int SrecFile::max_data_bytes_per_record() const {
+void SrecFile::select_codec() {
+	// An invalid size leaves the formatters unset; writing then throws
 	switch (address_size_bits) {
 		case AddressSize::BITS16:
-			return 255 - 1 - 4 - 1; // max data - byte_count -  address_width - checksum
 		case AddressSize::BITS24:
-			return 255 - 1 - 6 - 1; // max data - byte_count -  address_width - checksum
 		case AddressSize::BITS32:
-			return 255 - 1 - 8 - 1; // max data - byte_count -  address_width - checksum
+			with_record_codec(address_size_bits, [this](auto codec) {
+				using Codec = decltype(codec);
+				codec_payload = Codec::MAX_PAYLOAD;
+				max_address = Codec::MAX_ADDRESS;
+				address_length = Codec::ADDRESS_LENGTH;
+				format_data = &Codec::format_data;
+				format_termination = &Codec::format_termination;
+			});
+			break;
 		default:
-			return 0;
+			break;
+	}
+	apply_layout();
+}
+
+void SrecFile::apply_layout() {
+	max_payload = (record_layout.record_length > 0) ? static_cast<unsigned int>(record_layout.record_length)
+	                                                : codec_payload;
+	// S, type, count, address, checksum and line terminator
+	record_overhead = empty_line_length(address_length);
+	stride = record_layout.fixed_stride ? record_overhead + (2 * static_cast<size_t>(max_payload)) : 0;
+}
+
+void SrecFile::set_layout(const SrecLayout &new_layout) {
+	if (format_data && new_layout.record_length > codec_payload) {
+		throw SrecValidationException("Record length of " + std::to_string(new_layout.record_length) +
+		                              " exceeds the maximum of " + std::to_string(codec_payload) +
+		                              " for the address size", SrecValidationException::ValidationError::INVALID_FORMAT);
+	}
+	record_layout = new_layout;
+	apply_layout();
+}
+
+unsigned int SrecFile::max_data_bytes_per_record() const {
+	return max_payload;
+}
+
+size_t SrecFile::record_length_at(const uint64_t at) const {
+	if (!record_layout.align || max_payload == 0) {
+		return max_payload;
+	}
+	return max_payload - static_cast<size_t>(at % max_payload);
+}
+
+size_t SrecFile::trim_fill(const uint64_t start, const uint8_t *data, const size_t length, size_t &lead) const {
+	lead = 0;
+	if (!fill_skip.enabled) {
+		return length;
+	}
+	const size_t run = std::max<size_t>(fill_skip.min_run, 1);
+	const size_t leading = leading_fill(data, length, fill_skip.fill_byte);
+	if (leading == length) {
+		return 0;
+	}
+	// A record is never moved past the last address its address field can hold
+	lead = (leading >= run && start + leading <= max_address) ? leading : 0;
+	const size_t trailing = trailing_fill(data + lead, length - lead, fill_skip.fill_byte);
+	return length - lead - ((trailing >= run) ? trailing : 0);
+}
+
+uint32_t SrecFile::update_data_crc(uint32_t crc, const uint64_t start, const uint8_t *data, const size_t length,
+                                   size_t &covered) const {
+	if (!fill_skip.enabled || fill_skip.crc == SrecFillCrc::IMAGE) {
+		covered = length;
+		return crc32_update(data, length, crc);
+	}
+	// The bytes of the records write_data() would write
+	covered = 0;
+	for (size_t offset = 0; offset < length;) {
+		const size_t slot = std::min(record_length_at(start + offset), length - offset);
+		size_t lead = 0;
+		const size_t count = trim_fill(start + offset, data + offset, slot, lead);
+		crc = crc32_update(data + offset + lead, count, crc);
+		covered += count;
+		offset += slot;
+	}
+	return crc;
+}
+
+size_t SrecFile::empty_line_length(const size_t address_bytes) const {
+	return 6 + (2 * address_bytes) + (record_layout.line_ending == LineEnding::CRLF ? 2 : 1);
+}
+
+size_t SrecFile::count_data_records(const uint64_t start, const uint64_t length) const {
+	if (length == 0 || max_payload == 0) {
+		return 0;
+	}
+	const uint64_t first = std::min<uint64_t>(record_length_at(start), length);
+	return static_cast<size_t>(1 + ((length - first + max_payload - 1) / max_payload));
+}
+
+uint64_t SrecFile::data_text_size(const uint64_t start, const uint64_t length) const {
+	const uint64_t records = count_data_records(start, length);
+	return (stride > 0) ? records * stride : (records * record_overhead) + (2 * length);
+}
+
+size_t SrecFile::finish_line(char *line, size_t length, const bool data) const {
+	const bool crlf = record_layout.line_ending == LineEnding::CRLF;
+	// Padding goes before the terminator, where readers trim it away
+	if (data && stride > 0) {
+		const size_t padded = stride - (crlf ? 2 : 1);
+		if (length < padded) {
+			std::memset(line + length, ' ', padded - length);
+			length = padded;
+		}
+	}
+	if (crlf) {
+		line[length++] = '\r';
+	}
+	line[length++] = '\n';
+	return length;
+}
+
+void SrecFile::write_line(const Srec::Type type, const size_t length) {
+	SrecStatsTimer timer(statistics, SrecStats::Phase::WRITE);
+	const bool data = type == Srec::Type::S1 || type == Srec::Type::S2 || type == Srec::Type::S3;
+	const size_t line_length = finish_line(line_buffer.data(), length, data);
+	output->write(line_buffer.data(), line_length);
+	output_offset += line_length;
+	if (flush_mode == FlushPolicy::PER_RECORD) {
+		output->flush();
+	}
+	if (SrecStats::ENABLED && statistics) {
+		statistics->count_record(type);
+		statistics->bytes_out += line_length;
 	}
 }
 
 // Write record data (S1/S2/S3) to file
 void SrecFile::write_record_payload(const std::vector<uint8_t> &buffer) {
-	if (!this->file.is_open()) {
+	write_record_payload(buffer.data(), buffer.size());
+}
+
+void SrecFile::write_record_payload(const uint8_t *data, const size_t length) {
+	if (!is_open()) {
 		throw SrecFileException("File is not open", this->filename);
 	}
 	
 	// Check security limits
-	if (record_count >= MAX_RECORD_COUNT) {
+	check_limits(1, std::max<uint64_t>(stride, record_overhead + (2 * static_cast<uint64_t>(length))));
+	
+	// Check if adding this buffer would cause address overflow
+	if (length > 0 && address > UINT32_MAX - length) {
+		throw SrecAddressException(static_cast<uint32_t>(address + length), UINT32_MAX);
+	}
+
+	if (!format_data) {
+		throw SrecValidationException("Invalid address size", SrecValidationException::ValidationError::INVALID_FORMAT);
+	}
+	// Write the record to the file, unless it is all skipped fill
+	size_t lead = 0;
+	const size_t count = trim_fill(address, data, length, lead);
+	if (count > 0 || length == 0) {
+		SrecStatsTimer timer(statistics, SrecStats::Phase::FORMAT);
+		const size_t line_length = format_data(address + static_cast<unsigned int>(lead), data + lead, count,
+		                                       line_buffer.data());
+		timer.stop();
+		write_line(data_record_type(), line_length);
+		this->record_count++;
+	}
+
+	// Update the address
+	this->address += static_cast<unsigned int>(length);
+}
+
+void SrecFile::check_limits(const uint64_t records, const uint64_t characters) const {
+	// Written this way round so that neither side can overflow
+	if (record_count > limit.max_records || records > limit.max_records - record_count) {
 		throw SrecValidationException(
 			"Maximum record count exceeded",
 			SrecValidationException::ValidationError::DATA_TOO_LARGE
 		);
 	}
-	
-	// Check if adding this buffer would cause address overflow
-	if (buffer.size() > 0 && address > UINT32_MAX - buffer.size()) {
-		throw SrecAddressException(address + buffer.size(), UINT32_MAX);
+	if (output_offset > limit.max_file_size || characters > limit.max_file_size - output_offset) {
+		throw SrecValidationException(
+			"Maximum file size exceeded",
+			SrecValidationException::ValidationError::DATA_TOO_LARGE
+		);
+	}
+}
+
+size_t SrecFile::check_data_limits(const uint64_t start, const size_t length, const size_t pending_records,
+                                   const uint64_t pending_bytes) const {
+	if (length == 0) {
+		return 0;
 	}
+	// Same limits write_record_payload() applies to each record
+	if (start > UINT32_MAX - length) {
+		throw SrecAddressException(static_cast<uint32_t>(start + length), UINT32_MAX);
+	}
+	const size_t records = count_data_records(start, length);
+	const uint64_t total_records = static_cast<uint64_t>(pending_records) + records;
+	const uint64_t characters = (stride > 0) ? total_records * stride
+	                                         : (total_records * record_overhead) + (2 * (pending_bytes + length));
+	check_limits(total_records, characters);
+	// Every record must start within the address field's range
+	const uint64_t first = std::min<uint64_t>(record_length_at(start), length);
+	const uint64_t last_record = (records == 1) ? start : start + first + ((records - 2) * max_payload);
+	if (last_record > max_address) {
+		throw SrecAddressException(static_cast<uint32_t>(last_record), max_address);
+	}
+	return records;
+}
 
-	// Create the record type based on the address size
-	std::unique_ptr<Srec> record_type;
+template <typename Codec>
+void SrecFile::write_data_records(const uint8_t *data, const size_t length) {
+	// Records are formatted into a local batch and handed to the sink together
+	constexpr size_t LINE_CAPACITY = MAX_RECORD_LINE_LENGTH + 2;
+	constexpr size_t BATCH_RECORDS = 32;
+	std::array<char, BATCH_RECORDS * LINE_CAPACITY> batch;
+	const size_t batch_records = (flush_mode == FlushPolicy::PER_RECORD) ? 1 : BATCH_RECORDS;
+
+	size_t used = 0;
+	size_t pending = 0;
+	size_t pending_bytes = 0;
+	auto commit = [&] {
+		SrecStatsTimer timer(statistics, SrecStats::Phase::WRITE);
+		output->write(batch.data(), used);
+		output_offset += used;
+		if (flush_mode == FlushPolicy::PER_RECORD) {
+			output->flush();
+		}
+		if (SrecStats::ENABLED && statistics) {
+			statistics->count_record(Codec::DATA_TYPE, pending);
+			statistics->bytes_out += used;
+		}
+		record_count += static_cast<unsigned int>(pending);
+		address += static_cast<unsigned int>(pending_bytes);
+		used = 0;
+		pending = 0;
+		pending_bytes = 0;
+	};
+
+	// check_data_limits() has been called, so formatting cannot fail
+	size_t offset = 0;
+	size_t pending_count = 0;
+	while (offset < length) {
+		SrecStatsTimer timer(statistics, SrecStats::Phase::FORMAT);
+		for (; offset < length && pending < batch_records; offset += pending_count) {
+			const unsigned int record_address = address + static_cast<unsigned int>(pending_bytes);
+			pending_count = std::min(record_length_at(record_address), length - offset);
+			pending_bytes += pending_count;
+			size_t lead = 0;
+			const size_t count = trim_fill(record_address, data + offset, pending_count, lead);
+			if (count == 0) {
+				continue;
+			}
+			char *line = batch.data() + used;
+			used += finish_line(line, Codec::format_data(record_address + static_cast<unsigned int>(lead),
+			                                             data + offset + lead, count, line), true);
+			++pending;
+		}
+		timer.stop();
+		commit();
+	}
+}
+
+void SrecFile::write_data(const uint8_t *data, const size_t length) {
+	if (!is_open()) {
+		throw SrecFileException("File is not open", this->filename);
+	}
+	if (!format_data) {
+		throw SrecValidationException("Invalid address size", SrecValidationException::ValidationError::INVALID_FORMAT);
+	}
+	check_data_limits(address, length, 0, 0);
+
+	with_record_codec(address_size_bits, [this, data, length](auto codec) {
+		write_data_records<decltype(codec)>(data, length);
+	});
+}
+
+size_t SrecFile::format_data_records(const uint64_t start, const uint8_t *data, const size_t length, char *out,
+                                     size_t &records) const {
+	return with_record_codec(address_size_bits, [&](auto codec) {
+		using Codec = decltype(codec);
+		size_t used = 0;
+		records = 0;
+		for (size_t offset = 0; offset < length;) {
+			const uint64_t record_address = start + offset;
+			const size_t slot = std::min(record_length_at(record_address), length - offset);
+			// Same check write_record_payload() applies per record
+			if (record_address + slot > UINT32_MAX) {
+				throw SrecAddressException(static_cast<uint32_t>(record_address + slot), UINT32_MAX);
+			}
+			size_t lead = 0;
+			const size_t count = trim_fill(record_address, data + offset, slot, lead);
+			offset += slot;
+			if (count == 0) {
+				continue;
+			}
+			char *line = out + used;
+			used += finish_line(line, Codec::format_data(static_cast<uint32_t>(record_address + lead),
+			                                             data + offset - slot + lead, count, line), true);
+			++records;
+		}
+		return used;
+	});
+}
+
+void SrecFile::write_segments(const SrecSegment *segments, const size_t count) {
+	if (!is_open()) {
+		throw SrecFileException("File is not open", this->filename);
+	}
+	if (!format_data) {
+		throw SrecValidationException("Invalid address size", SrecValidationException::ValidationError::INVALID_FORMAT);
+	}
+	size_t records = 0;
+	uint64_t bytes = 0;
+	for (size_t i = 0; i < count; ++i) {
+		records += check_data_limits(segments[i].address, segments[i].length, records, bytes);
+		bytes += segments[i].length;
+	}
+
+	with_record_codec(address_size_bits, [this, segments, count](auto codec) {
+		for (size_t i = 0; i < count; ++i) {
+			if (segments[i].length == 0) {
+				continue;
+			}
+			address = segments[i].address;
+			write_data_records<decltype(codec)>(segments[i].data, segments[i].length);
+		}
+	});
+}
+
+void SrecFile::write_formatted_records(const char *text, const size_t length, const size_t records,
+                                       const size_t data_bytes) {
+	if (!is_open()) {
+		throw SrecFileException("File is not open", this->filename);
+	}
+
+	// Same limits as writing the records one by one
+	check_limits(records, length);
+	if (data_bytes > 0 && address > UINT32_MAX - data_bytes) {
+		throw SrecAddressException(static_cast<uint32_t>(address + data_bytes), UINT32_MAX);
+	}
+
+	SrecStatsTimer timer(statistics, SrecStats::Phase::WRITE);
+	output->write(text, length);
+	output_offset += length;
+	if (flush_mode == FlushPolicy::PER_RECORD) {
+		output->flush();
+	}
+	if (SrecStats::ENABLED && statistics) {
+		statistics->count_record(data_record_type(), records);
+		statistics->bytes_out += length;
+	}
+
+	this->record_count += static_cast<unsigned int>(records);
+	this->address += static_cast<unsigned int>(data_bytes);
+}
+
+Srec::Type SrecFile::data_record_type() const {
+	// Select the record type based on the address size
 	switch (address_size_bits) {
 		case AddressSize::BITS16:
-			record_type = std::make_unique<Srec1>(address, buffer);
-			break;
+			return Srec::Type::S1;
 		case AddressSize::BITS24:
-			record_type = std::make_unique<Srec2>(address, buffer);
-			break;
+			return Srec::Type::S2;
 		case AddressSize::BITS32:
-			record_type = std::make_unique<Srec3>(address, buffer);
-			break;
+			return Srec::Type::S3;
 		default:
 			throw SrecValidationException("Invalid address size", SrecValidationException::ValidationError::INVALID_FORMAT);
 	}
-	// Write the record to the file
-	this->file << record_type->toString() << std::endl;
-	this->file.flush();
-
-	// Update the record count and address
-	this->record_count++;
-	this->address += buffer.size();
 }
 
 // Write record count (S5/S6) to file
 void SrecFile::write_record_count() {
-	if (!this->file.is_open()) {
+	if (!is_open()) {
 		throw SrecFileException("File is not open", this->filename);
 	}
 
@@ -250,303 +903,287 @@ void SrecFile::write_record_count() {
 		);
 	}
 
-	// Create the record type based on the record count
-	std::unique_ptr<Srec> record;
-	if (this->record_count <= 0xFFFF) {
-		record = std::make_unique<Srec5>(this->record_count);
-	} else {
-		record = std::make_unique<Srec6>(this->record_count);
-	}
+	// Select the record type based on the record count
+	const Srec::Type type = (this->record_count <= 0xFFFF) ? Srec::Type::S5 : Srec::Type::S6;
 
 	// Write the record to the file
-	this->file << record->toString() << std::endl;
-	this->file.flush();
+	write_line(type, format_record(type, this->record_count, nullptr, 0, line_buffer.data()));
 }
 
 // Write record termination (S7/S8/S9) to file
 void SrecFile::write_record_termination() {
-	if (!this->file.is_open()) {
+	if (!is_open()) {
 		throw SrecFileException("File is not open", this->filename);
 	}
-
-	std::unique_ptr<Srec> record;
-	switch (address_size_bits) {
-		case AddressSize::BITS16:
-			record = std::make_unique<Srec9>(exec_address);
-			break;
-		case AddressSize::BITS24:
-			record = std::make_unique<Srec8>(exec_address);
-			break;
-		case AddressSize::BITS32:
-			record = std::make_unique<Srec7>(exec_address);
-			break;
-		default:
-			throw SrecValidationException("Invalid address size", SrecValidationException::ValidationError::INVALID_FORMAT);
+	if (!format_termination) {
+		throw SrecValidationException("Invalid address size", SrecValidationException::ValidationError::INVALID_FORMAT);
 	}
+
 	// Write the record to the file
-	this->file << record->toString() << std::endl;
-	this->file.flush();
+	const Srec::Type type = with_record_codec(address_size_bits, [](auto codec) {
+		return decltype(codec)::TERMINATION_TYPE;
+	});
+	write_line(type, format_termination(exec_address, line_buffer.data()));
+}
+
+void SrecFile::reserve_checksum_header() {
+	if (!is_open()) {
+		throw SrecFileException("File is not open", this->filename);
+	}
+	if (!output->can_patch()) {
+		throw SrecFileException("Output does not support patching", this->filename);
+	}
+
+	const auto placeholder = crc_header_bytes(0);
+	checksum_slot = output_offset;
+	write_line(Srec::Type::S0, format_record(Srec::Type::S0, 0, placeholder.data(), placeholder.size(),
+	                                         line_buffer.data()));
+}
+
+void SrecFile::write_checksum_header(const uint32_t sum) {
+	if (!checksum_slot) {
+		throw SrecFileException("No checksum header reserved", this->filename);
+	}
+
+	// Same record type and payload size as the placeholder, so same width
+	const auto bytes = crc_header_bytes(sum);
+	const size_t length = format_record(Srec::Type::S0, 0, bytes.data(), bytes.size(), line_buffer.data());
+	output->patch(*checksum_slot, line_buffer.data(), length);
 }
 
 void SrecFile::write_header(const std::vector<std::string> &header_data) {
-	if (!this->file.is_open()) {
+	if (!is_open()) {
 		throw SrecFileException("File is not open", this->filename);
 	}
 
 	// Write the header data to the file
 	for (const std::string &line : header_data) {
 		std::string hexStr = ASCIIToHexString(line);
-		auto record = Srec0(hexStr);
-		this->file << record.toString() << std::endl;
-		this->file.flush();
+		write_line(Srec::Type::S0, format_record(Srec::Type::S0, 0, reinterpret_cast<const uint8_t *>(hexStr.data()),
+		                                         hexStr.size(), line_buffer.data()));
 	}
 }
 
 void SrecFile::write_header(const std::vector<uint8_t> &header_data) {
-	if (!this->file.is_open()) {
+	if (!is_open()) {
 		throw SrecFileException("File is not open", this->filename);
 	}
 
 	// Write the header data to the file
-	auto record = Srec0(header_data);
-	this->file << record.toString() << std::endl;
-	this->file.flush();
+	write_line(Srec::Type::S0, format_record(Srec::Type::S0, 0, header_data.data(), header_data.size(),
+	                                         line_buffer.data()));
 }
 
 // ============================================================================
 // Streaming API Implementation
 // ============================================================================
 
-uint8_t SrecStreamParser::hex_char_to_byte(char c) {
-	if (c >= '0' && c <= '9') {
-		return static_cast<uint8_t>(c - '0');
-	} else if (c >= 'A' && c <= 'F') {
-		return static_cast<uint8_t>(c - 'A' + 10);
-	} else if (c >= 'a' && c <= 'f') {
-		return static_cast<uint8_t>(c - 'a' + 10);
-	} else {
-		throw SrecParseException("Invalid hex character: " + std::string(1, c));
+namespace {
+
+// Record type by its digit; false for 'S4' and non-digits
+bool record_type_of(const char type_char, Srec::Type &type) {
+	switch (type_char) {
+		case '0': type = Srec::Type::S0; return true;
+		case '1': type = Srec::Type::S1; return true;
+		case '2': type = Srec::Type::S2; return true;
+		case '3': type = Srec::Type::S3; return true;
+		case '5': type = Srec::Type::S5; return true;
+		case '6': type = Srec::Type::S6; return true;
+		case '7': type = Srec::Type::S7; return true;
+		case '8': type = Srec::Type::S8; return true;
+		case '9': type = Srec::Type::S9; return true;
+		default: return false;
 	}
 }
 
-uint8_t SrecStreamParser::parse_hex_byte(const std::string &hex_str, size_t offset) {
-	if (offset + 1 >= hex_str.size()) {
-		throw SrecParseException("Incomplete hex byte at offset " + std::to_string(offset));
+SrecParseResult parse_failure(const SrecParseError error, const size_t line_number, const size_t column = 0,
+                              const size_t expected = 0, const size_t actual = 0) {
+	return SrecParseResult{error, line_number, column, expected, actual};
+}
+
+// Failure for the first non-hex character in [begin, line end). The hex
+// kernel skips the chunks before it, so locating it costs about one more
+// decode of the line.
+SrecParseResult hex_failure(const std::string_view line, size_t begin, const size_t line_number) {
+	constexpr size_t CHUNK = 32; // bytes decoded per step
+	std::array<uint8_t, CHUNK> scratch;
+	uint32_t sum = 0;
+	while (line.length() - begin > 2 * CHUNK && hex_decode(line.data() + begin, CHUNK, scratch.data(), sum)) {
+		begin += 2 * CHUNK;
 	}
-	uint8_t high = hex_char_to_byte(hex_str[offset]);
-	uint8_t low = hex_char_to_byte(hex_str[offset + 1]);
-	return static_cast<uint8_t>((high << 4) | low);
+	for (size_t i = begin; i < line.length(); ++i) {
+		const char lower = static_cast<char>(line[i] | 0x20);
+		if (!((line[i] >= '0' && line[i] <= '9') || (lower >= 'a' && lower <= 'f'))) {
+			return parse_failure(SrecParseError::INVALID_HEX, line_number, i + 1, 0, static_cast<unsigned char>(line[i]));
+		}
+	}
+	return parse_failure(SrecParseError::INVALID_HEX, line_number);
 }
 
-Srec::Type SrecStreamParser::char_to_type(char type_char) {
-	switch (type_char) {
-		case '0': return Srec::Type::S0;
-		case '1': return Srec::Type::S1;
-		case '2': return Srec::Type::S2;
-		case '3': return Srec::Type::S3;
-		case '5': return Srec::Type::S5;
-		case '6': return Srec::Type::S6;
-		case '7': return Srec::Type::S7;
-		case '8': return Srec::Type::S8;
-		case '9': return Srec::Type::S9;
+} // namespace
+
+const char *parse_error_message(const SrecParseError error) {
+	switch (error) {
+		case SrecParseError::NONE: return "No error";
+		case SrecParseError::NOT_A_RECORD: return "Invalid S-record format";
+		case SrecParseError::TOO_SHORT: return "S-record too short";
+		case SrecParseError::INVALID_TYPE: return "Invalid S-record type";
+		case SrecParseError::INVALID_HEX: return "Invalid hex character";
+		case SrecParseError::LENGTH_MISMATCH: return "S-record length mismatch";
+		case SrecParseError::COUNT_TOO_SMALL: return "S-record byte count too small for record type";
+		case SrecParseError::CHECKSUM_MISMATCH: return "Checksum validation failed";
+		default: return "Unknown parse error";
+	}
+}
+
+void SrecParseResult::throw_exception() const {
+	std::ostringstream oss;
+	oss << parse_error_message(error);
+	switch (error) {
+		case SrecParseError::INVALID_TYPE:
+		case SrecParseError::INVALID_HEX:
+			if (actual != 0) {
+				oss << ": " << static_cast<char>(actual);
+			}
+			break;
+		case SrecParseError::LENGTH_MISMATCH:
+			oss << ": expected " << expected << ", got " << actual << " (byte_count=" << ((expected - 4) / 2) << ")";
+			break;
+		case SrecParseError::CHECKSUM_MISMATCH:
+			oss << " on line " << line << ": expected 0x" << std::hex << std::uppercase << std::setfill('0')
+			    << std::setw(2) << expected << ", got 0x" << std::setw(2) << actual;
+			throw SrecValidationException(oss.str(), SrecValidationException::ValidationError::CHECKSUM_MISMATCH);
+		case SrecParseError::NONE:
+		case SrecParseError::NOT_A_RECORD:
+		case SrecParseError::TOO_SHORT:
+		case SrecParseError::COUNT_TOO_SMALL:
 		default:
-			throw SrecParseException("Invalid S-record type: " + std::string(1, type_char));
+			break;
 	}
+	throw SrecParseException(oss.str(), line, column);
 }
 
 SrecStreamParser::ParsedRecord SrecStreamParser::parse_line(const std::string &line, 
                                                            size_t line_number,
                                                            bool validate_checksum) {
-	ParsedRecord record{};
+	std::array<uint8_t, MAX_RECORD_DATA_SIZE> payload;
+	ParsedRecordView view{};
+	parse_line(std::string_view(line), line_number, validate_checksum, payload.data(), view);
+	return view.to_record();
+}
+
+void SrecStreamParser::parse_line(std::string_view line,
+                                  size_t line_number,
+                                  bool validate_checksum,
+                                  uint8_t *payload,
+                                  ParsedRecordView &record) {
+	const SrecParseResult result = try_parse_line(line, line_number, validate_checksum, payload, record);
+	if (!result.ok()) {
+		result.throw_exception();
+	}
+}
+
+SrecParseResult SrecStreamParser::try_parse_line(std::string_view line,
+                                                 size_t line_number,
+                                                 bool validate_checksum,
+                                                 uint8_t *payload,
+                                                 ParsedRecordView &record) noexcept {
 	record.line_number = line_number;
 	record.checksum_valid = false;
+	record.data = payload;
+	record.length = 0;
 
-	// Skip empty lines and comments
 	if (line.empty() || line[0] != 'S') {
-		throw SrecParseException("Invalid S-record format", line_number);
+		return parse_failure(SrecParseError::NOT_A_RECORD, line_number);
 	}
 
 	// Minimum length: S + type + count (2 chars) + checksum (2 chars) = 6 chars
 	if (line.length() < 6) {
-		throw SrecParseException("S-record too short", line_number);
+		return parse_failure(SrecParseError::TOO_SHORT, line_number);
 	}
 
-	try {
-		// Parse type
-		record.type = char_to_type(line[1]);
+	if (!record_type_of(line[1], record.type)) {
+		return parse_failure(SrecParseError::INVALID_TYPE, line_number, 2, 0, static_cast<unsigned char>(line[1]));
+	}
 
-		// Parse byte count
-		uint8_t byte_count = parse_hex_byte(line, 2);
-		
-		// Validate record length
-		// Total length = 'S' + type + count (2 chars) + (byte_count * 2 chars per byte)
-		size_t expected_length = 4 + (byte_count * 2);
-		if (line.length() != expected_length) {
-			std::ostringstream oss;
-			oss << "S-record length mismatch: expected " << expected_length 
-			    << ", got " << line.length() 
-			    << " (byte_count=" << static_cast<unsigned int>(byte_count) << ")"
-			    << " at line " << line_number;
-			throw SrecParseException(oss.str(), line_number);
-		}
+	uint8_t byte_count = 0;
+	uint32_t sum = 0;
+	if (!hex_decode(line.data() + 2, 1, &byte_count, sum)) {
+		return hex_failure(line.substr(0, 4), 2, line_number);
+	}
 
-		// Parse address based on record type
-		size_t address_bytes = 0;
-		size_t data_start_offset = 4;
-		
-		switch (record.type) {
-			case Srec::Type::S0:
-				address_bytes = 2;
-				record.address = (parse_hex_byte(line, 4) << 8) | parse_hex_byte(line, 6);
-				data_start_offset = 8;
-				break;
-			case Srec::Type::S1:
-			case Srec::Type::S9:
-				address_bytes = 2;
-				record.address = (parse_hex_byte(line, 4) << 8) | parse_hex_byte(line, 6);
-				data_start_offset = 8;
-				break;
-			case Srec::Type::S2:
-			case Srec::Type::S8:
-				address_bytes = 3;
-				record.address = (parse_hex_byte(line, 4) << 16) | 
-				                (parse_hex_byte(line, 6) << 8) | 
-				                parse_hex_byte(line, 8);
-				data_start_offset = 10;
-				break;
-			case Srec::Type::S3:
-			case Srec::Type::S7:
-				address_bytes = 4;
-				record.address = (parse_hex_byte(line, 4) << 24) | 
-				                (parse_hex_byte(line, 6) << 16) |
-				                (parse_hex_byte(line, 8) << 8) | 
-				                parse_hex_byte(line, 10);
-				data_start_offset = 12;
-				break;
-			case Srec::Type::S5:
-				address_bytes = 2;
-				record.address = (parse_hex_byte(line, 4) << 8) | parse_hex_byte(line, 6);
-				data_start_offset = 8;
-				break;
-			case Srec::Type::S6:
-				address_bytes = 3;
-				record.address = (parse_hex_byte(line, 4) << 16) | 
-				                (parse_hex_byte(line, 6) << 8) | 
-				                parse_hex_byte(line, 8);
-				data_start_offset = 10;
-				break;
-		}
+	// Total length = 'S' + type + count (2 chars) + (byte_count * 2 chars per byte)
+	const size_t expected_length = 4 + (static_cast<size_t>(byte_count) * 2);
+	if (line.length() != expected_length) {
+		return parse_failure(SrecParseError::LENGTH_MISMATCH, line_number, 0, expected_length, line.length());
+	}
 
-		// Parse data bytes
-		size_t data_bytes = byte_count - address_bytes - 1; // -1 for checksum
-		record.data.reserve(data_bytes);
-		
-		for (size_t i = 0; i < data_bytes; ++i) {
-			uint8_t byte_val = parse_hex_byte(line, data_start_offset + (i * 2));
-			record.data.push_back(byte_val);
-		}
+	const size_t address_bytes = record_address_size(record.type);
+	if (byte_count < address_bytes + 1) {
+		return parse_failure(SrecParseError::COUNT_TOO_SMALL, line_number, 3);
+	}
 
-		// Parse checksum
-		size_t checksum_offset = data_start_offset + (data_bytes * 2);
-		record.checksum = parse_hex_byte(line, checksum_offset);
-
-		// Validate checksum if requested
-		if (validate_checksum) {
-			uint32_t sum = byte_count;
-			
-			// Add address bytes to sum
-			for (size_t i = 0; i < address_bytes; ++i) {
-				sum += parse_hex_byte(line, 4 + (i * 2));
-			}
-			
-			// Add data bytes to sum
-			for (uint8_t data_byte : record.data) {
-				sum += data_byte;
-			}
-			
-			uint8_t calculated_checksum = static_cast<uint8_t>(~sum & 0xFF);
-			record.checksum_valid = (calculated_checksum == record.checksum);
-			
-			if (!record.checksum_valid) {
-				std::ostringstream oss;
-				oss << "Checksum validation failed on line " << line_number
-				    << ": expected 0x" << std::hex << std::uppercase << std::setfill('0') << std::setw(2) 
-				    << static_cast<unsigned int>(calculated_checksum)
-				    << ", got 0x" << std::setw(2) << static_cast<unsigned int>(record.checksum);
-				throw SrecValidationException(
-					oss.str(),
-					SrecValidationException::ValidationError::CHECKSUM_MISMATCH
-				);
-			}
-		} else {
-			record.checksum_valid = true; // Assume valid when not validating
-		}
+	// Decode address, data and checksum in a single pass
+	std::array<uint8_t, 255> bytes;
+	sum = 0;
+	if (!hex_decode(line.data() + 4, byte_count, bytes.data(), sum)) {
+		return hex_failure(line, 4, line_number);
+	}
 
-	} catch (const SrecException &) {
-		throw; // Re-throw our exceptions
-	} catch (const std::exception &e) {
-		throw SrecParseException("Parse error on line " + std::to_string(line_number) + 
-		                        ": " + std::string(e.what()), line_number);
+	record.address = 0;
+	for (size_t i = 0; i < address_bytes; ++i) {
+		record.address = (record.address << 8) | bytes[i];
 	}
 
-	return record;
+	record.length = byte_count - address_bytes - 1; // -1 for checksum
+	std::memcpy(payload, bytes.data() + address_bytes, record.length);
+	record.checksum = bytes[byte_count - 1u];
+
+	if (validate_checksum) {
+		// The decoded sum covers address, data and the checksum byte itself
+		const uint32_t record_sum = byte_count + sum - record.checksum;
+		const auto calculated_checksum = static_cast<uint8_t>(~record_sum & 0xFF);
+		record.checksum_valid = (calculated_checksum == record.checksum);
+		if (!record.checksum_valid) {
+			return parse_failure(SrecParseError::CHECKSUM_MISMATCH, line_number, line.length() - 1,
+			                     calculated_checksum, record.checksum);
+		}
+	} else {
+		record.checksum_valid = true; // Assume valid when not validating
+	}
+	return SrecParseResult{SrecParseError::NONE, line_number, 0, 0, 0};
 }
 
 void SrecStreamParser::parse_stream(std::istream &input_stream, 
                                    RecordCallback callback,
-                                   bool validate_checksums) {
-	std::string line;
-	size_t line_number = 0;
-	
-	while (std::getline(input_stream, line)) {
-		++line_number;
-		
-		// Skip empty lines
-		if (line.empty() || line.find_first_not_of(" \t\r\n") == std::string::npos) {
-			continue;
-		}
-		
-		// Remove trailing whitespace
-		line.erase(line.find_last_not_of(" \t\r\n") + 1);
-		
-		try {
-			ParsedRecord record = parse_line(line, line_number, validate_checksums);
-			
-			// Call user callback
-			if (!callback(record)) {
-				break; // User requested to stop parsing
-			}
-		} catch (const SrecParseException &e) {
-			// Re-throw with line context if not already included
-			if (e.getLineNumber() == 0) {
-				throw SrecParseException(e.what(), line_number);
-			} else {
-				throw;
-			}
+                                   bool validate_checksums,
+                                   const SrecLimits &limits,
+                                   SrecStats *stats) {
+	SrecReader reader(input_stream, validate_checksums, SrecReader::DEFAULT_BLOCK_SIZE, limits);
+	reader.set_stats(stats);
+	ParsedRecordView view{};
+	ParsedRecord record{}; // reused, so records do not allocate once warmed up
+	while (reader.next(view)) {
+		view.copy_to(record);
+		if (!callback(record)) {
+			break; // User requested to stop parsing
 		}
 	}
-	
-	if (input_stream.bad()) {
-		throw SrecFileException("Stream read error", "");
-	}
 }
 
 void SrecStreamParser::parse_file(const std::string &filename,
                                  RecordCallback callback,
-                                 bool validate_checksums) {
-	std::ifstream file(filename);
-	if (!file.is_open()) {
-		throw SrecFileException("Failed to open file", filename);
+                                 bool validate_checksums,
+                                 const SrecLimits &limits,
+                                 SrecStats *stats) {
+	if (detect_compression(filename) != SrecCompression::NONE) {
+		SrecDecompressStream input(filename);
+		parse_stream(input, std::move(callback), validate_checksums, limits, stats);
+		return;
 	}
-	
-	try {
-		parse_stream(file, callback, validate_checksums);
-	} catch (const SrecException &) {
-		file.close();
-		throw;
-	}
-	
-	file.close();
+	SrecMappedReader reader(filename, validate_checksums, limits);
+	reader.set_stats(stats);
+	reader.parse(callback);
 }
 
 void SrecStreamConverter::convert_stream(std::istream &input,
@@ -555,12 +1192,19 @@ void SrecStreamConverter::convert_stream(std::istream &input,
                                         uint32_t start_address,
                                         bool want_checksum,
                                         ProgressCallback progress_callback,
-                                        size_t buffer_size) {
+                                        size_t buffer_size,
+                                        const SrecLimits &limits,
+                                        SrecStats *stats,
+                                        const SrecLayout &layout,
+                                        const SrecFillSkip &skip) {
 	// Create output file
-	SrecFile sfile(output_filename, address_size, start_address);
+	SrecFile sfile(output_filename, address_size, start_address, FlushPolicy::ON_CLOSE, limits);
 	if (!sfile.is_open()) {
 		throw SrecFileException("Failed to create output file", output_filename);
 	}
+	sfile.set_layout(layout);
+	sfile.set_skip_fill(skip);
+	sfile.set_stats(stats);
 
 	// Get input stream size if possible
 	size_t total_bytes = 0;
@@ -570,39 +1214,49 @@ void SrecStreamConverter::convert_stream(std::istream &input,
 		input.seekg(0, std::ios::beg);
 	}
 
-	// Calculate optimal record size
-	size_t max_record_size = sfile.max_data_bytes_per_record();
-	size_t chunk_size = std::min(buffer_size, max_record_size);
-	
+	// One record per read: buffer_size bytes, capped by the layout's record length
+	const size_t chunk_size = std::max<size_t>(std::min<size_t>(buffer_size, sfile.max_data_bytes_per_record()), 1);
 	std::vector<uint8_t> buffer(chunk_size);
 	size_t bytes_processed = 0;
 	uint32_t crc_sum = 0;
+	if (SrecStats::ENABLED && stats) {
+		stats->note_buffer(buffer.size());
+	}
+
+	const ChecksumHeader header = want_checksum ? begin_checksum_header(input, sfile, chunk_size) : ChecksumHeader::NONE;
+
+	auto read_chunk = [&] {
+		SrecStatsTimer timer(stats, SrecStats::Phase::READ);
+		const size_t record = std::min(buffer.size(), sfile.next_record_length());
+		return input.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(record)) ||
+		       input.gcount() > 0;
+	};
 	
 	// Process input in chunks
-	while (input.read(reinterpret_cast<char*>(buffer.data()), 
-	                 static_cast<std::streamsize>(buffer.size())) || input.gcount() > 0) {
-		                 
+	while (read_chunk()) {
 		size_t bytes_read = static_cast<size_t>(input.gcount());
-		buffer.resize(bytes_read);
-		
-		// Write data record
-		sfile.write_record_payload(buffer);
 		
-		// Update CRC if needed
+		// Update CRC if needed, for the record's address before it is written
 		if (want_checksum) {
-			crc_sum = xcrc32(buffer.data(), buffer.size(), crc_sum);
+			SrecStatsTimer timer(stats, SrecStats::Phase::CHECKSUM);
+			size_t covered = 0;
+			crc_sum = sfile.update_data_crc(crc_sum, sfile.next_address(), buffer.data(), bytes_read, covered);
 		}
+
+		// Write data record
+		sfile.write_record_payload(buffer.data(), bytes_read);
 		
 		bytes_processed += bytes_read;
+		if (SrecStats::ENABLED && stats) {
+			stats->bytes_in += bytes_read;
+		}
 		
 		// Call progress callback if provided
 		if (progress_callback && !progress_callback(bytes_processed, total_bytes)) {
 			throw SrecValidationException("Conversion aborted by user", 
 			                             SrecValidationException::ValidationError::USER_CANCELLED);
 		}
-		
-		// Reset buffer size for next iteration
-		buffer.resize(chunk_size);
+
 	}
 	
 	// Check for read errors
@@ -613,12 +1267,123 @@ void SrecStreamConverter::convert_stream(std::istream &input,
 	// Write record count and termination
 	sfile.write_record_count();
 	sfile.write_record_termination();
+	if (header == ChecksumHeader::RESERVED) {
+		sfile.write_checksum_header(crc_sum);
+	}
 	sfile.close();
 	
 	// Add checksum header if requested
-	if (want_checksum) {
+	if (header == ChecksumHeader::DEFERRED) {
 		write_checksum(sfile, crc_sum);
 	}
 }
 
+void SrecStreamConverter::convert_stream_async(std::istream &input,
+                                              const std::string &output_filename,
+                                              SrecFile::AddressSize address_size,
+                                              uint32_t start_address,
+                                              bool want_checksum,
+                                              ProgressCallback progress_callback,
+                                              size_t buffer_size,
+                                              size_t buffer_count,
+                                              const SrecLimits &limits,
+                                              SrecStats *stats,
+                                              const SrecLayout &layout,
+                                              const SrecFillSkip &skip) {
+	// Create output file, written by a background thread
+	auto sink = std::make_unique<SrecAsyncSink>(std::make_unique<SrecFileSink>(output_filename));
+	if (!sink->is_open()) {
+		throw SrecFileException("Failed to create output file", output_filename);
+	}
+	SrecFile sfile(std::move(sink), address_size, start_address, FlushPolicy::ON_CLOSE, limits);
+	sfile.set_layout(layout);
+	sfile.set_skip_fill(skip);
+	sfile.set_stats(stats);
+
+	// Get input stream size if possible
+	size_t total_bytes = 0;
+	if (input.tellg() != -1) {
+		input.seekg(0, std::ios::end);
+		total_bytes = static_cast<size_t>(input.tellg());
+		input.seekg(0, std::ios::beg);
+	}
+
+	// Records are sized as in convert_stream()
+	const size_t chunk_size = std::max<size_t>(std::min<size_t>(buffer_size, sfile.max_data_bytes_per_record()), 1);
+	const size_t block_size = std::max(chunk_size, buffer_size / chunk_size * chunk_size);
+	size_t bytes_processed = 0;
+	uint32_t crc_sum = 0;
+
+	// The async sink can patch, so the header is always reserved here
+	const ChecksumHeader header = want_checksum ? begin_checksum_header(input, sfile, chunk_size) : ChecksumHeader::NONE;
+
+	{
+		const size_t blocks = std::max<size_t>(buffer_count, 2);
+		AsyncBlockReader reader(input, block_size, blocks);
+		if (SrecStats::ENABLED && stats) {
+			stats->note_buffer((block_size * blocks) + (2 * SrecAsyncSink::DEFAULT_BUFFER_SIZE));
+		}
+		const uint8_t *block = nullptr;
+		size_t block_length = 0;
+		auto next_block = [&] {
+			SrecStatsTimer timer(stats, SrecStats::Phase::READ);
+			return reader.next(block, block_length);
+		};
+		auto write_record = [&](const uint8_t *data, const size_t length) {
+			if (want_checksum) {
+				SrecStatsTimer timer(stats, SrecStats::Phase::CHECKSUM);
+				size_t covered = 0;
+				crc_sum = sfile.update_data_crc(crc_sum, sfile.next_address(), data, length, covered);
+			}
+			sfile.write_record_payload(data, length);
+			bytes_processed += length;
+			if (SrecStats::ENABLED && stats) {
+				stats->bytes_in += length;
+			}
+
+			// Call progress callback if provided
+			if (progress_callback && !progress_callback(bytes_processed, total_bytes)) {
+				throw SrecValidationException("Conversion aborted by user",
+				                             SrecValidationException::ValidationError::USER_CANCELLED);
+			}
+		};
+
+		// A record cut by the end of a block is completed from the next one,
+		// so the records are those of convert_stream() whatever the layout
+		std::vector<uint8_t> carry;
+		carry.reserve(chunk_size);
+		while (next_block()) {
+			size_t offset = 0;
+			while (offset < block_length) {
+				const size_t record = std::min(chunk_size, sfile.next_record_length());
+				const size_t take = std::min(record - carry.size(), block_length - offset);
+				if (carry.empty() && take == record) {
+					write_record(block + offset, record);
+				} else {
+					carry.insert(carry.end(), block + offset, block + offset + take);
+					if (carry.size() == record) {
+						write_record(carry.data(), carry.size());
+						carry.clear();
+					}
+				}
+				offset += take;
+			}
+		}
+		if (!carry.empty()) {
+			write_record(carry.data(), carry.size());
+		}
+		if (reader.failed()) {
+			throw SrecFileException("Input stream read error", "");
+		}
+	}
+
+	// Write record count and termination
+	sfile.write_record_count();
+	sfile.write_record_termination();
+	if (header == ChecksumHeader::RESERVED) {
+		sfile.write_checksum_header(crc_sum);
+	}
+	sfile.close();
+}
+
 } // namespace tierone::srec
@@ -18,6 +18,7 @@
 
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iomanip>
 #include <vector>
@@ -25,8 +26,13 @@
 #include <cstddef>
 #include <limits>
 #include <functional>
+#include <array>
+#include <memory>
+#include <optional>
 
 #include "srec_exceptions.h"
+#include "srec_sink.h"
+#include "srec_stats.h"
 
 namespace tierone::srec {
 
@@ -41,6 +47,8 @@ std::string ASCIIToHexString(const std::string &buffer);
 
 
 
+struct SrecView;
+
 /**
  * @brief Base class for all Motorola S-record types
  * 
@@ -83,6 +91,11 @@ public:
 	explicit Srec(Type record_type) : type(record_type) {};
 	virtual ~Srec() = default;
 
+	Srec(const Srec &) = default;
+	Srec(Srec &&) noexcept = default;
+	Srec &operator=(const Srec &) = default;
+	Srec &operator=(Srec &&) noexcept = default;
+
 	/**
 	 * @brief Get the character representation of the S-record type
 	 * @return Character '0'-'9' corresponding to the S-record type
@@ -144,6 +157,13 @@ public:
 	 */
 	virtual std::vector<uint8_t> getRecordData() = 0;
 
+	/**
+	 * @brief Get a non-owning view of the record
+	 * @return View referring to this record's payload; valid while the
+	 *         record is alive and unmodified
+	 */
+	virtual SrecView view() const = 0;
+
 	/**
 	 * @brief Convert the S-record to its string representation
 	 * 
@@ -155,36 +175,108 @@ public:
 	 * @return Formatted S-record string (uppercase hexadecimal)
 	 * @throws SrecValidationException if record data exceeds 254 bytes
 	 */
-	virtual std::string toString() {
-		std::vector<uint8_t> data = getRecordData();
-
-		if (data.size() > 254) { // 255 - 1 for checksum
-			throw SrecValidationException(
-				"Record data size exceeds maximum of 254 bytes",
-				SrecValidationException::ValidationError::DATA_TOO_LARGE
-			);
-		}
-
-		// Pre-allocate string buffer for better performance
-		// Format: S + type + 2-digit count + data bytes (2 chars each) + 2-digit checksum
-		const size_t estimated_size = 1 + 1 + 2 + (data.size() * 2) + 2;
-		std::string result;
-		result.reserve(estimated_size);
-		
-		std::stringstream ss;
-		ss << 'S' << getTypeChar()
-		   << std::setfill('0') << std::setw(2) << std::uppercase << std::hex << static_cast<unsigned int>(data.size() + 1/*data + checksum*/);
-		for (const auto byte : data) {
-			ss << std::setfill('0') << std::setw(2) << std::uppercase << std::hex << static_cast<unsigned int>(byte);
-		}
-		ss << std::setfill('0') << std::setw(2) << std::uppercase << std::hex << static_cast<unsigned int>(checksum(data));
-		return ss.str();
-	}
+	virtual std::string toString();
 
 private:
 	Type type;
 };
 
+/**
+ * @brief Non-owning S-record: type, address and a pointer to the payload
+ *
+ * Formats, checksums and compares records without owning or copying their
+ * payload. The referenced bytes must outlive the view.
+ */
+struct SrecView {
+	Srec::Type type{Srec::Type::S0}; ///< Record type (S0-S9)
+	uint32_t address{0};             ///< Address, count (S5/S6) or 0 (S0)
+	const uint8_t *data{nullptr};    ///< Payload bytes (excluding address)
+	size_t length{0};                ///< Number of payload bytes
+
+	/**
+	 * @brief Format the record into a caller supplied buffer
+	 * @param out Destination buffer, at least MAX_RECORD_LINE_LENGTH chars
+	 * @return Number of characters written (no line terminator)
+	 * @throws SrecValidationException if the record would exceed 255 bytes
+	 * @throws SrecAddressException if the address does not fit the address field
+	 * @see format_record()
+	 */
+	size_t format(char *out) const;
+
+	/**
+	 * @brief Format the record as a string
+	 * @return Formatted S-record string (uppercase hexadecimal)
+	 * @throws SrecValidationException if the record would exceed 255 bytes
+	 * @throws SrecAddressException if the address does not fit the address field
+	 */
+	std::string to_string() const;
+
+	/**
+	 * @brief Compute the record checksum
+	 * @return One's complement of the sum of count, address and payload bytes
+	 */
+	uint8_t checksum() const;
+
+	/**
+	 * @brief Compare type, address and payload bytes
+	 * @param other Record to compare with
+	 * @return true if both describe the same record
+	 */
+	bool operator==(const SrecView &other) const;
+
+	bool operator!=(const SrecView &other) const {
+		return !(*this == other);
+	}
+};
+
+/**
+ * @brief Maximum length of a formatted S-record line, excluding the line terminator
+ *
+ * 'S' + type + count (2 chars) + 255 bytes of address/data/checksum (2 chars each)
+ */
+constexpr size_t MAX_RECORD_LINE_LENGTH = 4 + (255 * 2);
+
+/**
+ * @brief Get the number of address bytes used by a record type
+ * @param type S-record type
+ * @return Address field width in bytes (2, 3 or 4)
+ */
+constexpr size_t record_address_size(Srec::Type type) {
+	switch (type) {
+		case Srec::Type::S2:
+		case Srec::Type::S6:
+		case Srec::Type::S8:
+			return 3;
+		case Srec::Type::S3:
+		case Srec::Type::S7:
+			return 4;
+		case Srec::Type::S0:
+		case Srec::Type::S1:
+		case Srec::Type::S5:
+		case Srec::Type::S9:
+		default:
+			return 2;
+	}
+}
+
+/**
+ * @brief Format an S-record directly into a caller supplied buffer
+ *
+ * Writes S<type><count><address><data><checksum> using a byte to hex-pair
+ * lookup table and computes the checksum in the same pass. No heap memory
+ * is allocated and no line terminator is appended.
+ *
+ * @param type Record type; selects the address field width
+ * @param address Address (S1-S3, S7-S9), count (S5/S6) or 0 (S0)
+ * @param data Payload bytes (may be nullptr if length is 0)
+ * @param length Number of payload bytes
+ * @param out Destination buffer, at least MAX_RECORD_LINE_LENGTH chars
+ * @return Number of characters written
+ * @throws SrecValidationException if the record would exceed 255 bytes
+ * @throws SrecAddressException if the address does not fit the address field
+ */
+size_t format_record(Srec::Type type, uint32_t address, const uint8_t *data, size_t length, char *out);
+
 /**
  * @brief S0 Header Record
  * 
@@ -200,18 +292,22 @@ public:
 	static constexpr size_t ADDRESS_SIZE = 2; //in bytes
 
 	explicit Srec0(const std::vector<uint8_t> &header_data) : Srec(Srec::Type::S0), header(header_data) {};
-	explicit Srec0(const std::string &header_data) : Srec(Srec::Type::S0) {
-		for (const auto c : header_data) {
-			this->header.push_back(static_cast<uint8_t>(c));
-		}
-	};
-	Srec0(const char *header_data, const size_t length) : Srec(Srec::Type::S0) {
-		for (size_t i = 0; i < length; ++i) {
-			this->header.push_back(static_cast<uint8_t>(header_data[i]));
-		}
-	};
+	explicit Srec0(std::vector<uint8_t> &&header_data) : Srec(Srec::Type::S0), header(std::move(header_data)) {};
+	explicit Srec0(const std::string &header_data)
+		: Srec(Srec::Type::S0), header(header_data.begin(), header_data.end()) {};
+	Srec0(const char *header_data, const size_t length)
+		: Srec(Srec::Type::S0), header(header_data, header_data + length) {};
 	~Srec0() final = default;
 
+	Srec0(const Srec0 &) = default;
+	Srec0(Srec0 &&) noexcept = default;
+	Srec0 &operator=(const Srec0 &) = default;
+	Srec0 &operator=(Srec0 &&) noexcept = default;
+
+	SrecView view() const override {
+		return SrecView{getType(), 0, header.data(), header.size()};
+	}
+
 	std::vector<uint8_t> getRecordData() override {
 		// prepend 2 zero bytes to the header
 		// this is the address field
@@ -238,37 +334,49 @@ class Srec1 final : public Srec {
 public:
 	static constexpr size_t ADDRESS_SIZE = 2; //in bytes
 
-	Srec1(unsigned int addr, const std::vector<uint8_t> &record_data) : Srec(Srec::Type::S1), address(addr), data(record_data) {
+	Srec1(unsigned int addr, const std::vector<uint8_t> &record_data)
+		: Srec(Srec::Type::S1), address(addr), data(record_data) {
 		if (addr > 0xFFFF) {
 			throw SrecAddressException(addr, 0xFFFF);
 		}
 	};
-	Srec1(unsigned int addr, const std::string &record_data) : Srec(Srec::Type::S1), address(addr) {
+	Srec1(unsigned int addr, std::vector<uint8_t> &&record_data)
+		: Srec(Srec::Type::S1), address(addr), data(std::move(record_data)) {
 		if (addr > 0xFFFF) {
 			throw SrecAddressException(addr, 0xFFFF);
 		}
-		for (const auto c : record_data) {
-			this->data.push_back(static_cast<uint8_t>(c));
-		}
 	};
-	Srec1(unsigned int addr, const unsigned char *record_data, const size_t length) : Srec(Srec::Type::S1), address(addr) {
+	Srec1(unsigned int addr, const std::string &record_data)
+		: Srec(Srec::Type::S1), address(addr), data(record_data.begin(), record_data.end()) {
 		if (addr > 0xFFFF) {
 			throw SrecAddressException(addr, 0xFFFF);
 		}
-		for (size_t i = 0; i < length; ++i) {
-			this->data.push_back(record_data[i]);
+	};
+	Srec1(unsigned int addr, const unsigned char *record_data, const size_t length)
+		: Srec(Srec::Type::S1), address(addr), data(record_data, record_data + length) {
+		if (addr > 0xFFFF) {
+			throw SrecAddressException(addr, 0xFFFF);
 		}
 	};
 	~Srec1() final = default;
 
+	Srec1(const Srec1 &) = default;
+	Srec1(Srec1 &&) noexcept = default;
+	Srec1 &operator=(const Srec1 &) = default;
+	Srec1 &operator=(Srec1 &&) noexcept = default;
+
 	/**
 	 * @brief Get the data payload
-	 * @return Copy of the data bytes (excluding address)
+	 * @return The data bytes (excluding address)
 	 */
-	std::vector<uint8_t> getData() const {
+	const std::vector<uint8_t> &getData() const {
 		return data;
 	}
 
+	SrecView view() const override {
+		return SrecView{getType(), address, data.data(), data.size()};
+	}
+
 	std::vector<uint8_t> getRecordData() override {
 		std::vector<uint8_t> record;
 		record.push_back(static_cast<uint8_t>((address >> 8) & 0xFF));
@@ -292,37 +400,49 @@ class Srec2 final : public Srec {
 public:
 	static constexpr size_t ADDRESS_SIZE = 3; //in bytes
 
-	Srec2(unsigned int addr, const std::vector<uint8_t> &record_data) : Srec(Srec::Type::S2), address(addr), data(record_data) {
+	Srec2(unsigned int addr, const std::vector<uint8_t> &record_data)
+		: Srec(Srec::Type::S2), address(addr), data(record_data) {
 		if (addr > 0xFFFFFF) {
 			throw SrecAddressException(addr, 0xFFFFFF);
 		}
 	};
-	Srec2(unsigned int addr, const std::string &record_data) : Srec(Srec::Type::S2), address(addr) {
+	Srec2(unsigned int addr, std::vector<uint8_t> &&record_data)
+		: Srec(Srec::Type::S2), address(addr), data(std::move(record_data)) {
 		if (addr > 0xFFFFFF) {
 			throw SrecAddressException(addr, 0xFFFFFF);
 		}
-		for (const auto c : record_data) {
-			this->data.push_back(static_cast<uint8_t>(c));
-		}
 	};
-	Srec2(unsigned int addr, const unsigned char *record_data, const size_t length) : Srec(Srec::Type::S2), address(addr) {
+	Srec2(unsigned int addr, const std::string &record_data)
+		: Srec(Srec::Type::S2), address(addr), data(record_data.begin(), record_data.end()) {
 		if (addr > 0xFFFFFF) {
 			throw SrecAddressException(addr, 0xFFFFFF);
 		}
-		for (size_t i = 0; i < length; ++i) {
-			this->data.push_back(record_data[i]);
+	};
+	Srec2(unsigned int addr, const unsigned char *record_data, const size_t length)
+		: Srec(Srec::Type::S2), address(addr), data(record_data, record_data + length) {
+		if (addr > 0xFFFFFF) {
+			throw SrecAddressException(addr, 0xFFFFFF);
 		}
 	};
 	~Srec2() final = default;
 
+	Srec2(const Srec2 &) = default;
+	Srec2(Srec2 &&) noexcept = default;
+	Srec2 &operator=(const Srec2 &) = default;
+	Srec2 &operator=(Srec2 &&) noexcept = default;
+
 	/**
 	 * @brief Get the data payload
-	 * @return Copy of the data bytes (excluding address)
+	 * @return The data bytes (excluding address)
 	 */
-	std::vector<uint8_t> getData() const {
+	const std::vector<uint8_t> &getData() const {
 		return data;
 	}
 
+	SrecView view() const override {
+		return SrecView{getType(), address, data.data(), data.size()};
+	}
+
 	std::vector<uint8_t> getRecordData() override {
 		std::vector<uint8_t> record;
 		record.push_back(static_cast<uint8_t>((address >> 16) & 0xFF));
@@ -347,27 +467,33 @@ class Srec3 final : public Srec {
 public:
 	static constexpr size_t ADDRESS_SIZE = 4; //in bytes
 
-	Srec3(unsigned int addr, const std::vector<uint8_t> &record_data) : Srec(Srec::Type::S3), address(addr), data(record_data) {};
-	Srec3(unsigned int addr, const std::string &record_data) : Srec(Srec::Type::S3), address(addr) {
-		for (const auto c : record_data) {
-			this->data.push_back(static_cast<uint8_t>(c));
-		}
-	};
-	Srec3(unsigned int addr, const unsigned char *record_data, const size_t length) : Srec(Srec::Type::S3), address(addr) {
-		for (size_t i = 0; i < length; ++i) {
-			this->data.push_back(record_data[i]);
-		}
-	};
+	Srec3(unsigned int addr, const std::vector<uint8_t> &record_data)
+		: Srec(Srec::Type::S3), address(addr), data(record_data) {};
+	Srec3(unsigned int addr, std::vector<uint8_t> &&record_data)
+		: Srec(Srec::Type::S3), address(addr), data(std::move(record_data)) {};
+	Srec3(unsigned int addr, const std::string &record_data)
+		: Srec(Srec::Type::S3), address(addr), data(record_data.begin(), record_data.end()) {};
+	Srec3(unsigned int addr, const unsigned char *record_data, const size_t length)
+		: Srec(Srec::Type::S3), address(addr), data(record_data, record_data + length) {};
 	~Srec3() final = default;
 
+	Srec3(const Srec3 &) = default;
+	Srec3(Srec3 &&) noexcept = default;
+	Srec3 &operator=(const Srec3 &) = default;
+	Srec3 &operator=(Srec3 &&) noexcept = default;
+
 	/**
 	 * @brief Get the data payload
-	 * @return Copy of the data bytes (excluding address)
+	 * @return The data bytes (excluding address)
 	 */
-	std::vector<uint8_t> getData() const {
+	const std::vector<uint8_t> &getData() const {
 		return data;
 	}
 
+	SrecView view() const override {
+		return SrecView{getType(), address, data.data(), data.size()};
+	}
+
 	std::vector<uint8_t> getRecordData() override {
 		std::vector<uint8_t> record;
 		record.push_back(static_cast<uint8_t>((address >> 24) & 0xFF));
@@ -397,6 +523,10 @@ public:
 	};
 	~Srec5() final = default;
 
+	SrecView view() const override {
+		return SrecView{getType(), count, nullptr, 0};
+	}
+
 	std::vector<uint8_t> getRecordData() override {
 		std::vector<uint8_t> record;
 		record.push_back(static_cast<uint8_t>((count >> 8) & 0xFF));
@@ -423,6 +553,10 @@ public:
 	};
 	~Srec6() final = default;
 
+	SrecView view() const override {
+		return SrecView{getType(), count, nullptr, 0};
+	}
+
 	std::vector<uint8_t> getRecordData() override {
 		std::vector<uint8_t> record;
 		record.push_back(static_cast<uint8_t>((count >> 16) & 0xFF));
@@ -448,6 +582,10 @@ public:
 	explicit Srec7(unsigned int addr) : Srec(Srec::Type::S7), address(addr) {};
 	~Srec7() final = default;
 
+	SrecView view() const override {
+		return SrecView{getType(), address, nullptr, 0};
+	}
+
 	std::vector<uint8_t> getRecordData() override {
 		std::vector<uint8_t> record;
 		record.push_back(static_cast<uint8_t>((address >> 24) & 0xFF));
@@ -478,6 +616,10 @@ public:
 	};
 	~Srec8() final = default;
 
+	SrecView view() const override {
+		return SrecView{getType(), address, nullptr, 0};
+	}
+
 	std::vector<uint8_t> getRecordData() override {
 		std::vector<uint8_t> record;
 		record.push_back(static_cast<uint8_t>((address >> 16) & 0xFF));
@@ -507,6 +649,10 @@ public:
 	};
 	~Srec9() final = default;
 
+	SrecView view() const override {
+		return SrecView{getType(), address, nullptr, 0};
+	}
+
 	std::vector<uint8_t> getRecordData() override {
 		std::vector<uint8_t> record;
 		record.push_back(static_cast<uint8_t>((address >> 8) & 0xFF));
@@ -516,6 +662,144 @@ public:
 };
 
 
+/**
+ * @brief Size limits for writing and reading S-record files
+ *
+ * Guards against runaway conversions and hostile inputs. The default
+ * constructed value is the safe preset, which caps the record count as
+ * SrecFile always did; strict() also caps the text size, large() fits the
+ * whole 32-bit address space and unlimited() disables the checks. The
+ * checks are plain comparisons on running totals, made once per batch of
+ * records where the API writes in batches.
+ */
+struct SrecLimits {
+	uint64_t max_records{1000000};     ///< Maximum number of data records (S1/S2/S3)
+	uint64_t max_file_size{UINT64_MAX}; ///< Maximum characters of S-record text
+
+	/**
+	 * @brief Get the safe preset (1M records, any text size)
+	 * @return Default limits
+	 */
+	static constexpr SrecLimits safe() {
+		return SrecLimits{};
+	}
+
+	/**
+	 * @brief Get the safe preset with a text size cap (1M records, 100 MiB)
+	 *
+	 * For services converting untrusted input, where the output size must
+	 * be bounded as well.
+	 *
+	 * @return Strict limits
+	 */
+	static constexpr SrecLimits strict() {
+		return SrecLimits{1000000, 100 * 1024 * 1024};
+	}
+
+	/**
+	 * @brief Get limits for multi-GB images
+	 *
+	 * Allows as many records as a count record can hold (0xFFFFFF), enough
+	 * for 4 GiB of data in full-size records, of any text size.
+	 *
+	 * @return Large limits
+	 */
+	static constexpr SrecLimits large() {
+		return SrecLimits{0xFFFFFF, UINT64_MAX};
+	}
+
+	/**
+	 * @brief Get limits that never trigger
+	 * @return Unlimited limits
+	 */
+	static constexpr SrecLimits unlimited() {
+		return SrecLimits{UINT64_MAX, UINT64_MAX};
+	}
+};
+
+/**
+ * @brief Line terminator of written records
+ */
+enum class LineEnding {
+	LF,  ///< "\n" (default)
+	CRLF ///< "\r\n", for tools that expect DOS text files
+};
+
+/**
+ * @brief Arrangement of the data records of a written file
+ *
+ * The default constructed value packs the maximum payload of the address
+ * size into every record, splits records at multiples of that payload from
+ * where each write starts and ends lines with LF, as SrecFile always did.
+ *
+ * With align set, record boundaries fall on addresses that are multiples
+ * of the record length, so a write that starts mid-way gets a short first
+ * record. With fixed_stride set, every data record line is padded with
+ * spaces before its terminator to the length of a full record; readers
+ * ignore trailing whitespace, and the offset of data record N is the
+ * offset of the first data record plus N times SrecFile::record_stride().
+ */
+struct SrecLayout {
+	size_t record_length{0};                ///< Payload bytes per data record; 0 for the maximum of the address size
+	bool align{false};                      ///< Break records at multiples of the record length in the address space
+	LineEnding line_ending{LineEnding::LF}; ///< Line terminator of every record
+	bool fixed_stride{false};               ///< Pad data record lines to one length
+
+	/**
+	 * @brief Check whether records are laid out as by default, apart from their length
+	 * @return true for unaligned, unpadded, LF-terminated records
+	 */
+	bool is_plain() const {
+		return !align && !fixed_stride && line_ending == LineEnding::LF;
+	}
+};
+
+/**
+ * @brief Bytes a CRC32 header covers when fill runs are left out
+ */
+enum class SrecFillCrc {
+	EMITTED, ///< The payloads of the data records as written, which is what sreccheck verifies
+	IMAGE    ///< Every input byte, the fill left out included, as without skipping
+};
+
+/**
+ * @brief Leaving runs of a fill byte, such as erased flash, out of written files
+ *
+ * Decided record by record as the layout splits the data: a record of
+ * nothing but fill is not written, and runs of at least min_run fill bytes
+ * at the start or end of a record are cut off, so after a gap the data
+ * restarts at the first byte that is not fill. Runs inside a record, and
+ * leading runs that would move a record's start past the largest address
+ * of its address field, are kept. Record boundaries stay where they would
+ * be without skipping, so every converter writes the same records whatever
+ * its read size.
+ *
+ * Addresses are unchanged, and the count record counts the data records
+ * actually written. Reading the file with the same fill byte gives back the
+ * input between its first and last bytes that are not fill.
+ */
+struct SrecFillSkip {
+	/// Default shortest run cut from the start or end of a record
+	static constexpr size_t DEFAULT_MIN_RUN = 16;
+
+	bool enabled{false};                   ///< Whether to leave fill out
+	uint8_t fill_byte{0xFF};               ///< Value of unused bytes (0xFF for erased NOR flash)
+	size_t min_run{DEFAULT_MIN_RUN};       ///< Shortest run cut from the start or end of a record
+	SrecFillCrc crc{SrecFillCrc::EMITTED}; ///< What the CRC32 header covers
+};
+
+/**
+ * @brief Contiguous run of bytes to be written at an address
+ *
+ * The bytes are not owned; they must stay valid for the duration of the
+ * call they are passed to.
+ */
+struct SrecSegment {
+	uint32_t address{0};          ///< Address of the first byte
+	const uint8_t *data{nullptr}; ///< Bytes to write
+	size_t length{0};             ///< Number of bytes
+};
+
 /**
  * @brief S-record file writer and manager
  * 
@@ -537,19 +821,53 @@ public:
 		BITS32  ///< 32-bit addresses (S3/S7 records)
 	};
 
+	/// Record count and size limits, see SrecLimits
+	using Limits = SrecLimits;
+
 private:
 	std::string filename;
-	std::fstream file;
+	std::unique_ptr<SrecSink> output;
+	FlushPolicy flush_mode{FlushPolicy::ON_CLOSE};
 
 	unsigned int address; // current address
 	unsigned int exec_address; // execution address
 	AddressSize address_size_bits;
 
 	unsigned int record_count{0};
+
+	size_t output_offset{0};             // characters written to the sink
+	std::optional<size_t> checksum_slot; // offset of the reserved CRC header
+
+	// Scratch buffer for formatting one record plus its line terminator
+	std::array<char, MAX_RECORD_LINE_LENGTH + 2> line_buffer{};
+
+	// Formatters for the address size, chosen once at construction (see RecordCodec)
+	unsigned int max_payload{0};   // payload of a full data record in the current layout
+	unsigned int codec_payload{0}; // most payload the address size allows
+	uint32_t max_address{0};
+	size_t record_overhead{0}; // characters of a data record line besides the data
+	size_t address_length{0};  // address bytes of a data record
+
+	// Arrangement of data records, see SrecLayout
+	SrecLayout record_layout;
+	size_t stride{0}; // characters of every data record line with fixed_stride, otherwise 0
+	SrecFillSkip fill_skip;
+	size_t (*format_data)(uint32_t address, const uint8_t *data, size_t length, char *out){nullptr};
+	size_t (*format_termination)(uint32_t address, char *out){nullptr};
+
+	void select_codec();
+	void apply_layout();
+	size_t trim_fill(uint64_t start, const uint8_t *data, size_t length, size_t &lead) const;
+	size_t finish_line(char *line, size_t length, bool data) const;
+	void write_line(Srec::Type type, size_t length);
+	size_t check_data_limits(uint64_t start, size_t length, size_t pending_records, uint64_t pending_bytes) const;
+	template <typename Codec>
+	void write_data_records(const uint8_t *data, size_t length);
 	
-	// Security limits
-	static constexpr size_t MAX_FILE_SIZE = 100 * 1024 * 1024; // 100MB
-	static constexpr size_t MAX_RECORD_COUNT = 1000000; // 1M records
+	// Security limits, applied to data records
+	Limits limit;
+	SrecStats *statistics{nullptr};
+	void check_limits(uint64_t records, uint64_t characters) const;
 
 
 public:
@@ -558,19 +876,65 @@ public:
 	 * @param file_name Path to the output file
 	 * @param address_size Address size for data records (16/24/32-bit)
 	 * @param start_address Starting address for data records (default: 0)
-	 * @throws SrecFileException if file cannot be opened
+	 * @param flush_policy When buffered output is flushed (default: on close)
+	 * @param file_limits Record count and size limits (default: SrecLimits::safe())
+	 * @note Check is_open() to see whether the file could be opened
 	 */
-	SrecFile(const std::string &file_name, AddressSize address_size, unsigned int start_address = 0);
+	SrecFile(const std::string &file_name, AddressSize address_size, unsigned int start_address = 0,
+	         FlushPolicy flush_policy = FlushPolicy::ON_CLOSE, const Limits &file_limits = Limits());
+
+	/**
+	 * @brief Construct an S-record writer on a custom output sink
+	 * @param sink Destination for the formatted records
+	 * @param address_size Address size for data records (16/24/32-bit)
+	 * @param start_address Starting address for data records (default: 0)
+	 * @param flush_policy When buffered output is flushed (default: on close)
+	 * @param file_limits Record count and size limits (default: SrecLimits::safe())
+	 */
+	SrecFile(std::unique_ptr<SrecSink> sink, AddressSize address_size, unsigned int start_address = 0,
+	         FlushPolicy flush_policy = FlushPolicy::ON_CLOSE, const Limits &file_limits = Limits());
 	
 	/**
 	 * @brief Destructor - automatically closes the file
+	 * @note Write errors are ignored here; call close() to observe them
 	 */
     ~SrecFile();
     
 	/**
 	 * @brief Close the S-record file and flush all data
+	 * @throws SrecFileException if buffered data cannot be written
 	 */
     void close();
+
+	/**
+	 * @brief Push buffered records to the output
+	 * @throws SrecFileException if buffered data cannot be written
+	 */
+	void flush();
+
+	/**
+	 * @brief Get the flush policy
+	 * @return When buffered output is flushed
+	 */
+	FlushPolicy flush_policy() const {
+		return flush_mode;
+	}
+
+	/**
+	 * @brief Set the flush policy
+	 * @param policy When buffered output is flushed
+	 */
+	void set_flush_policy(FlushPolicy policy) {
+		flush_mode = policy;
+	}
+
+	/**
+	 * @brief Get the output sink
+	 * @return Sink the records are written to
+	 */
+	SrecSink &sink() {
+		return *output;
+	}
     
 	/**
 	 * @brief Check if the file is currently open
@@ -579,11 +943,177 @@ public:
 	bool is_open();
 	
 	/**
-	 * @brief Get maximum data bytes per record for current address size
-	 * @return Maximum number of data bytes that can fit in one record
+	 * @brief Get the payload of a full data record
+	 * @return The layout's record length, by default the most data bytes
+	 *         that fit in one record of the address size
 	 */
 	unsigned int max_data_bytes_per_record() const;
 
+	/**
+	 * @brief Get the arrangement of data records
+	 * @return Current layout
+	 */
+	const SrecLayout &layout() const {
+		return record_layout;
+	}
+
+	/**
+	 * @brief Change the arrangement of data records
+	 *
+	 * Applies to the records written after the call; set it before writing
+	 * for a file with one layout throughout.
+	 *
+	 * @param new_layout Record length, alignment, line ending and stride
+	 * @throws SrecValidationException if the record length does not fit the address size
+	 */
+	void set_layout(const SrecLayout &new_layout);
+
+	/**
+	 * @brief Get the fill skipping setting
+	 * @return Current setting; disabled by default
+	 */
+	const SrecFillSkip &skip_fill() const {
+		return fill_skip;
+	}
+
+	/**
+	 * @brief Leave runs of a fill byte out of the data records written after the call
+	 *
+	 * Applies to write_data(), write_segments(), write_record_payload() and
+	 * format_data_records(). The limits are checked against the records the
+	 * data would take without skipping.
+	 *
+	 * @param skip Fill byte, shortest run and CRC coverage
+	 */
+	void set_skip_fill(const SrecFillSkip &skip) {
+		fill_skip = skip;
+	}
+
+	/**
+	 * @brief Add data to the CRC32 of the checksum header
+	 *
+	 * Covers all of 'data' unless fill is skipped with SrecFillCrc::EMITTED;
+	 * then only the bytes that go into data records, as write_data() lays
+	 * them out from 'start', are added.
+	 *
+	 * @param crc CRC so far, 0 to begin
+	 * @param start Address of the first byte
+	 * @param data Bytes about to be written
+	 * @param length Number of bytes
+	 * @param covered Receives the number of bytes added, for xcrc32_combine()
+	 * @return Updated CRC
+	 */
+	uint32_t update_data_crc(uint32_t crc, uint64_t start, const uint8_t *data, size_t length, size_t &covered) const;
+
+	/**
+	 * @brief Get the length of every data record line in fixed-stride layout
+	 * @return Characters per data record line including the terminator, or
+	 *         0 if the layout is not fixed-stride
+	 */
+	size_t record_stride() const {
+		return stride;
+	}
+
+	/**
+	 * @brief Get the payload of the data record starting at next_address()
+	 * @return max_data_bytes_per_record(), or less up to the next boundary in
+	 *         aligned layout
+	 */
+	size_t next_record_length() const {
+		return record_length_at(address);
+	}
+
+	/**
+	 * @brief Get the payload of a data record starting at an address
+	 * @param at Address of the record's first byte
+	 * @return max_data_bytes_per_record(), or less up to the next boundary in
+	 *         aligned layout
+	 */
+	size_t record_length_at(uint64_t at) const;
+
+	/**
+	 * @brief Count the records write_data() produces
+	 * @param start Address of the first byte
+	 * @param length Number of bytes
+	 * @return Number of data records
+	 */
+	size_t count_data_records(uint64_t start, uint64_t length) const;
+
+	/**
+	 * @brief Compute the characters write_data() produces
+	 * @param start Address of the first byte
+	 * @param length Number of bytes
+	 * @return Length of the data record text, terminators included
+	 */
+	uint64_t data_text_size(uint64_t start, uint64_t length) const;
+
+	/**
+	 * @brief Get the length of a record line without payload, such as a count record
+	 * @param address_bytes Bytes of the record's address field
+	 * @return Characters including the terminator
+	 */
+	size_t empty_line_length(size_t address_bytes) const;
+
+	/**
+	 * @brief Format data records as write_data() would, without writing them
+	 *
+	 * Lets converters format on other threads and hand the text to
+	 * write_formatted_records(). Only reads the layout, so concurrent calls
+	 * are safe while the file is not modified.
+	 *
+	 * @param start Address of the first byte
+	 * @param data Bytes to format
+	 * @param length Number of bytes
+	 * @param out Destination, at least count_data_records() * (MAX_RECORD_LINE_LENGTH + 2) characters
+	 * @param records Receives the number of records
+	 * @return Characters written
+	 * @throws SrecAddressException if a record would extend past the 32-bit address space
+	 * @throws SrecValidationException if the address size is invalid
+	 */
+	size_t format_data_records(uint64_t start, const uint8_t *data, size_t length, char *out, size_t &records) const;
+
+	/**
+	 * @brief Get the record count and size limits
+	 * @return Limits applied to data records
+	 */
+	const Limits &limits() const {
+		return limit;
+	}
+
+	/**
+	 * @brief Replace the record count and size limits
+	 *
+	 * Records already written count against the new limits.
+	 *
+	 * @param file_limits New limits
+	 */
+	void set_limits(const Limits &file_limits) {
+		limit = file_limits;
+	}
+
+	/**
+	 * @brief Attach statistics to update while writing
+	 *
+	 * Counts the records and characters written, charges formatting of
+	 * data records to SrecStats::Phase::FORMAT and handing them to the
+	 * sink to SrecStats::Phase::WRITE. Single-threaded convert_bin_to_srec()
+	 * also charges its input reads and CRC to the statistics attached here.
+	 *
+	 * @param stats Statistics to update, or nullptr to stop
+	 * @note The statistics must outlive the file or be detached first
+	 */
+	void set_stats(SrecStats *stats) {
+		statistics = stats;
+	}
+
+	/**
+	 * @brief Get the attached statistics
+	 * @return Statistics set with set_stats(), or nullptr
+	 */
+	SrecStats *stats() const {
+		return statistics;
+	}
+
 	/**
 	 * @brief Write header records (S0) from string data
 	 * @param header_data Vector of header strings (converted to ASCII)
@@ -606,6 +1136,75 @@ public:
 	 * @throws SrecAddressException if address overflow
 	 */
 	void write_record_payload(const std::vector<uint8_t> &buffer);
+
+	/**
+	 * @brief Write data record (S1/S2/S3) from a raw buffer
+	 * @param data Pointer to the payload bytes
+	 * @param length Number of payload bytes
+	 * @throws SrecFileException if file is not open
+	 * @throws SrecValidationException if limits exceeded
+	 * @throws SrecAddressException if address overflow
+	 */
+	void write_record_payload(const uint8_t *data, size_t length);
+	
+	/**
+	 * @brief Write a buffer of any size as data records
+	 *
+	 * The buffer is split into records starting at next_address() as the
+	 * layout says; without alignment that is max_data_bytes_per_record()
+	 * sized records, exactly as repeated write_record_payload() calls
+	 * would. The record count and address limits are checked once, for the
+	 * whole buffer, before anything is written, and the records reach the
+	 * sink in batches.
+	 *
+	 * @param data Bytes to write
+	 * @param length Number of bytes
+	 * @throws SrecFileException if file is not open
+	 * @throws SrecValidationException if limits exceeded
+	 * @throws SrecAddressException if address overflow
+	 */
+	void write_data(const uint8_t *data, size_t length);
+
+	/**
+	 * @brief Write data records for a list of segments
+	 *
+	 * Each segment starts a new run of records at its own address, so
+	 * gaps between segments are preserved. Zero-length segments are
+	 * skipped. All limits are checked before anything is written.
+	 *
+	 * @param segments Segments to write, in output order
+	 * @param count Number of segments
+	 * @throws SrecFileException if file is not open
+	 * @throws SrecValidationException if limits exceeded
+	 * @throws SrecAddressException if a segment does not fit the address space
+	 */
+	void write_segments(const SrecSegment *segments, size_t count);
+
+	/**
+	 * @brief Write data records for a list of segments
+	 * @see write_segments(const SrecSegment *, size_t)
+	 */
+	void write_segments(const std::vector<SrecSegment> &segments) {
+		write_segments(segments.data(), segments.size());
+	}
+
+	/**
+	 * @brief Append data records that were formatted elsewhere
+	 *
+	 * Used by converters that format records on other threads. The text
+	 * must hold 'records' complete, terminated data records of the type
+	 * matching the address size (see format_data_records()), starting at next_address() and
+	 * carrying 'data_bytes' payload bytes in total.
+	 *
+	 * @param text Formatted records
+	 * @param length Number of characters
+	 * @param records Number of records in the text
+	 * @param data_bytes Number of payload bytes in the records
+	 * @throws SrecFileException if file is not open
+	 * @throws SrecValidationException if limits exceeded
+	 * @throws SrecAddressException if address overflow
+	 */
+	void write_formatted_records(const char *text, size_t length, size_t records, size_t data_bytes);
 	
 	/**
 	 * @brief Write count record (S5/S6) with current record count
@@ -620,6 +1219,24 @@ public:
 	 */
 	void write_record_termination();
 
+	/**
+	 * @brief Reserve space for the CRC32 header record (S0)
+	 *
+	 * Writes a placeholder header of the same fixed width as the real one.
+	 * write_checksum_header() later overwrites it in place, so a checksummed
+	 * file is produced in a single write pass.
+	 *
+	 * @throws SrecFileException if the file is not open or the sink cannot be patched
+	 */
+	void reserve_checksum_header();
+
+	/**
+	 * @brief Fill in the header reserved by reserve_checksum_header()
+	 * @param sum CRC32 checksum value
+	 * @throws SrecFileException if no header was reserved or patching fails
+	 */
+	void write_checksum_header(uint32_t sum);
+
 	/**
 	 * @brief Get the filename of this S-record file
 	 * @return Filename as provided to constructor
@@ -628,6 +1245,48 @@ public:
 		return filename;
 	}
 
+	/**
+	 * @brief Get the address of the next data record
+	 * @return Start address plus all payload bytes written so far
+	 */
+	unsigned int next_address() const {
+		return address;
+	}
+
+	/**
+	 * @brief Move the address of the next data record
+	 *
+	 * Leaves a gap (or goes back) in the address space; the execution
+	 * address written by write_record_termination() is not changed.
+	 *
+	 * @param next Address of the next data record
+	 */
+	void set_next_address(unsigned int next) {
+		address = next;
+	}
+
+	/**
+	 * @brief Get the execution address written by write_record_termination()
+	 * @return Execution address, initially the start address
+	 */
+	unsigned int execution_address() const {
+		return exec_address;
+	}
+
+	/**
+	 * @brief Set the execution address written by write_record_termination()
+	 * @param entry Execution address
+	 */
+	void set_execution_address(unsigned int entry) {
+		exec_address = entry;
+	}
+
+	/**
+	 * @brief Get the data record type for the address size
+	 * @return S1, S2 or S3
+	 */
+	Srec::Type data_record_type() const;
+
 	/**
 	 * @brief Get the address size configuration
 	 * @return Current address size setting
@@ -640,29 +1299,104 @@ public:
 
 /**
  * @brief Convert binary file to S-record format
+ *
+ * With want_checksum the CRC32 header is produced without rewriting the
+ * output: a header slot is reserved and patched when the sink supports it,
+ * otherwise the CRC is computed up front from a seekable input. Only when
+ * neither is possible does it fall back to write_checksum().
+ *
  * @param input Input binary file stream
  * @param sfile Output S-record file
  * @param want_checksum Whether to include CRC32 checksum in header
- * @throws SrecFileException on file I/O errors
+ * @param threads Formatting threads; 1 converts on the calling thread, 0 uses
+ *                one per hardware thread (default: 1). The output is the
+ *                same for every thread count.
+ * @throws SrecFileException on file I/O errors, or if a checksum is wanted
+ *         for an input that cannot be seeked and an output that can neither
+ *         be patched nor rewritten by name (e.g. compressed)
+ * @see SrecParallelConverter
  */
-void convert_bin_to_srec(std::ifstream &input, SrecFile &sfile, bool want_checksum);
+void convert_bin_to_srec(std::ifstream &input, SrecFile &sfile, bool want_checksum, unsigned threads = 1);
 
 /**
  * @brief Write CRC32 checksum as S0 header record
  * @param srecfile S-record file to modify
  * @param sum CRC32 checksum value
- * @throws std::ios_base::failure on file operations
+ * @throws std::ios_base::failure if the file has no name (it was opened on a
+ *         sink) or cannot be copied or replaced
  */
 void write_checksum(const SrecFile &srecfile, unsigned int sum);
 
 /**
  * @brief Convert S-record file to binary format
+ *
+ * Payloads are placed at their record addresses, so out-of-order and gapped
+ * files are handled. The output starts at the lowest address in the file.
+ * Payloads are decoded straight into the mapped output, and with a fill
+ * byte of 0 large gaps stay holes in a sparse file.
+ *
  * @param input_file Path to input S-record file
  * @param output_file Path to output binary file
- * @throws std::ios_base::failure on file I/O errors
+ * @param fill_byte Value written to addresses no record defines (default: 0x00)
+ * @throws SrecFileException on file I/O errors
+ * @throws SrecParseException on parsing errors
+ * @throws SrecValidationException on validation failures
  * @note Only processes S1, S2, and S3 data records
+ * @see SrecBinaryConverter
+ */
+void convert_srec_to_bin(const std::string &input_file, const std::string &output_file, uint8_t fill_byte = 0x00);
+
+/**
+ * @brief Reasons SrecStreamParser::try_parse_line() rejects a line
+ */
+enum class SrecParseError : uint8_t {
+	NONE,              ///< The line is a valid record
+	NOT_A_RECORD,      ///< The line does not start with 'S'
+	TOO_SHORT,         ///< Shorter than the smallest record
+	INVALID_TYPE,      ///< Unknown record type
+	INVALID_HEX,       ///< Non-hex character in the count, address, data or checksum
+	LENGTH_MISMATCH,   ///< Line length does not match the byte count
+	COUNT_TOO_SMALL,   ///< Byte count too small for the record type's address field
+	CHECKSUM_MISMATCH  ///< Checksum does not match the record
+};
+
+/**
+ * @brief Get a printable description of a parse error
+ * @param error Error kind
+ * @return Static description, e.g. "Invalid hex character"
  */
-void convert_srec_to_bin(const std::string &input_file, const std::string &output_file);
+const char *parse_error_message(SrecParseError error);
+
+/**
+ * @brief Outcome of SrecStreamParser::try_parse_line()
+ *
+ * Plain data, so reporting an error allocates nothing. throw_exception()
+ * turns it into the exception SrecStreamParser::parse_line() throws.
+ */
+struct SrecParseResult {
+	SrecParseError error{SrecParseError::NONE}; ///< What was wrong, NONE for a valid record
+	size_t line{0};                             ///< Line number given to the parser
+	size_t column{0};                           ///< 1-based column of the offending character, 0 if none
+	size_t expected{0};                         ///< Line length for LENGTH_MISMATCH, checksum for CHECKSUM_MISMATCH
+	size_t actual{0};                           ///< Value found instead; the offending character for
+	                                            ///< INVALID_TYPE and INVALID_HEX
+
+	/**
+	 * @brief Check whether the line was a valid record
+	 * @return true if error is NONE
+	 */
+	bool ok() const {
+		return error == SrecParseError::NONE;
+	}
+
+	/**
+	 * @brief Throw the exception describing the error
+	 * @throws SrecValidationException for CHECKSUM_MISMATCH
+	 * @throws SrecParseException for the other errors
+	 * @note Must not be called for a valid record
+	 */
+	[[noreturn]] void throw_exception() const;
+};
 
 /**
  * @brief Streaming S-record parser for memory-efficient processing
@@ -684,6 +1418,71 @@ public:
 		uint8_t checksum;          ///< Parsed checksum
 		bool checksum_valid;       ///< Whether checksum validation passed
 		size_t line_number;        ///< Line number in file (1-based)
+
+		/**
+		 * @brief Get the record without the parse information
+		 * @return View referring to this record's payload
+		 */
+		SrecView view() const {
+			return SrecView{type, address, data.data(), data.size()};
+		}
+	};
+
+	/**
+	 * @brief Maximum number of data bytes a single record can carry
+	 *
+	 * 255 (byte count) - 2 (smallest address field) - 1 (checksum)
+	 */
+	static constexpr size_t MAX_RECORD_DATA_SIZE = 252;
+
+	/**
+	 * @brief Parsed S-record referring to a payload it does not own
+	 *
+	 * The data pointer stays valid only as long as the buffer it was decoded
+	 * into, typically until the next record is parsed.
+	 */
+	struct ParsedRecordView {
+		Srec::Type type;           ///< Record type (S0-S9)
+		uint32_t address;          ///< Address field (if applicable)
+		const uint8_t *data;       ///< Data payload
+		size_t length;             ///< Number of data bytes
+		uint8_t checksum;          ///< Parsed checksum
+		bool checksum_valid;       ///< Whether checksum validation passed
+		size_t line_number;        ///< Line number in file (1-based)
+
+		/**
+		 * @brief Copy the view into an owning ParsedRecord
+		 * @return Parsed record with its own copy of the payload
+		 */
+		ParsedRecord to_record() const {
+			return ParsedRecord{type, address, std::vector<uint8_t>(data, data + length),
+			                    checksum, checksum_valid, line_number};
+		}
+
+		/**
+		 * @brief Copy the view into an existing ParsedRecord
+		 *
+		 * Reuses the payload storage of 'record', so converting a stream
+		 * of views allocates only when a record outgrows all earlier ones.
+		 *
+		 * @param record Receives the record and a copy of the payload
+		 */
+		void copy_to(ParsedRecord &record) const {
+			record.type = type;
+			record.address = address;
+			record.data.assign(data, data + length);
+			record.checksum = checksum;
+			record.checksum_valid = checksum_valid;
+			record.line_number = line_number;
+		}
+
+		/**
+		 * @brief Get the record without the parse information
+		 * @return View sharing this view's payload
+		 */
+		SrecView view() const {
+			return SrecView{type, address, data, length};
+		}
 	};
 
 	/**
@@ -698,24 +1497,36 @@ public:
 	 * @param input_stream Input stream containing S-record data
 	 * @param callback Function called for each parsed record
 	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @param limits Record count and size limits (default: SrecLimits::unlimited())
+	 * @param stats Statistics to update, see SrecReader::set_stats() (default: none)
 	 * @throws SrecParseException on parsing errors
-	 * @throws SrecValidationException on validation failures
+	 * @throws SrecValidationException on validation failures or exceeded limits
+	 * @throws SrecFileException on stream read errors
+	 * @note The stream is read in blocks (see SrecReader); when the callback
+	 *       stops early the stream position is past the last record seen
 	 */
 	static void parse_stream(std::istream &input_stream, 
 	                        RecordCallback callback,
-	                        bool validate_checksums = true);
+	                        bool validate_checksums = true,
+	                        const SrecLimits &limits = SrecLimits::unlimited(),
+	                        SrecStats *stats = nullptr);
 
 	/**
 	 * @brief Parse S-record file with callback processing
 	 * @param filename Path to S-record file
 	 * @param callback Function called for each parsed record
 	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @param limits Record count and size limits (default: SrecLimits::unlimited())
+	 * @param stats Statistics to update, see SrecMappedReader::set_stats() (default: none)
 	 * @throws SrecFileException on file I/O errors
 	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures or exceeded limits
 	 */
 	static void parse_file(const std::string &filename,
 	                      RecordCallback callback,
-	                      bool validate_checksums = true);
+	                      bool validate_checksums = true,
+	                      const SrecLimits &limits = SrecLimits::unlimited(),
+	                      SrecStats *stats = nullptr);
 
 	/**
 	 * @brief Parse a single S-record line
@@ -729,10 +1540,65 @@ public:
 	                              size_t line_number = 0,
 	                              bool validate_checksum = true);
 
-private:
-	static uint8_t hex_char_to_byte(char c);
-	static uint8_t parse_hex_byte(const std::string &hex_str, size_t offset);
-	static Srec::Type char_to_type(char type_char);
+	/**
+	 * @brief Parse a single S-record line without allocating
+	 *
+	 * The payload is decoded into the caller supplied buffer and the returned
+	 * view points at it. Wraps try_parse_line().
+	 *
+	 * @param line S-record line to parse (no line terminator)
+	 * @param line_number Line number for error reporting
+	 * @param validate_checksum Whether to validate checksum
+	 * @param payload Buffer of at least MAX_RECORD_DATA_SIZE bytes
+	 * @param record Receives the parsed record
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on checksum mismatch
+	 */
+	static void parse_line(std::string_view line,
+	                       size_t line_number,
+	                       bool validate_checksum,
+	                       uint8_t *payload,
+	                       ParsedRecordView &record);
+
+	/**
+	 * @brief Parse a single S-record line, reporting errors without throwing
+	 *
+	 * For untrusted input at line rate: a rejected line costs no more than
+	 * an accepted one, and no memory is allocated either way. Only the
+	 * characters of 'line' are read, whatever its byte count announces, and
+	 * at most MAX_RECORD_DATA_SIZE bytes are written to 'payload'.
+	 *
+	 * @param line S-record line to parse (no line terminator)
+	 * @param line_number Line number to report in the result
+	 * @param validate_checksum Whether to validate checksum
+	 * @param payload Buffer of at least MAX_RECORD_DATA_SIZE bytes
+	 * @param record Receives the parsed record; unspecified if the line is rejected
+	 * @return Error kind, line and column; ok() for a valid record
+	 */
+	static SrecParseResult try_parse_line(std::string_view line,
+	                                      size_t line_number,
+	                                      bool validate_checksum,
+	                                      uint8_t *payload,
+	                                      ParsedRecordView &record) noexcept;
+
+	/**
+	 * @brief Check whether a line holds nothing but whitespace
+	 * @param line Line to check
+	 * @return true if the line should be skipped
+	 */
+	static bool is_blank(std::string_view line) {
+		return line.find_first_not_of(" \t\r\n") == std::string_view::npos;
+	}
+
+	/**
+	 * @brief Remove trailing whitespace (including '\r') from a line
+	 * @param line Line to trim
+	 * @return Trimmed view of the same characters
+	 */
+	static std::string_view trim_trailing(std::string_view line) {
+		const size_t end = line.find_last_not_of(" \t\r\n");
+		return (end == std::string_view::npos) ? std::string_view() : line.substr(0, end + 1);
+	}
 };
 
 /**
@@ -758,9 +1624,15 @@ public:
 	 * @param start_address Starting address (default: 0)
 	 * @param want_checksum Include CRC32 checksum header (default: false)
 	 * @param progress_callback Optional progress reporting callback
-	 * @param buffer_size Buffer size for reading (default: 64KB)
+	 * @param buffer_size Bytes read per record; records are at most this
+	 *        long and at most the layout's record length (default: 64KB)
+	 * @param limits Output record count and size limits (default: SrecLimits::safe())
+	 * @param stats Statistics to update with reads, CRC and the output file's
+	 *        counters (see SrecFile::set_stats()) (default: none)
+	 * @param layout Record length, alignment, line ending and stride (default: packed, LF)
+	 * @param skip Fill left out of the data records (default: none, see SrecFile::set_skip_fill())
 	 * @throws SrecFileException on file errors
-	 * @throws SrecValidationException on validation errors
+	 * @throws SrecValidationException on validation errors or exceeded limits
 	 */
 	static void convert_stream(std::istream &input,
 	                          const std::string &output_filename,
@@ -768,7 +1640,50 @@ public:
 	                          uint32_t start_address = 0,
 	                          bool want_checksum = false,
 	                          ProgressCallback progress_callback = nullptr,
-	                          size_t buffer_size = 65536);
+	                          size_t buffer_size = 65536,
+	                          const SrecLimits &limits = SrecLimits(),
+	                          SrecStats *stats = nullptr,
+	                          const SrecLayout &layout = SrecLayout(),
+	                          const SrecFillSkip &skip = SrecFillSkip());
+
+	/**
+	 * @brief Convert binary stream to S-record format with overlapped I/O
+	 *
+	 * Produces the same output as convert_stream() with the same arguments.
+	 * A background thread reads the input into a ring of buffer_count
+	 * blocks and the output is written through an SrecAsyncSink, so the
+	 * next read and the previous write overlap with formatting. Progress is
+	 * reported and cancellation checked after every record, as in
+	 * convert_stream().
+	 *
+	 * @param input Input binary stream; used by the reader thread until the call returns
+	 * @param output_filename Output S-record file
+	 * @param address_size Address size for records
+	 * @param start_address Starting address (default: 0)
+	 * @param want_checksum Include CRC32 checksum header (default: false)
+	 * @param progress_callback Optional progress reporting callback, called on the calling thread
+	 * @param buffer_size Record size limit and input block size (default: 64KB)
+	 * @param buffer_count Number of input blocks, at least 2 (default: 3)
+	 * @param limits Output record count and size limits (default: SrecLimits::safe())
+	 * @param stats Statistics to update as in convert_stream(); the read phase
+	 *        is the time spent waiting for the reader thread (default: none)
+	 * @param layout Record length, alignment, line ending and stride (default: packed, LF)
+	 * @param skip Fill left out of the data records (default: none, see SrecFile::set_skip_fill())
+	 * @throws SrecFileException on file errors
+	 * @throws SrecValidationException on validation errors or exceeded limits
+	 */
+	static void convert_stream_async(std::istream &input,
+	                                 const std::string &output_filename,
+	                                 SrecFile::AddressSize address_size,
+	                                 uint32_t start_address = 0,
+	                                 bool want_checksum = false,
+	                                 ProgressCallback progress_callback = nullptr,
+	                                 size_t buffer_size = 65536,
+	                                 size_t buffer_count = 3,
+	                                 const SrecLimits &limits = SrecLimits(),
+	                                 SrecStats *stats = nullptr,
+	                                 const SrecLayout &layout = SrecLayout(),
+	                                 const SrecFillSkip &skip = SrecFillSkip());
 };
 
 } // namespace tierone::srec
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "srec_arena.h"
+#include "srec_mapped.h"
+#include "srec_reader.h"
+
+namespace tierone::srec {
+
+SrecRecordArena::SrecRecordArena(const size_t size)
+	: block_size(std::max<size_t>(size, SrecStreamParser::MAX_RECORD_DATA_SIZE))
+{
+}
+
+uint8_t *SrecRecordArena::prepare(const size_t capacity) {
+	if (current < blocks.size() && blocks[current].size - position >= capacity) {
+		return blocks[current].storage.get() + position;
+	}
+
+	// Move on to the next retained block that fits, or add one
+	if (current < blocks.size()) {
+		++current;
+	}
+	position = 0;
+	while (current < blocks.size() && blocks[current].size < capacity) {
+		++current;
+	}
+	if (current == blocks.size()) {
+		const size_t size = std::max(block_size, capacity);
+		blocks.push_back(Block{std::make_unique<uint8_t[]>(size), size});
+	}
+	return blocks[current].storage.get();
+}
+
+SrecStreamParser::ParsedRecordView SrecRecordArena::store(const SrecStreamParser::ParsedRecordView &record) {
+	SrecStreamParser::ParsedRecordView stored = record;
+	if (record.length > 0) {
+		uint8_t *storage = allocate(record.length);
+		std::memcpy(storage, record.data, record.length);
+		stored.data = storage;
+	}
+	return stored;
+}
+
+void SrecRecordArena::clear() {
+	current = 0;
+	position = 0;
+	used = 0;
+}
+
+void SrecRecordArena::release() {
+	blocks.clear();
+	clear();
+}
+
+size_t SrecRecordArena::capacity() const {
+	size_t total = 0;
+	for (const auto &block : blocks) {
+		total += block.size;
+	}
+	return total;
+}
+
+void SrecRecordTable::push_back(const SrecStreamParser::ParsedRecordView &record) {
+	type_list.push_back(record.type);
+	address_list.push_back(record.address);
+	length_list.push_back(static_cast<uint8_t>(record.length));
+	offset_list.push_back(bytes.size());
+	checksum_list.push_back(record.checksum);
+	line_list.push_back(record.line_number);
+	bytes.insert(bytes.end(), record.data, record.data + record.length);
+}
+
+void SrecRecordTable::load_file(const std::string &filename, const bool validate_checksums) {
+	SrecMappedReader reader(filename, validate_checksums);
+	// Payload bytes take two characters each, so this bounds the growth
+	bytes.reserve(bytes.size() + reader.size() / 2);
+	SrecStreamParser::ParsedRecordView record{};
+	while (reader.next(record)) {
+		push_back(record);
+	}
+}
+
+void SrecRecordTable::load(std::istream &input, const bool validate_checksums) {
+	SrecReader reader(input, validate_checksums);
+	SrecStreamParser::ParsedRecordView record{};
+	while (reader.next(record)) {
+		push_back(record);
+	}
+}
+
+void SrecRecordTable::load_buffer(const char *data, const size_t size, const bool validate_checksums) {
+	SrecMappedReader reader(data, size, validate_checksums);
+	SrecStreamParser::ParsedRecordView record{};
+	while (reader.next(record)) {
+		push_back(record);
+	}
+}
+
+void SrecRecordTable::reserve(const size_t records, const size_t payload_bytes) {
+	type_list.reserve(records);
+	address_list.reserve(records);
+	length_list.reserve(records);
+	offset_list.reserve(records);
+	checksum_list.reserve(records);
+	line_list.reserve(records);
+	bytes.reserve(payload_bytes);
+}
+
+void SrecRecordTable::clear() {
+	type_list.clear();
+	address_list.clear();
+	length_list.clear();
+	offset_list.clear();
+	checksum_list.clear();
+	line_list.clear();
+	bytes.clear();
+}
+
+SrecStreamParser::ParsedRecordView SrecRecordTable::operator[](const size_t index) const {
+	const uint8_t *payload_data = data(index);
+	const size_t length = length_list[index];
+	const uint8_t checksum = checksum_list[index];
+	const bool valid = SrecView{type_list[index], address_list[index], payload_data, length}.checksum() == checksum;
+	return SrecStreamParser::ParsedRecordView{type_list[index], address_list[index], payload_data, length,
+	                                          checksum, valid, line_list[index]};
+}
+
+} // namespace tierone::srec
@@ -0,0 +1,281 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "srec.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief Bump allocator for record payloads
+ *
+ * Hands out payload storage from large blocks, so keeping millions of
+ * records costs a handful of allocations instead of one per record.
+ * Storage is only released in bulk: clear() makes every block reusable and
+ * release() frees them. Pointers stay valid until then.
+ *
+ * Payloads can be decoded straight into the arena:
+ * @code
+ * SrecRecordArena arena;
+ * std::vector<SrecStreamParser::ParsedRecordView> records;
+ * SrecStreamParser::ParsedRecordView record{};
+ * while (reader.next(record, arena.prepare(SrecStreamParser::MAX_RECORD_DATA_SIZE))) {
+ *     arena.commit(record.length);
+ *     records.push_back(record);
+ * }
+ * @endcode
+ *
+ * @note This class is not thread-safe
+ */
+class SrecRecordArena {
+public:
+	/// Default size of each block
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+	/**
+	 * @brief Create an empty arena
+	 * @param block_size Size of each block (default: 64 KiB)
+	 */
+	explicit SrecRecordArena(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+	SrecRecordArena(const SrecRecordArena &) = delete;
+	SrecRecordArena &operator=(const SrecRecordArena &) = delete;
+	SrecRecordArena(SrecRecordArena &&) noexcept = default;
+	SrecRecordArena &operator=(SrecRecordArena &&) noexcept = default;
+	~SrecRecordArena() = default;
+
+	/**
+	 * @brief Allocate payload storage
+	 * @param length Number of bytes
+	 * @return Storage for length bytes, valid until clear() or release()
+	 */
+	uint8_t *allocate(size_t length) {
+		uint8_t *storage = prepare(length);
+		commit(length);
+		return storage;
+	}
+
+	/**
+	 * @brief Get storage for a payload whose length is not known yet
+	 *
+	 * The bytes are only handed out once commit() is called; until then the
+	 * next prepare() or allocate() returns the same storage.
+	 *
+	 * @param capacity Number of bytes that may be written
+	 * @return Storage for at least capacity bytes
+	 */
+	uint8_t *prepare(size_t capacity);
+
+	/**
+	 * @brief Keep the first bytes of the storage returned by prepare()
+	 * @param length Number of bytes used, at most the prepared capacity
+	 */
+	void commit(size_t length) {
+		position += length;
+		used += length;
+	}
+
+	/**
+	 * @brief Copy a record's payload into the arena
+	 * @param record Record whose payload may be transient
+	 * @return The same record with its data pointing into the arena
+	 */
+	SrecStreamParser::ParsedRecordView store(const SrecStreamParser::ParsedRecordView &record);
+
+	/**
+	 * @brief Invalidate all payloads and keep the blocks for reuse
+	 */
+	void clear();
+
+	/**
+	 * @brief Invalidate all payloads and free the blocks
+	 */
+	void release();
+
+	/**
+	 * @brief Get the number of payload bytes handed out
+	 * @return Bytes allocated since the last clear() or release()
+	 */
+	size_t bytes_used() const {
+		return used;
+	}
+
+	/**
+	 * @brief Get the total size of all blocks
+	 * @return Bytes held by the arena
+	 */
+	size_t capacity() const;
+
+private:
+	struct Block {
+		std::unique_ptr<uint8_t[]> storage;
+		size_t size;
+	};
+
+	std::vector<Block> blocks;
+	size_t block_size;
+	size_t current{0};  // index of the block being filled
+	size_t position{0}; // bytes used in the current block
+	size_t used{0};
+};
+
+/**
+ * @brief A whole file's records as a structure of arrays
+ *
+ * Record fields are kept in parallel arrays and all payloads back to back
+ * in a single byte buffer, so scanning addresses or lengths touches only
+ * those arrays and the payloads can be processed as one contiguous block.
+ * Record i's payload is payload().data() + offsets()[i], lengths()[i]
+ * bytes long.
+ *
+ * @note This class is thread-safe for reading operations only.
+ *       Writing operations are not thread-safe.
+ */
+class SrecRecordTable {
+public:
+	SrecRecordTable() = default;
+
+	/**
+	 * @brief Append a record
+	 * @param record Record to copy
+	 */
+	void push_back(const SrecStreamParser::ParsedRecordView &record);
+
+	/**
+	 * @brief Append every record of an S-record file
+	 * @param filename Path to S-record file
+	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @throws SrecFileException on file I/O errors
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	void load_file(const std::string &filename, bool validate_checksums = true);
+
+	/**
+	 * @brief Append every record of an S-record stream
+	 * @param input Input stream containing S-record data
+	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @throws SrecFileException on stream read errors
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	void load(std::istream &input, bool validate_checksums = true);
+
+	/**
+	 * @brief Append every record of S-record text held in memory
+	 * @param data S-record text
+	 * @param size Number of characters
+	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	void load_buffer(const char *data, size_t size, bool validate_checksums = true);
+
+	/**
+	 * @brief Reserve space
+	 * @param records Number of records
+	 * @param payload_bytes Total payload bytes
+	 */
+	void reserve(size_t records, size_t payload_bytes);
+
+	/**
+	 * @brief Remove all records
+	 */
+	void clear();
+
+	/**
+	 * @brief Get the number of records
+	 * @return Record count
+	 */
+	size_t size() const {
+		return type_list.size();
+	}
+
+	/**
+	 * @brief Check whether the table is empty
+	 * @return true if there are no records
+	 */
+	bool empty() const {
+		return type_list.empty();
+	}
+
+	/**
+	 * @brief Get one record
+	 * @param index Record index, below size()
+	 * @return View of the record; its data points into payload()
+	 */
+	SrecStreamParser::ParsedRecordView operator[](size_t index) const;
+
+	/**
+	 * @brief Get a record's payload
+	 * @param index Record index, below size()
+	 * @return Pointer to lengths()[index] bytes
+	 */
+	const uint8_t *data(size_t index) const {
+		return bytes.data() + offset_list[index];
+	}
+
+	const std::vector<Srec::Type> &types() const {
+		return type_list;
+	}
+
+	const std::vector<uint32_t> &addresses() const {
+		return address_list;
+	}
+
+	const std::vector<uint8_t> &lengths() const {
+		return length_list;
+	}
+
+	const std::vector<uint64_t> &offsets() const {
+		return offset_list;
+	}
+
+	const std::vector<uint8_t> &checksums() const {
+		return checksum_list;
+	}
+
+	const std::vector<size_t> &line_numbers() const {
+		return line_list;
+	}
+
+	/**
+	 * @brief Get all payloads
+	 * @return Payload bytes of every record, in record order
+	 */
+	const std::vector<uint8_t> &payload() const {
+		return bytes;
+	}
+
+private:
+	std::vector<Srec::Type> type_list;
+	std::vector<uint32_t> address_list;
+	std::vector<uint8_t> length_list;
+	std::vector<uint64_t> offset_list;
+	std::vector<uint8_t> checksum_list;
+	std::vector<size_t> line_list;
+	std::vector<uint8_t> bytes;
+};
+
+} // namespace tierone::srec
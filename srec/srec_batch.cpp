@@ -0,0 +1,159 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <optional>
+
+#include "srec_batch.h"
+#include "srec_threads.h"
+
+namespace tierone::srec {
+
+namespace {
+
+SrecBatchResult run_job(const SrecBatchRunner::Job &job, const size_t index, const unsigned worker) {
+	try {
+		return job(index, worker);
+	} catch (const std::exception &err) {
+		return SrecBatchResult{false, err.what()};
+	} catch (...) {
+		return SrecBatchResult{false, "Unknown error"};
+	}
+}
+
+std::string trim(const std::string &text) {
+	const size_t first = text.find_first_not_of(" \t\r\n");
+	if (first == std::string::npos) {
+		return std::string();
+	}
+	return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+} // namespace
+
+SrecBatchRunner::SrecBatchRunner(const unsigned threads)
+	: worker_count(detail::resolve_thread_count(threads))
+{
+}
+
+size_t SrecBatchRunner::run(const size_t count, const Job &job, const ReportCallback &report) {
+	size_t failures = 0;
+	if (worker_count == 1 || count <= 1) {
+		for (size_t index = 0; index < count; ++index) {
+			const SrecBatchResult result = run_job(job, index, 0);
+			failures += result.ok ? 0 : 1;
+			report(index, result);
+		}
+		return failures;
+	}
+
+	std::vector<std::optional<SrecBatchResult>> results(count);
+	std::mutex mutex;
+	std::condition_variable finished;
+	std::atomic<size_t> next_job{0};
+	std::atomic<bool> stop{false};
+
+	auto worker = [&](const unsigned worker_index) {
+		for (;;) {
+			const size_t index = next_job.fetch_add(1);
+			if (index >= count || stop.load()) {
+				return;
+			}
+			SrecBatchResult result = run_job(job, index, worker_index);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				results[index] = std::move(result);
+			}
+			finished.notify_all();
+		}
+	};
+
+	// Declared after the workers so it runs first on every exit path
+	struct StopGuard {
+		std::atomic<bool> &stop;
+		~StopGuard() {
+			stop = true;
+		}
+	};
+
+	detail::WorkerThreads threads;
+	StopGuard guard{stop};
+	const auto started = static_cast<unsigned>(std::min<size_t>(worker_count, count));
+	for (unsigned worker_index = 0; worker_index < started; ++worker_index) {
+		threads.start(1, [&worker, worker_index] { worker(worker_index); });
+	}
+
+	for (size_t index = 0; index < count; ++index) {
+		SrecBatchResult result;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			finished.wait(lock, [&] { return results[index].has_value(); });
+			result = std::move(*results[index]);
+			results[index].reset();
+		}
+		failures += result.ok ? 0 : 1;
+		report(index, result);
+	}
+	return failures;
+}
+
+std::vector<SrecBatchJob> SrecBatchRunner::read_manifest(const std::string &filename) {
+	std::ifstream input(filename);
+	if (!input.is_open()) {
+		throw SrecFileException("Failed to open manifest", filename);
+	}
+	try {
+		return read_manifest(input);
+	} catch (const SrecFileException &) {
+		throw SrecFileException("Failed to read manifest", filename);
+	}
+}
+
+std::vector<SrecBatchJob> SrecBatchRunner::read_manifest(std::istream &input) {
+	std::vector<SrecBatchJob> jobs;
+	std::string line;
+	while (std::getline(input, line)) {
+		const std::string entry = trim(line);
+		if (entry.empty() || entry[0] == '#') {
+			continue;
+		}
+		const size_t tab = entry.find('\t');
+		if (tab == std::string::npos) {
+			jobs.push_back(SrecBatchJob{entry, std::string()});
+		} else {
+			jobs.push_back(SrecBatchJob{trim(entry.substr(0, tab)), trim(entry.substr(tab + 1))});
+		}
+	}
+	if (input.bad()) {
+		throw SrecFileException("Stream read error");
+	}
+	return jobs;
+}
+
+std::string SrecBatchRunner::replace_extension(const std::string &path, const std::string &extension) {
+	const size_t slash = path.find_last_of("/\\");
+	const size_t dot = path.find_last_of('.');
+	const bool has_extension = dot != std::string::npos && dot != 0 &&
+	                           (slash == std::string::npos || (dot > slash + 1));
+	return (has_extension ? path.substr(0, dot) : path) + extension;
+}
+
+} // namespace tierone::srec
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "srec_exceptions.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief One file of a batch
+ */
+struct SrecBatchJob {
+	std::string input;  ///< Input file
+	std::string output; ///< Output file, empty to let the tool choose
+};
+
+/**
+ * @brief Outcome of one batch job
+ */
+struct SrecBatchResult {
+	bool ok{false};      ///< Whether the job succeeded
+	std::string message; ///< Error description, or a summary for successful jobs
+};
+
+/**
+ * @brief Runs many independent file jobs on one pool of worker threads
+ *
+ * Lets a single process convert or verify thousands of files, so process
+ * startup and the one-time setup of the hex and CRC tables are paid once.
+ * Jobs receive the index of the worker running them, which callers use to
+ * keep per-worker state (buffers, images) alive from one job to the next.
+ * Results are reported on the calling thread in job order, as soon as all
+ * earlier jobs have finished.
+ */
+class SrecBatchRunner {
+public:
+	/**
+	 * @brief Job function type
+	 * @param index Index of the job
+	 * @param worker Index of the worker running it, below workers()
+	 * @return Outcome of the job; exceptions are reported as failures
+	 */
+	using Job = std::function<SrecBatchResult(size_t index, unsigned worker)>;
+
+	/**
+	 * @brief Report function type
+	 * @param index Index of the job
+	 * @param result Outcome of the job
+	 */
+	using ReportCallback = std::function<void(size_t index, const SrecBatchResult &result)>;
+
+	/**
+	 * @brief Create a runner
+	 * @param threads Worker threads, 0 for one per hardware thread (default: 0)
+	 */
+	explicit SrecBatchRunner(unsigned threads = 0);
+
+	/**
+	 * @brief Get the number of workers
+	 * @return Number of workers; worker indices passed to jobs are below it
+	 */
+	unsigned workers() const {
+		return worker_count;
+	}
+
+	/**
+	 * @brief Run jobs and report each outcome
+	 * @param count Number of jobs
+	 * @param job Function running one job; called concurrently
+	 * @param report Function called for every job in order, on the calling thread
+	 * @return Number of failed jobs
+	 * @note An exception thrown by the report function stops the batch and is rethrown
+	 */
+	size_t run(size_t count, const Job &job, const ReportCallback &report);
+
+	/**
+	 * @brief Read a manifest of batch jobs
+	 *
+	 * Each line names one input, optionally followed by a tab and the output.
+	 * Blank lines and lines starting with '#' are skipped and whitespace
+	 * around names is ignored.
+	 *
+	 * @param filename Path to the manifest
+	 * @return Jobs in manifest order
+	 * @throws SrecFileException if the manifest cannot be read
+	 */
+	static std::vector<SrecBatchJob> read_manifest(const std::string &filename);
+
+	/**
+	 * @brief Read a manifest of batch jobs from a stream
+	 * @param input Manifest text
+	 * @return Jobs in manifest order
+	 * @throws SrecFileException on stream read errors
+	 * @see read_manifest(const std::string &)
+	 */
+	static std::vector<SrecBatchJob> read_manifest(std::istream &input);
+
+	/**
+	 * @brief Derive an output name from an input name
+	 * @param path Input path
+	 * @param extension New extension including the dot, e.g. ".srec"
+	 * @return path with its extension, if any, replaced
+	 */
+	static std::string replace_extension(const std::string &path, const std::string &extension);
+
+private:
+	unsigned worker_count;
+};
+
+} // namespace tierone::srec
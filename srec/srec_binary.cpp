@@ -0,0 +1,350 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SREC_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include "srec.h"
+#include "srec_binary.h"
+#include "srec_compress.h"
+#include "srec_image.h"
+#include "srec_index.h"
+#include "srec_mapped.h"
+#include "srec_metadata.h"
+
+namespace tierone::srec {
+
+namespace {
+
+// Address range [first, second) of output bytes
+using Range = std::pair<uint64_t, uint64_t>;
+
+// Address range of a data record, read from its count and address fields only
+bool peek_data_record(const std::string_view line, uint64_t &address, uint64_t &length) {
+	SrecRecordFields fields;
+	if (!peek_record_fields(line, fields) || fields.type < Srec::Type::S1 || fields.type > Srec::Type::S3) {
+		return false;
+	}
+	address = fields.address;
+	length = fields.length;
+	return true;
+}
+
+// Call function(line, line number) for every non-blank line, split and
+// trimmed as SrecMappedReader does
+template <typename Function>
+void for_each_line(const char *text, const size_t size, Function &&function) {
+	size_t position = 0;
+	size_t line_number = 0;
+	while (position < size) {
+		const char *start = text + position;
+		const auto *newline = static_cast<const char *>(std::memchr(start, '\n', size - position));
+		const size_t line_length = newline ? static_cast<size_t>(newline - start) : size - position;
+		position += line_length + (newline ? 1 : 0);
+		++line_number;
+
+		const std::string_view line(start, line_length);
+		if (!SrecStreamParser::is_blank(line)) {
+			function(SrecStreamParser::trim_trailing(line), line_number);
+		}
+	}
+}
+
+// Sort ranges and join those that overlap or touch
+void coalesce(std::vector<Range> &ranges) {
+	std::sort(ranges.begin(), ranges.end());
+	size_t used = 0;
+	for (const Range &range : ranges) {
+		if (used > 0 && range.first <= ranges[used - 1].second) {
+			ranges[used - 1].second = std::max(ranges[used - 1].second, range.second);
+		} else {
+			ranges[used++] = range;
+		}
+	}
+	ranges.resize(used);
+}
+
+// Ranges defined by the data records, from the address fields alone
+std::vector<Range> scan_ranges(const char *text, const size_t size) {
+	std::vector<Range> ranges;
+	for_each_line(text, size, [&ranges](const std::string_view line, size_t) {
+		uint64_t address = 0;
+		uint64_t length = 0;
+		if (!peek_data_record(line, address, length) || length == 0) {
+			return;
+		}
+		if (!ranges.empty() && ranges.back().second == address) {
+			ranges.back().second += length;
+		} else {
+			ranges.emplace_back(address, address + length);
+		}
+	});
+	coalesce(ranges);
+	return ranges;
+}
+
+// Ranges from a current side-car index; false if there is none
+bool index_ranges(const std::string &filename, std::vector<Range> &ranges) {
+	const std::string sidecar = SrecIndex::sidecar_path(filename);
+	std::error_code error;
+	if (!std::filesystem::exists(sidecar, error)) {
+		return false;
+	}
+	try {
+		const SrecIndex index = SrecIndex::load(sidecar);
+		if (!index.is_current(filename)) {
+			return false;
+		}
+		for (const SrecIndexEntry &entry : index.entries()) {
+			if (entry.length > 0) {
+				ranges.emplace_back(entry.address, entry.end());
+			}
+		}
+	} catch (const SrecFileException &) {
+		ranges.clear();
+		return false;
+	}
+	coalesce(ranges);
+	return true;
+}
+
+SrecBinaryResult convert_in_memory(const std::string &input_file, const std::string &output_file,
+                                   const SrecBinaryOptions &options) {
+	SrecMemoryImage image;
+	image.set_fill_byte(options.fill_byte);
+	image.load_file(input_file, options.validate_checksums, options.stats);
+
+	SrecStatsTimer timer(options.stats, SrecStats::Phase::WRITE);
+	image.write_binary_file(output_file);
+	SrecBinaryResult result;
+	result.start_address = image.start_address();
+	result.size = image.end_address() - image.start_address();
+	result.data_bytes = image.data_size();
+	if (SrecStats::ENABLED && options.stats) {
+		options.stats->bytes_out += result.size;
+	}
+	return result;
+}
+
+#if defined(SREC_HAVE_MMAP)
+
+// Closes a file descriptor
+struct FileHandle {
+	int fd{-1};
+
+	~FileHandle() {
+		if (fd >= 0) {
+			::close(fd);
+		}
+	}
+};
+
+// Unmaps a writable mapping
+struct Mapping {
+	void *address{MAP_FAILED};
+	size_t length{0};
+
+	~Mapping() {
+		if (address != MAP_FAILED) {
+			::munmap(address, length);
+		}
+	}
+};
+
+// Reserve disk blocks for part of the output, so writing the mapping cannot run out of space
+void allocate(const int fd, const uint64_t offset, const uint64_t length, const std::string &filename) {
+#if defined(__linux__)
+	const int error = ::posix_fallocate(fd, static_cast<off_t>(offset), static_cast<off_t>(length));
+	if (error == ENOSPC || error == EFBIG) {
+		throw SrecFileException("Not enough space for output file", filename);
+	}
+	// Other errors (e.g. no support in the file system) leave allocation to the writes
+#else
+	(void)fd;
+	(void)offset;
+	(void)length;
+	(void)filename;
+#endif
+}
+
+// Decode the input into a mapped output; false if the output cannot be mapped
+bool convert_mapped(const SrecMappedFile &input, const std::string &output_file, const std::vector<Range> &ranges,
+                    const SrecBinaryOptions &options, SrecBinaryResult &result) {
+	const uint64_t start = ranges.front().first;
+	const uint64_t end = ranges.back().second;
+	const uint64_t size = end - start;
+	if (size > SIZE_MAX) {
+		return false;
+	}
+
+	FileHandle output;
+	output.fd = ::open(output_file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+	if (output.fd < 0) {
+		throw SrecFileException("Failed to open output file", output_file);
+	}
+	if (::ftruncate(output.fd, static_cast<off_t>(size)) != 0) {
+		throw SrecFileException("Failed to size output file", output_file);
+	}
+
+	// Allocate everything but the gaps that stay holes
+	const bool holes = options.fill_byte == 0 && options.hole_size > 0;
+	uint64_t allocated = ranges.front().first;
+	for (size_t i = 0; i < ranges.size(); ++i) {
+		const bool last = i + 1 == ranges.size();
+		const uint64_t gap = last ? 0 : ranges[i + 1].first - ranges[i].second;
+		if (last || (holes && gap >= options.hole_size)) {
+			allocate(output.fd, allocated - start, ranges[i].second - allocated, output_file);
+			result.hole_bytes += gap;
+			if (!last) {
+				allocated = ranges[i + 1].first;
+			}
+		}
+	}
+
+	Mapping mapping;
+	mapping.length = static_cast<size_t>(size);
+	mapping.address = ::mmap(nullptr, mapping.length, PROT_READ | PROT_WRITE, MAP_SHARED, output.fd, 0);
+	if (mapping.address == MAP_FAILED) {
+		return false;
+	}
+	auto *image = static_cast<uint8_t *>(mapping.address);
+
+	// A fresh file reads as zeros; other fill bytes have to be written
+	if (options.fill_byte != 0) {
+		for (size_t i = 0; i + 1 < ranges.size(); ++i) {
+			std::memset(image + (ranges[i].second - start), options.fill_byte,
+			            static_cast<size_t>(ranges[i + 1].first - ranges[i].second));
+		}
+	}
+
+	// Decode every payload straight to its place in the output
+	{
+		SrecStatsTimer timer(options.stats, SrecStats::Phase::DECODE);
+		std::array<uint8_t, SrecStreamParser::MAX_RECORD_DATA_SIZE> scratch{};
+		SrecStreamParser::ParsedRecordView record{};
+		for_each_line(input.data(), input.size(), [&](const std::string_view line, const size_t line_number) {
+			uint64_t address = 0;
+			uint64_t length = 0;
+			uint8_t *destination = scratch.data();
+			if (peek_data_record(line, address, length) && length > 0) {
+				if (address < start || address + length > end) {
+					throw SrecFileException("Input does not match its index or changed while converting",
+					                        input.getFilename());
+				}
+				destination = image + (address - start);
+			}
+			SrecStreamParser::parse_line(line, line_number, options.validate_checksums, destination, record);
+			if (SrecStats::ENABLED && options.stats) {
+				options.stats->count_record(record.type);
+			}
+		});
+	}
+
+	SrecStatsTimer timer(options.stats, SrecStats::Phase::WRITE);
+	if (::munmap(mapping.address, mapping.length) != 0) {
+		throw SrecFileException("Failed to write output file", output_file);
+	}
+	mapping.address = MAP_FAILED;
+	const int fd = output.fd;
+	output.fd = -1;
+	if (::close(fd) != 0) {
+		throw SrecFileException("Failed to write output file", output_file);
+	}
+	result.mapped = true;
+	return true;
+}
+
+#endif
+
+} // namespace
+
+SrecBinaryResult SrecBinaryConverter::convert(const std::string &input_file, const std::string &output_file,
+                                              const Options &options) {
+	// Converting in place only works when the input is read completely first,
+	// and compressed input has no address fields to scan without inflating it
+	std::error_code error;
+	if (std::filesystem::equivalent(input_file, output_file, error) ||
+	    detect_compression(input_file) != SrecCompression::NONE) {
+		return convert_in_memory(input_file, output_file, options);
+	}
+
+	const SrecMappedFile input(input_file);
+	if (SrecStats::ENABLED && options.stats) {
+		options.stats->bytes_in += input.size();
+	}
+
+	SrecBinaryResult result;
+	std::vector<Range> ranges;
+	result.indexed = options.use_index && index_ranges(input_file, ranges);
+	if (!result.indexed) {
+		SrecStatsTimer timer(options.stats, SrecStats::Phase::DECODE);
+		ranges = scan_ranges(input.data(), input.size());
+	}
+	if (ranges.empty()) {
+		// No data, but the records are still checked
+		SrecMappedReader reader(input.data(), input.size(), options.validate_checksums);
+		SrecStreamParser::ParsedRecordView record{};
+		while (reader.next(record)) {
+		}
+		std::ofstream output(output_file, std::ios::binary | std::ios::trunc);
+		if (!output.is_open()) {
+			throw SrecFileException("Failed to open output file", output_file);
+		}
+		return result;
+	}
+
+	result.start_address = static_cast<uint32_t>(ranges.front().first);
+	result.size = ranges.back().second - ranges.front().first;
+	for (const Range &range : ranges) {
+		result.data_bytes += range.second - range.first;
+	}
+
+#if defined(SREC_HAVE_MMAP)
+	try {
+		if (convert_mapped(input, output_file, ranges, options, result)) {
+			if (SrecStats::ENABLED && options.stats) {
+				options.stats->bytes_out += result.size;
+			}
+			return result;
+		}
+	} catch (...) {
+		std::remove(output_file.c_str());
+		throw;
+	}
+#endif
+
+	// The output could not be mapped: build the image in memory
+	SrecBinaryResult fallback = convert_in_memory(input_file, output_file, options);
+	fallback.indexed = result.indexed;
+	return fallback;
+}
+
+} // namespace tierone::srec
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "srec_stats.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief Options for SrecBinaryConverter
+ */
+struct SrecBinaryOptions {
+	/// Default smallest gap left as a hole in the output
+	static constexpr uint64_t DEFAULT_HOLE_SIZE = 64 * 1024;
+
+	uint8_t fill_byte{0x00};                 ///< Value of addresses no record defines
+	bool validate_checksums{true};           ///< Whether to validate record checksums
+	bool use_index{true};                    ///< Take the extent from a current side-car index if there is one
+	uint64_t hole_size{DEFAULT_HOLE_SIZE};   ///< Gaps this large stay unallocated if fill_byte is 0; 0 for none
+	SrecStats *stats{nullptr};               ///< Statistics to update, or nullptr
+};
+
+/**
+ * @brief Totals of an S-record to binary conversion
+ */
+struct SrecBinaryResult {
+	uint32_t start_address{0}; ///< Address of the first output byte
+	uint64_t size{0};          ///< Size of the output file
+	uint64_t data_bytes{0};    ///< Output bytes defined by records
+	uint64_t hole_bytes{0};    ///< Output bytes left as holes in a sparse file
+	bool mapped{false};        ///< Whether the output was written through a mapping
+	bool indexed{false};       ///< Whether the extent came from a side-car index
+};
+
+/**
+ * @brief S-record to binary conversion straight into the output file
+ *
+ * Works in two passes over the mapped input. The first only reads the
+ * count and address fields of the data records (or takes the ranges from a
+ * current SrecIndex side-car) to find the output extent and its gaps. The
+ * output is then sized, its data ranges preallocated and the file mapped,
+ * and the second pass decodes every payload directly to its offset in the
+ * mapping. Nothing is buffered, so memory use does not grow with the image.
+ *
+ * With a fill byte of 0, gaps of at least hole_size are neither allocated
+ * nor touched and stay holes in a sparse file: a 4 GiB address space
+ * holding 10 MiB of data takes about 10 MiB on disk. Other fill bytes have
+ * to be written, so the file is then fully allocated.
+ *
+ * The output is byte-for-byte what SrecMemoryImage::write_binary_file()
+ * writes, including later records overwriting earlier ones. Where files
+ * cannot be mapped the conversion goes through SrecMemoryImage instead.
+ *
+ * @note Output space is preallocated where the platform supports it, so a
+ *       full disk is reported as an exception rather than a fault while
+ *       writing the mapping.
+ */
+class SrecBinaryConverter {
+public:
+	using Options = SrecBinaryOptions;
+	using Result = SrecBinaryResult;
+
+	/**
+	 * @brief Convert an S-record file to a binary file
+	 * @param input_file Path to input S-record file
+	 * @param output_file Path to output binary file; removed if converting fails
+	 * @param options Fill byte, validation and sparse file settings
+	 * @return Conversion totals
+	 * @throws SrecFileException on file I/O errors or if the output does not fit on the device
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	static Result convert(const std::string &input_file, const std::string &output_file,
+	                      const Options &options = Options());
+};
+
+} // namespace tierone::srec
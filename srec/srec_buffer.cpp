@@ -0,0 +1,186 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <memory>
+
+#include "srec_buffer.h"
+#include "srec_codec.h"
+#include "srec_crc.h"
+#include "srec_mapped.h"
+#include "srec_metadata.h"
+
+namespace tierone::srec {
+
+namespace {
+
+// Sink writing into a fixed caller buffer
+class BufferSink : public SrecSink {
+public:
+	BufferSink(char *buffer, const size_t buffer_capacity) : out(buffer), capacity(buffer_capacity) {}
+
+	void write(const char *data, const size_t length) override {
+		if (length > capacity - used) {
+			throw SrecFileException("Output buffer is too small");
+		}
+		std::memcpy(out + used, data, length);
+		used += length;
+	}
+
+	void flush() override {}
+
+	void close() override {
+		open = false;
+	}
+
+	bool is_open() const override {
+		return open;
+	}
+
+	bool can_patch() const override {
+		return true;
+	}
+
+	void patch(const size_t offset, const char *data, const size_t length) override {
+		if (offset > used || length > used - offset) {
+			throw SrecFileException("Patch range has not been written");
+		}
+		std::memcpy(out + offset, data, length);
+	}
+
+	size_t size() const {
+		return used;
+	}
+
+private:
+	char *out;
+	size_t capacity;
+	size_t used{0};
+	bool open{true};
+};
+
+bool is_data(const Srec::Type type) {
+	return type == Srec::Type::S1 || type == Srec::Type::S2 || type == Srec::Type::S3;
+}
+
+} // namespace
+
+size_t SrecBufferConverter::srec_size(const size_t length, const SrecTextOptions &options) {
+	// The file works out its own data records; nothing is written to it
+	SrecFile sizing(std::make_unique<SrecMemorySink>(), options.address_size, options.start_address);
+	sizing.set_layout(options.layout);
+	const size_t records = sizing.count_data_records(options.start_address, length);
+
+	uint64_t size = sizing.data_text_size(options.start_address, length);
+	if (options.want_checksum) {
+		size += sizing.empty_line_length(2) + 10; // S0 with the CRC and a null byte
+	}
+	size += sizing.empty_line_length(records <= 0xFFFF ? 2 : 3); // S5 or S6
+	size += with_record_codec(options.address_size, [&sizing](auto codec) {
+		return sizing.empty_line_length(decltype(codec)::ADDRESS_LENGTH); // termination
+	});
+	return static_cast<size_t>(size);
+}
+
+size_t SrecBufferConverter::to_srec(const uint8_t *data, const size_t length, char *out, const size_t capacity,
+                                    const SrecTextOptions &options) {
+	auto sink = std::make_unique<BufferSink>(out, capacity);
+	const BufferSink *buffer = sink.get();
+	SrecFile sfile(std::move(sink), options.address_size, options.start_address, FlushPolicy::ON_CLOSE,
+	               options.limits);
+	sfile.set_layout(options.layout);
+	sfile.set_stats(options.stats);
+
+	// The whole input is at hand, but patching the header keeps it one pass over the data
+	if (options.want_checksum) {
+		sfile.reserve_checksum_header();
+	}
+	sfile.write_data(data, length);
+	sfile.write_record_count();
+	sfile.write_record_termination();
+	if (options.want_checksum) {
+		SrecStatsTimer timer(options.stats, SrecStats::Phase::CHECKSUM);
+		const uint32_t crc = crc32_update(data, length, 0);
+		timer.stop();
+		sfile.write_checksum_header(crc);
+	}
+	if (SrecStats::ENABLED && options.stats) {
+		options.stats->bytes_in += length;
+	}
+	sfile.close();
+	return buffer->size();
+}
+
+std::string SrecBufferConverter::to_srec(const uint8_t *data, const size_t length, const SrecTextOptions &options) {
+	std::string text(srec_size(length, options), '\0');
+	text.resize(to_srec(data, length, text.data(), text.size(), options));
+	return text;
+}
+
+SrecBinaryExtent SrecBufferConverter::binary_extent(const char *text, const size_t size) {
+	SrecMetadataOptions options;
+	options.validate_checksums = false;
+	const SrecMetadata metadata = SrecMetadataScanner::scan(text, size, options);
+	return SrecBinaryExtent{metadata.start_address, metadata.end_address - metadata.start_address};
+}
+
+void SrecBufferConverter::to_binary(const char *text, const size_t size, const SrecBinaryExtent &extent, uint8_t *out,
+                                    const size_t capacity, const SrecImageOptions &options) {
+	if (capacity < extent.size) {
+		throw SrecFileException("Output buffer is too small");
+	}
+	std::memset(out, options.fill_byte, static_cast<size_t>(extent.size));
+
+	SrecStatsTimer timer(options.stats, SrecStats::Phase::DECODE);
+	SrecMappedReader reader(text, size, options.validate_checksums);
+	reader.set_stats(options.stats);
+	SrecStreamParser::ParsedRecordView record{};
+	const uint64_t end = extent.start_address + extent.size;
+	while (reader.next(record)) {
+		if (!is_data(record.type) || record.length == 0) {
+			continue;
+		}
+		if (record.address < extent.start_address || record.address + record.length > end) {
+			throw SrecFileException("Record lies outside the binary extent");
+		}
+		std::memcpy(out + (record.address - extent.start_address), record.data, record.length);
+	}
+	if (SrecStats::ENABLED && options.stats) {
+		options.stats->bytes_out += extent.size;
+	}
+}
+
+std::vector<uint8_t> SrecBufferConverter::to_binary(const char *text, const size_t size,
+                                                    const SrecImageOptions &options) {
+	const SrecBinaryExtent extent = binary_extent(text, size);
+	std::vector<uint8_t> binary(static_cast<size_t>(extent.size));
+	to_binary(text, size, extent, binary.data(), binary.size(), options);
+	return binary;
+}
+
+SrecMemoryImage SrecBufferConverter::to_image(const char *text, const size_t size, const SrecImageOptions &options) {
+	SrecMemoryImage image;
+	image.set_fill_byte(options.fill_byte);
+	SrecMappedReader reader(text, size, options.validate_checksums);
+	reader.set_stats(options.stats);
+	SrecStreamParser::ParsedRecordView record{};
+	while (reader.next(record)) {
+		image.add_record(record);
+	}
+	return image;
+}
+
+} // namespace tierone::srec
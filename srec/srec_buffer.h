@@ -0,0 +1,164 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "srec.h"
+#include "srec_image.h"
+#include "srec_stats.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief Options for binary to S-record conversion in memory
+ */
+struct SrecTextOptions {
+	SrecFile::AddressSize address_size{SrecFile::AddressSize::BITS32}; ///< Data record type S1, S2 or S3
+	uint32_t start_address{0};  ///< Address of the first byte; also the execution address
+	bool want_checksum{false};  ///< Start with a CRC32 header, as bin2srec --checksum
+	SrecLimits limits{};        ///< Limits on the records produced
+	SrecLayout layout{};        ///< Record length, alignment, line ending and stride
+	SrecStats *stats{nullptr};  ///< Statistics to update, or nullptr
+};
+
+/**
+ * @brief Options for S-record to binary conversion in memory
+ */
+struct SrecImageOptions {
+	uint8_t fill_byte{0x00};        ///< Value of addresses no record defines
+	bool validate_checksums{true};  ///< Whether to validate record checksums
+	SrecStats *stats{nullptr};      ///< Statistics to update, or nullptr
+};
+
+/**
+ * @brief Address extent of the data records of S-record text
+ */
+struct SrecBinaryExtent {
+	uint32_t start_address{0}; ///< Lowest data address
+	uint64_t size{0};          ///< Bytes from the lowest address to one past the highest; 0 if there is no data
+};
+
+/**
+ * @brief Buffer-to-buffer conversion without files
+ *
+ * The same conversions as bin2srec and srec2bin on memory: binary data to
+ * S-record text and S-record text to a flat binary or a sparse image.
+ * Output sizes can be computed up front, so a caller-provided buffer is
+ * filled in place and a returned buffer is allocated exactly once. The
+ * CRC32 header is patched into the output, never through a temporary file,
+ * and nothing is shared between calls, so conversions may run concurrently
+ * on different threads.
+ *
+ * The text is what convert_bin_to_srec() writes: an optional CRC32 header,
+ * full-length data records, a count record and a termination record.
+ *
+ * @code
+ * std::string text = SrecBufferConverter::to_srec(firmware.data(), firmware.size());
+ * std::vector<uint8_t> binary = SrecBufferConverter::to_binary(text.data(), text.size());
+ * @endcode
+ */
+class SrecBufferConverter {
+public:
+	/**
+	 * @brief Compute the exact length of the S-record text for binary data
+	 * @param length Number of data bytes
+	 * @param options Address size and checksum setting
+	 * @return Characters to_srec() produces
+	 */
+	static size_t srec_size(size_t length, const SrecTextOptions &options = SrecTextOptions());
+
+	/**
+	 * @brief Convert binary data to S-record text
+	 * @param data Binary data
+	 * @param length Number of bytes
+	 * @param options Conversion options
+	 * @return S-record text, allocated once at its final size
+	 * @throws SrecValidationException if the data does not fit the address size or the limits
+	 */
+	static std::string to_srec(const uint8_t *data, size_t length, const SrecTextOptions &options = SrecTextOptions());
+
+	/**
+	 * @brief Convert binary data to S-record text in a caller-provided buffer
+	 * @param data Binary data
+	 * @param length Number of bytes
+	 * @param out Output buffer
+	 * @param capacity Size of the output buffer; at least srec_size()
+	 * @param options Conversion options
+	 * @return Characters written
+	 * @throws SrecValidationException if the data does not fit the address size or the limits
+	 * @throws SrecFileException if the buffer is too small
+	 */
+	static size_t to_srec(const uint8_t *data, size_t length, char *out, size_t capacity,
+	                      const SrecTextOptions &options = SrecTextOptions());
+
+	/**
+	 * @brief Find the binary extent of S-record text
+	 *
+	 * Reads only the address fields of the data records, so this is much
+	 * cheaper than the conversion itself.
+	 *
+	 * @param text S-record text
+	 * @param size Number of characters
+	 * @return Start address and size of the flat binary
+	 * @throws SrecParseException if a record's fields cannot be read
+	 */
+	static SrecBinaryExtent binary_extent(const char *text, size_t size);
+
+	/**
+	 * @brief Convert S-record text to a flat binary
+	 * @param text S-record text
+	 * @param size Number of characters
+	 * @param options Fill byte and validation
+	 * @return Bytes from the lowest to the highest data address
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	static std::vector<uint8_t> to_binary(const char *text, size_t size,
+	                                      const SrecImageOptions &options = SrecImageOptions());
+
+	/**
+	 * @brief Convert S-record text to a flat binary in a caller-provided buffer
+	 * @param text S-record text
+	 * @param size Number of characters
+	 * @param extent Extent from binary_extent() for the same text
+	 * @param out Output buffer
+	 * @param capacity Size of the output buffer; at least extent.size
+	 * @param options Fill byte and validation
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 * @throws SrecFileException if the buffer is too small or a record lies outside the extent
+	 */
+	static void to_binary(const char *text, size_t size, const SrecBinaryExtent &extent, uint8_t *out,
+	                      size_t capacity, const SrecImageOptions &options = SrecImageOptions());
+
+	/**
+	 * @brief Load S-record text into a sparse image
+	 * @param text S-record text
+	 * @param size Number of characters
+	 * @param options Fill byte and validation
+	 * @return Image of the data records
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	static SrecMemoryImage to_image(const char *text, size_t size, const SrecImageOptions &options = SrecImageOptions());
+};
+
+} // namespace tierone::srec
@@ -0,0 +1,273 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include "srec.h"
+#include "srec_hex.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief Data and termination record layout for one address width
+ *
+ * Everything that depends on the address width is a compile-time constant,
+ * so loops instantiated over a codec format and decode records without
+ * virtual calls or address-width branches. Use with_record_codec() to
+ * select the codec once, at run time, for a whole file.
+ *
+ * @tparam Size Address width
+ */
+template <SrecFile::AddressSize Size>
+struct RecordCodec {
+	/// Address width this codec handles
+	static constexpr SrecFile::AddressSize ADDRESS_SIZE = Size;
+
+	/// Number of address bytes in data and termination records
+	static constexpr size_t ADDRESS_LENGTH =
+		(Size == SrecFile::AddressSize::BITS16) ? 2 : (Size == SrecFile::AddressSize::BITS24) ? 3 : 4;
+
+	/// Highest address the address field can hold
+	static constexpr uint32_t MAX_ADDRESS =
+		(ADDRESS_LENGTH == 4) ? 0xFFFFFFFFu : (1u << (ADDRESS_LENGTH * 8)) - 1;
+
+	/// Payload bytes per record, as SrecFile::max_data_bytes_per_record()
+	static constexpr size_t MAX_PAYLOAD = 255 - 1 - (ADDRESS_LENGTH * 2) - 1;
+
+	/// Data record type (S1, S2 or S3)
+	static constexpr Srec::Type DATA_TYPE =
+		(ADDRESS_LENGTH == 2) ? Srec::Type::S1 : (ADDRESS_LENGTH == 3) ? Srec::Type::S2 : Srec::Type::S3;
+
+	/// Termination record type (S9, S8 or S7)
+	static constexpr Srec::Type TERMINATION_TYPE =
+		(ADDRESS_LENGTH == 2) ? Srec::Type::S9 : (ADDRESS_LENGTH == 3) ? Srec::Type::S8 : Srec::Type::S7;
+
+	static constexpr char DATA_TYPE_CHAR = static_cast<char>('0' + (ADDRESS_LENGTH - 1));        ///< '1'-'3'
+	static constexpr char TERMINATION_TYPE_CHAR = static_cast<char>('0' + (11 - ADDRESS_LENGTH)); ///< '9'-'7'
+
+	/**
+	 * @brief Format a data record
+	 * @param address Record address
+	 * @param data Payload bytes (may be nullptr if length is 0)
+	 * @param length Number of payload bytes
+	 * @param out Destination buffer, at least MAX_RECORD_LINE_LENGTH chars
+	 * @return Number of characters written (no line terminator)
+	 * @throws SrecValidationException if the record would exceed 255 bytes
+	 * @throws SrecAddressException if the address does not fit the address field
+	 */
+	static size_t format_data(uint32_t address, const uint8_t *data, size_t length, char *out) {
+		return format(DATA_TYPE_CHAR, address, data, length, out);
+	}
+
+	/**
+	 * @brief Format a termination record
+	 * @param address Execution address
+	 * @param out Destination buffer, at least MAX_RECORD_LINE_LENGTH chars
+	 * @return Number of characters written (no line terminator)
+	 * @throws SrecAddressException if the address does not fit the address field
+	 */
+	static size_t format_termination(uint32_t address, char *out) {
+		return format(TERMINATION_TYPE_CHAR, address, nullptr, 0, out);
+	}
+
+	/**
+	 * @brief Decode a well-formed data record of this width
+	 *
+	 * Only the common case is handled here: a data record of this codec's
+	 * type with a consistent length, valid hex digits and (if requested) a
+	 * matching checksum. Anything else returns false without throwing, and
+	 * the caller passes the line to SrecStreamParser::parse_line(), which
+	 * accepts every record type and reports errors.
+	 *
+	 * @param line S-record line (no line terminator)
+	 * @param line_number Line number stored in the record
+	 * @param validate_checksum Whether the checksum must match
+	 * @param payload Buffer of at least MAX_RECORD_DATA_SIZE bytes
+	 * @param record Receives the parsed record
+	 * @return true if the line was decoded
+	 */
+	static bool parse_data(std::string_view line, size_t line_number, bool validate_checksum, uint8_t *payload,
+	                       SrecStreamParser::ParsedRecordView &record) {
+		constexpr size_t MIN_LENGTH = 4 + ((ADDRESS_LENGTH + 1) * 2);
+		if (line.size() < MIN_LENGTH || line[0] != 'S' || line[1] != DATA_TYPE_CHAR) {
+			return false;
+		}
+
+		// The fixed-size fields are decoded inline; only the payload goes
+		// through the (vectorized) hex kernel
+		std::array<uint8_t, 1 + ADDRESS_LENGTH> header;
+		uint32_t sum = 0;
+		if (!decode_fixed(line.data() + 2, header, sum)) {
+			return false;
+		}
+		const size_t byte_count = header[0];
+		if (line.size() != 4 + (byte_count * 2) || byte_count < ADDRESS_LENGTH + 1) {
+			return false;
+		}
+
+		const size_t length = byte_count - ADDRESS_LENGTH - 1;
+		uint32_t payload_sum = 0;
+		std::array<uint8_t, 1> checksum_field;
+		uint32_t checksum_sum = 0;
+		if (!hex_decode(line.data() + MIN_LENGTH - 2, length, payload, payload_sum) ||
+		    !decode_fixed(line.data() + line.size() - 2, checksum_field, checksum_sum)) {
+			return false;
+		}
+		const uint8_t checksum = checksum_field[0];
+		if (validate_checksum && static_cast<uint8_t>(~(sum + payload_sum) & 0xFF) != checksum) {
+			return false;
+		}
+
+		uint32_t address = 0;
+		for (size_t i = 1; i <= ADDRESS_LENGTH; ++i) {
+			address = (address << 8) | header[i];
+		}
+		record.type = DATA_TYPE;
+		record.address = address;
+		record.data = payload;
+		record.length = length;
+		record.checksum = checksum;
+		record.checksum_valid = true;
+		record.line_number = line_number;
+		return true;
+	}
+
+private:
+	static int hex_value(const char c) {
+		if (c >= '0' && c <= '9') {
+			return c - '0';
+		}
+		const int lower = c | 0x20;
+		return (lower >= 'a' && lower <= 'f') ? lower - 'a' + 10 : -1;
+	}
+
+	template <size_t N>
+	static bool decode_fixed(const char *in, std::array<uint8_t, N> &out, uint32_t &sum) {
+		for (size_t i = 0; i < N; ++i) {
+			const int high = hex_value(in[i * 2]);
+			const int low = hex_value(in[(i * 2) + 1]);
+			if ((high | low) < 0) {
+				return false;
+			}
+			out[i] = static_cast<uint8_t>((high << 4) | low);
+			sum += out[i];
+		}
+		return true;
+	}
+
+	static size_t format(const char type_char, const uint32_t address, const uint8_t *data, const size_t length,
+	                     char *out) {
+		if (length > 254 - ADDRESS_LENGTH) { // 255 - 1 for checksum
+			throw SrecValidationException(
+				"Record data size exceeds maximum of 254 bytes",
+				SrecValidationException::ValidationError::DATA_TOO_LARGE
+			);
+		}
+		if (address > MAX_ADDRESS) {
+			throw SrecAddressException(address, MAX_ADDRESS);
+		}
+
+		std::array<uint8_t, 1 + ADDRESS_LENGTH> header;
+		header[0] = static_cast<uint8_t>(ADDRESS_LENGTH + length + 1); // address + data + checksum
+		for (size_t i = 0; i < ADDRESS_LENGTH; ++i) {
+			header[ADDRESS_LENGTH - i] = static_cast<uint8_t>((address >> (i * 8)) & 0xFF);
+		}
+
+		out[0] = 'S';
+		out[1] = type_char;
+		uint32_t sum = hex_encode(header.data(), header.size(), out + 2);
+		char *tail = out + 2 + (header.size() * 2);
+		if (length > 0) {
+			sum += hex_encode(data, length, tail);
+			tail += length * 2;
+		}
+		const auto checksum = static_cast<uint8_t>(~sum & 0xFF);
+		hex_encode(&checksum, 1, tail);
+		return static_cast<size_t>(tail - out) + 2;
+	}
+};
+
+/**
+ * @brief Call a function with the codec for an address width
+ *
+ * The function is instantiated once per width and receives a default
+ * constructed RecordCodec, typically as an 'auto' lambda parameter:
+ *
+ * @code
+ * with_record_codec(size, [&](auto codec) {
+ *     using Codec = decltype(codec);
+ *     ... Codec::format_data(...) ...
+ * });
+ * @endcode
+ *
+ * @param size Address width
+ * @param function Function to call
+ * @return Whatever the function returns
+ * @throws SrecValidationException if the address size is invalid
+ */
+template <typename Function>
+decltype(auto) with_record_codec(const SrecFile::AddressSize size, Function &&function) {
+	switch (size) {
+		case SrecFile::AddressSize::BITS16:
+			return function(RecordCodec<SrecFile::AddressSize::BITS16>{});
+		case SrecFile::AddressSize::BITS24:
+			return function(RecordCodec<SrecFile::AddressSize::BITS24>{});
+		case SrecFile::AddressSize::BITS32:
+			return function(RecordCodec<SrecFile::AddressSize::BITS32>{});
+		default:
+			throw SrecValidationException("Invalid address size", SrecValidationException::ValidationError::INVALID_FORMAT);
+	}
+}
+
+/**
+ * @brief Signature of RecordCodec::parse_data
+ */
+using DataRecordParser = bool (*)(std::string_view line, size_t line_number, bool validate_checksum,
+                                  uint8_t *payload, SrecStreamParser::ParsedRecordView &record);
+
+/**
+ * @brief Get the fast data record decoder for a record type
+ *
+ * Readers call this once, for the first data record of a file, and use the
+ * result for the following lines.
+ *
+ * @param type Record type
+ * @return RecordCodec::parse_data for S1/S2/S3, nullptr for other types
+ */
+inline DataRecordParser data_record_parser(const Srec::Type type) {
+	switch (type) {
+		case Srec::Type::S1:
+			return &RecordCodec<SrecFile::AddressSize::BITS16>::parse_data;
+		case Srec::Type::S2:
+			return &RecordCodec<SrecFile::AddressSize::BITS24>::parse_data;
+		case Srec::Type::S3:
+			return &RecordCodec<SrecFile::AddressSize::BITS32>::parse_data;
+		case Srec::Type::S0:
+		case Srec::Type::S5:
+		case Srec::Type::S6:
+		case Srec::Type::S7:
+		case Srec::Type::S8:
+		case Srec::Type::S9:
+		default:
+			return nullptr;
+	}
+}
+
+} // namespace tierone::srec
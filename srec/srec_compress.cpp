@@ -0,0 +1,606 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <fstream>
+
+#if defined(SREC_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(SREC_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+#include "srec_compress.h"
+
+namespace tierone::srec {
+
+namespace {
+
+// Compressed bytes read from the file at a time
+constexpr size_t INPUT_BLOCK_SIZE = 256 * 1024;
+
+// Compressed bytes produced per encoder call
+constexpr size_t OUTPUT_CHUNK_SIZE = 64 * 1024;
+
+bool ends_with(const std::string &text, const std::string &suffix) {
+	return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void require_support(const SrecCompression format, const std::string &filename) {
+	if (!compression_supported(format)) {
+		throw SrecFileException(std::string("Library built without ") + compression_name(format) + " support", filename);
+	}
+}
+
+} // namespace
+
+bool compression_supported(const SrecCompression format) {
+	switch (format) {
+		case SrecCompression::NONE:
+			return true;
+		case SrecCompression::GZIP:
+#if defined(SREC_HAVE_ZLIB)
+			return true;
+#else
+			return false;
+#endif
+		case SrecCompression::ZSTD:
+#if defined(SREC_HAVE_ZSTD)
+			return true;
+#else
+			return false;
+#endif
+		default:
+			return false;
+	}
+}
+
+const char *compression_name(const SrecCompression format) {
+	switch (format) {
+		case SrecCompression::NONE:
+			return "none";
+		case SrecCompression::GZIP:
+			return "gzip";
+		case SrecCompression::ZSTD:
+			return "zstd";
+		default:
+			return "unknown";
+	}
+}
+
+SrecCompression compression_for_filename(const std::string &filename) {
+	if (ends_with(filename, ".gz")) {
+		return SrecCompression::GZIP;
+	}
+	if (ends_with(filename, ".zst")) {
+		return SrecCompression::ZSTD;
+	}
+	return SrecCompression::NONE;
+}
+
+SrecCompression detect_compression(const std::string &filename) {
+	std::ifstream file(filename, std::ios::binary);
+	std::array<unsigned char, 4> magic{};
+	file.read(reinterpret_cast<char *>(magic.data()), static_cast<std::streamsize>(magic.size()));
+	const auto count = static_cast<size_t>(file.gcount());
+	if (count >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+		return SrecCompression::GZIP;
+	}
+	if (count == 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) {
+		return SrecCompression::ZSTD;
+	}
+	return SrecCompression::NONE;
+}
+
+// Compressor behind SrecCompressedSink
+class SrecCompressedSink::Encoder {
+public:
+	virtual ~Encoder() = default;
+
+	// Compress 'length' characters, appending the output produced to 'out'
+	virtual void encode(const char *data, size_t length, EncodeMode mode, std::vector<char> &out) = 0;
+};
+
+namespace {
+
+#if defined(SREC_HAVE_ZLIB)
+class GzipEncoder : public SrecCompressedSink::Encoder {
+public:
+	explicit GzipEncoder(const int level) {
+		// 15 window bits plus 16 selects a gzip wrapper
+		if (deflateInit2(&stream, level < 0 ? Z_DEFAULT_COMPRESSION : level, Z_DEFLATED, 15 + 16, 8,
+		                 Z_DEFAULT_STRATEGY) != Z_OK) {
+			throw SrecFileException("Failed to initialize gzip compression");
+		}
+	}
+
+	~GzipEncoder() override {
+		deflateEnd(&stream);
+	}
+
+	GzipEncoder(const GzipEncoder &) = delete;
+	GzipEncoder &operator=(const GzipEncoder &) = delete;
+
+	void encode(const char *data, size_t length, const SrecCompressedSink::EncodeMode mode, std::vector<char> &out) override {
+		do {
+			// zlib counts in uInt; hand over very large writes piecewise
+			const size_t piece = std::min<size_t>(length, UINT_MAX);
+			const bool last = piece == length;
+			const int flush = !last || mode == SrecCompressedSink::EncodeMode::RUN ? Z_NO_FLUSH
+				: mode == SrecCompressedSink::EncodeMode::FLUSH ? Z_SYNC_FLUSH : Z_FINISH;
+			stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+			stream.avail_in = static_cast<uInt>(piece);
+			int result = Z_OK;
+			do {
+				const size_t offset = out.size();
+				out.resize(offset + OUTPUT_CHUNK_SIZE);
+				stream.next_out = reinterpret_cast<Bytef *>(out.data() + offset);
+				stream.avail_out = static_cast<uInt>(OUTPUT_CHUNK_SIZE);
+				result = deflate(&stream, flush);
+				if (result == Z_STREAM_ERROR) {
+					throw SrecFileException("gzip compression failed");
+				}
+				out.resize(offset + OUTPUT_CHUNK_SIZE - stream.avail_out);
+			} while (flush == Z_FINISH ? result != Z_STREAM_END : stream.avail_out == 0);
+			data += piece;
+			length -= piece;
+		} while (length > 0);
+	}
+
+private:
+	z_stream stream{};
+};
+#endif
+
+#if defined(SREC_HAVE_ZSTD)
+class ZstdEncoder : public SrecCompressedSink::Encoder {
+public:
+	explicit ZstdEncoder(const int level) : context(ZSTD_createCCtx()) {
+		if (context == nullptr) {
+			throw SrecFileException("Failed to initialize zstd compression");
+		}
+		if (level >= 0) {
+			ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, level);
+		}
+	}
+
+	~ZstdEncoder() override {
+		ZSTD_freeCCtx(context);
+	}
+
+	ZstdEncoder(const ZstdEncoder &) = delete;
+	ZstdEncoder &operator=(const ZstdEncoder &) = delete;
+
+	void encode(const char *data, const size_t length, const SrecCompressedSink::EncodeMode mode,
+	            std::vector<char> &out) override {
+		const ZSTD_EndDirective directive = mode == SrecCompressedSink::EncodeMode::RUN ? ZSTD_e_continue
+			: mode == SrecCompressedSink::EncodeMode::FLUSH ? ZSTD_e_flush : ZSTD_e_end;
+		ZSTD_inBuffer input{data, length, 0};
+		for (;;) {
+			const size_t offset = out.size();
+			out.resize(offset + OUTPUT_CHUNK_SIZE);
+			ZSTD_outBuffer output{out.data() + offset, OUTPUT_CHUNK_SIZE, 0};
+			const size_t remaining = ZSTD_compressStream2(context, &output, &input, directive);
+			if (ZSTD_isError(remaining)) {
+				throw SrecFileException(std::string("zstd compression failed: ") + ZSTD_getErrorName(remaining));
+			}
+			out.resize(offset + output.pos);
+			if (directive == ZSTD_e_continue ? input.pos == input.size : remaining == 0) {
+				break;
+			}
+		}
+	}
+
+private:
+	ZSTD_CCtx *context;
+};
+#endif
+
+std::unique_ptr<SrecCompressedSink::Encoder> make_encoder(const SrecCompression format, const int level) {
+	require_support(format, std::string());
+	switch (format) {
+		case SrecCompression::GZIP:
+#if defined(SREC_HAVE_ZLIB)
+			return std::make_unique<GzipEncoder>(level);
+#else
+			break;
+#endif
+		case SrecCompression::ZSTD:
+#if defined(SREC_HAVE_ZSTD)
+			return std::make_unique<ZstdEncoder>(level);
+#else
+			break;
+#endif
+		case SrecCompression::NONE:
+		default:
+			break;
+	}
+	(void)level;
+	throw SrecFileException("A compressed sink needs a compression format");
+}
+
+} // namespace
+
+SrecCompressedSink::SrecCompressedSink(std::unique_ptr<SrecSink> target, const SrecCompression format, const int level)
+	: inner(std::move(target)),
+	  encoder(make_encoder(format, level))
+{
+	staging.reserve(STAGING_SIZE);
+}
+
+SrecCompressedSink::~SrecCompressedSink() {
+	try {
+		close();
+	} catch (const SrecException &) {
+		// Destructors must not throw; call close() to observe errors
+	}
+}
+
+void SrecCompressedSink::compress(const EncodeMode mode) {
+	std::vector<char> out;
+	encoder->encode(staging.data(), staging.size(), mode, out);
+	staging.clear();
+	if (!out.empty()) {
+		inner->write(out.data(), out.size());
+		produced += out.size();
+	}
+}
+
+void SrecCompressedSink::write(const char *data, const size_t length) {
+	if (closed) {
+		throw SrecFileException("Compressed sink is closed");
+	}
+	staging.insert(staging.end(), data, data + length);
+	if (staging.size() >= STAGING_SIZE) {
+		compress(EncodeMode::RUN);
+	}
+}
+
+void SrecCompressedSink::flush() {
+	if (closed) {
+		return;
+	}
+	compress(EncodeMode::FLUSH);
+	inner->flush();
+}
+
+void SrecCompressedSink::sync() {
+	flush();
+	inner->sync();
+}
+
+void SrecCompressedSink::close() {
+	if (closed) {
+		return;
+	}
+	closed = true;
+	compress(EncodeMode::FINISH);
+	inner->close();
+}
+
+bool SrecCompressedSink::is_open() const {
+	return !closed && inner->is_open();
+}
+
+std::unique_ptr<SrecSink> open_output_sink(const std::string &filename, const int level) {
+	const SrecCompression format = compression_for_filename(filename);
+	require_support(format, filename);
+	auto file = std::make_unique<SrecFileSink>(filename);
+	if (format == SrecCompression::NONE || !file->is_open()) {
+		return file;
+	}
+	return std::make_unique<SrecAsyncSink>(std::make_unique<SrecCompressedSink>(std::move(file), format, level));
+}
+
+// Produces the decompressed contents of a file
+class SrecDecompressStream::Decoder {
+public:
+	explicit Decoder(const std::string &file_name)
+		: filename(file_name),
+		  file(file_name, std::ios::binary)
+	{
+		if (!file.is_open()) {
+			throw SrecFileException("Failed to open file", filename);
+		}
+	}
+
+	virtual ~Decoder() = default;
+
+	Decoder(const Decoder &) = delete;
+	Decoder &operator=(const Decoder &) = delete;
+
+	// Decompress up to 'capacity' characters; returns 0 at the end
+	virtual size_t read(char *out, size_t capacity) = 0;
+
+protected:
+	// Read the next compressed block into 'input'; false at end of file
+	bool refill() {
+		input.resize(INPUT_BLOCK_SIZE);
+		file.read(input.data(), static_cast<std::streamsize>(input.size()));
+		if (file.bad()) {
+			throw SrecFileException("Failed to read file", filename);
+		}
+		input.resize(static_cast<size_t>(file.gcount()));
+		position = 0;
+		return !input.empty();
+	}
+
+	std::string filename;
+	std::ifstream file;
+	std::vector<char> input;
+	size_t position{0}; // next unused character of 'input'
+};
+
+namespace {
+
+class PlainDecoder : public SrecDecompressStream::Decoder {
+public:
+	using Decoder::Decoder;
+
+	size_t read(char *out, const size_t capacity) override {
+		file.read(out, static_cast<std::streamsize>(capacity));
+		if (file.bad()) {
+			throw SrecFileException("Failed to read file", filename);
+		}
+		return static_cast<size_t>(file.gcount());
+	}
+};
+
+#if defined(SREC_HAVE_ZLIB)
+class GzipDecoder : public SrecDecompressStream::Decoder {
+public:
+	explicit GzipDecoder(const std::string &file_name) : Decoder(file_name) {
+		// 15 window bits plus 32 accepts gzip and zlib streams
+		if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+			throw SrecFileException("Failed to initialize gzip decompression", filename);
+		}
+	}
+
+	~GzipDecoder() override {
+		inflateEnd(&stream);
+	}
+
+	GzipDecoder(const GzipDecoder &) = delete;
+	GzipDecoder &operator=(const GzipDecoder &) = delete;
+
+	size_t read(char *out, const size_t capacity) override {
+		stream.next_out = reinterpret_cast<Bytef *>(out);
+		stream.avail_out = static_cast<uInt>(std::min<size_t>(capacity, UINT_MAX));
+		const uInt requested = stream.avail_out;
+		while (stream.avail_out > 0) {
+			if (stream.avail_in == 0) {
+				if (!refill()) {
+					if (in_member) {
+						throw SrecFileException("Truncated gzip data", filename);
+					}
+					break;
+				}
+				stream.next_in = reinterpret_cast<Bytef *>(input.data());
+				stream.avail_in = static_cast<uInt>(input.size());
+			}
+			const int result = inflate(&stream, Z_NO_FLUSH);
+			if (result == Z_STREAM_END) {
+				// Concatenated members form one stream, as with gunzip
+				in_member = false;
+				inflateReset(&stream);
+				continue;
+			}
+			if (result != Z_OK && result != Z_BUF_ERROR) {
+				throw SrecFileException("Corrupt gzip data", filename);
+			}
+			in_member = true;
+		}
+		return requested - stream.avail_out;
+	}
+
+private:
+	z_stream stream{};
+	bool in_member{false};
+};
+#endif
+
+#if defined(SREC_HAVE_ZSTD)
+class ZstdDecoder : public SrecDecompressStream::Decoder {
+public:
+	explicit ZstdDecoder(const std::string &file_name) : Decoder(file_name), context(ZSTD_createDCtx()) {
+		if (context == nullptr) {
+			throw SrecFileException("Failed to initialize zstd decompression", filename);
+		}
+	}
+
+	~ZstdDecoder() override {
+		ZSTD_freeDCtx(context);
+	}
+
+	ZstdDecoder(const ZstdDecoder &) = delete;
+	ZstdDecoder &operator=(const ZstdDecoder &) = delete;
+
+	size_t read(char *out, const size_t capacity) override {
+		ZSTD_outBuffer output{out, capacity, 0};
+		while (output.pos < output.size) {
+			const bool at_end = position == input.size() && !refill();
+			ZSTD_inBuffer in{input.data() + position, input.size() - position, 0};
+			const size_t before = output.pos;
+			const size_t result = ZSTD_decompressStream(context, &output, &in);
+			if (ZSTD_isError(result)) {
+				throw SrecFileException(std::string("Corrupt zstd data: ") + ZSTD_getErrorName(result), filename);
+			}
+			position += in.pos;
+			if (in.pos > 0 || output.pos > before) {
+				// 0 once a frame is complete; a call without progress only returns a size hint
+				pending = result;
+			}
+			if (at_end && output.pos == before) {
+				if (pending != 0) {
+					throw SrecFileException("Truncated zstd data", filename);
+				}
+				break;
+			}
+		}
+		return output.pos;
+	}
+
+private:
+	ZSTD_DCtx *context;
+	size_t pending{0}; // non-zero while a frame is incomplete
+};
+#endif
+
+std::unique_ptr<SrecDecompressStream::Decoder> make_decoder(const std::string &filename, const SrecCompression format) {
+	require_support(format, filename);
+	switch (format) {
+		case SrecCompression::GZIP:
+#if defined(SREC_HAVE_ZLIB)
+			return std::make_unique<GzipDecoder>(filename);
+#else
+			break;
+#endif
+		case SrecCompression::ZSTD:
+#if defined(SREC_HAVE_ZSTD)
+			return std::make_unique<ZstdDecoder>(filename);
+#else
+			break;
+#endif
+		case SrecCompression::NONE:
+		default:
+			break;
+	}
+	return std::make_unique<PlainDecoder>(filename);
+}
+
+} // namespace
+
+SrecDecompressStream::Buffer::Buffer(const std::string &filename, const size_t size, const size_t count)
+	: format(detect_compression(filename)),
+	  decoder(make_decoder(filename, format)),
+	  block_size(std::max<size_t>(size, 1)),
+	  spare(std::max<size_t>(count, 1))
+{
+	worker = std::thread(&Buffer::decode_loop, this);
+}
+
+SrecDecompressStream::Buffer::~Buffer() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	changed.notify_all();
+	worker.join();
+}
+
+void SrecDecompressStream::Buffer::decode_loop() {
+	try {
+		for (;;) {
+			std::vector<char> block;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				changed.wait(lock, [this] { return stop || !spare.empty(); });
+				if (stop) {
+					return;
+				}
+				block = std::move(spare.back());
+				spare.pop_back();
+			}
+
+			block.resize(block_size);
+			size_t used = 0;
+			bool end = false;
+			while (used < block_size && !end) {
+				const size_t count = decoder->read(block.data() + used, block_size - used);
+				used += count;
+				end = count == 0;
+			}
+			block.resize(used);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (used > 0) {
+					ready.push_back(std::move(block));
+				}
+				finished = end;
+			}
+			changed.notify_all();
+			if (end) {
+				return;
+			}
+		}
+	} catch (...) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			error = std::current_exception();
+			finished = true;
+		}
+		changed.notify_all();
+	}
+}
+
+SrecDecompressStream::Buffer::int_type SrecDecompressStream::Buffer::underflow() {
+	if (gptr() < egptr()) {
+		return traits_type::to_int_type(*gptr());
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	if (holding) {
+		spare.push_back(std::move(current));
+		holding = false;
+		changed.notify_all();
+	}
+	changed.wait(lock, [this] { return !ready.empty() || finished; });
+	if (ready.empty()) {
+		setg(nullptr, nullptr, nullptr);
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		return traits_type::eof();
+	}
+	current = std::move(ready.front());
+	ready.pop_front();
+	holding = true;
+	lock.unlock();
+
+	setg(current.data(), current.data(), current.data() + current.size());
+	return traits_type::to_int_type(*gptr());
+}
+
+SrecDecompressStream::SrecDecompressStream(const std::string &filename, const size_t block_size,
+                                           const size_t block_count)
+	: std::istream(nullptr),
+	  buffer(filename, block_size, block_count)
+{
+	rdbuf(&buffer);
+	exceptions(std::ios::badbit);
+}
+
+SrecDecompressStream::~SrecDecompressStream() = default;
+
+SrecCompression SrecDecompressStream::format() const {
+	return buffer.format;
+}
+
+std::string SrecDecompressStream::read_file(const std::string &filename) {
+	SrecDecompressStream input(filename);
+	std::string text;
+	std::vector<char> block(DEFAULT_BLOCK_SIZE);
+	while (input.read(block.data(), static_cast<std::streamsize>(block.size())) || input.gcount() > 0) {
+		text.append(block.data(), static_cast<size_t>(input.gcount()));
+	}
+	return text;
+}
+
+} // namespace tierone::srec
@@ -0,0 +1,251 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "srec_sink.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief Compression formats for S-record files
+ *
+ * Support for each format is optional and detected when the library is
+ * built (zlib for GZIP, libzstd for ZSTD); see compression_supported().
+ */
+enum class SrecCompression {
+	NONE, ///< Plain text
+	GZIP, ///< gzip (.gz)
+	ZSTD  ///< Zstandard (.zst)
+};
+
+/**
+ * @brief Check whether the library was built with a compression format
+ * @param format Format to check
+ * @return true if files of this format can be read and written
+ */
+bool compression_supported(SrecCompression format);
+
+/**
+ * @brief Get a printable name for a compression format
+ * @param format Format to name
+ * @return Format name, e.g. "gzip"
+ */
+const char *compression_name(SrecCompression format);
+
+/**
+ * @brief Choose the compression format of an output file by its extension
+ * @param filename File name
+ * @return GZIP for ".gz", ZSTD for ".zst", otherwise NONE
+ */
+SrecCompression compression_for_filename(const std::string &filename);
+
+/**
+ * @brief Detect the compression format of a file from its magic bytes
+ * @param filename Path to the file
+ * @return Detected format; NONE for plain text or unreadable files
+ */
+SrecCompression detect_compression(const std::string &filename);
+
+/**
+ * @brief Sink that compresses its output into another sink
+ *
+ * Input is staged and compressed in blocks. flush() ends the current
+ * compressed block so that everything written so far can be decompressed,
+ * then flushes the target; close() finishes the stream. Compressed output
+ * cannot be patched, so checksummed conversions compute the CRC up front.
+ *
+ * Wrap the sink in an SrecAsyncSink to compress on a separate thread
+ * while records are formatted; open_output_sink() does that.
+ *
+ * @note This class is not thread-safe
+ */
+class SrecCompressedSink : public SrecSink {
+public:
+	/// Use the format's default compression level
+	static constexpr int DEFAULT_LEVEL = -1;
+
+	/// Characters staged before a block is compressed
+	static constexpr size_t STAGING_SIZE = 64 * 1024;
+
+	/**
+	 * @brief Compress into another sink
+	 * @param target Sink receiving the compressed output
+	 * @param format GZIP or ZSTD
+	 * @param level Compression level (gzip 1-9, zstd 1-19), or DEFAULT_LEVEL
+	 * @throws SrecFileException if the format is NONE or not supported by this build
+	 */
+	SrecCompressedSink(std::unique_ptr<SrecSink> target, SrecCompression format, int level = DEFAULT_LEVEL);
+
+	/**
+	 * @brief Destructor - finishes the stream and closes, ignoring errors
+	 */
+	~SrecCompressedSink() override;
+
+	SrecCompressedSink(const SrecCompressedSink &) = delete;
+	SrecCompressedSink &operator=(const SrecCompressedSink &) = delete;
+
+	void write(const char *data, size_t length) override;
+	void flush() override;
+	void sync() override;
+	void close() override;
+	bool is_open() const override;
+
+	/**
+	 * @brief Get the number of compressed bytes produced so far
+	 * @return Bytes passed to the target
+	 */
+	uint64_t compressed_bytes() const {
+		return produced;
+	}
+
+	class Encoder;
+
+	/// How far a block of input is pushed through the encoder
+	enum class EncodeMode {
+		RUN,    ///< Compress what fills whole blocks
+		FLUSH,  ///< End the block so all input so far can be decompressed
+		FINISH  ///< End the stream
+	};
+
+private:
+	void compress(EncodeMode mode);
+
+	std::unique_ptr<SrecSink> inner;
+	std::unique_ptr<Encoder> encoder;
+	std::vector<char> staging;
+	uint64_t produced{0};
+	bool closed{false};
+};
+
+/**
+ * @brief Create a sink for an output file, compressed according to its extension
+ *
+ * Names ending in ".gz" or ".zst" get an SrecCompressedSink, compressing
+ * on a background thread through SrecAsyncSink; other names get a plain
+ * SrecFileSink.
+ *
+ * @param filename Path to the output file
+ * @param level Compression level, or SrecCompressedSink::DEFAULT_LEVEL
+ * @return Sink for SrecFile
+ * @throws SrecFileException if the file cannot be created or its compression is not supported
+ */
+std::unique_ptr<SrecSink> open_output_sink(const std::string &filename,
+                                           int level = SrecCompressedSink::DEFAULT_LEVEL);
+
+/**
+ * @brief Input stream decompressing a file on a background thread
+ *
+ * A worker thread reads and decompresses the file into a small ring of
+ * blocks while the consumer parses the previous ones, so reading is
+ * limited by the slower of decompression and parsing rather than by
+ * their sum. Plain files are passed through, so any S-record file can be
+ * opened this way.
+ *
+ * Errors of the worker (read errors, corrupt or truncated data) are
+ * thrown from the read that reaches them; the stream sets
+ * exceptions(badbit) so they propagate through std::istream.
+ *
+ * @code
+ * SrecDecompressStream input("firmware.s37.gz");
+ * SrecReader reader(input);
+ * @endcode
+ */
+class SrecDecompressStream : public std::istream {
+public:
+	/// Default size of each decompressed block
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+	/// Default number of blocks decompressed ahead of the consumer
+	static constexpr size_t DEFAULT_BLOCK_COUNT = 4;
+
+	/**
+	 * @brief Open a file for reading
+	 * @param filename Path to the file
+	 * @param block_size Size of each decompressed block (default: 256 KiB)
+	 * @param block_count Blocks decompressed ahead (default: 4)
+	 * @throws SrecFileException if the file cannot be opened or its format is not supported
+	 */
+	explicit SrecDecompressStream(const std::string &filename, size_t block_size = DEFAULT_BLOCK_SIZE,
+	                              size_t block_count = DEFAULT_BLOCK_COUNT);
+
+	~SrecDecompressStream() override;
+
+	SrecDecompressStream(const SrecDecompressStream &) = delete;
+	SrecDecompressStream &operator=(const SrecDecompressStream &) = delete;
+
+	/**
+	 * @brief Get the detected format of the file
+	 * @return Compression format
+	 */
+	SrecCompression format() const;
+
+	/**
+	 * @brief Read a whole file, decompressing it if needed
+	 * @param filename Path to the file
+	 * @return Decompressed contents
+	 * @throws SrecFileException on I/O errors or corrupt data
+	 */
+	static std::string read_file(const std::string &filename);
+
+	class Decoder;
+
+private:
+	// Stream buffer handing out the blocks of the worker thread
+	class Buffer : public std::streambuf {
+	public:
+		Buffer(const std::string &filename, size_t block_size, size_t block_count);
+		~Buffer() override;
+
+		SrecCompression format{SrecCompression::NONE};
+
+	protected:
+		int_type underflow() override;
+
+	private:
+		void decode_loop();
+
+		std::unique_ptr<Decoder> decoder;
+		size_t block_size;
+		std::vector<char> current;              // block being consumed
+		bool holding{false};                    // whether 'current' came from the worker
+		std::deque<std::vector<char>> ready;    // decompressed blocks in order
+		std::vector<std::vector<char>> spare;   // empty blocks for the worker
+		bool finished{false};
+		bool stop{false};
+		std::exception_ptr error;
+		std::mutex mutex;
+		std::condition_variable changed;
+		std::thread worker;
+	};
+
+	Buffer buffer;
+};
+
+} // namespace tierone::srec
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Internal helpers for runtime CPU feature detection. Not installed.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SREC_ARCH_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SREC_ARCH_ARM64 1
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+// Compile a single function for an instruction set extension without
+// raising the baseline of the whole library
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SREC_TARGET(features)
+#else
+#define SREC_TARGET(features) __attribute__((target(features)))
+#endif
+
+namespace tierone::srec::cpu {
+
+#if defined(SREC_ARCH_X86)
+
+struct X86Features {
+	bool sse41{false};
+	bool pclmul{false};
+	bool avx2{false};
+};
+
+inline X86Features detect_x86() {
+	X86Features features;
+	unsigned int regs[4] = {0, 0, 0, 0}; // eax, ebx, ecx, edx
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 0);
+	const auto max_leaf = static_cast<unsigned int>(info[0]);
+	__cpuid(info, 1);
+	for (int i = 0; i < 4; ++i) {
+		regs[i] = static_cast<unsigned int>(info[i]);
+	}
+#else
+	const unsigned int max_leaf = __get_cpuid_max(0, nullptr);
+	__get_cpuid(1, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+	features.sse41 = (regs[2] & (1u << 19)) != 0;
+	features.pclmul = (regs[2] & (1u << 1)) != 0 && features.sse41;
+
+	// AVX2 also needs the OS to save the YMM state (OSXSAVE + XCR0 bits 1 and 2)
+	const bool osxsave = (regs[2] & (1u << 27)) != 0;
+	const bool avx = (regs[2] & (1u << 28)) != 0;
+	if (osxsave && avx && max_leaf >= 7) {
+#if defined(_MSC_VER) && !defined(__clang__)
+		const auto xcr0 = static_cast<unsigned long long>(_xgetbv(0));
+		__cpuidex(info, 7, 0);
+		const auto ebx = static_cast<unsigned int>(info[1]);
+#else
+		unsigned int xcr0_lo = 0;
+		unsigned int xcr0_hi = 0;
+		__asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+		const unsigned long long xcr0 = xcr0_lo;
+		unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+		__cpuid_count(7, 0, eax, ebx, ecx, edx);
+#endif
+		features.avx2 = (xcr0 & 0x6) == 0x6 && (ebx & (1u << 5)) != 0;
+	}
+	return features;
+}
+
+inline const X86Features &x86() {
+	static const X86Features features = detect_x86();
+	return features;
+}
+
+#endif
+
+inline bool has_sse41() {
+#if defined(SREC_ARCH_X86)
+	return x86().sse41;
+#else
+	return false;
+#endif
+}
+
+inline bool has_avx2() {
+#if defined(SREC_ARCH_X86)
+	return x86().avx2;
+#else
+	return false;
+#endif
+}
+
+inline bool has_pclmul() {
+#if defined(SREC_ARCH_X86)
+	return x86().pclmul;
+#else
+	return false;
+#endif
+}
+
+inline bool has_neon() {
+#if defined(SREC_ARCH_ARM64)
+	return true; // mandatory on AArch64
+#else
+	return false;
+#endif
+}
+
+inline bool has_pmull() {
+#if defined(SREC_ARCH_ARM64) && defined(__linux__) && defined(HWCAP_PMULL)
+	return (getauxval(AT_HWCAP) & HWCAP_PMULL) != 0;
+#elif defined(SREC_ARCH_ARM64) && defined(__APPLE__)
+	return true; // every Apple AArch64 core implements the crypto extension
+#else
+	return false;
+#endif
+}
+
+} // namespace tierone::srec::cpu
@@ -0,0 +1,357 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "srec_crc.h"
+#include "srec_cpu.h"
+
+#include <cstring>
+#include <initializer_list>
+
+#if defined(SREC_ARCH_X86)
+#include <immintrin.h>
+#elif defined(SREC_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+// PMULL needs the crypto extension at compile time; it is checked again at run time
+#if defined(SREC_ARCH_ARM64) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#define SREC_HAVE_PMULL 1
+#endif
+
+namespace tierone::srec {
+
+namespace {
+
+using CrcFn = uint32_t (*)(const uint8_t *, size_t, uint32_t);
+
+constexpr uint32_t POLYNOMIAL = 0x04C11DB7;
+
+// tables[k][i] is the CRC of byte i followed by k zero bytes
+struct SlicingTables {
+	uint32_t values[16][256];
+
+	constexpr SlicingTables() : values() {
+		for (uint32_t i = 0; i < 256; ++i) {
+			uint32_t crc = i << 24;
+			for (int bit = 0; bit < 8; ++bit) {
+				crc = (crc << 1) ^ ((crc & 0x80000000u) ? POLYNOMIAL : 0);
+			}
+			values[0][i] = crc;
+		}
+		for (int k = 1; k < 16; ++k) {
+			for (uint32_t i = 0; i < 256; ++i) {
+				const uint32_t previous = values[k - 1][i];
+				values[k][i] = (previous << 8) ^ values[0][previous >> 24];
+			}
+		}
+	}
+};
+
+constexpr SlicingTables tables{};
+
+// x^n mod P, for the folding constants and combine
+constexpr uint32_t x_pow_mod(unsigned int n) {
+	uint32_t value = 1;
+	while (n-- > 0) {
+		value = (value << 1) ^ ((value & 0x80000000u) ? POLYNOMIAL : 0);
+	}
+	return value;
+}
+
+inline uint32_t load_be32(const uint8_t *p) {
+	return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+	       (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+uint32_t crc_table(const uint8_t *data, size_t length, uint32_t crc) {
+	while (length--) {
+		crc = (crc << 8) ^ tables.values[0][((crc >> 24) ^ *data++) & 0xFF];
+	}
+	return crc;
+}
+
+uint32_t crc_slicing8(const uint8_t *data, size_t length, uint32_t crc) {
+	const auto &t = tables.values;
+	while (length >= 8) {
+		const uint32_t x = crc ^ load_be32(data);
+		crc = t[7][x >> 24] ^ t[6][(x >> 16) & 0xFF] ^ t[5][(x >> 8) & 0xFF] ^ t[4][x & 0xFF] ^
+		      t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+		data += 8;
+		length -= 8;
+	}
+	return crc_table(data, length, crc);
+}
+
+uint32_t crc_slicing16(const uint8_t *data, size_t length, uint32_t crc) {
+	const auto &t = tables.values;
+	while (length >= 16) {
+		const uint32_t x = crc ^ load_be32(data);
+		crc = t[15][x >> 24] ^ t[14][(x >> 16) & 0xFF] ^ t[13][(x >> 8) & 0xFF] ^ t[12][x & 0xFF] ^
+		      t[11][data[4]] ^ t[10][data[5]] ^ t[9][data[6]] ^ t[8][data[7]] ^
+		      t[7][data[8]] ^ t[6][data[9]] ^ t[5][data[10]] ^ t[4][data[11]] ^
+		      t[3][data[12]] ^ t[2][data[13]] ^ t[1][data[14]] ^ t[0][data[15]];
+		data += 16;
+		length -= 16;
+	}
+	return crc_slicing8(data, length, crc);
+}
+
+// Carry-less multiply folding, after Intel's "Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ", in its non-reflected form. Each
+// 128-bit accumulator holds message bits with the earliest bit highest.
+// Folding by d bits replaces the accumulator H*x^64 + L by
+// H*(x^(d+64) mod P) + L*(x^d mod P); the remaining 128 bits are reduced
+// by running them through the table.
+constexpr size_t FOLD_MIN_LENGTH = 128;
+
+#if defined(SREC_ARCH_X86)
+
+SREC_TARGET("pclmul,sse4.1")
+inline __m128i clmul_fold(const __m128i acc, const __m128i constants) {
+	return _mm_xor_si128(_mm_clmulepi64_si128(acc, constants, 0x11), _mm_clmulepi64_si128(acc, constants, 0x00));
+}
+
+// Load 16 bytes as a 128-bit big-endian value
+SREC_TARGET("pclmul,sse4.1")
+inline __m128i clmul_load(const uint8_t *p) {
+	const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), reverse);
+}
+
+SREC_TARGET("pclmul,sse4.1")
+uint32_t crc_clmul(const uint8_t *data, size_t length, uint32_t crc) {
+	if (length < FOLD_MIN_LENGTH) {
+		return crc_slicing16(data, length, crc);
+	}
+
+	constexpr auto k512_high = static_cast<long long>(x_pow_mod(512 + 64)), k512_low = static_cast<long long>(x_pow_mod(512));
+	constexpr auto k384_high = static_cast<long long>(x_pow_mod(384 + 64)), k384_low = static_cast<long long>(x_pow_mod(384));
+	constexpr auto k256_high = static_cast<long long>(x_pow_mod(256 + 64)), k256_low = static_cast<long long>(x_pow_mod(256));
+	constexpr auto k128_high = static_cast<long long>(x_pow_mod(128 + 64)), k128_low = static_cast<long long>(x_pow_mod(128));
+	const __m128i fold512 = _mm_set_epi64x(k512_high, k512_low);
+	const __m128i fold384 = _mm_set_epi64x(k384_high, k384_low);
+	const __m128i fold256 = _mm_set_epi64x(k256_high, k256_low);
+	const __m128i fold128 = _mm_set_epi64x(k128_high, k128_low);
+
+	// The starting value is XORed into the first 32 message bits
+	__m128i acc0 = _mm_xor_si128(clmul_load(data), _mm_set_epi32(static_cast<int>(crc), 0, 0, 0));
+	__m128i acc1 = clmul_load(data + 16);
+	__m128i acc2 = clmul_load(data + 32);
+	__m128i acc3 = clmul_load(data + 48);
+	data += 64;
+	length -= 64;
+
+	while (length >= 64) {
+		acc0 = _mm_xor_si128(clmul_fold(acc0, fold512), clmul_load(data));
+		acc1 = _mm_xor_si128(clmul_fold(acc1, fold512), clmul_load(data + 16));
+		acc2 = _mm_xor_si128(clmul_fold(acc2, fold512), clmul_load(data + 32));
+		acc3 = _mm_xor_si128(clmul_fold(acc3, fold512), clmul_load(data + 48));
+		data += 64;
+		length -= 64;
+	}
+
+	__m128i acc = _mm_xor_si128(_mm_xor_si128(clmul_fold(acc0, fold384), clmul_fold(acc1, fold256)),
+	                            _mm_xor_si128(clmul_fold(acc2, fold128), acc3));
+	while (length >= 16) {
+		acc = _mm_xor_si128(clmul_fold(acc, fold128), clmul_load(data));
+		data += 16;
+		length -= 16;
+	}
+
+	const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	alignas(16) uint8_t block[16];
+	_mm_store_si128(reinterpret_cast<__m128i *>(block), _mm_shuffle_epi8(acc, reverse));
+	return crc_slicing16(data, length, crc_slicing16(block, sizeof(block), 0));
+}
+
+#endif
+
+#if defined(SREC_HAVE_PMULL)
+
+inline uint64x2_t pmull_fold(const uint64x2_t acc, const uint64_t high, const uint64_t low) {
+	const poly128_t h = vmull_p64(static_cast<poly64_t>(vgetq_lane_u64(acc, 1)), static_cast<poly64_t>(high));
+	const poly128_t l = vmull_p64(static_cast<poly64_t>(vgetq_lane_u64(acc, 0)), static_cast<poly64_t>(low));
+	return veorq_u64(vreinterpretq_u64_p128(h), vreinterpretq_u64_p128(l));
+}
+
+// Load 16 bytes as a 128-bit big-endian value
+inline uint64x2_t pmull_load(const uint8_t *p) {
+	const uint8x16_t bytes = vrev64q_u8(vld1q_u8(p));
+	const uint64x2_t words = vreinterpretq_u64_u8(bytes);
+	return vextq_u64(words, words, 1);
+}
+
+uint32_t crc_pmull(const uint8_t *data, size_t length, uint32_t crc) {
+	if (length < FOLD_MIN_LENGTH) {
+		return crc_slicing16(data, length, crc);
+	}
+
+	static constexpr uint64_t k512_high = x_pow_mod(512 + 64), k512_low = x_pow_mod(512);
+	static constexpr uint64_t k384_high = x_pow_mod(384 + 64), k384_low = x_pow_mod(384);
+	static constexpr uint64_t k256_high = x_pow_mod(256 + 64), k256_low = x_pow_mod(256);
+	static constexpr uint64_t k128_high = x_pow_mod(128 + 64), k128_low = x_pow_mod(128);
+
+	const uint64x2_t init = vcombine_u64(vcreate_u64(0), vcreate_u64(static_cast<uint64_t>(crc) << 32));
+	uint64x2_t acc0 = veorq_u64(pmull_load(data), init);
+	uint64x2_t acc1 = pmull_load(data + 16);
+	uint64x2_t acc2 = pmull_load(data + 32);
+	uint64x2_t acc3 = pmull_load(data + 48);
+	data += 64;
+	length -= 64;
+
+	while (length >= 64) {
+		acc0 = veorq_u64(pmull_fold(acc0, k512_high, k512_low), pmull_load(data));
+		acc1 = veorq_u64(pmull_fold(acc1, k512_high, k512_low), pmull_load(data + 16));
+		acc2 = veorq_u64(pmull_fold(acc2, k512_high, k512_low), pmull_load(data + 32));
+		acc3 = veorq_u64(pmull_fold(acc3, k512_high, k512_low), pmull_load(data + 48));
+		data += 64;
+		length -= 64;
+	}
+
+	uint64x2_t acc = veorq_u64(veorq_u64(pmull_fold(acc0, k384_high, k384_low), pmull_fold(acc1, k256_high, k256_low)),
+	                           veorq_u64(pmull_fold(acc2, k128_high, k128_low), acc3));
+	while (length >= 16) {
+		acc = veorq_u64(pmull_fold(acc, k128_high, k128_low), pmull_load(data));
+		data += 16;
+		length -= 16;
+	}
+
+	// Back to byte order: high 64 bits first, each big-endian
+	uint8_t block[16];
+	const uint64_t high = vgetq_lane_u64(acc, 1);
+	const uint64_t low = vgetq_lane_u64(acc, 0);
+	for (int i = 0; i < 8; ++i) {
+		block[i] = static_cast<uint8_t>(high >> (56 - 8 * i));
+		block[8 + i] = static_cast<uint8_t>(low >> (56 - 8 * i));
+	}
+	return crc_slicing16(data, length, crc_slicing16(block, sizeof(block), 0));
+}
+
+#endif
+
+struct CrcOps {
+	CrcKernel kernel;
+	CrcFn update;
+};
+
+CrcOps ops_for(const CrcKernel kernel) {
+	switch (kernel) {
+		case CrcKernel::TABLE:
+			return {kernel, crc_table};
+		case CrcKernel::SLICING8:
+			return {kernel, crc_slicing8};
+		case CrcKernel::CLMUL:
+#if defined(SREC_ARCH_X86)
+			return {kernel, crc_clmul};
+#else
+			break;
+#endif
+		case CrcKernel::PMULL:
+#if defined(SREC_HAVE_PMULL)
+			return {kernel, crc_pmull};
+#else
+			break;
+#endif
+		case CrcKernel::SLICING16:
+		default:
+			break;
+	}
+	return {CrcKernel::SLICING16, crc_slicing16};
+}
+
+const CrcOps &active_ops() {
+	static const CrcOps ops = [] {
+		for (const auto kernel : {CrcKernel::CLMUL, CrcKernel::PMULL}) {
+			if (crc_kernel_supported(kernel)) {
+				return ops_for(kernel);
+			}
+		}
+		return ops_for(CrcKernel::SLICING16);
+	}();
+	return ops;
+}
+
+// a * b mod P
+uint32_t multiply_mod(const uint32_t a, const uint32_t b) {
+	uint32_t product = 0;
+	for (int bit = 31; bit >= 0; --bit) {
+		product = (product << 1) ^ ((product & 0x80000000u) ? POLYNOMIAL : 0);
+		if ((b >> bit) & 1u) {
+			product ^= a;
+		}
+	}
+	return product;
+}
+
+} // namespace
+
+bool crc_kernel_supported(const CrcKernel kernel) {
+	switch (kernel) {
+		case CrcKernel::TABLE:
+		case CrcKernel::SLICING8:
+		case CrcKernel::SLICING16:
+			return true;
+		case CrcKernel::CLMUL:
+			return cpu::has_pclmul();
+		case CrcKernel::PMULL:
+#if defined(SREC_HAVE_PMULL)
+			return cpu::has_pmull();
+#else
+			return false;
+#endif
+		default:
+			return false;
+	}
+}
+
+CrcKernel crc_active_kernel() {
+	return active_ops().kernel;
+}
+
+const char *crc_kernel_name(const CrcKernel kernel) {
+	switch (kernel) {
+		case CrcKernel::TABLE: return "table";
+		case CrcKernel::SLICING8: return "slicing8";
+		case CrcKernel::SLICING16: return "slicing16";
+		case CrcKernel::CLMUL: return "clmul";
+		case CrcKernel::PMULL: return "pmull";
+		default: return "unknown";
+	}
+}
+
+uint32_t crc32_update(const uint8_t *data, const size_t length, const uint32_t init) {
+	return active_ops().update(data, length, init);
+}
+
+uint32_t crc32_update(const CrcKernel kernel, const uint8_t *data, const size_t length, const uint32_t init) {
+	return ops_for(kernel).update(data, length, init);
+}
+
+uint32_t xcrc32_combine(const uint32_t crc_a, const uint32_t crc_b, uint64_t len_b) {
+	// Appending len_b bytes multiplies crc_a by x^(8 * len_b); start at x^8
+	uint32_t shift = 1;
+	uint32_t square = x_pow_mod(8);
+	while (len_b != 0) {
+		if (len_b & 1u) {
+			shift = multiply_mod(shift, square);
+		}
+		square = multiply_mod(square, square);
+		len_b >>= 1;
+	}
+	return multiply_mod(crc_a, shift) ^ crc_b;
+}
+
+} // namespace tierone::srec
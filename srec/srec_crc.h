@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace tierone::srec {
+
+/**
+ * @brief CRC32 implementations
+ *
+ * All kernels compute the same non-reflected CRC (polynomial 0x04C11DB7,
+ * no final XOR) as the original xcrc32(). The fastest kernel supported by
+ * the running CPU is selected once, on first use of crc32_update(). The
+ * explicit-kernel overload exists for testing and benchmarking.
+ */
+enum class CrcKernel {
+	TABLE,     ///< One table lookup per byte
+	SLICING8,  ///< Eight tables, 8 bytes per iteration
+	SLICING16, ///< Sixteen tables, 16 bytes per iteration
+	CLMUL,     ///< x86 PCLMULQDQ folding, 64 bytes per iteration
+	PMULL      ///< ARMv8 PMULL folding, 64 bytes per iteration
+};
+
+/**
+ * @brief Check whether a kernel is compiled in and supported by this CPU
+ * @param kernel Kernel to check
+ * @return true if the kernel can be used
+ */
+bool crc_kernel_supported(CrcKernel kernel);
+
+/**
+ * @brief Get the kernel used by crc32_update()
+ * @return The runtime-selected kernel
+ */
+CrcKernel crc_active_kernel();
+
+/**
+ * @brief Get a printable name for a kernel
+ * @param kernel Kernel to name
+ * @return Kernel name, e.g. "clmul"
+ */
+const char *crc_kernel_name(CrcKernel kernel);
+
+/**
+ * @brief Compute the CRC32 of a buffer
+ *
+ * Data split across several buffers can be processed by passing the
+ * result of each call as 'init' of the next.
+ *
+ * @param data Input bytes
+ * @param length Number of bytes
+ * @param init Starting value (the CRC of the preceding data, or 0)
+ * @return Updated CRC
+ */
+uint32_t crc32_update(const uint8_t *data, size_t length, uint32_t init);
+
+/**
+ * @brief Compute the CRC32 of a buffer using a specific kernel
+ * @see crc32_update(const uint8_t *, size_t, uint32_t)
+ * @note The kernel must be supported (see crc_kernel_supported())
+ */
+uint32_t crc32_update(CrcKernel kernel, const uint8_t *data, size_t length, uint32_t init);
+
+/**
+ * @brief Combine the CRCs of two consecutive blocks
+ *
+ * Given crc_a = xcrc32(A, len_a, init) and crc_b = xcrc32(B, len_b, 0),
+ * returns xcrc32(A followed by B, len_a + len_b, init). Blocks can thus be
+ * checksummed independently, e.g. on separate threads, and merged in order.
+ *
+ * @param crc_a CRC of the first block
+ * @param crc_b CRC of the second block, computed with init 0
+ * @param len_b Length of the second block in bytes
+ * @return CRC of the concatenation
+ */
+uint32_t xcrc32_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b);
+
+} // namespace tierone::srec
@@ -0,0 +1,377 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "srec_hex.h"
+#include "srec_cpu.h"
+
+#include <initializer_list>
+
+#if defined(SREC_ARCH_X86)
+#include <immintrin.h>
+#elif defined(SREC_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace tierone::srec {
+
+namespace {
+
+using DecodeFn = bool (*)(const char *, size_t, uint8_t *, uint32_t &);
+using EncodeFn = uint32_t (*)(const uint8_t *, size_t, char *);
+
+// Nibble value of every character, 0xFF for anything that is not a hex digit
+struct NibbleTable {
+	uint8_t values[256];
+
+	constexpr NibbleTable() : values() {
+		for (unsigned int c = 0; c < 256; ++c) {
+			if (c >= '0' && c <= '9') {
+				values[c] = static_cast<uint8_t>(c - '0');
+			} else if (c >= 'A' && c <= 'F') {
+				values[c] = static_cast<uint8_t>(c - 'A' + 10);
+			} else if (c >= 'a' && c <= 'f') {
+				values[c] = static_cast<uint8_t>(c - 'a' + 10);
+			} else {
+				values[c] = 0xFF;
+			}
+		}
+	}
+};
+
+constexpr NibbleTable nibble_table{};
+
+// Two uppercase hex characters for every byte value, indexed by byte * 2
+struct HexPairTable {
+	char pairs[512];
+
+	constexpr HexPairTable() : pairs() {
+		constexpr char digits[] = "0123456789ABCDEF";
+		for (unsigned int i = 0; i < 256; ++i) {
+			pairs[i * 2] = digits[i >> 4];
+			pairs[i * 2 + 1] = digits[i & 0x0F];
+		}
+	}
+};
+
+constexpr HexPairTable hex_table{};
+
+bool decode_scalar(const char *in, const size_t count, uint8_t *out, uint32_t &sum) {
+	uint32_t total = 0;
+	unsigned int invalid = 0;
+	for (size_t i = 0; i < count; ++i) {
+		const uint8_t high = nibble_table.values[static_cast<uint8_t>(in[i * 2])];
+		const uint8_t low = nibble_table.values[static_cast<uint8_t>(in[i * 2 + 1])];
+		invalid |= high | low; // any 0xFF sets the upper nibble
+		const auto byte = static_cast<uint8_t>((high << 4) | (low & 0x0F));
+		out[i] = byte;
+		total += byte;
+	}
+	sum = total;
+	return (invalid & 0xF0) == 0;
+}
+
+uint32_t encode_scalar(const uint8_t *in, const size_t count, char *out) {
+	uint32_t total = 0;
+	for (size_t i = 0; i < count; ++i) {
+		out[i * 2] = hex_table.pairs[in[i] * 2];
+		out[i * 2 + 1] = hex_table.pairs[in[i] * 2 + 1];
+		total += in[i];
+	}
+	return total;
+}
+
+#if defined(SREC_ARCH_X86)
+
+SREC_TARGET("sse4.1")
+bool decode_sse41(const char *in, const size_t count, uint8_t *out, uint32_t &sum) {
+	const __m128i ascii_zero = _mm_set1_epi8('0');
+	const __m128i ascii_a = _mm_set1_epi8('a');
+	const __m128i case_bit = _mm_set1_epi8(0x20);
+	const __m128i nine = _mm_set1_epi8(9);
+	const __m128i five = _mm_set1_epi8(5);
+	const __m128i ten = _mm_set1_epi8(10);
+	const __m128i weights = _mm_set1_epi16(0x0110); // high nibble * 16 + low nibble
+
+	__m128i valid = _mm_set1_epi8(-1);
+	__m128i total = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 2));
+
+		const __m128i digit = _mm_sub_epi8(chars, ascii_zero);
+		const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, nine), digit);
+		const __m128i alpha = _mm_sub_epi8(_mm_or_si128(chars, case_bit), ascii_a);
+		const __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, five), alpha);
+		valid = _mm_and_si128(valid, _mm_or_si128(is_digit, is_alpha));
+
+		const __m128i nibbles = _mm_or_si128(_mm_and_si128(is_digit, digit),
+		                                     _mm_and_si128(is_alpha, _mm_add_epi8(alpha, ten)));
+		const __m128i pairs = _mm_maddubs_epi16(nibbles, weights);
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(pairs, pairs));
+		total = _mm_add_epi64(total, _mm_sad_epu8(pairs, _mm_setzero_si128()));
+	}
+
+	uint32_t tail_sum = 0;
+	const bool tail_valid = decode_scalar(in + i * 2, count - i, out + i, tail_sum);
+	sum = static_cast<uint32_t>(_mm_cvtsi128_si32(total)) +
+	      static_cast<uint32_t>(_mm_extract_epi32(total, 2)) + tail_sum;
+	return tail_valid && _mm_movemask_epi8(valid) == 0xFFFF;
+}
+
+SREC_TARGET("sse4.1")
+uint32_t encode_sse41(const uint8_t *in, const size_t count, char *out) {
+	const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+	                                     '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+	const __m128i low_mask = _mm_set1_epi8(0x0F);
+
+	__m128i total = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+		const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask));
+		const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, low_mask));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * 2), _mm_unpacklo_epi8(high, low));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * 2 + 16), _mm_unpackhi_epi8(high, low));
+		total = _mm_add_epi64(total, _mm_sad_epu8(bytes, _mm_setzero_si128()));
+	}
+
+	return static_cast<uint32_t>(_mm_cvtsi128_si32(total)) +
+	       static_cast<uint32_t>(_mm_extract_epi32(total, 2)) +
+	       encode_scalar(in + i, count - i, out + i * 2);
+}
+
+SREC_TARGET("avx2")
+bool decode_avx2(const char *in, const size_t count, uint8_t *out, uint32_t &sum) {
+	const __m256i ascii_zero = _mm256_set1_epi8('0');
+	const __m256i ascii_a = _mm256_set1_epi8('a');
+	const __m256i case_bit = _mm256_set1_epi8(0x20);
+	const __m256i nine = _mm256_set1_epi8(9);
+	const __m256i five = _mm256_set1_epi8(5);
+	const __m256i ten = _mm256_set1_epi8(10);
+	const __m256i weights = _mm256_set1_epi16(0x0110);
+
+	__m256i valid = _mm256_set1_epi8(-1);
+	__m256i total = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i * 2));
+
+		const __m256i digit = _mm256_sub_epi8(chars, ascii_zero);
+		const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, nine), digit);
+		const __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(chars, case_bit), ascii_a);
+		const __m256i is_alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, five), alpha);
+		valid = _mm256_and_si256(valid, _mm256_or_si256(is_digit, is_alpha));
+
+		const __m256i nibbles = _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+		                                        _mm256_and_si256(is_alpha, _mm256_add_epi8(alpha, ten)));
+		const __m256i pairs = _mm256_maddubs_epi16(nibbles, weights);
+		// packus works per 128-bit lane; gather the two 8-byte results into the low lane
+		const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(pairs, pairs), 0xD8);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm256_castsi256_si128(packed));
+		total = _mm256_add_epi64(total, _mm256_sad_epu8(pairs, _mm256_setzero_si256()));
+	}
+
+	const __m128i folded = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+	const bool all_valid = _mm256_movemask_epi8(valid) == -1;
+	const uint32_t block_sum = static_cast<uint32_t>(_mm_cvtsi128_si32(folded)) +
+	                           static_cast<uint32_t>(_mm_extract_epi32(folded, 2));
+
+	// Avoid the AVX to SSE transition penalty in the non-VEX tail code
+	_mm256_zeroupper();
+	uint32_t tail_sum = 0;
+	const bool tail_valid = decode_sse41(in + i * 2, count - i, out + i, tail_sum);
+	sum = block_sum + tail_sum;
+	return tail_valid && all_valid;
+}
+
+SREC_TARGET("avx2")
+uint32_t encode_avx2(const uint8_t *in, const size_t count, char *out) {
+	const __m256i digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+	                                        '8', '9', 'A', 'B', 'C', 'D', 'E', 'F',
+	                                        '0', '1', '2', '3', '4', '5', '6', '7',
+	                                        '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+	const __m256i low_mask = _mm256_set1_epi8(0x0F);
+
+	__m256i total = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32) {
+		const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+		const __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_mask));
+		const __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, low_mask));
+		// unpack works per 128-bit lane; reorder lanes so output stays sequential
+		const __m256i first = _mm256_unpacklo_epi8(high, low);
+		const __m256i second = _mm256_unpackhi_epi8(high, low);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * 2), _mm256_permute2x128_si256(first, second, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * 2 + 32), _mm256_permute2x128_si256(first, second, 0x31));
+		total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+	}
+
+	const __m128i folded = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+	const uint32_t block_sum = static_cast<uint32_t>(_mm_cvtsi128_si32(folded)) +
+	                           static_cast<uint32_t>(_mm_extract_epi32(folded, 2));
+
+	// Avoid the AVX to SSE transition penalty in the non-VEX tail code
+	_mm256_zeroupper();
+	return block_sum + encode_sse41(in + i, count - i, out + i * 2);
+}
+
+#endif // SREC_ARCH_X86
+
+#if defined(SREC_ARCH_ARM64)
+
+inline uint8x16_t neon_nibbles(const uint8x16_t chars, uint8x16_t &valid) {
+	const uint8x16_t digit = vsubq_u8(chars, vdupq_n_u8('0'));
+	const uint8x16_t is_digit = vcleq_u8(digit, vdupq_n_u8(9));
+	const uint8x16_t alpha = vsubq_u8(vorrq_u8(chars, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+	const uint8x16_t is_alpha = vcleq_u8(alpha, vdupq_n_u8(5));
+	valid = vandq_u8(valid, vorrq_u8(is_digit, is_alpha));
+	return vbslq_u8(is_digit, digit, vaddq_u8(alpha, vdupq_n_u8(10)));
+}
+
+bool decode_neon(const char *in, const size_t count, uint8_t *out, uint32_t &sum) {
+	const auto *chars = reinterpret_cast<const uint8_t *>(in);
+	uint8x16_t valid = vdupq_n_u8(0xFF);
+	uint32_t total = 0;
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		// de-interleave: val[0] holds the high nibble characters, val[1] the low ones
+		const uint8x16x2_t pair = vld2q_u8(chars + i * 2);
+		const uint8x16_t high = neon_nibbles(pair.val[0], valid);
+		const uint8x16_t low = neon_nibbles(pair.val[1], valid);
+		const uint8x16_t bytes = vorrq_u8(vshlq_n_u8(high, 4), low);
+		vst1q_u8(out + i, bytes);
+		total += vaddlvq_u8(bytes);
+	}
+
+	uint32_t tail_sum = 0;
+	const bool tail_valid = decode_scalar(in + i * 2, count - i, out + i, tail_sum);
+	sum = total + tail_sum;
+	return tail_valid && vminvq_u8(valid) == 0xFF;
+}
+
+uint32_t encode_neon(const uint8_t *in, const size_t count, char *out) {
+	static constexpr uint8_t digit_chars[16] = {'0', '1', '2', '3', '4', '5', '6', '7',
+	                                            '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+	const uint8x16_t digits = vld1q_u8(digit_chars);
+	auto *chars = reinterpret_cast<uint8_t *>(out);
+	uint32_t total = 0;
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const uint8x16_t bytes = vld1q_u8(in + i);
+		uint8x16x2_t pair;
+		pair.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(bytes, 4));
+		pair.val[1] = vqtbl1q_u8(digits, vandq_u8(bytes, vdupq_n_u8(0x0F)));
+		vst2q_u8(chars + i * 2, pair); // interleaves high/low characters
+		total += vaddlvq_u8(bytes);
+	}
+	return total + encode_scalar(in + i, count - i, out + i * 2);
+}
+
+#endif // SREC_ARCH_ARM64
+
+struct HexOps {
+	HexKernel kernel;
+	DecodeFn decode;
+	EncodeFn encode;
+};
+
+HexOps ops_for(const HexKernel kernel) {
+	switch (kernel) {
+		case HexKernel::SSE41:
+#if defined(SREC_ARCH_X86)
+			return {kernel, decode_sse41, encode_sse41};
+#else
+			break;
+#endif
+		case HexKernel::AVX2:
+#if defined(SREC_ARCH_X86)
+			return {kernel, decode_avx2, encode_avx2};
+#else
+			break;
+#endif
+		case HexKernel::NEON:
+#if defined(SREC_ARCH_ARM64)
+			return {kernel, decode_neon, encode_neon};
+#else
+			break;
+#endif
+		case HexKernel::SCALAR:
+		default:
+			break;
+	}
+	return {HexKernel::SCALAR, decode_scalar, encode_scalar};
+}
+
+const HexOps &active_ops() {
+	static const HexOps ops = [] {
+		for (const auto kernel : {HexKernel::AVX2, HexKernel::NEON, HexKernel::SSE41}) {
+			if (hex_kernel_supported(kernel)) {
+				return ops_for(kernel);
+			}
+		}
+		return ops_for(HexKernel::SCALAR);
+	}();
+	return ops;
+}
+
+} // namespace
+
+bool hex_kernel_supported(const HexKernel kernel) {
+	switch (kernel) {
+		case HexKernel::SCALAR:
+			return true;
+		case HexKernel::SSE41:
+			return cpu::has_sse41();
+		case HexKernel::AVX2:
+			return cpu::has_avx2();
+		case HexKernel::NEON:
+			return cpu::has_neon();
+		default:
+			return false;
+	}
+}
+
+HexKernel hex_active_kernel() {
+	return active_ops().kernel;
+}
+
+const char *hex_kernel_name(const HexKernel kernel) {
+	switch (kernel) {
+		case HexKernel::SCALAR: return "scalar";
+		case HexKernel::SSE41: return "sse4.1";
+		case HexKernel::AVX2: return "avx2";
+		case HexKernel::NEON: return "neon";
+		default: return "unknown";
+	}
+}
+
+bool hex_decode(const char *in, const size_t count, uint8_t *out, uint32_t &sum) {
+	return active_ops().decode(in, count, out, sum);
+}
+
+uint32_t hex_encode(const uint8_t *in, const size_t count, char *out) {
+	return active_ops().encode(in, count, out);
+}
+
+bool hex_decode(const HexKernel kernel, const char *in, const size_t count, uint8_t *out, uint32_t &sum) {
+	return ops_for(kernel).decode(in, count, out, sum);
+}
+
+uint32_t hex_encode(const HexKernel kernel, const uint8_t *in, const size_t count, char *out) {
+	return ops_for(kernel).encode(in, count, out);
+}
+
+} // namespace tierone::srec
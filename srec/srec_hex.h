@@ -0,0 +1,95 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace tierone::srec {
+
+/**
+ * @brief Hex codec implementations
+ *
+ * The best kernel supported by the running CPU is selected once, on first
+ * use of hex_decode()/hex_encode(). The explicit-kernel overloads exist for
+ * testing and benchmarking.
+ */
+enum class HexKernel {
+	SCALAR, ///< Portable table-driven implementation
+	SSE41,  ///< x86 SSE4.1, 16 characters per iteration
+	AVX2,   ///< x86 AVX2, 32 characters per iteration
+	NEON    ///< ARM NEON, 32 characters per iteration
+};
+
+/**
+ * @brief Check whether a kernel is compiled in and supported by this CPU
+ * @param kernel Kernel to check
+ * @return true if the kernel can be used
+ */
+bool hex_kernel_supported(HexKernel kernel);
+
+/**
+ * @brief Get the kernel used by hex_decode()/hex_encode()
+ * @return The runtime-selected kernel
+ */
+HexKernel hex_active_kernel();
+
+/**
+ * @brief Get a printable name for a kernel
+ * @param kernel Kernel to name
+ * @return Kernel name, e.g. "avx2"
+ */
+const char *hex_kernel_name(HexKernel kernel);
+
+/**
+ * @brief Decode and validate hexadecimal characters
+ *
+ * Decodes count bytes from 2 * count characters. Upper and lower case
+ * digits are accepted.
+ *
+ * @param in Input characters (2 * count)
+ * @param count Number of bytes to decode
+ * @param out Output bytes (count); contents are unspecified on failure
+ * @param sum Receives the sum of all decoded bytes
+ * @return true if every character was a valid hex digit
+ */
+bool hex_decode(const char *in, size_t count, uint8_t *out, uint32_t &sum);
+
+/**
+ * @brief Encode bytes as uppercase hexadecimal characters
+ * @param in Input bytes (count)
+ * @param count Number of bytes to encode
+ * @param out Output characters (2 * count)
+ * @return Sum of all encoded bytes
+ */
+uint32_t hex_encode(const uint8_t *in, size_t count, char *out);
+
+/**
+ * @brief Decode using a specific kernel
+ * @see hex_decode(const char *, size_t, uint8_t *, uint32_t &)
+ * @note The kernel must be supported (see hex_kernel_supported())
+ */
+bool hex_decode(HexKernel kernel, const char *in, size_t count, uint8_t *out, uint32_t &sum);
+
+/**
+ * @brief Encode using a specific kernel
+ * @see hex_encode(const uint8_t *, size_t, char *)
+ * @note The kernel must be supported (see hex_kernel_supported())
+ */
+uint32_t hex_encode(HexKernel kernel, const uint8_t *in, size_t count, char *out);
+
+} // namespace tierone::srec
@@ -0,0 +1,274 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "srec_compress.h"
+#include "srec_image.h"
+#include "srec_mapped.h"
+#include "srec_reader.h"
+
+namespace tierone::srec {
+
+SrecMemoryImage::SrecMemoryImage(const SrecMemoryImage &other)
+	: segment_map(other.segment_map),
+	  defined_bytes(other.defined_bytes),
+	  entry_point(other.entry_point),
+	  fill(other.fill)
+{
+}
+
+SrecMemoryImage::SrecMemoryImage(SrecMemoryImage &&other) noexcept
+	: segment_map(std::move(other.segment_map)),
+	  defined_bytes(other.defined_bytes),
+	  entry_point(other.entry_point),
+	  fill(other.fill)
+{
+	other.clear();
+}
+
+SrecMemoryImage &SrecMemoryImage::operator=(const SrecMemoryImage &other) {
+	if (this != &other) {
+		segment_map = other.segment_map;
+		last_write = segment_map.end();
+		defined_bytes = other.defined_bytes;
+		entry_point = other.entry_point;
+		fill = other.fill;
+	}
+	return *this;
+}
+
+SrecMemoryImage &SrecMemoryImage::operator=(SrecMemoryImage &&other) noexcept {
+	if (this != &other) {
+		segment_map = std::move(other.segment_map);
+		last_write = segment_map.end();
+		defined_bytes = other.defined_bytes;
+		entry_point = other.entry_point;
+		fill = other.fill;
+		other.clear();
+	}
+	return *this;
+}
+
+void SrecMemoryImage::write(const uint32_t address, const uint8_t *data, const size_t length) {
+	if (length == 0) {
+		return;
+	}
+	const uint64_t end = static_cast<uint64_t>(address) + length;
+	if (end - 1 > MAX_ADDRESS) {
+		throw SrecAddressException(address, MAX_ADDRESS);
+	}
+
+	// Fast path: the write continues the previous one and touches nothing else
+	if (last_write != segment_map.end()) {
+		auto &bytes = last_write->second;
+		if (static_cast<uint64_t>(last_write->first) + bytes.size() == address) {
+			const auto next = std::next(last_write);
+			if (next == segment_map.end() || next->first > end) {
+				bytes.insert(bytes.end(), data, data + length);
+				defined_bytes += length;
+				return;
+			}
+		}
+	}
+
+	// Extend the segment containing or ending at 'address', or start a new one
+	const auto next = segment_map.upper_bound(address);
+	SegmentMap::iterator target;
+	if (next != segment_map.begin() &&
+	    static_cast<uint64_t>(std::prev(next)->first) + std::prev(next)->second.size() >= address) {
+		target = std::prev(next);
+	} else {
+		target = segment_map.emplace_hint(next, address, std::vector<uint8_t>());
+	}
+	const uint32_t base = target->first;
+	auto &bytes = target->second;
+
+	// Absorb following segments the new range overlaps or touches
+	size_t previous_size = bytes.size();
+	uint64_t new_end = std::max<uint64_t>(base + bytes.size(), end);
+	auto last = next;
+	for (; last != segment_map.end() && last->first <= end; ++last) {
+		previous_size += last->second.size();
+		new_end = std::max<uint64_t>(new_end, last->first + last->second.size());
+	}
+
+	bytes.resize(static_cast<size_t>(new_end - base));
+	for (auto it = next; it != last; ++it) {
+		// Only the part past the new data survives
+		const uint64_t segment_end = it->first + it->second.size();
+		if (segment_end > end) {
+			const auto skip = static_cast<size_t>(end - it->first);
+			std::memcpy(bytes.data() + (end - base), it->second.data() + skip, it->second.size() - skip);
+		}
+	}
+	segment_map.erase(next, last);
+
+	std::memcpy(bytes.data() + (address - base), data, length);
+	defined_bytes = defined_bytes - previous_size + bytes.size();
+	last_write = target;
+}
+
+void SrecMemoryImage::add_record(const SrecStreamParser::ParsedRecordView &record) {
+	switch (record.type) {
+		case Srec::Type::S1:
+		case Srec::Type::S2:
+		case Srec::Type::S3:
+			write(record.address, record.data, record.length);
+			break;
+		case Srec::Type::S7:
+		case Srec::Type::S8:
+		case Srec::Type::S9:
+			entry_point = record.address;
+			break;
+		case Srec::Type::S0:
+		case Srec::Type::S5:
+		case Srec::Type::S6:
+		default:
+			break;
+	}
+}
+
+void SrecMemoryImage::add_record(const SrecStreamParser::ParsedRecord &record) {
+	add_record(SrecStreamParser::ParsedRecordView{record.type, record.address, record.data.data(),
+	                                              record.data.size(), record.checksum,
+	                                              record.checksum_valid, record.line_number});
+}
+
+void SrecMemoryImage::load_file(const std::string &filename, const bool validate_checksums, SrecStats *stats) {
+	if (detect_compression(filename) != SrecCompression::NONE) {
+		SrecDecompressStream input(filename);
+		load(input, validate_checksums, stats);
+		return;
+	}
+	SrecMappedReader reader(filename, validate_checksums);
+	reader.set_stats(stats);
+	SrecStreamParser::ParsedRecordView record{};
+	while (reader.next(record)) {
+		add_record(record);
+	}
+}
+
+void SrecMemoryImage::load(std::istream &input, const bool validate_checksums, SrecStats *stats) {
+	SrecReader reader(input, validate_checksums);
+	reader.set_stats(stats);
+	SrecStreamParser::ParsedRecordView record{};
+	while (reader.next(record)) {
+		add_record(record);
+	}
+}
+
+const uint8_t *SrecMemoryImage::find(const uint32_t address, const size_t length) const {
+	auto it = segment_map.upper_bound(address);
+	if (it == segment_map.begin()) {
+		return nullptr;
+	}
+	--it;
+	const size_t offset = address - it->first;
+	if (offset > it->second.size() || length > it->second.size() - offset) {
+		return nullptr;
+	}
+	return it->second.data() + offset;
+}
+
+size_t SrecMemoryImage::read(const uint32_t address, uint8_t *out, const size_t length) const {
+	std::memset(out, fill, length);
+
+	const uint64_t end = static_cast<uint64_t>(address) + length;
+	auto it = segment_map.upper_bound(address);
+	if (it != segment_map.begin()) {
+		--it;
+	}
+
+	size_t copied = 0;
+	for (; it != segment_map.end() && it->first < end; ++it) {
+		const uint64_t first = std::max<uint64_t>(it->first, address);
+		const uint64_t last = std::min<uint64_t>(it->first + it->second.size(), end);
+		if (first >= last) {
+			continue;
+		}
+		const auto count = static_cast<size_t>(last - first);
+		std::memcpy(out + (first - address), it->second.data() + (first - it->first), count);
+		copied += count;
+	}
+	return copied;
+}
+
+void SrecMemoryImage::write_binary(std::ostream &output) const {
+	std::array<char, 4096> fill_block;
+	fill_block.fill(static_cast<char>(fill));
+
+	uint64_t position = start_address();
+	for (const auto &[start, bytes] : segment_map) {
+		for (uint64_t gap = start - position; gap > 0;) {
+			const auto count = static_cast<size_t>(std::min<uint64_t>(gap, fill_block.size()));
+			output.write(fill_block.data(), static_cast<std::streamsize>(count));
+			gap -= count;
+		}
+		output.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		position = start + bytes.size();
+	}
+
+	if (!output) {
+		throw SrecFileException("Failed to write binary image");
+	}
+}
+
+void SrecMemoryImage::write_binary_file(const std::string &filename) const {
+	std::ofstream output(filename, std::ios::binary);
+	if (!output.is_open()) {
+		throw SrecFileException("Failed to open output file", filename);
+	}
+	write_binary(output);
+	output.close();
+	if (!output) {
+		throw SrecFileException("Failed to write output file", filename);
+	}
+}
+
+std::vector<uint8_t> SrecMemoryImage::to_binary() const {
+	const uint64_t start = start_address();
+	std::vector<uint8_t> binary(static_cast<size_t>(end_address() - start), fill);
+	for (const auto &[address, bytes] : segment_map) {
+		std::copy(bytes.begin(), bytes.end(), binary.begin() + static_cast<std::ptrdiff_t>(address - start));
+	}
+	return binary;
+}
+
+void SrecMemoryImage::clear() {
+	segment_map.clear();
+	last_write = segment_map.end();
+	defined_bytes = 0;
+	entry_point.reset();
+}
+
+uint32_t SrecMemoryImage::start_address() const {
+	return segment_map.empty() ? 0 : segment_map.begin()->first;
+}
+
+uint64_t SrecMemoryImage::end_address() const {
+	if (segment_map.empty()) {
+		return 0;
+	}
+	const auto &last = *segment_map.rbegin();
+	return static_cast<uint64_t>(last.first) + last.second.size();
+}
+
+} // namespace tierone::srec
@@ -0,0 +1,249 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "srec.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief Sparse memory image built from S-record data records
+ *
+ * The image is a sorted set of non-overlapping segments. Adjacent and
+ * overlapping writes are coalesced, so every contiguous run of defined
+ * bytes lives in exactly one segment. Writing the next record of an
+ * in-order file appends to the previous segment in amortized O(1) time.
+ * Later writes overwrite earlier data at the same addresses.
+ *
+ * @note This class is thread-safe for reading operations only.
+ *       Writing operations are not thread-safe.
+ */
+class SrecMemoryImage {
+public:
+	/// Segments keyed by start address
+	using SegmentMap = std::map<uint32_t, std::vector<uint8_t>>;
+
+	/// Highest address an image can hold
+	static constexpr uint32_t MAX_ADDRESS = 0xFFFFFFFF;
+
+	SrecMemoryImage() = default;
+	SrecMemoryImage(const SrecMemoryImage &other);
+	SrecMemoryImage(SrecMemoryImage &&other) noexcept;
+	SrecMemoryImage &operator=(const SrecMemoryImage &other);
+	SrecMemoryImage &operator=(SrecMemoryImage &&other) noexcept;
+	~SrecMemoryImage() = default;
+
+	/**
+	 * @brief Store bytes at an address
+	 * @param address Address of the first byte
+	 * @param data Bytes to store
+	 * @param length Number of bytes
+	 * @throws SrecAddressException if the range extends past MAX_ADDRESS
+	 */
+	void write(uint32_t address, const uint8_t *data, size_t length);
+
+	/**
+	 * @brief Store bytes at an address
+	 * @param address Address of the first byte
+	 * @param data Bytes to store
+	 * @throws SrecAddressException if the range extends past MAX_ADDRESS
+	 */
+	void write(uint32_t address, const std::vector<uint8_t> &data) {
+		write(address, data.data(), data.size());
+	}
+
+	/**
+	 * @brief Add a parsed record to the image
+	 *
+	 * S1/S2/S3 payloads are stored at their address, S7/S8/S9 set the
+	 * execution address. Header and count records are ignored.
+	 *
+	 * @param record Parsed record
+	 */
+	void add_record(const SrecStreamParser::ParsedRecordView &record);
+
+	/**
+	 * @brief Add a parsed record to the image
+	 * @param record Parsed record
+	 * @see add_record(const SrecStreamParser::ParsedRecordView &)
+	 */
+	void add_record(const SrecStreamParser::ParsedRecord &record);
+
+	/**
+	 * @brief Add every record of an S-record file to the image
+	 * @param filename Path to S-record file
+	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @param stats Statistics to update, see SrecMappedReader::set_stats() (default: none)
+	 * @throws SrecFileException on file I/O errors
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	void load_file(const std::string &filename, bool validate_checksums = true, SrecStats *stats = nullptr);
+
+	/**
+	 * @brief Add every record of an S-record stream to the image
+	 * @param input Input stream containing S-record data
+	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @param stats Statistics to update, see SrecReader::set_stats() (default: none)
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	void load(std::istream &input, bool validate_checksums = true, SrecStats *stats = nullptr);
+
+	/**
+	 * @brief Find a range that is fully defined
+	 * @param address First address of the range
+	 * @param length Number of bytes
+	 * @return Pointer to the stored bytes or nullptr if any byte is undefined
+	 */
+	const uint8_t *find(uint32_t address, size_t length) const;
+
+	/**
+	 * @brief Check whether every byte in a range is defined
+	 * @param address First address of the range
+	 * @param length Number of bytes
+	 * @return true if the range is covered by the image
+	 */
+	bool contains(uint32_t address, size_t length = 1) const {
+		return find(address, length) != nullptr;
+	}
+
+	/**
+	 * @brief Copy a range out of the image
+	 * @param address First address of the range
+	 * @param out Receives length bytes; undefined bytes are set to the fill byte
+	 * @param length Number of bytes
+	 * @return Number of bytes that were defined in the image
+	 */
+	size_t read(uint32_t address, uint8_t *out, size_t length) const;
+
+	/**
+	 * @brief Write the image as a flat binary
+	 *
+	 * Output starts at the lowest defined address and runs to the end of the
+	 * highest segment; gaps are filled with the fill byte.
+	 *
+	 * @param output Output stream
+	 * @throws SrecFileException if writing fails
+	 */
+	void write_binary(std::ostream &output) const;
+
+	/**
+	 * @brief Write the image as a flat binary file
+	 * @param filename Path to output file
+	 * @throws SrecFileException on file I/O errors
+	 * @see write_binary(std::ostream &)
+	 */
+	void write_binary_file(const std::string &filename) const;
+
+	/**
+	 * @brief Get the image as a flat binary
+	 * @return Bytes from the lowest to the highest defined address
+	 * @see write_binary(std::ostream &)
+	 */
+	std::vector<uint8_t> to_binary() const;
+
+	/**
+	 * @brief Remove all data and the execution address
+	 */
+	void clear();
+
+	/**
+	 * @brief Get the segments
+	 * @return Coalesced segments keyed by start address
+	 */
+	const SegmentMap &segments() const {
+		return segment_map;
+	}
+
+	/**
+	 * @brief Check whether the image holds any data
+	 * @return true if no byte is defined
+	 */
+	bool empty() const {
+		return segment_map.empty();
+	}
+
+	/**
+	 * @brief Get the number of defined bytes
+	 * @return Sum of all segment sizes
+	 */
+	size_t data_size() const {
+		return defined_bytes;
+	}
+
+	/**
+	 * @brief Get the lowest defined address
+	 * @return Start of the first segment, 0 for an empty image
+	 */
+	uint32_t start_address() const;
+
+	/**
+	 * @brief Get the address one past the highest defined byte
+	 * @return End of the last segment, 0 for an empty image
+	 */
+	uint64_t end_address() const;
+
+	/**
+	 * @brief Get the execution address from the termination record
+	 * @return Execution address, if a termination record was added
+	 */
+	std::optional<uint32_t> execution_address() const {
+		return entry_point;
+	}
+
+	/**
+	 * @brief Set the execution address
+	 * @param address Execution address
+	 */
+	void set_execution_address(uint32_t address) {
+		entry_point = address;
+	}
+
+	/**
+	 * @brief Get the byte used for undefined addresses
+	 * @return Fill byte (default: 0x00)
+	 */
+	uint8_t fill_byte() const {
+		return fill;
+	}
+
+	/**
+	 * @brief Set the byte used for undefined addresses
+	 * @param value Fill byte
+	 */
+	void set_fill_byte(uint8_t value) {
+		fill = value;
+	}
+
+private:
+	SegmentMap segment_map;
+	SegmentMap::iterator last_write{segment_map.end()}; // segment written most recently
+	size_t defined_bytes{0};
+	std::optional<uint32_t> entry_point;
+	uint8_t fill{0x00};
+};
+
+} // namespace tierone::srec
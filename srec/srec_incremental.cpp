@@ -0,0 +1,199 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <tuple>
+
+#include "srec_codec.h"
+#include "srec_crc.h"
+#include "srec_incremental.h"
+#include "srec_mapped.h"
+
+namespace tierone::srec {
+
+namespace {
+
+// Map a file of the previous build, or nothing if there is none to use
+std::unique_ptr<SrecMappedFile> map_previous(const std::string &filename) {
+	std::error_code error;
+	if (filename.empty() || !std::filesystem::is_regular_file(filename, error)) {
+		return nullptr;
+	}
+	try {
+		return std::make_unique<SrecMappedFile>(filename);
+	} catch (const SrecFileException &) {
+		return nullptr;
+	}
+}
+
+bool same_file(const std::string &a, const std::string &b) {
+	std::error_code error;
+	return std::filesystem::equivalent(a, b, error);
+}
+
+const uint8_t *bytes_of(const SrecMappedFile &file) {
+	return reinterpret_cast<const uint8_t *>(file.data());
+}
+
+// Layout of the previous S-record output
+struct PreviousText {
+	const char *text{nullptr};
+	size_t records{0};            // offset of the first data record
+	std::optional<uint32_t> crc;  // CRC from its header, if it has one
+};
+
+// Check that the previous output has the layout convert_stream() writes for
+// the previous input with these settings: optional CRC header, full-length
+// data records, the count record. Returns false if anything differs.
+bool inspect_previous(const SrecMappedFile &file, const uint64_t previous_length, const bool want_checksum,
+                      const size_t payload, const size_t overhead, const char data_type, PreviousText &previous) {
+	const char *text = file.data();
+	const size_t size = file.size();
+	previous.text = text;
+	previous.records = 0;
+
+	if (want_checksum) {
+		const void *end = size > 0 ? std::memchr(text, '\n', std::min(size, MAX_RECORD_LINE_LENGTH + 1)) : nullptr;
+		if (end == nullptr) {
+			return false;
+		}
+		const auto length = static_cast<size_t>(static_cast<const char *>(end) - text);
+		std::array<uint8_t, SrecStreamParser::MAX_RECORD_DATA_SIZE> payload_buffer{};
+		SrecStreamParser::ParsedRecordView header{};
+		try {
+			SrecStreamParser::parse_line(std::string_view(text, length), 1, true, payload_buffer.data(), header);
+		} catch (const SrecException &) {
+			return false;
+		}
+		if (header.type != Srec::Type::S0 || header.length != 5 || header.data[4] != 0) {
+			return false;
+		}
+		previous.crc = (static_cast<uint32_t>(header.data[0]) << 24) | (static_cast<uint32_t>(header.data[1]) << 16) |
+		               (static_cast<uint32_t>(header.data[2]) << 8) | static_cast<uint32_t>(header.data[3]);
+		previous.records = length + 1;
+	}
+
+	const uint64_t full = previous_length / payload;
+	const uint64_t rest = previous_length % payload;
+	const uint64_t count = previous.records + full * (overhead + 2 * payload) + (rest > 0 ? overhead + 2 * rest : 0);
+	if (count + 2 > size || text[count] != 'S' || (text[count + 1] != '5' && text[count + 1] != '6')) {
+		return false;
+	}
+	return previous_length == 0 || (text[previous.records] == 'S' && text[previous.records + 1] == data_type);
+}
+
+} // namespace
+
+SrecIncrementalResult SrecIncrementalConverter::convert(const std::string &input, const std::string &previous_input,
+                                                        const std::string &previous_output, const std::string &output,
+                                                        const Options &options) {
+	// Opening the output truncates it, so it must not be one of the sources
+	if (same_file(output, previous_output) || same_file(output, previous_input) || same_file(output, input)) {
+		throw SrecFileException("Output must not be an input or the previous output", output);
+	}
+
+	const SrecMappedFile current(input);
+	const uint8_t *data = bytes_of(current);
+	const size_t length = current.size();
+
+	SrecFile sfile(output, options.address_size, options.start_address, FlushPolicy::ON_CLOSE,
+	               options.limits);
+	if (!sfile.is_open()) {
+		throw SrecFileException("Failed to create output file", output);
+	}
+	if (options.want_checksum) {
+		sfile.reserve_checksum_header();
+	}
+
+	const size_t payload = sfile.max_data_bytes_per_record();
+	const auto [overhead, record_type, data_type] = with_record_codec(options.address_size, [](auto codec) {
+		using Codec = decltype(codec);
+		return std::tuple<size_t, Srec::Type, char>(7 + 2 * Codec::ADDRESS_LENGTH, Codec::DATA_TYPE,
+		                                            static_cast<char>('0' + Codec::ADDRESS_LENGTH - 1));
+	});
+	const size_t line = overhead + 2 * payload;
+
+	SrecIncrementalResult result;
+	const auto old_binary = map_previous(previous_input);
+	const auto old_srec = old_binary ? map_previous(previous_output) : nullptr;
+	PreviousText previous;
+	result.incremental = old_srec && inspect_previous(*old_srec, old_binary->size(), options.want_checksum, payload,
+	                                                  overhead, data_type, previous);
+	const uint8_t *old_data = result.incremental ? bytes_of(*old_binary) : nullptr;
+	const size_t old_length = result.incremental ? old_binary->size() : 0;
+
+	// Same length and a CRC to start from: only changed blocks enter the CRC
+	result.crc_updated = options.want_checksum && result.incremental && previous.crc && old_length == length;
+	uint32_t crc = result.crc_updated ? *previous.crc : 0;
+
+	const size_t block_bytes = std::max<size_t>(options.block_records, 1) * payload;
+	std::array<char, MAX_RECORD_LINE_LENGTH + 1> check{};
+	for (size_t offset = 0; offset < length; offset += block_bytes) {
+		const size_t count = std::min(block_bytes, length - offset);
+		const size_t records = (count + payload - 1) / payload;
+		++result.blocks;
+
+		// A block reads the same bytes at the same place in both inputs; a
+		// short block is the last of both, since the sizes then agree
+		bool unchanged = offset < old_length && std::min(block_bytes, old_length - offset) == count &&
+		                 std::memcmp(data + offset, old_data + offset, count) == 0;
+		if (unchanged) {
+			const char *text = previous.text + previous.records + (offset / payload) * line;
+			const size_t text_length = (count / payload) * line + (count % payload > 0 ? overhead + 2 * (count % payload) : 0);
+
+			// The arithmetic found the text; spot-check it holds these records
+			const size_t first = format_record(record_type, sfile.next_address(),
+			                                   data + offset, std::min(count, payload), check.data());
+			unchanged = std::memcmp(text, check.data(), first) == 0 && text[first] == '\n' && text[text_length - 1] == '\n';
+			if (unchanged) {
+				sfile.write_formatted_records(text, text_length, records, count);
+				++result.reused_blocks;
+				result.reused_records += records;
+			}
+		}
+		if (!unchanged) {
+			sfile.write_data(data + offset, count);
+			result.formatted_records += records;
+		}
+
+		if (!options.want_checksum) {
+			continue;
+		}
+		if (!result.crc_updated) {
+			crc = crc32_update(data + offset, count, crc);
+		} else if (std::memcmp(data + offset, old_data + offset, count) != 0) {
+			// CRC(new) = CRC(old) ^ CRC(new ^ old); the difference is zero outside this block
+			const uint32_t difference = crc32_update(data + offset, count, 0) ^ crc32_update(old_data + offset, count, 0);
+			crc ^= xcrc32_combine(difference, 0, length - offset - count);
+		}
+	}
+
+	sfile.write_record_count();
+	sfile.write_record_termination();
+	if (options.want_checksum) {
+		sfile.write_checksum_header(crc);
+		result.crc = crc;
+	}
+	sfile.close();
+	return result;
+}
+
+} // namespace tierone::srec
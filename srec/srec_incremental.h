@@ -0,0 +1,100 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "srec.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief Options for SrecIncrementalConverter
+ *
+ * Address size, start address and checksum setting must be the ones the
+ * previous output was converted with; records whose text no longer matches
+ * are detected and reformatted, but nothing is reused then.
+ */
+struct SrecIncrementalOptions {
+	/// Default number of records compared and reused as a unit
+	static constexpr size_t DEFAULT_BLOCK_RECORDS = 256;
+
+	SrecFile::AddressSize address_size{SrecFile::AddressSize::BITS32}; ///< Address size of the records
+	uint32_t start_address{0};                                         ///< Address of the first input byte
+	bool want_checksum{false};                                         ///< Include the CRC32 header
+	size_t block_records{DEFAULT_BLOCK_RECORDS};                       ///< Records per compared block
+	SrecLimits limits{};                                               ///< Output limits
+};
+
+/**
+ * @brief Totals of an incremental conversion
+ */
+struct SrecIncrementalResult {
+	bool incremental{false};        ///< Whether the previous output could be used at all
+	bool crc_updated{false};        ///< Whether the CRC was derived from the previous header
+	uint64_t blocks{0};             ///< Blocks in the new input
+	uint64_t reused_blocks{0};      ///< Blocks copied from the previous output
+	uint64_t reused_records{0};     ///< Data records copied from the previous output
+	uint64_t formatted_records{0};  ///< Data records formatted from the input
+	uint32_t crc{0};                ///< CRC32 of the input, if want_checksum
+};
+
+/**
+ * @brief Binary to S-record conversion that reuses the previous output
+ *
+ * Produces exactly what convert_bin_to_srec() or
+ * SrecStreamConverter::convert_stream() would, but copies the text of
+ * unchanged records from the previous build's output instead of
+ * formatting them again. The input is compared with the previous input
+ * block by block; because convert_stream() output has a fixed line length,
+ * the text of an unchanged block is located by arithmetic and spot-checked
+ * against one freshly formatted record before it is copied.
+ *
+ * With want_checksum and an input of unchanged size, the CRC is not
+ * recomputed: it is the previous header's CRC updated with the CRCs of the
+ * changed blocks only, using that this CRC (no reflection, initial value
+ * and final XOR 0) is linear and xcrc32_combine() to position each block.
+ * Otherwise the CRC is computed over the whole input.
+ *
+ * If the previous files are missing or were not produced with the same
+ * settings, every record is formatted; the conversion never fails because
+ * of them.
+ */
+class SrecIncrementalConverter {
+public:
+	using Options = SrecIncrementalOptions;
+	using Result = SrecIncrementalResult;
+
+	/**
+	 * @brief Convert a binary file, reusing the previous output where possible
+	 * @param input New binary file
+	 * @param previous_input Binary file the previous output was made from
+	 * @param previous_output S-record output of the previous conversion
+	 * @param output S-record file to write; must not be previous_output
+	 * @param options Conversion settings
+	 * @return Conversion totals
+	 * @throws SrecFileException on file errors
+	 * @throws SrecValidationException on validation errors or exceeded limits
+	 */
+	static Result convert(const std::string &input, const std::string &previous_input,
+	                      const std::string &previous_output, const std::string &output,
+	                      const Options &options = Options());
+};
+
+} // namespace tierone::srec
@@ -0,0 +1,348 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include "srec_crc.h"
+#include "srec_index.h"
+#include "srec_mapped.h"
+
+namespace tierone::srec {
+
+namespace {
+
+// Side-car layout, all integers little-endian:
+//   magic[8] version:u32 reserved:u32 source_size:u64 source_time:i64 count:u64
+//   count x { address:u32 length:u32 offset:u64 size:u64 line:u64 }
+//   crc:u32 over everything before it (xcrc32 with init 0)
+constexpr std::array<char, 8> INDEX_MAGIC{'S', 'R', 'E', 'C', 'I', 'D', 'X', '\n'};
+constexpr uint32_t INDEX_VERSION = 1;
+constexpr size_t HEADER_SIZE = 8 + 4 + 4 + 8 + 8 + 8;
+constexpr size_t ENTRY_SIZE = 4 + 4 + 8 + 8 + 8;
+
+template <typename T>
+void put(std::string &out, const T value) {
+	auto bits = static_cast<uint64_t>(value);
+	for (size_t i = 0; i < sizeof(T); ++i) {
+		out.push_back(static_cast<char>(bits & 0xFF));
+		bits >>= 8;
+	}
+}
+
+template <typename T>
+T get(const char *&in) {
+	uint64_t bits = 0;
+	for (size_t i = 0; i < sizeof(T); ++i) {
+		bits |= static_cast<uint64_t>(static_cast<uint8_t>(in[i])) << (8 * i);
+	}
+	in += sizeof(T);
+	return static_cast<T>(bits);
+}
+
+// Size and modification time, the two properties an index is tied to
+bool file_stamp(const std::string &filename, uint64_t &size, int64_t &time) {
+	std::error_code error;
+	const auto file_size = std::filesystem::file_size(filename, error);
+	if (error) {
+		return false;
+	}
+	const auto write_time = std::filesystem::last_write_time(filename, error);
+	if (error) {
+		return false;
+	}
+	size = static_cast<uint64_t>(file_size);
+	time = static_cast<int64_t>(write_time.time_since_epoch().count());
+	return true;
+}
+
+bool is_data_record(const Srec::Type type) {
+	return type == Srec::Type::S1 || type == Srec::Type::S2 || type == Srec::Type::S3;
+}
+
+} // namespace
+
+SrecIndex SrecIndex::build(const std::string &filename, const bool validate_checksums,
+                           const size_t records_per_entry) {
+	SrecIndex index;
+	if (!file_stamp(filename, index.file_size, index.file_time)) {
+		throw SrecFileException("Failed to open file", filename);
+	}
+
+	SrecMappedReader reader(filename, validate_checksums);
+	SrecStreamParser::ParsedRecordView record{};
+	const size_t group = std::max<size_t>(records_per_entry, 1);
+	SrecIndexEntry current{};
+	size_t grouped = 0; // records in 'current', 0 when no entry is open
+	size_t line_start = reader.offset();
+	size_t first_line = reader.line_number() + 1;
+
+	while (reader.next(record)) {
+		if (is_data_record(record.type)) {
+			if (record.length > 0) {
+				if (grouped > 0 && grouped < group && record.address == current.end() &&
+				    current.length <= std::numeric_limits<uint32_t>::max() - record.length) {
+					current.length += static_cast<uint32_t>(record.length);
+					++grouped;
+				} else {
+					if (grouped > 0) {
+						index.entry_list.push_back(current);
+					}
+					current = SrecIndexEntry{record.address, static_cast<uint32_t>(record.length),
+					                         line_start, 0, first_line};
+					grouped = 1;
+				}
+				current.size = reader.offset() - current.offset;
+			}
+		} else if (grouped > 0) {
+			index.entry_list.push_back(current);
+			grouped = 0;
+		}
+		line_start = reader.offset();
+		first_line = reader.line_number() + 1;
+	}
+	if (grouped > 0) {
+		index.entry_list.push_back(current);
+	}
+
+	if (!index.is_current(filename) || reader.size() != index.file_size) {
+		throw SrecFileException("File changed while indexing", filename);
+	}
+	index.finish();
+	return index;
+}
+
+SrecIndex SrecIndex::load(const std::string &index_filename) {
+	std::ifstream input(index_filename, std::ios::binary);
+	if (!input.is_open()) {
+		throw SrecFileException("Failed to open index file", index_filename);
+	}
+	const std::string bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	if (input.bad()) {
+		throw SrecFileException("Failed to read index file", index_filename);
+	}
+
+	const auto invalid = [&index_filename]() {
+		return SrecFileException("Invalid index file", index_filename);
+	};
+	if (bytes.size() < HEADER_SIZE + 4 || std::memcmp(bytes.data(), INDEX_MAGIC.data(), INDEX_MAGIC.size()) != 0) {
+		throw invalid();
+	}
+	const char *in = bytes.data() + bytes.size() - 4;
+	const auto stored_crc = get<uint32_t>(in);
+	if (crc32_update(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size() - 4, 0) != stored_crc) {
+		throw invalid();
+	}
+
+	SrecIndex index;
+	in = bytes.data() + INDEX_MAGIC.size();
+	if (get<uint32_t>(in) != INDEX_VERSION) {
+		throw invalid();
+	}
+	get<uint32_t>(in);
+	index.file_size = get<uint64_t>(in);
+	index.file_time = get<int64_t>(in);
+	const auto count = get<uint64_t>(in);
+	if (count != (bytes.size() - HEADER_SIZE - 4) / ENTRY_SIZE || (bytes.size() - HEADER_SIZE - 4) % ENTRY_SIZE != 0) {
+		throw invalid();
+	}
+
+	index.entry_list.resize(static_cast<size_t>(count));
+	for (auto &entry : index.entry_list) {
+		entry.address = get<uint32_t>(in);
+		entry.length = get<uint32_t>(in);
+		entry.offset = get<uint64_t>(in);
+		entry.size = get<uint64_t>(in);
+		entry.line = get<uint64_t>(in);
+		if (entry.offset > index.file_size || entry.size > index.file_size - entry.offset) {
+			throw invalid();
+		}
+	}
+	index.finish();
+	return index;
+}
+
+SrecIndex SrecIndex::open(const std::string &filename, const bool validate_checksums) {
+	const std::string sidecar = sidecar_path(filename);
+	try {
+		SrecIndex index = load(sidecar);
+		if (index.is_current(filename)) {
+			return index;
+		}
+	} catch (const SrecFileException &) {
+		// Missing or damaged side-car; rebuild it below
+	}
+
+	SrecIndex index = build(filename, validate_checksums);
+	try {
+		index.save(sidecar);
+	} catch (const SrecFileException &) {
+		// The index still works from memory
+	}
+	return index;
+}
+
+void SrecIndex::save(const std::string &index_filename) const {
+	std::string bytes;
+	bytes.reserve(HEADER_SIZE + entry_list.size() * ENTRY_SIZE + 4);
+	bytes.append(INDEX_MAGIC.data(), INDEX_MAGIC.size());
+	put(bytes, INDEX_VERSION);
+	put(bytes, uint32_t{0});
+	put(bytes, file_size);
+	put(bytes, file_time);
+	put(bytes, static_cast<uint64_t>(entry_list.size()));
+	for (const auto &entry : entry_list) {
+		put(bytes, entry.address);
+		put(bytes, entry.length);
+		put(bytes, entry.offset);
+		put(bytes, entry.size);
+		put(bytes, entry.line);
+	}
+	put(bytes, crc32_update(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size(), 0));
+
+	std::ofstream output(index_filename, std::ios::binary | std::ios::trunc);
+	if (!output.is_open()) {
+		throw SrecFileException("Failed to open index file", index_filename);
+	}
+	output.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	output.close();
+	if (!output) {
+		throw SrecFileException("Failed to write index file", index_filename);
+	}
+}
+
+bool SrecIndex::is_current(const std::string &filename) const {
+	uint64_t size = 0;
+	int64_t time = 0;
+	return file_stamp(filename, size, time) && size == file_size && time == file_time;
+}
+
+void SrecIndex::find(const uint32_t address, const size_t length,
+                     std::vector<const SrecIndexEntry *> &matches) const {
+	matches.clear();
+	if (length == 0) {
+		return;
+	}
+	const uint64_t end = static_cast<uint64_t>(address) + length;
+
+	// max_end is non-decreasing, so every earlier entry ends at or before 'address'
+	auto first = static_cast<size_t>(std::partition_point(max_end.begin(), max_end.end(),
+		[address](const uint64_t entry_end) { return entry_end <= address; }) - max_end.begin());
+	for (; first < entry_list.size() && entry_list[first].address < end; ++first) {
+		if (entry_list[first].end() > address) {
+			matches.push_back(&entry_list[first]);
+		}
+	}
+	std::sort(matches.begin(), matches.end(), [](const SrecIndexEntry *a, const SrecIndexEntry *b) {
+		return a->offset < b->offset;
+	});
+}
+
+void SrecIndex::finish() {
+	std::stable_sort(entry_list.begin(), entry_list.end(), [](const SrecIndexEntry &a, const SrecIndexEntry &b) {
+		return a.address != b.address ? a.address < b.address : a.offset < b.offset;
+	});
+	max_end.resize(entry_list.size());
+	uint64_t highest = 0;
+	for (size_t i = 0; i < entry_list.size(); ++i) {
+		highest = std::max(highest, entry_list[i].end());
+		max_end[i] = highest;
+	}
+}
+
+SrecIndexedReader::SrecIndexedReader(const std::string &file_name, const bool validate_checksums)
+	: SrecIndexedReader(file_name, SrecIndex::open(file_name, validate_checksums), validate_checksums)
+{
+}
+
+SrecIndexedReader::SrecIndexedReader(const std::string &file_name, SrecIndex index, const bool validate_checksums)
+	: filename(file_name),
+	  file_index(std::move(index)),
+	  validate(validate_checksums),
+	  input(file_name, std::ios::binary)
+{
+	if (!input.is_open()) {
+		throw SrecFileException("Failed to open file", filename);
+	}
+	if (!is_current()) {
+		throw SrecFileException("Index is out of date", filename);
+	}
+}
+
+size_t SrecIndexedReader::read(const uint32_t address, uint8_t *out, const size_t length) {
+	std::memset(out, fill, length);
+	if (!is_current()) {
+		throw SrecFileException("Index is out of date", filename);
+	}
+
+	const uint64_t end = static_cast<uint64_t>(address) + length;
+	file_index.find(address, length, candidates);
+	std::vector<std::pair<uint64_t, uint64_t>> covered;
+	covered.reserve(candidates.size());
+
+	for (const SrecIndexEntry *entry : candidates) {
+		text.resize(static_cast<size_t>(entry->size));
+		input.clear();
+		input.seekg(static_cast<std::streamoff>(entry->offset));
+		input.read(text.data(), static_cast<std::streamsize>(text.size()));
+		if (static_cast<size_t>(input.gcount()) != text.size()) {
+			throw SrecFileException("Index does not match file", filename);
+		}
+
+		SrecMappedReader lines(text.data(), text.size(), validate, static_cast<size_t>(entry->line));
+		SrecStreamParser::ParsedRecordView record{};
+		uint64_t expected = entry->address;
+		while (lines.next(record)) {
+			if (!is_data_record(record.type) || record.length == 0) {
+				continue;
+			}
+			if (record.address != expected) {
+				throw SrecFileException("Index does not match file", filename);
+			}
+			const uint64_t record_end = expected + record.length;
+			const uint64_t first = std::max<uint64_t>(expected, address);
+			const uint64_t last = std::min<uint64_t>(record_end, end);
+			if (first < last) {
+				std::memcpy(out + (first - address), record.data + (first - expected), static_cast<size_t>(last - first));
+			}
+			expected = record_end;
+		}
+		if (expected != entry->end()) {
+			throw SrecFileException("Index does not match file", filename);
+		}
+		covered.emplace_back(std::max<uint64_t>(entry->address, address), std::min(entry->end(), end));
+	}
+
+	// Entries may overlap, so count the union of what they covered
+	std::sort(covered.begin(), covered.end());
+	size_t defined = 0;
+	uint64_t reached = address;
+	for (const auto &[first, last] : covered) {
+		const uint64_t from = std::max(first, reached);
+		if (last > from) {
+			defined += static_cast<size_t>(last - from);
+			reached = last;
+		}
+	}
+	return defined;
+}
+
+} // namespace tierone::srec
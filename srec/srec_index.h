@@ -0,0 +1,279 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "srec_exceptions.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief One run of address-contiguous data records in an S-record file
+ */
+struct SrecIndexEntry {
+	uint32_t address; ///< Address of the first byte
+	uint32_t length;  ///< Number of bytes covered by the run
+	uint64_t offset;  ///< File offset of the run's first line
+	uint64_t size;    ///< Number of characters from offset to the end of the run's last line
+	uint64_t line;    ///< Line number of the run's first line (1-based)
+
+	/**
+	 * @brief Get the address one past the last byte
+	 * @return End address; may be 2^32 for a run ending at the top of memory
+	 */
+	uint64_t end() const {
+		return static_cast<uint64_t>(address) + length;
+	}
+
+	bool operator==(const SrecIndexEntry &other) const {
+		return address == other.address && length == other.length && offset == other.offset &&
+		       size == other.size && line == other.line;
+	}
+};
+
+/**
+ * @brief Address index of an S-record file
+ *
+ * Built in one pass over the file. Consecutive data records that continue
+ * each other's address range are grouped into entries of up to
+ * records_per_entry records, so a lookup only has to decode the lines of
+ * the entries it overlaps. Entries are kept sorted by address.
+ *
+ * The index remembers the size and modification time of the file it was
+ * built from; is_current() tells whether it still describes that file.
+ * An index can be kept in memory or saved next to the file as a side-car
+ * (see sidecar_path()).
+ *
+ * @note This class is thread-safe for reading operations only.
+ */
+class SrecIndex {
+public:
+	/// Default number of data records grouped into one entry
+	static constexpr size_t DEFAULT_RECORDS_PER_ENTRY = 64;
+
+	SrecIndex() = default;
+
+	/**
+	 * @brief Index an S-record file
+	 * @param filename Path to S-record file
+	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @param records_per_entry Maximum number of records per entry (default: 64)
+	 * @return Index of the file
+	 * @throws SrecFileException on file I/O errors or if the file changes while indexing
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	static SrecIndex build(const std::string &filename, bool validate_checksums = true,
+	                       size_t records_per_entry = DEFAULT_RECORDS_PER_ENTRY);
+
+	/**
+	 * @brief Read an index written by save()
+	 * @param index_filename Path to the index file
+	 * @return Loaded index
+	 * @throws SrecFileException if the file cannot be read or is not a valid index
+	 */
+	static SrecIndex load(const std::string &index_filename);
+
+	/**
+	 * @brief Use the side-car index of a file, rebuilding it when needed
+	 *
+	 * Loads sidecar_path(filename) if it exists and is current. Otherwise
+	 * the file is indexed and the side-car rewritten; failing to write the
+	 * side-car (e.g. in a read-only directory) is not an error.
+	 *
+	 * @param filename Path to S-record file
+	 * @param validate_checksums Whether to validate checksums when building (default: true)
+	 * @return Current index of the file
+	 * @throws SrecFileException on file I/O errors
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	static SrecIndex open(const std::string &filename, bool validate_checksums = true);
+
+	/**
+	 * @brief Get the default side-car location for a file
+	 * @param filename Path to S-record file
+	 * @return filename with ".sidx" appended
+	 */
+	static std::string sidecar_path(const std::string &filename) {
+		return filename + ".sidx";
+	}
+
+	/**
+	 * @brief Write the index to a file
+	 * @param index_filename Path to the index file
+	 * @throws SrecFileException on file I/O errors
+	 */
+	void save(const std::string &index_filename) const;
+
+	/**
+	 * @brief Check whether the index still describes a file
+	 * @param filename Path to the S-record file the index was built from
+	 * @return true if the file's size and modification time are unchanged
+	 */
+	bool is_current(const std::string &filename) const;
+
+	/**
+	 * @brief Find the entries overlapping an address range
+	 * @param address First address of the range
+	 * @param length Number of bytes
+	 * @param matches Receives the overlapping entries in file order, so
+	 *                applying them in sequence lets later records win
+	 */
+	void find(uint32_t address, size_t length, std::vector<const SrecIndexEntry *> &matches) const;
+
+	/**
+	 * @brief Get all entries
+	 * @return Entries sorted by address, then by file offset
+	 */
+	const std::vector<SrecIndexEntry> &entries() const {
+		return entry_list;
+	}
+
+	/**
+	 * @brief Get the size of the indexed file
+	 * @return Size in bytes when the index was built
+	 */
+	uint64_t source_size() const {
+		return file_size;
+	}
+
+	/**
+	 * @brief Get the modification time of the indexed file
+	 * @return File time in the file system clock's native units
+	 */
+	int64_t source_time() const {
+		return file_time;
+	}
+
+private:
+	void finish();
+
+	std::vector<SrecIndexEntry> entry_list;
+	std::vector<uint64_t> max_end; // running maximum of end() over entry_list
+	uint64_t file_size{0};
+	int64_t file_time{0};
+};
+
+/**
+ * @brief Random access to the data of an indexed S-record file
+ *
+ * read() seeks straight to the lines covering the requested range and
+ * decodes only those. Every read first checks that the file still matches
+ * the index, and each decoded entry is checked against the addresses the
+ * index recorded for it.
+ *
+ * @note This class is not thread-safe
+ */
+class SrecIndexedReader {
+public:
+	/**
+	 * @brief Open a file using its side-car index
+	 * @param filename Path to S-record file
+	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @throws SrecFileException on file I/O errors
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 * @see SrecIndex::open()
+	 */
+	explicit SrecIndexedReader(const std::string &filename, bool validate_checksums = true);
+
+	/**
+	 * @brief Open a file with an index supplied by the caller
+	 * @param filename Path to S-record file
+	 * @param index Index built from the file
+	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @throws SrecFileException if the file cannot be opened or the index is out of date
+	 */
+	SrecIndexedReader(const std::string &filename, SrecIndex index, bool validate_checksums = true);
+
+	SrecIndexedReader(const SrecIndexedReader &) = delete;
+	SrecIndexedReader &operator=(const SrecIndexedReader &) = delete;
+
+	/**
+	 * @brief Copy a range out of the file
+	 * @param address First address of the range
+	 * @param out Receives length bytes; undefined bytes are set to the fill byte
+	 * @param length Number of bytes
+	 * @return Number of bytes that were defined in the file
+	 * @throws SrecFileException if the file changed since it was indexed
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	size_t read(uint32_t address, uint8_t *out, size_t length);
+
+	/**
+	 * @brief Copy a range out of the file
+	 * @param address First address of the range
+	 * @param length Number of bytes
+	 * @return The bytes, with undefined ones set to the fill byte
+	 * @see read(uint32_t, uint8_t *, size_t)
+	 */
+	std::vector<uint8_t> read(uint32_t address, size_t length) {
+		std::vector<uint8_t> bytes(length);
+		read(address, bytes.data(), length);
+		return bytes;
+	}
+
+	/**
+	 * @brief Check whether the file still matches the index
+	 * @return true if the file's size and modification time are unchanged
+	 */
+	bool is_current() const {
+		return file_index.is_current(filename);
+	}
+
+	/**
+	 * @brief Get the index in use
+	 * @return Index of the file
+	 */
+	const SrecIndex &index() const {
+		return file_index;
+	}
+
+	/**
+	 * @brief Get the byte used for undefined addresses
+	 * @return Fill byte (default 0x00)
+	 */
+	uint8_t fill_byte() const {
+		return fill;
+	}
+
+	/**
+	 * @brief Set the byte used for undefined addresses
+	 * @param value Fill byte
+	 */
+	void set_fill_byte(uint8_t value) {
+		fill = value;
+	}
+
+private:
+	std::string filename;
+	SrecIndex file_index;
+	bool validate;
+	uint8_t fill{0x00};
+	std::ifstream input;
+	std::vector<char> text;                         // lines of the entry being decoded
+	std::vector<const SrecIndexEntry *> candidates; // reused by read()
+};
+
+} // namespace tierone::srec
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SREC_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include "srec_mapped.h"
+
+namespace tierone::srec {
+
+namespace {
+
+// Block size used when the file has to be read instead of mapped
+constexpr size_t READ_BLOCK_SIZE = 1024 * 1024;
+
+} // namespace
+
+SrecMappedFile::SrecMappedFile(const std::string &file_name) : filename(file_name) {
+#if defined(SREC_HAVE_MMAP)
+	const int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw SrecFileException("Failed to open file", filename);
+	}
+
+	struct stat info{};
+	if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+		const auto file_size = static_cast<size_t>(info.st_size);
+		void *map = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			::posix_madvise(map, file_size, POSIX_MADV_SEQUENTIAL);
+			contents = static_cast<const char *>(map);
+			length = file_size;
+			mapped = true;
+			::close(fd);
+			return;
+		}
+	}
+
+	// Not mappable: read the whole file in large blocks
+	size_t used = 0;
+	for (;;) {
+		if (buffer.size() - used < READ_BLOCK_SIZE) {
+			buffer.resize(used + READ_BLOCK_SIZE);
+		}
+		const ssize_t count = ::read(fd, buffer.data() + used, READ_BLOCK_SIZE);
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			::close(fd);
+			throw SrecFileException("Failed to read file", filename);
+		}
+		if (count == 0) {
+			break;
+		}
+		used += static_cast<size_t>(count);
+	}
+	::close(fd);
+#else
+	std::ifstream input(filename, std::ios::binary);
+	if (!input.is_open()) {
+		throw SrecFileException("Failed to open file", filename);
+	}
+
+	size_t used = 0;
+	for (;;) {
+		buffer.resize(used + READ_BLOCK_SIZE);
+		input.read(buffer.data() + used, static_cast<std::streamsize>(READ_BLOCK_SIZE));
+		const auto count = static_cast<size_t>(input.gcount());
+		used += count;
+		if (count < READ_BLOCK_SIZE) {
+			break;
+		}
+	}
+	if (input.bad()) {
+		throw SrecFileException("Failed to read file", filename);
+	}
+#endif
+	buffer.resize(used);
+	contents = buffer.data();
+	length = used;
+}
+
+SrecMappedFile::~SrecMappedFile() {
+#if defined(SREC_HAVE_MMAP)
+	if (mapped) {
+		::munmap(const_cast<char *>(contents), length);
+	}
+#endif
+}
+
+SrecMappedReader::SrecMappedReader(const std::string &filename, bool validate_checksums, const SrecLimits &limits)
+	: file(std::make_unique<SrecMappedFile>(filename)),
+	  text(file->data(), file->size()),
+	  validate(validate_checksums),
+	  limit(limits)
+{
+	check_size();
+}
+
+SrecMappedReader::SrecMappedReader(const char *data, size_t size, bool validate_checksums, size_t first_line)
+	: text(data, size),
+	  current_line(first_line - 1),
+	  validate(validate_checksums)
+{
+}
+
+bool SrecMappedReader::next(ParsedRecordView &record, uint8_t *destination) {
+	SrecParseResult result;
+	if (try_next(record, result, destination)) {
+		return true;
+	}
+	if (!result.ok()) {
+		result.throw_exception();
+	}
+	return false;
+}
+
+bool SrecMappedReader::try_next(ParsedRecordView &record, SrecParseResult &result, uint8_t *destination) {
+	if (!(SrecStats::ENABLED && stats)) {
+		return read_record(record, destination, result);
+	}
+	SrecStatsTimer timer(stats, SrecStats::Phase::DECODE);
+	const size_t start = position;
+	const bool found = read_record(record, destination, result);
+	stats->bytes_in += position - start;
+	if (found) {
+		stats->count_record(record.type);
+	}
+	return found;
+}
+
+bool SrecMappedReader::read_record(ParsedRecordView &record, uint8_t *destination, SrecParseResult &result) {
+	result = SrecParseResult();
+	while (position < text.size()) {
+		const char *start = text.data() + position;
+		const size_t remaining = text.size() - position;
+		const auto *newline = static_cast<const char *>(std::memchr(start, '\n', remaining));
+		const size_t line_length = newline ? static_cast<size_t>(newline - start) : remaining;
+
+		position += line_length + (newline ? 1 : 0);
+		++current_line;
+
+		const std::string_view line(start, line_length);
+		if (SrecStreamParser::is_blank(line)) {
+			continue;
+		}
+
+		const std::string_view trimmed = SrecStreamParser::trim_trailing(line);
+		if (parse_data && parse_data(trimmed, current_line, validate, destination, record)) {
+			count_data_record();
+			return true;
+		}
+		result = SrecStreamParser::try_parse_line(trimmed, current_line, validate, destination, record);
+		if (!result.ok()) {
+			return false;
+		}
+		if (!parse_data) {
+			parse_data = data_record_parser(record.type);
+		}
+		switch (record.type) {
+			case Srec::Type::S1:
+			case Srec::Type::S2:
+			case Srec::Type::S3:
+				count_data_record();
+				break;
+			case Srec::Type::S0:
+			case Srec::Type::S5:
+			case Srec::Type::S6:
+			case Srec::Type::S7:
+			case Srec::Type::S8:
+			case Srec::Type::S9:
+			default:
+				break;
+		}
+		return true;
+	}
+	return false;
+}
+
+void SrecMappedReader::check_size() const {
+	if (consumed > limit.max_file_size || text.size() > limit.max_file_size - consumed) {
+		throw SrecValidationException(
+			"Maximum file size exceeded",
+			SrecValidationException::ValidationError::DATA_TOO_LARGE
+		);
+	}
+}
+
+void SrecMappedReader::count_data_record() {
+	if (++data_records > limit.max_records) {
+		throw SrecValidationException(
+			"Maximum record count exceeded on line " + std::to_string(current_line),
+			SrecValidationException::ValidationError::DATA_TOO_LARGE
+		);
+	}
+}
+
+void SrecMappedReader::parse(const SrecStreamParser::RecordCallback &callback) {
+	ParsedRecordView view{};
+	SrecStreamParser::ParsedRecord record{};
+	while (next(view)) {
+		view.copy_to(record);
+		if (!callback(record)) {
+			break; // User requested to stop parsing
+		}
+	}
+}
+
+} // namespace tierone::srec
@@ -0,0 +1,356 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "srec.h"
+#include "srec_codec.h"
+#include "srec_stats.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief Read-only view of a whole file's contents
+ *
+ * Regular files are memory-mapped. When mapping is not possible (pipes,
+ * character devices, platforms without mmap) the file is read into memory
+ * in large blocks instead.
+ *
+ * @note This class is thread-safe for reading operations only.
+ */
+class SrecMappedFile {
+public:
+	/**
+	 * @brief Map or read the given file
+	 * @param filename Path to the file
+	 * @throws SrecFileException if the file cannot be opened or read
+	 */
+	explicit SrecMappedFile(const std::string &filename);
+	~SrecMappedFile();
+
+	SrecMappedFile(const SrecMappedFile &) = delete;
+	SrecMappedFile &operator=(const SrecMappedFile &) = delete;
+
+	/**
+	 * @brief Get the file contents
+	 * @return Pointer to the first byte (may be nullptr for an empty file)
+	 */
+	const char *data() const {
+		return contents;
+	}
+
+	/**
+	 * @brief Get the file size
+	 * @return Number of bytes available through data()
+	 */
+	size_t size() const {
+		return length;
+	}
+
+	/**
+	 * @brief Check whether the contents are memory-mapped
+	 * @return true if mapped, false if read into a heap buffer
+	 */
+	bool is_mapped() const {
+		return mapped;
+	}
+
+	/**
+	 * @brief Get the file name
+	 * @return Filename as provided to constructor
+	 */
+	const std::string &getFilename() const {
+		return filename;
+	}
+
+private:
+	std::string filename;
+	const char *contents{nullptr};
+	size_t length{0};
+	bool mapped{false};
+	std::vector<char> buffer; // used when the file is not mapped
+};
+
+/**
+ * @brief Input iterator over the records of a pull-based reader
+ *
+ * Works with any reader offering bool next(ParsedRecordView &). The
+ * referenced record is valid until the iterator is advanced.
+ *
+ * @tparam Reader Reader type, e.g. SrecMappedReader or SrecReader
+ */
+template <typename Reader>
+class SrecRecordIterator {
+public:
+	using iterator_category = std::input_iterator_tag;
+	using value_type = SrecStreamParser::ParsedRecordView;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const value_type *;
+	using reference = const value_type &;
+
+	/// End iterator
+	SrecRecordIterator() = default;
+
+	/// Iterator reading the next record from 'source'
+	explicit SrecRecordIterator(Reader &source) : reader(&source) {
+		++*this;
+	}
+
+	reference operator*() const {
+		return record;
+	}
+
+	pointer operator->() const {
+		return &record;
+	}
+
+	SrecRecordIterator &operator++() {
+		if (!reader->next(record)) {
+			reader = nullptr;
+		}
+		return *this;
+	}
+
+	void operator++(int) {
+		++*this;
+	}
+
+	bool operator==(const SrecRecordIterator &other) const {
+		return reader == other.reader;
+	}
+
+	bool operator!=(const SrecRecordIterator &other) const {
+		return reader != other.reader;
+	}
+
+private:
+	Reader *reader{nullptr};
+	value_type record{};
+};
+
+/**
+ * @brief Zero-copy S-record reader over a mapped file or memory buffer
+ *
+ * Line boundaries are located with memchr directly in the mapped data and
+ * each record's payload is decoded into a reusable internal buffer or a
+ * caller supplied one. No memory is allocated per line.
+ *
+ * Line handling matches SrecStreamParser::parse_stream: blank lines are
+ * skipped and trailing whitespace (including '\r') is ignored.
+ *
+ * @note This class is not thread-safe
+ */
+class SrecMappedReader {
+public:
+	using ParsedRecordView = SrecStreamParser::ParsedRecordView;
+
+	/**
+	 * @brief Open a file for reading
+	 * @param filename Path to S-record file
+	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @param limits Record count and size limits (default: SrecLimits::unlimited())
+	 * @throws SrecFileException if the file cannot be opened
+	 * @throws SrecValidationException if the file is larger than the limits allow
+	 */
+	explicit SrecMappedReader(const std::string &filename, bool validate_checksums = true,
+	                          const SrecLimits &limits = SrecLimits::unlimited());
+
+	/**
+	 * @brief Read S-records from memory owned by the caller
+	 * @param data S-record text
+	 * @param size Number of characters
+	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @param first_line Line number of the first line in 'data' (default: 1)
+	 * @note The memory must outlive the reader
+	 */
+	SrecMappedReader(const char *data, size_t size, bool validate_checksums = true, size_t first_line = 1);
+
+	/**
+	 * @brief Parse the next record into the internal payload buffer
+	 * @param record Receives the record; its data is valid until the next call
+	 * @return true if a record was read, false at end of input
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on checksum mismatch
+	 */
+	bool next(ParsedRecordView &record) {
+		return next(record, payload.data());
+	}
+
+	/**
+	 * @brief Parse the next record, decoding the payload into caller memory
+	 *
+	 * Lets callers place payloads back to back in an arena of their own,
+	 * advancing the destination by record.length after each call.
+	 *
+	 * @param record Receives the record; its data points into 'destination'
+	 * @param destination At least SrecStreamParser::MAX_RECORD_DATA_SIZE bytes
+	 * @return true if a record was read, false at end of input
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on checksum mismatch or exceeded limits
+	 */
+	bool next(ParsedRecordView &record, uint8_t *destination);
+
+	/**
+	 * @brief Parse the next record, reporting malformed lines without throwing
+	 *
+	 * For untrusted input: a rejected line is consumed, so calling again
+	 * carries on with the line after it.
+	 *
+	 * @param record Receives the record; its data points into 'destination'
+	 * @param result Receives the error of a rejected line; ok() otherwise
+	 * @param destination At least SrecStreamParser::MAX_RECORD_DATA_SIZE bytes
+	 * @return true if a record was read, false at end of input or on a rejected line
+	 * @throws SrecValidationException if the limits are exceeded
+	 */
+	bool try_next(ParsedRecordView &record, SrecParseResult &result, uint8_t *destination);
+
+	/**
+	 * @brief Parse the next record into the internal payload buffer without throwing
+	 * @param record Receives the record; its data is valid until the next call
+	 * @param result Receives the error of a rejected line; ok() otherwise
+	 * @return true if a record was read, false at end of input or on a rejected line
+	 * @throws SrecValidationException if the limits are exceeded
+	 */
+	bool try_next(ParsedRecordView &record, SrecParseResult &result) {
+		return try_next(record, result, payload.data());
+	}
+
+	/**
+	 * @brief Parse all remaining records through the callback interface
+	 * @param callback Function called for each parsed record
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	void parse(const SrecStreamParser::RecordCallback &callback);
+
+	/**
+	 * @brief Continue reading from another buffer
+	 *
+	 * Used to feed a text in pieces that each end on a line boundary. Line
+	 * numbering carries on from the previous buffer. Records returned
+	 * earlier stay valid until the next call to next().
+	 *
+	 * @param data S-record text; must outlive the reader or the next call
+	 * @param size Number of characters
+	 * @throws SrecValidationException if the text read so far exceeds the limits
+	 */
+	void continue_with(const char *data, size_t size) {
+		consumed += text.size();
+		text = std::string_view(data, size);
+		position = 0;
+		check_size();
+	}
+
+	/**
+	 * @brief Get the record count and size limits
+	 * @return Limits applied while reading
+	 */
+	const SrecLimits &limits() const {
+		return limit;
+	}
+
+	/**
+	 * @brief Replace the record count and size limits
+	 *
+	 * max_records bounds the number of data records (S1/S2/S3) and
+	 * max_file_size the number of characters. Both are checked against
+	 * everything read so far, the size once per buffer.
+	 *
+	 * @param limits New limits
+	 * @throws SrecValidationException if the input read so far exceeds them
+	 */
+	void set_limits(const SrecLimits &limits) {
+		limit = limits;
+		check_size();
+	}
+
+	/**
+	 * @brief Attach statistics to update while reading
+	 *
+	 * Every next() then adds the characters it consumed, counts the
+	 * record's type and charges its time to SrecStats::Phase::DECODE.
+	 *
+	 * @param statistics Statistics to update, or nullptr to stop
+	 * @note The statistics must outlive the reader or be detached first
+	 */
+	void set_stats(SrecStats *statistics) {
+		stats = statistics;
+	}
+
+	/**
+	 * @brief Iterate over the remaining records
+	 * @return Iterator to the next record
+	 * @note Advancing the iterator calls next(); errors are thrown from there
+	 */
+	SrecRecordIterator<SrecMappedReader> begin() {
+		return SrecRecordIterator<SrecMappedReader>(*this);
+	}
+
+	SrecRecordIterator<SrecMappedReader> end() {
+		return SrecRecordIterator<SrecMappedReader>();
+	}
+
+	/**
+	 * @brief Get the number of the last line read (1-based)
+	 * @return Line number, one less than the first line before the first call to next()
+	 */
+	size_t line_number() const {
+		return current_line;
+	}
+
+	/**
+	 * @brief Get the offset of the next unread character
+	 * @return Byte offset into the input
+	 */
+	size_t offset() const {
+		return position;
+	}
+
+	/**
+	 * @brief Get the total input size
+	 * @return Number of characters in the input
+	 */
+	size_t size() const {
+		return text.size();
+	}
+
+private:
+	bool read_record(ParsedRecordView &record, uint8_t *destination, SrecParseResult &result);
+	void check_size() const;
+	void count_data_record();
+
+	std::unique_ptr<SrecMappedFile> file; // owned mapping, if opened by filename
+	std::string_view text;
+	size_t position{0};
+	size_t current_line{0};
+	bool validate;
+	SrecLimits limit{SrecLimits::unlimited()};
+	uint64_t consumed{0};     // characters of earlier buffers
+	uint64_t data_records{0}; // data records returned so far
+	SrecStats *stats{nullptr};
+	DataRecordParser parse_data{nullptr}; // decoder for the file's data record type
+	std::array<uint8_t, SrecStreamParser::MAX_RECORD_DATA_SIZE> payload{};
+};
+
+} // namespace tierone::srec
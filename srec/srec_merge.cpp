@@ -0,0 +1,266 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "srec_merge.h"
+
+namespace tierone::srec {
+
+namespace {
+
+std::string hex_address(const uint64_t address) {
+	std::ostringstream text;
+	text << "0x" << std::hex << std::uppercase << std::setw(8) << std::setfill('0') << address;
+	return text.str();
+}
+
+// Collects the merged bytes into runs of whole records for SrecFile
+class RunWriter {
+public:
+	RunWriter(SrecFile &file, const size_t records)
+		: output(file),
+		  capacity(std::max<size_t>(records, 1) * std::max<size_t>(file.max_data_bytes_per_record(), 1))
+	{
+		run.reserve(capacity);
+	}
+
+	void append(const uint64_t address, const uint8_t *data, size_t length, SrecMergeResult &result) {
+		if (length == 0) {
+			return;
+		}
+		if (address != run_start + run.size() || result.segments == 0) {
+			flush();
+			run_start = address;
+			++result.segments;
+		}
+		result.output_bytes += length;
+		while (length > 0) {
+			const size_t count = std::min(length, capacity - run.size());
+			run.insert(run.end(), data, data + count);
+			data += count;
+			length -= count;
+			if (run.size() == capacity) {
+				flush();
+			}
+		}
+	}
+
+	void flush() {
+		if (run.empty()) {
+			return;
+		}
+		const SrecSegment segment{static_cast<uint32_t>(run_start), run.data(), run.size()};
+		output.write_segments(&segment, 1);
+		run_start += run.size();
+		run.clear();
+	}
+
+private:
+	SrecFile &output;
+	size_t capacity;
+	std::vector<uint8_t> run;
+	uint64_t run_start{0};
+};
+
+} // namespace
+
+// One input and its current data record
+struct SrecMerger::Source {
+	std::string name;
+	SrecMappedReader reader;
+	SrecStreamParser::ParsedRecordView record{};
+	uint64_t start{0}; // address range of the current data record
+	uint64_t end{0};
+	bool active{false};
+	std::optional<uint32_t> entry_point;
+
+	Source(std::string source_name, const std::string &filename, const bool validate)
+		: name(std::move(source_name)),
+		  reader(filename, validate)
+	{
+	}
+
+	Source(std::string source_name, const char *data, const size_t size, const bool validate)
+		: name(std::move(source_name)),
+		  reader(data, size, validate)
+	{
+	}
+};
+
+SrecMerger::SrecMerger(const Options &options)
+	: settings(options)
+{
+}
+
+SrecMerger::~SrecMerger() = default;
+
+void SrecMerger::add_file(const std::string &filename) {
+	sources.push_back(std::make_unique<Source>(filename, filename, settings.validate_checksums));
+}
+
+void SrecMerger::add_buffer(const char *data, const size_t size, const std::string &name) {
+	sources.push_back(std::make_unique<Source>(name, data, size, settings.validate_checksums));
+}
+
+void SrecMerger::advance(Source &source, SrecMergeResult &result) {
+	const uint64_t previous_end = source.active ? source.end : 0;
+	source.active = false;
+	while (source.reader.next(source.record)) {
+		switch (source.record.type) {
+			case Srec::Type::S1:
+			case Srec::Type::S2:
+			case Srec::Type::S3:
+				if (source.record.length == 0) {
+					break;
+				}
+				if (source.record.address < previous_end) {
+					throw SrecValidationException(
+						"Records are not in address order in " + source.name + " on line " +
+							std::to_string(source.reader.line_number()),
+						SrecValidationException::ValidationError::INVALID_FORMAT
+					);
+				}
+				source.start = source.record.address;
+				source.end = source.start + source.record.length;
+				source.active = true;
+				++result.input_records;
+				result.input_bytes += source.record.length;
+				return;
+			case Srec::Type::S7:
+			case Srec::Type::S8:
+			case Srec::Type::S9:
+				source.entry_point = source.record.address;
+				break;
+			case Srec::Type::S0:
+			case Srec::Type::S5:
+			case Srec::Type::S6:
+			default:
+				break;
+		}
+	}
+}
+
+SrecMergeResult SrecMerger::write(SrecFile &output) {
+	if (consumed) {
+		throw SrecFileException("Merge inputs have already been written");
+	}
+	consumed = true;
+
+	SrecMergeResult result;
+	for (auto &source : sources) {
+		advance(*source, result);
+	}
+
+	// Higher priority inputs win overlaps; ERROR never gets to resolve one
+	const bool last_wins = settings.overlap == SrecOverlapPolicy::LAST_WINS;
+	auto outranks = [last_wins](const size_t a, const size_t b) {
+		return last_wins ? a > b : a < b;
+	};
+
+	RunWriter writer(output, settings.run_records);
+	uint64_t position = 0;
+	for (;;) {
+		// Find the inputs covering 'position' and the nearest one starting after it
+		size_t winner = sources.size();
+		size_t covering = 0;
+		uint64_t next_start = UINT64_MAX;
+		for (size_t i = 0; i < sources.size(); ++i) {
+			Source &source = *sources[i];
+			while (source.active && source.end <= position) {
+				advance(source, result);
+			}
+			if (!source.active) {
+				continue;
+			}
+			if (source.start <= position) {
+				++covering;
+				if (winner == sources.size() || outranks(i, winner)) {
+					winner = i;
+				}
+			} else {
+				next_start = std::min(next_start, source.start);
+			}
+		}
+		if (winner == sources.size()) {
+			if (next_start == UINT64_MAX) {
+				break;
+			}
+			position = next_start; // a gap no input covers
+			continue;
+		}
+		if (covering > 1 && settings.overlap == SrecOverlapPolicy::ERROR) {
+			std::string names;
+			for (const auto &source : sources) {
+				if (source->active && source->start <= position) {
+					names += (names.empty() ? "" : ", ") + source->name;
+				}
+			}
+			throw SrecValidationException("Address overlap at " + hex_address(position) + " between " + names,
+			                              SrecValidationException::ValidationError::INVALID_ADDRESS);
+		}
+
+		// The winner supplies bytes until its record ends or an input that could win starts
+		const Source &source = *sources[winner];
+		uint64_t limit = source.end;
+		for (size_t i = 0; i < sources.size(); ++i) {
+			const Source &other = *sources[i];
+			if (i != winner && other.active && other.start > position &&
+			    (outranks(i, winner) || settings.overlap == SrecOverlapPolicy::ERROR)) {
+				limit = std::min(limit, other.start);
+			}
+		}
+		writer.append(position, source.record.data + (position - source.start),
+		              static_cast<size_t>(limit - position), result);
+		position = limit;
+	}
+	writer.flush();
+
+	// Entry point of the highest-priority input that has one
+	for (size_t i = 0; i < sources.size(); ++i) {
+		const Source &source = *sources[last_wins ? sources.size() - 1 - i : i];
+		if (source.entry_point) {
+			result.entry_point = source.entry_point;
+			break;
+		}
+	}
+	if (settings.set_entry_point && result.entry_point) {
+		output.set_execution_address(*result.entry_point);
+	}
+	return result;
+}
+
+SrecMergeResult SrecMerger::merge_files(const std::vector<std::string> &inputs, const std::string &output,
+                                        const SrecFile::AddressSize address_size, const Options &options) {
+	SrecMerger merger(options);
+	for (const auto &input : inputs) {
+		merger.add_file(input);
+	}
+
+	SrecFile sfile(output, address_size);
+	if (!sfile.is_open()) {
+		throw SrecFileException("Failed to create output file", output);
+	}
+	const SrecMergeResult result = merger.write(sfile);
+	sfile.write_record_count();
+	sfile.write_record_termination();
+	sfile.close();
+	return result;
+}
+
+} // namespace tierone::srec
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "srec.h"
+#include "srec_mapped.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief How bytes defined by more than one input are resolved
+ */
+enum class SrecOverlapPolicy {
+	ERROR,      ///< Throw on the first overlapping byte (default)
+	FIRST_WINS, ///< The input added first keeps its bytes
+	LAST_WINS   ///< The input added last overwrites the others
+};
+
+/**
+ * @brief Options for SrecMerger
+ */
+struct SrecMergeOptions {
+	/// Bytes per output run; whole records, so runs split exactly where writing everything at once would
+	static constexpr size_t DEFAULT_RUN_RECORDS = 256;
+
+	SrecOverlapPolicy overlap{SrecOverlapPolicy::ERROR}; ///< Overlap resolution
+	bool validate_checksums{true};                       ///< Whether to validate input checksums
+	bool set_entry_point{true};                          ///< Copy the winning input's entry point to the output
+	size_t run_records{DEFAULT_RUN_RECORDS};             ///< Data records buffered before writing a run
+};
+
+/**
+ * @brief Totals of a merge
+ */
+struct SrecMergeResult {
+	uint64_t input_records{0};   ///< Data records read from all inputs
+	uint64_t input_bytes{0};     ///< Data bytes read from all inputs
+	uint64_t output_bytes{0};    ///< Data bytes written to the output
+	size_t segments{0};          ///< Contiguous address ranges in the output
+	std::optional<uint32_t> entry_point; ///< Entry point taken from the inputs, if any
+
+	/**
+	 * @brief Get the number of input bytes replaced by other inputs
+	 * @return Bytes discarded by the overlap policy
+	 */
+	uint64_t overlap_bytes() const {
+		return input_bytes - output_bytes;
+	}
+};
+
+/**
+ * @brief Streaming k-way merge of S-record files into one output
+ *
+ * Every input is read record by record through its own SrecMappedReader
+ * and the inputs are swept together in address order, like the merge step
+ * of a merge sort. At each point the highest-priority input covering the
+ * current address supplies the bytes, up to where a higher-priority input
+ * starts, so overlaps are found and resolved without an image of the
+ * whole address space: memory use is one record per input plus one output
+ * run. Each step compares against the inputs' current records only, so
+ * the work is O(records * inputs) however many segments the inputs have.
+ *
+ * Inputs must list their data records in ascending, non-overlapping
+ * address order, as linkers write them; SrecMemoryImage can merge
+ * unordered files in memory instead. Header and count records are not
+ * copied. The entry point is taken from the highest-priority input that
+ * has a termination record (the first input for ERROR and FIRST_WINS).
+ *
+ * @code
+ * SrecMerger merger({SrecOverlapPolicy::LAST_WINS});
+ * merger.add_file("bootloader.s19");
+ * merger.add_file("application.s19");
+ * merger.add_file("calibration.s19");
+ * SrecFile output("merged.s19", SrecFile::AddressSize::BITS32);
+ * merger.write(output);
+ * output.write_record_count();
+ * output.write_record_termination();
+ * @endcode
+ *
+ * @note This class is not thread-safe
+ */
+class SrecMerger {
+public:
+	using Options = SrecMergeOptions;
+
+	/**
+	 * @brief Create a merger without inputs
+	 * @param options Overlap policy and reading options
+	 */
+	explicit SrecMerger(const Options &options = Options());
+
+	~SrecMerger();
+
+	SrecMerger(const SrecMerger &) = delete;
+	SrecMerger &operator=(const SrecMerger &) = delete;
+
+	/**
+	 * @brief Add a file as the next input
+	 * @param filename Path to S-record file; it is mapped, not read
+	 * @throws SrecFileException if the file cannot be opened
+	 */
+	void add_file(const std::string &filename);
+
+	/**
+	 * @brief Add S-record text owned by the caller as the next input
+	 * @param data S-record text; must outlive the merger
+	 * @param size Number of characters
+	 * @param name Name used in error messages
+	 */
+	void add_buffer(const char *data, size_t size, const std::string &name);
+
+	/**
+	 * @brief Get the number of inputs added
+	 * @return Input count
+	 */
+	size_t inputs() const {
+		return sources.size();
+	}
+
+	/**
+	 * @brief Merge all inputs into an output file
+	 *
+	 * Writes the data records only; the caller adds the count and
+	 * termination records. The inputs are consumed, so write() can be
+	 * called once.
+	 *
+	 * @param output Output file; data records are written at their input addresses
+	 * @return Merge totals
+	 * @throws SrecValidationException on overlaps under SrecOverlapPolicy::ERROR
+	 *         (INVALID_ADDRESS), unordered inputs (INVALID_FORMAT) or invalid records
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecFileException on output errors
+	 */
+	SrecMergeResult write(SrecFile &output);
+
+	/**
+	 * @brief Merge files into a new S-record file
+	 *
+	 * Writes the merged data records, a count record and a termination
+	 * record with the merged entry point.
+	 *
+	 * @param inputs Input files in priority order
+	 * @param output Output file name
+	 * @param address_size Address size of the output records
+	 * @param options Overlap policy and reading options
+	 * @return Merge totals
+	 * @throws SrecFileException, SrecParseException or SrecValidationException as write()
+	 */
+	static SrecMergeResult merge_files(const std::vector<std::string> &inputs, const std::string &output,
+	                                   SrecFile::AddressSize address_size, const Options &options = Options());
+
+private:
+	struct Source;
+
+	void advance(Source &source, SrecMergeResult &result);
+
+	Options settings;
+	std::vector<std::unique_ptr<Source>> sources;
+	bool consumed{false};
+};
+
+} // namespace tierone::srec
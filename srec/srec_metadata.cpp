@@ -0,0 +1,226 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "srec_compress.h"
+#include "srec_hex.h"
+#include "srec_mapped.h"
+#include "srec_metadata.h"
+
+namespace tierone::srec {
+
+namespace {
+
+// Call function(line, line number) for every non-blank line starting in
+// [begin, end), trimmed as SrecMappedReader does, until it returns false.
+// Lines are numbered from first_line; 0 numbers none.
+template <typename Function>
+bool for_each_line(const char *text, size_t begin, const size_t end, const size_t size, size_t first_line,
+                   Function &&function) {
+	for (size_t line_number = first_line; begin < end; line_number += (first_line > 0 ? 1 : 0)) {
+		const char *start = text + begin;
+		const auto *newline = static_cast<const char *>(std::memchr(start, '\n', size - begin));
+		const size_t line_length = newline ? static_cast<size_t>(newline - start) : size - begin;
+		const std::string_view line(start, line_length);
+		if (!SrecStreamParser::is_blank(line) && !function(SrecStreamParser::trim_trailing(line), line_number)) {
+			return false;
+		}
+		begin += line_length + (newline ? 1 : 0);
+	}
+	return true;
+}
+
+bool is_data(const Srec::Type type) {
+	return type == Srec::Type::S1 || type == Srec::Type::S2 || type == Srec::Type::S3;
+}
+
+// Collects the metadata of the records it is given
+class MetadataBuilder {
+public:
+	explicit MetadataBuilder(const bool validate_checksums) : validate(validate_checksums) {}
+
+	// Read a line's fields; header, count and termination records are decoded in full
+	SrecRecordFields read(const std::string_view line, const size_t line_number, const bool overwrite) {
+		SrecRecordFields fields;
+		if (!peek_record_fields(line, fields)) {
+			throw SrecParseException("Invalid record", line_number);
+		}
+		switch (fields.type) {
+			case Srec::Type::S0:
+				if (accept_header && !header_seen) {
+					header_seen = true;
+					decode(line, line_number);
+					metadata.header.assign(record.data, record.data + record.length);
+				}
+				break;
+			case Srec::Type::S5:
+			case Srec::Type::S6:
+				if (overwrite || !metadata.record_count) {
+					decode(line, line_number);
+					metadata.record_count = record.address;
+				}
+				break;
+			case Srec::Type::S7:
+			case Srec::Type::S8:
+			case Srec::Type::S9:
+				if (overwrite || !metadata.entry_point) {
+					decode(line, line_number);
+					metadata.entry_point = record.address;
+				}
+				break;
+			case Srec::Type::S1:
+			case Srec::Type::S2:
+			case Srec::Type::S3:
+			default:
+				break;
+		}
+		return fields;
+	}
+
+	void add_data(const SrecRecordFields &fields) {
+		if (fields.length > 0) {
+			lowest = std::min<uint64_t>(lowest, fields.address);
+			highest = std::max<uint64_t>(highest, static_cast<uint64_t>(fields.address) + fields.length);
+		}
+		++metadata.data_records;
+		metadata.data_bytes += fields.length;
+	}
+
+	SrecMetadata finish() {
+		if (lowest <= highest) {
+			metadata.start_address = static_cast<uint32_t>(lowest);
+			metadata.end_address = highest;
+		}
+		if (metadata.header.size() == 5 && metadata.header[4] == 0) {
+			metadata.crc = (static_cast<uint32_t>(metadata.header[0]) << 24) |
+			               (static_cast<uint32_t>(metadata.header[1]) << 16) |
+			               (static_cast<uint32_t>(metadata.header[2]) << 8) | static_cast<uint32_t>(metadata.header[3]);
+		}
+		return metadata;
+	}
+
+	SrecMetadata metadata;
+	bool accept_header{true}; // false while reading a tail that does not start the file
+
+private:
+	void decode(const std::string_view line, const size_t line_number) {
+		SrecStreamParser::parse_line(line, line_number, validate, payload.data(), record);
+	}
+
+	bool validate;
+	bool header_seen{false};
+	uint64_t lowest{UINT64_MAX};
+	uint64_t highest{0};
+	std::array<uint8_t, SrecStreamParser::MAX_RECORD_DATA_SIZE> payload{};
+	SrecStreamParser::ParsedRecordView record{};
+};
+
+} // namespace
+
+bool peek_record_fields(const std::string_view line, SrecRecordFields &fields) {
+	if (line.size() < 4 || line[0] != 'S') {
+		return false;
+	}
+	// Record types by their digit; there is no S4
+	constexpr std::array<Srec::Type, 10> TYPES = {
+		Srec::Type::S0, Srec::Type::S1, Srec::Type::S2, Srec::Type::S3, Srec::Type::S0,
+		Srec::Type::S5, Srec::Type::S6, Srec::Type::S7, Srec::Type::S8, Srec::Type::S9
+	};
+	if (line[1] < '0' || line[1] > '9' || line[1] == '4') {
+		return false;
+	}
+	const Srec::Type type = TYPES[static_cast<size_t>(line[1] - '0')];
+
+	const size_t address_length = record_address_size(type);
+	std::array<uint8_t, 5> bytes{};
+	uint32_t sum = 0;
+	if (line.size() < 2 + (2 * (1 + address_length)) ||
+	    !hex_decode(line.data() + 2, 1 + address_length, bytes.data(), sum) || bytes[0] < address_length + 1) {
+		return false;
+	}
+	uint32_t address = 0;
+	for (size_t i = 1; i <= address_length; ++i) {
+		address = (address << 8) | bytes[i];
+	}
+	fields = {type, address, bytes[0] - address_length - 1};
+	return true;
+}
+
+std::string SrecMetadata::header_text() const {
+	const auto end = std::find(header.begin(), header.end(), uint8_t{0});
+	return std::string(header.begin(), end);
+}
+
+SrecMetadata SrecMetadataScanner::scan(const char *data, const size_t size, const Options &options) {
+	MetadataBuilder builder(options.validate_checksums);
+
+	// The tail starts at the first whole line in its last tail_bytes
+	size_t tail = size > options.tail_bytes ? size - options.tail_bytes : 0;
+	if (tail > 0) {
+		const auto *newline = static_cast<const char *>(std::memchr(data + tail - 1, '\n', size - tail + 1));
+		tail = newline ? static_cast<size_t>(newline - data) + 1 : size;
+	}
+
+	// Count and termination records come last, so read the tail first; later records win
+	std::optional<Srec::Type> tail_type;
+	builder.accept_header = tail == 0;
+	for_each_line(data, tail, size, size, tail == 0 ? 1 : 0, [&](const std::string_view line, const size_t line_number) {
+		const SrecRecordFields fields = builder.read(line, line_number, true);
+		if (is_data(fields.type)) {
+			tail_type = tail_type.value_or(fields.type);
+			builder.add_data(fields);
+		}
+		return true;
+	});
+
+	builder.accept_header = true;
+
+	// Then the lines before the tail: all of them, or up to the first data record
+	const bool scanned = for_each_line(data, 0, tail, size, 1, [&](const std::string_view line, const size_t line_number) {
+		const SrecRecordFields fields = builder.read(line, line_number, false);
+		if (!is_data(fields.type)) {
+			return true;
+		}
+		builder.metadata.data_type = builder.metadata.data_type.value_or(fields.type);
+		builder.add_data(fields);
+		return options.scan_data || fields.length == 0;
+	});
+
+	if (!builder.metadata.data_type) {
+		builder.metadata.data_type = tail_type;
+	}
+	builder.metadata.scanned = scanned;
+	if (!scanned) {
+		builder.metadata.data_records = 0;
+		builder.metadata.data_bytes = 0;
+	}
+	return builder.finish();
+}
+
+SrecMetadata SrecMetadataScanner::scan_file(const std::string &filename, const Options &options) {
+	// The tail of a compressed file is only reachable by decompressing all of it
+	if (detect_compression(filename) != SrecCompression::NONE) {
+		const std::string text = SrecDecompressStream::read_file(filename);
+		return scan(text.data(), text.size(), options);
+	}
+	const SrecMappedFile file(filename);
+	return scan(file.data(), file.size(), options);
+}
+
+} // namespace tierone::srec
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "srec.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief Type, address and payload length of a record, read without its payload
+ */
+struct SrecRecordFields {
+	Srec::Type type{Srec::Type::S0}; ///< Record type
+	uint32_t address{0};             ///< Address field (count for S5/S6)
+	size_t length{0};                ///< Number of payload bytes the byte count announces
+};
+
+/**
+ * @brief Decode the type, byte count and address fields of a record
+ *
+ * Only the first few characters are read; the payload and checksum are
+ * neither decoded nor checked, and the line length is not compared with
+ * the byte count.
+ *
+ * @param line S-record line (no line terminator)
+ * @param fields Receives the fields
+ * @return false if the line does not start with a valid record type, byte
+ *         count and address
+ */
+bool peek_record_fields(std::string_view line, SrecRecordFields &fields);
+
+/**
+ * @brief Options for SrecMetadataScanner
+ */
+struct SrecMetadataOptions {
+	/// Default number of bytes read from the end of the file
+	static constexpr size_t DEFAULT_TAIL_BYTES = 4096;
+
+	bool scan_data{true};                   ///< Read the fields of every data record; false reads the head and tail only
+	size_t tail_bytes{DEFAULT_TAIL_BYTES};  ///< Bytes at the end searched for count and termination records
+	bool validate_checksums{true};          ///< Validate the checksums of the records that are decoded in full
+};
+
+/**
+ * @brief Catalog information about an S-record file
+ */
+struct SrecMetadata {
+	std::vector<uint8_t> header;          ///< Payload of the first S0 record
+	std::optional<uint32_t> crc;          ///< CRC32 of a 5-byte CRC header (as written by bin2srec --checksum)
+	std::optional<uint32_t> record_count; ///< Value of the last S5/S6 record
+	std::optional<uint32_t> entry_point;  ///< Address of the last termination record
+	std::optional<Srec::Type> data_type;  ///< Type of the first data record
+	uint32_t start_address{0};            ///< Lowest data address
+	uint64_t end_address{0};              ///< One past the highest data address; equal to start if there is no data
+	uint64_t data_records{0};             ///< Number of data records; 0 unless scanned
+	uint64_t data_bytes{0};               ///< Payload bytes of the data records; 0 unless scanned
+	bool scanned{false};                  ///< Whether every data record was read; otherwise the range is that of
+	                                      ///< the first and last data records, exact for address-ordered files
+
+	/**
+	 * @brief Get the header as text
+	 * @return Header bytes up to the first null byte
+	 */
+	std::string header_text() const;
+};
+
+/**
+ * @brief Fast metadata scan of S-record files
+ *
+ * Reads what a catalog needs: the S0 header and CRC, the count record,
+ * the entry point and the address range. Header, count and termination
+ * records are decoded in full; of the data records only the type, byte
+ * count and address fields are read and the payload hex is skipped, so no
+ * data is decoded or checksummed. The file is mapped and the tail is read
+ * first for the count and termination records, which linkers put last.
+ *
+ * With scan_data disabled only the head and the last tail_bytes of the
+ * file are touched, so the cost no longer depends on the file size; the
+ * address range then assumes the data records are in address order.
+ *
+ * @note Record checksums outside the header, count and termination
+ *       records are not checked; use SrecParallelVerifier for that.
+ */
+class SrecMetadataScanner {
+public:
+	using Options = SrecMetadataOptions;
+
+	/**
+	 * @brief Scan a file
+	 * @param filename Path to S-record file
+	 * @param options Scan options
+	 * @return File metadata
+	 * @throws SrecFileException if the file cannot be read
+	 * @throws SrecParseException if a record's fields cannot be read
+	 * @throws SrecValidationException on checksum mismatch in a decoded record
+	 */
+	static SrecMetadata scan_file(const std::string &filename, const Options &options = Options());
+
+	/**
+	 * @brief Scan S-record text in memory
+	 * @param data S-record text
+	 * @param size Number of characters
+	 * @param options Scan options
+	 * @return Metadata of the text
+	 * @throws SrecParseException if a record's fields cannot be read
+	 * @throws SrecValidationException on checksum mismatch in a decoded record
+	 */
+	static SrecMetadata scan(const char *data, size_t size, const Options &options = Options());
+};
+
+} // namespace tierone::srec
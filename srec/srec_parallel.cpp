@@ -0,0 +1,599 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+#include "srec_codec.h"
+#include "srec_compress.h"
+#include "srec_crc.h"
+#include "srec_mapped.h"
+#include "srec_parallel.h"
+#include "srec_threads.h"
+
+namespace tierone::srec {
+
+namespace {
+
+using ParsedRecordView = SrecStreamParser::ParsedRecordView;
+
+struct Chunk {
+	const char *begin;
+	size_t size;
+};
+
+// Decoded contents of one chunk, with chunk-relative line numbers
+struct ChunkResult {
+	std::vector<ParsedRecordView> records;
+	std::vector<uint8_t> payload;
+	size_t lines{0};              // lines consumed (up to the failing one)
+	bool failed{false};
+	size_t error_offset{0};       // offset of the text following the last good record
+	size_t error_line{0};         // line number preceding error_offset
+	std::exception_ptr error;
+	bool ready{false};
+};
+
+// Split the text into chunks of roughly chunk_size bytes ending on a newline
+std::vector<Chunk> split_chunks(const char *data, size_t size, size_t chunk_size) {
+	std::vector<Chunk> chunks;
+	chunk_size = std::max<size_t>(chunk_size, 1);
+	size_t position = 0;
+	while (position < size) {
+		size_t end = size;
+		if (size - position > chunk_size) {
+			const size_t search = position + chunk_size - 1;
+			const auto *newline = static_cast<const char *>(std::memchr(data + search, '\n', size - search));
+			if (newline) {
+				end = static_cast<size_t>(newline - data) + 1;
+			}
+		}
+		chunks.push_back(Chunk{data + position, end - position});
+		position = end;
+	}
+	return chunks;
+}
+
+void parse_chunk(const Chunk &chunk, bool validate, ChunkResult &result) {
+	result.records.clear();
+	result.failed = false;
+	result.error = nullptr;
+	// Every payload byte takes two characters, so this bounds the total
+	if (result.payload.size() < chunk.size / 2) {
+		result.payload.resize(chunk.size / 2);
+	}
+
+	SrecMappedReader reader(chunk.begin, chunk.size, validate);
+	uint8_t *cursor = result.payload.data();
+	ParsedRecordView view{};
+	size_t offset = 0;
+	size_t line = 0;
+	try {
+		for (;;) {
+			offset = reader.offset();
+			line = reader.line_number();
+			if (!reader.next(view, cursor)) {
+				break;
+			}
+			result.records.push_back(view);
+			cursor += view.length;
+		}
+	} catch (...) {
+		result.failed = true;
+		result.error_offset = offset;
+		result.error_line = line;
+		result.error = std::current_exception();
+	}
+	result.lines = reader.line_number();
+}
+
+// Deliver one chunk's records. Returns false if the callback asked to stop.
+bool deliver_chunk(const Chunk &chunk, const ChunkResult &result, size_t base_line, bool validate,
+                   const SrecParallelParser::RecordViewCallback &callback) {
+	for (ParsedRecordView view : result.records) {
+		view.line_number += base_line;
+		if (!callback(view)) {
+			return false;
+		}
+	}
+
+	if (result.failed) {
+		// Parse the failing line again with its absolute line number so the
+		// exception matches the one the sequential parser throws
+		SrecMappedReader reader(chunk.begin + result.error_offset, chunk.size - result.error_offset,
+		                        validate, base_line + result.error_line + 1);
+		ParsedRecordView view{};
+		reader.next(view);
+		std::rethrow_exception(result.error);
+	}
+	return true;
+}
+
+} // namespace
+
+void SrecParallelParser::parse_file(const std::string &filename,
+                                    const RecordCallback &callback,
+                                    const Options &options) {
+	// Compressed files are inflated in one go; chunks need random access to the text
+	if (detect_compression(filename) != SrecCompression::NONE) {
+		const std::string text = SrecDecompressStream::read_file(filename);
+		parse_buffer(text.data(), text.size(), callback, options);
+		return;
+	}
+	SrecMappedFile file(filename);
+	parse_buffer(file.data(), file.size(), callback, options);
+}
+
+void SrecParallelParser::parse_buffer(const char *data, size_t size,
+                                      const RecordCallback &callback,
+                                      const Options &options) {
+	ParsedRecord copy{};
+	parse_buffer_views(data, size, [&callback, &copy](const ParsedRecordView &record) {
+		record.copy_to(copy);
+		return callback(copy);
+	}, options);
+}
+
+void SrecParallelParser::parse_buffer_views(const char *data, size_t size,
+                                            const RecordViewCallback &callback,
+                                            const Options &options) {
+	const unsigned threads = detail::resolve_thread_count(options.threads);
+	const std::vector<Chunk> chunks = split_chunks(data, size, options.chunk_size);
+
+	if (threads == 1 || chunks.size() <= 1) {
+		SrecMappedReader reader(data, size, options.validate_checksums);
+		ParsedRecordView view{};
+		while (reader.next(view)) {
+			if (!callback(view)) {
+				break; // User requested to stop parsing
+			}
+		}
+		return;
+	}
+
+	// Workers fill a ring of result slots at most 'window' chunks ahead of
+	// the chunk being delivered, which bounds memory use on large inputs
+	const size_t window = std::min(chunks.size(), static_cast<size_t>(threads) * 2);
+	std::vector<ChunkResult> slots(window);
+	std::mutex mutex;
+	std::condition_variable slot_ready;
+	std::condition_variable slot_free;
+	size_t next_chunk = 0;
+	size_t delivered = 0;
+	bool stop = false;
+
+	auto worker = [&]() {
+		for (;;) {
+			size_t index = 0;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				slot_free.wait(lock, [&] {
+					return stop || next_chunk >= chunks.size() || next_chunk < delivered + window;
+				});
+				if (stop || next_chunk >= chunks.size()) {
+					return;
+				}
+				index = next_chunk++;
+			}
+			ChunkResult &slot = slots[index % window];
+			parse_chunk(chunks[index], options.validate_checksums, slot);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				slot.ready = true;
+			}
+			slot_ready.notify_all();
+		}
+	};
+
+	// Declared after the workers so it runs first on every exit path
+	struct StopGuard {
+		std::mutex &mutex;
+		std::condition_variable &slot_free;
+		bool &stop;
+		~StopGuard() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			slot_free.notify_all();
+		}
+	};
+
+	detail::WorkerThreads workers;
+	StopGuard guard{mutex, slot_free, stop};
+	workers.start(std::min(threads, static_cast<unsigned>(chunks.size())), worker);
+
+	size_t base_line = 0;
+	for (size_t index = 0; index < chunks.size(); ++index) {
+		ChunkResult &slot = slots[index % window];
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			slot_ready.wait(lock, [&slot] { return slot.ready; });
+		}
+		if (!deliver_chunk(chunks[index], slot, base_line, options.validate_checksums, callback)) {
+			return;
+		}
+		base_line += slot.lines;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			slot.ready = false;
+			++delivered;
+		}
+		slot_free.notify_all();
+	}
+}
+
+namespace {
+
+// Verification totals of one chunk, with chunk-relative line numbers
+struct VerifySummary {
+	SrecVerifyResult totals;
+	size_t count_position{0}; // data records in the chunk before its last count record
+	size_t lines{0};
+	bool failed{false};
+	size_t error_offset{0};
+	size_t error_line{0};
+	std::exception_ptr error;
+	SrecStats stats;
+};
+
+void verify_chunk(const Chunk &chunk, const bool validate, const bool timed, VerifySummary &summary) {
+	SrecMappedReader reader(chunk.begin, chunk.size, validate);
+	SrecStats *stats = timed ? &summary.stats : nullptr;
+	reader.set_stats(stats);
+	SrecVerifyResult &totals = summary.totals;
+	ParsedRecordView view{};
+	size_t offset = 0;
+	size_t line = 0;
+	try {
+		for (;;) {
+			offset = reader.offset();
+			line = reader.line_number();
+			if (!reader.next(view)) {
+				break;
+			}
+			++totals.records;
+			switch (view.type) {
+				case Srec::Type::S1:
+				case Srec::Type::S2:
+				case Srec::Type::S3: {
+					SrecStatsTimer timer(stats, SrecStats::Phase::CHECKSUM);
+					totals.crc = crc32_update(view.data, view.length, totals.crc);
+					timer.stop();
+					totals.data_bytes += view.length;
+					++totals.data_records;
+					break;
+				}
+				case Srec::Type::S0:
+					// A CRC header is the 4 CRC bytes and a null, as bin2srec --checksum writes it
+					if (!totals.stored_crc && view.length == 5 && view.data[4] == 0) {
+						totals.stored_crc = (static_cast<uint32_t>(view.data[0]) << 24) |
+						                    (static_cast<uint32_t>(view.data[1]) << 16) |
+						                    (static_cast<uint32_t>(view.data[2]) << 8) |
+						                    static_cast<uint32_t>(view.data[3]);
+					}
+					break;
+				case Srec::Type::S5:
+				case Srec::Type::S6:
+					totals.stored_count = view.address;
+					summary.count_position = totals.data_records;
+					break;
+				case Srec::Type::S7:
+				case Srec::Type::S8:
+				case Srec::Type::S9:
+				default:
+					break;
+			}
+		}
+	} catch (...) {
+		summary.failed = true;
+		summary.error_offset = offset;
+		summary.error_line = line;
+		summary.error = std::current_exception();
+	}
+	summary.lines = reader.line_number();
+}
+
+// Append the totals of the next chunk to the totals of the chunks before it
+void merge_summary(SrecVerifyResult &result, const VerifySummary &summary) {
+	const SrecVerifyResult &totals = summary.totals;
+	if (totals.stored_count) {
+		result.stored_count = totals.stored_count;
+		result.counted_records = result.data_records + summary.count_position;
+	}
+	if (!result.stored_crc) {
+		result.stored_crc = totals.stored_crc;
+	}
+	result.crc = xcrc32_combine(result.crc, totals.crc, totals.data_bytes);
+	result.records += totals.records;
+	result.data_records += totals.data_records;
+	result.data_bytes += totals.data_bytes;
+}
+
+// Throw the failing chunk's error with the sequential parser's line number
+[[noreturn]] void rethrow_chunk_error(const Chunk &chunk, const VerifySummary &summary, const size_t base_line,
+                                      const bool validate) {
+	SrecMappedReader reader(chunk.begin + summary.error_offset, chunk.size - summary.error_offset,
+	                        validate, base_line + summary.error_line + 1);
+	ParsedRecordView view{};
+	reader.next(view);
+	std::rethrow_exception(summary.error);
+}
+
+} // namespace
+
+SrecVerifyResult SrecParallelVerifier::verify_file(const std::string &filename, const Options &options) {
+	if (detect_compression(filename) != SrecCompression::NONE) {
+		const std::string text = SrecDecompressStream::read_file(filename);
+		return verify_buffer(text.data(), text.size(), options);
+	}
+	SrecMappedFile file(filename);
+	return verify_buffer(file.data(), file.size(), options);
+}
+
+SrecVerifyResult SrecParallelVerifier::verify_buffer(const char *data, const size_t size, const Options &options) {
+	const unsigned threads = detail::resolve_thread_count(options.threads);
+	const std::vector<Chunk> chunks = (threads == 1) ? std::vector<Chunk>{Chunk{data, size}}
+	                                                 : split_chunks(data, size, options.chunk_size);
+
+	// Summaries are small, so every chunk gets its own and no ring is needed
+	std::vector<VerifySummary> summaries(chunks.size());
+	std::atomic<size_t> next_chunk{0};
+	std::atomic<size_t> first_failure{chunks.size()};
+	auto worker = [&]() {
+		for (;;) {
+			const size_t index = next_chunk.fetch_add(1);
+			// Chunks after a failed one can never be reported
+			if (index >= chunks.size() || index > first_failure.load()) {
+				return;
+			}
+			verify_chunk(chunks[index], options.validate_checksums, options.stats != nullptr, summaries[index]);
+			if (summaries[index].failed) {
+				size_t current = first_failure.load();
+				while (index < current && !first_failure.compare_exchange_weak(current, index)) {
+				}
+			}
+		}
+	};
+
+	if (threads == 1 || chunks.size() <= 1) {
+		worker();
+	} else {
+		detail::WorkerThreads workers;
+		workers.start(std::min(threads, static_cast<unsigned>(chunks.size())), worker);
+		workers.join();
+	}
+
+	SrecVerifyResult result;
+	size_t base_line = 0;
+	for (size_t index = 0; index < chunks.size(); ++index) {
+		const VerifySummary &summary = summaries[index];
+		if (summary.failed) {
+			rethrow_chunk_error(chunks[index], summary, base_line, options.validate_checksums);
+		}
+		merge_summary(result, summary);
+		base_line += summary.lines;
+		if (options.stats) {
+			options.stats->merge(summary.stats);
+		}
+	}
+	return result;
+}
+
+namespace {
+
+// One block of binary input and its formatted records
+struct ConvertBlock {
+	enum class State {
+		FREE,       // waiting for the reader
+		FILLED,     // holds input, waiting for a worker
+		FORMATTING, // claimed by a worker
+		DONE        // formatted, waiting for the writer
+	};
+
+	State state{State::FREE};
+	size_t sequence{0};
+	uint64_t address{0};
+	std::vector<uint8_t> data;
+	size_t length{0};
+	std::vector<char> text;
+	size_t text_length{0};
+	size_t records{0};
+	uint32_t crc{0};
+	size_t crc_length{0}; // bytes the CRC covers
+	std::exception_ptr error;
+};
+
+// Format a block of input as the output file lays out its records
+void format_block(const SrecFile &sfile, ConvertBlock &block) {
+	block.text_length = 0;
+	block.records = 0;
+	block.error = nullptr;
+	try {
+		block.text_length = sfile.format_data_records(block.address, block.data.data(), block.length, block.text.data(),
+		                                              block.records);
+		block.crc = sfile.update_data_crc(0, block.address, block.data.data(), block.length, block.crc_length);
+	} catch (...) {
+		block.error = std::current_exception();
+	}
+}
+
+} // namespace
+
+uint32_t SrecParallelConverter::write_data_records(std::istream &input, SrecFile &sfile, const Options &options,
+                                                   const ProgressCallback &progress_callback) {
+	// Invalid address sizes throw here rather than on a worker
+	with_record_codec(sfile.addrsize(), [](auto) {});
+	const size_t record_size = std::max<size_t>(sfile.max_data_bytes_per_record(), 1);
+	const size_t records_per_block = std::max<size_t>(options.block_size / record_size, 1);
+	const size_t block_size = records_per_block * record_size;
+	const unsigned threads = detail::resolve_thread_count(options.threads);
+	const uint64_t start_address = sfile.next_address();
+	// An aligned layout starting mid-record gets a short first block, so
+	// every block boundary is a record boundary
+	const size_t skew = record_size - std::min(sfile.next_record_length(), record_size);
+
+	// Enough blocks in flight to keep every worker and the reader busy. Their
+	// buffers are allocated on first use, so small inputs stay cheap.
+	std::vector<ConvertBlock> blocks(2 * static_cast<size_t>(threads) + 1);
+
+	std::mutex mutex;
+	std::condition_variable changed;
+	bool stop = false;
+	bool input_done = false;
+	size_t total_blocks = 0; // valid once input_done is set
+	size_t blocks_read = 0;
+	size_t next_format = 0;
+	std::exception_ptr read_error;
+
+	auto reader = [&] {
+		try {
+			for (size_t sequence = 0;; ++sequence) {
+				ConvertBlock &block = blocks[sequence % blocks.size()];
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					changed.wait(lock, [&] { return stop || block.state == ConvertBlock::State::FREE; });
+					if (stop) {
+						return;
+					}
+				}
+				if (block.data.empty()) {
+					block.data.resize(block_size);
+					block.text.resize((records_per_block + 1) * (MAX_RECORD_LINE_LENGTH + 2));
+				}
+				const size_t wanted = (sequence == 0) ? block_size - skew : block_size;
+				input.read(reinterpret_cast<char *>(block.data.data()), static_cast<std::streamsize>(wanted));
+				const auto bytes_read = static_cast<size_t>(input.gcount());
+				if (bytes_read == 0) {
+					if (input.bad()) {
+						throw SrecFileException("Input stream read error", "");
+					}
+					std::lock_guard<std::mutex> lock(mutex);
+					input_done = true;
+					total_blocks = blocks_read;
+					break;
+				}
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					block.sequence = sequence;
+					block.address = start_address + (static_cast<uint64_t>(sequence) * block_size) -
+					                (sequence == 0 ? 0 : skew);
+					block.length = bytes_read;
+					block.state = ConvertBlock::State::FILLED;
+					++blocks_read;
+				}
+				changed.notify_all();
+			}
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(mutex);
+			read_error = std::current_exception();
+			input_done = true;
+			total_blocks = blocks_read;
+		}
+		changed.notify_all();
+	};
+
+	auto worker = [&] {
+		for (;;) {
+			ConvertBlock *block = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				changed.wait(lock, [&] {
+					const ConvertBlock &next = blocks[next_format % blocks.size()];
+					return stop || (input_done && next_format >= total_blocks) ||
+					       (next.state == ConvertBlock::State::FILLED && next.sequence == next_format);
+				});
+				if (stop || (input_done && next_format >= total_blocks)) {
+					return;
+				}
+				block = &blocks[next_format % blocks.size()];
+				block->state = ConvertBlock::State::FORMATTING;
+				++next_format;
+			}
+			format_block(sfile, *block);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				block->state = ConvertBlock::State::DONE;
+			}
+			changed.notify_all();
+		}
+	};
+
+	// Declared after the threads so it runs first on every exit path
+	struct StopGuard {
+		std::mutex &mutex;
+		std::condition_variable &changed;
+		bool &stop;
+		~StopGuard() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			changed.notify_all();
+		}
+	};
+
+	detail::WorkerThreads reader_thread;
+	detail::WorkerThreads workers;
+	StopGuard guard{mutex, changed, stop};
+	reader_thread.start(1, reader);
+	workers.start(threads, worker);
+
+	uint32_t crc = 0;
+	size_t bytes_processed = 0;
+	for (size_t sequence = 0;; ++sequence) {
+		ConvertBlock &block = blocks[sequence % blocks.size()];
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [&] {
+				return (input_done && sequence >= total_blocks) ||
+				       (block.state == ConvertBlock::State::DONE && block.sequence == sequence);
+			});
+			if (input_done && sequence >= total_blocks) {
+				break;
+			}
+		}
+		if (block.error) {
+			std::rethrow_exception(block.error);
+		}
+		sfile.write_formatted_records(block.text.data(), block.text_length, block.records, block.length);
+		crc = xcrc32_combine(crc, block.crc, block.crc_length);
+		bytes_processed += block.length;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			block.state = ConvertBlock::State::FREE;
+		}
+		changed.notify_all();
+
+		if (progress_callback && !progress_callback(bytes_processed, 0)) {
+			throw SrecValidationException("Conversion aborted by user",
+			                              SrecValidationException::ValidationError::USER_CANCELLED);
+		}
+	}
+
+	if (read_error) {
+		std::rethrow_exception(read_error);
+	}
+	return crc;
+}
+
+} // namespace tierone::srec
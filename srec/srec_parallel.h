@@ -0,0 +1,227 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <optional>
+#include <string>
+
+#include "srec.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief Options for SrecParallelParser
+ */
+struct SrecParallelOptions {
+	/// Default amount of input text per chunk
+	static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+	unsigned threads{0};                   ///< Worker threads, 0 for one per hardware thread
+	size_t chunk_size{DEFAULT_CHUNK_SIZE}; ///< Approximate input bytes per chunk
+	bool validate_checksums{true};         ///< Whether to validate checksums
+	SrecStats *stats{nullptr};             ///< Statistics to update (SrecParallelVerifier only), or nullptr
+};
+
+/**
+ * @brief Multi-threaded S-record parser
+ *
+ * The input is split into newline-aligned chunks which are decoded and
+ * checksum-validated on worker threads. Records are handed to the callback
+ * on the calling thread, in file order and with the same line numbers the
+ * sequential parser reports.
+ *
+ * Errors are deterministic: records preceding the first bad line are
+ * delivered and then the exception SrecStreamParser would throw for that
+ * line is thrown, regardless of which chunk a worker failed on first.
+ */
+class SrecParallelParser {
+public:
+	using ParsedRecord = SrecStreamParser::ParsedRecord;
+	using ParsedRecordView = SrecStreamParser::ParsedRecordView;
+	using RecordCallback = SrecStreamParser::RecordCallback;
+
+	/**
+	 * @brief Callback function type for processing record views
+	 * @param record Parsed record; its data is valid only during the call
+	 * @return true to continue parsing, false to stop
+	 */
+	using RecordViewCallback = std::function<bool(const ParsedRecordView &record)>;
+
+	using Options = SrecParallelOptions;
+
+	/**
+	 * @brief Parse an S-record file in parallel
+	 * @param filename Path to S-record file
+	 * @param callback Function called for each parsed record, in file order
+	 * @param options Parsing options
+	 * @throws SrecFileException on file I/O errors
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	static void parse_file(const std::string &filename,
+	                       const RecordCallback &callback,
+	                       const Options &options = Options());
+
+	/**
+	 * @brief Parse S-record text held in memory in parallel
+	 * @param data S-record text
+	 * @param size Number of characters
+	 * @param callback Function called for each parsed record, in file order
+	 * @param options Parsing options
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	static void parse_buffer(const char *data, size_t size,
+	                         const RecordCallback &callback,
+	                         const Options &options = Options());
+
+	/**
+	 * @brief Parse S-record text in parallel without copying payloads
+	 * @param data S-record text
+	 * @param size Number of characters
+	 * @param callback Function called for each parsed record, in file order
+	 * @param options Parsing options
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	static void parse_buffer_views(const char *data, size_t size,
+	                               const RecordViewCallback &callback,
+	                               const Options &options = Options());
+};
+
+/**
+ * @brief Outcome of SrecParallelVerifier
+ */
+struct SrecVerifyResult {
+	size_t records{0};                    ///< Records in the file
+	size_t data_records{0};               ///< S1/S2/S3 records
+	uint64_t data_bytes{0};               ///< Payload bytes of all data records
+	uint32_t crc{0};                      ///< CRC32 of the data payloads in file order (xcrc32, init 0)
+	std::optional<uint32_t> stored_crc;   ///< CRC from the first 5-byte CRC header (4 CRC bytes and a null)
+	std::optional<uint32_t> stored_count; ///< Value of the last S5/S6 record
+	size_t counted_records{0};            ///< Data records preceding the last S5/S6 record
+
+	/**
+	 * @brief Check the CRC header
+	 * @return true if a CRC header is present and matches the data
+	 */
+	bool crc_matches() const {
+		return stored_crc && *stored_crc == crc;
+	}
+
+	/**
+	 * @brief Check the count record
+	 * @return true if there is no count record or it matches the data records before it
+	 */
+	bool count_matches() const {
+		return !stored_count || *stored_count == counted_records;
+	}
+};
+
+/**
+ * @brief Single-pass S-record file verification
+ *
+ * Validates every record's checksum, computes the CRC32 of the data
+ * payloads and collects the CRC header and count record in one pass. The
+ * text is split into newline-aligned chunks that are checked on worker
+ * threads; their CRCs are merged with xcrc32_combine(), so no record data
+ * has to be handed back to the calling thread.
+ *
+ * Errors are deterministic: the exception SrecStreamParser would throw for
+ * the first bad line is thrown, whichever chunk failed first.
+ */
+class SrecParallelVerifier {
+public:
+	using Options = SrecParallelOptions;
+
+	/**
+	 * @brief Verify an S-record file
+	 * @param filename Path to S-record file
+	 * @param options Verification options; threads = 1 checks on the calling thread
+	 * @return Totals, CRCs and count record of the file
+	 * @throws SrecFileException on file I/O errors
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	static SrecVerifyResult verify_file(const std::string &filename, const Options &options = Options());
+
+	/**
+	 * @brief Verify S-record text held in memory
+	 * @param data S-record text
+	 * @param size Number of characters
+	 * @param options Verification options; threads = 1 checks on the calling thread
+	 * @return Totals, CRCs and count record of the text
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures
+	 */
+	static SrecVerifyResult verify_buffer(const char *data, size_t size, const Options &options = Options());
+};
+
+/**
+ * @brief Options for SrecParallelConverter
+ */
+struct SrecParallelConvertOptions {
+	/// Default amount of binary input per block
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+	unsigned threads{0};                   ///< Formatting threads, 0 for one per hardware thread
+	size_t block_size{DEFAULT_BLOCK_SIZE}; ///< Approximate input bytes per block
+};
+
+/**
+ * @brief Multi-threaded binary to S-record data record writer
+ *
+ * A reader thread fills large input blocks, worker threads format each
+ * block into S-record text and compute its partial CRC32, and the calling
+ * thread appends the blocks to the output in order. Blocks end on record
+ * boundaries and are formatted with SrecFile::format_data_records(), so
+ * the records, addresses and record count are identical to writing the
+ * input with SrecFile::write_data() in the file's layout.
+ */
+class SrecParallelConverter {
+public:
+	using ProgressCallback = SrecStreamConverter::ProgressCallback;
+
+	using Options = SrecParallelConvertOptions;
+
+	/**
+	 * @brief Write the remaining input as data records
+	 *
+	 * Only data records are written; header, count and termination records
+	 * are left to the caller.
+	 *
+	 * @param input Binary input, read until end of stream
+	 * @param sfile Output S-record file, continuing at its next_address()
+	 * @param options Conversion options
+	 * @param progress_callback Optional progress callback, called per block
+	 *        with the total size 0
+	 * @return CRC32 of the bytes read, as computed by xcrc32() with init 0, or of
+	 *         the bytes written with SrecFile::skip_fill() and SrecFillCrc::EMITTED
+	 * @throws SrecFileException on file I/O errors
+	 * @throws SrecValidationException if limits are exceeded or the
+	 *         progress callback aborts
+	 * @throws SrecAddressException if the data does not fit the address space
+	 */
+	static uint32_t write_data_records(std::istream &input,
+	                                   SrecFile &sfile,
+	                                   const Options &options = Options(),
+	                                   const ProgressCallback &progress_callback = nullptr);
+};
+
+} // namespace tierone::srec
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "srec_reader.h"
+
+namespace tierone::srec {
+
+SrecReader::SrecReader(std::istream &input_stream, const bool validate_checksums, const size_t size,
+                       const SrecLimits &limits)
+	: input(input_stream),
+	  block_size(std::max<size_t>(size, 1)),
+	  buffer(block_size),
+	  max_text(limits.max_file_size),
+	  lines(nullptr, 0, validate_checksums)
+{
+	lines.set_limits(limits);
+}
+
+bool SrecReader::next(ParsedRecordView &record) {
+	SrecParseResult result;
+	if (try_next(record, result)) {
+		return true;
+	}
+	if (!result.ok()) {
+		result.throw_exception();
+	}
+	return false;
+}
+
+bool SrecReader::try_next(ParsedRecordView &record, SrecParseResult &result) {
+	while (!lines.try_next(record, result)) {
+		if (!result.ok() || !refill()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SrecReader::refill() {
+	if (end_of_input && complete == filled) {
+		return false;
+	}
+
+	// Keep the partial line left over from the previous block
+	const size_t leftover = filled - complete;
+	std::memmove(buffer.data(), buffer.data() + complete, leftover);
+	filled = leftover;
+	complete = 0;
+
+	SrecStatsTimer timer(stats, SrecStats::Phase::READ);
+	while (complete == 0 && !end_of_input) {
+		// A line longer than the buffer makes it grow
+		if (buffer.size() - filled < block_size) {
+			buffer.resize(filled + block_size);
+		}
+		if (SrecStats::ENABLED && stats) {
+			stats->note_buffer(buffer.size());
+		}
+		input.read(buffer.data() + filled, static_cast<std::streamsize>(buffer.size() - filled));
+		const auto count = static_cast<size_t>(input.gcount());
+		if (input.bad()) {
+			throw SrecFileException("Stream read error", "");
+		}
+		if (count == 0) {
+			end_of_input = true;
+			break;
+		}
+		// Checked here too, so a line without an end cannot grow the buffer forever
+		read_total += count;
+		if (read_total > max_text) {
+			throw SrecValidationException(
+				"Maximum file size exceeded",
+				SrecValidationException::ValidationError::DATA_TOO_LARGE
+			);
+		}
+
+		// Search only the new characters for the last line end
+		for (size_t i = filled + count; i > filled; --i) {
+			if (buffer[i - 1] == '\n') {
+				complete = i;
+				break;
+			}
+		}
+		filled += count;
+		if (input.eof()) {
+			end_of_input = true;
+		}
+	}
+	if (end_of_input) {
+		complete = filled; // the last line need not end in a newline
+	}
+	timer.stop();
+
+	lines.continue_with(buffer.data(), complete);
+	return complete > 0;
+}
+
+} // namespace tierone::srec
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <istream>
+#include <vector>
+
+#include "srec.h"
+#include "srec_mapped.h"
+
+namespace tierone::srec {
+
+/**
+ * @brief Pull-based S-record reader for input streams
+ *
+ * Reads the stream in large blocks into one reusable buffer and decodes
+ * records on demand, so a loop over next() performs no per-record
+ * allocation and no callback indirection. Line numbers, error reporting
+ * and checksum validation match SrecStreamParser::parse_stream().
+ *
+ * @code
+ * SrecReader reader(input);
+ * for (const auto &record : reader) {
+ *     ...
+ * }
+ * @endcode
+ *
+ * @note The stream is read ahead in blocks; after stopping early its
+ *       position is past the last record returned.
+ * @note This class is not thread-safe
+ */
+class SrecReader {
+public:
+	using ParsedRecordView = SrecStreamParser::ParsedRecordView;
+
+	/// Default number of characters requested from the stream at a time
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+	/**
+	 * @brief Read records from a stream
+	 * @param input Stream holding S-record text; must outlive the reader
+	 * @param validate_checksums Whether to validate checksums (default: true)
+	 * @param block_size Characters requested from the stream at a time (default: 64 KiB)
+	 * @param limits Record count and size limits (default: SrecLimits::unlimited())
+	 */
+	explicit SrecReader(std::istream &input, bool validate_checksums = true,
+	                    size_t block_size = DEFAULT_BLOCK_SIZE,
+	                    const SrecLimits &limits = SrecLimits::unlimited());
+
+	SrecReader(const SrecReader &) = delete;
+	SrecReader &operator=(const SrecReader &) = delete;
+
+	/**
+	 * @brief Parse the next record
+	 * @param record Receives the record; its data is valid until the next call
+	 * @return true if a record was read, false at end of input
+	 * @throws SrecParseException on parsing errors
+	 * @throws SrecValidationException on validation failures or exceeded limits
+	 * @throws SrecFileException on stream read errors
+	 */
+	bool next(ParsedRecordView &record);
+
+	/**
+	 * @brief Parse the next record, reporting malformed lines without throwing
+	 *
+	 * A rejected line is consumed, so calling again carries on with the
+	 * line after it.
+	 *
+	 * @param record Receives the record; its data is valid until the next call
+	 * @param result Receives the error of a rejected line; ok() otherwise
+	 * @return true if a record was read, false at end of input or on a rejected line
+	 * @throws SrecValidationException if the limits are exceeded
+	 * @throws SrecFileException on stream read errors
+	 */
+	bool try_next(ParsedRecordView &record, SrecParseResult &result);
+
+	/**
+	 * @brief Iterate over the remaining records
+	 * @return Iterator to the next record
+	 * @note Advancing the iterator calls next(); errors are thrown from there
+	 */
+	SrecRecordIterator<SrecReader> begin() {
+		return SrecRecordIterator<SrecReader>(*this);
+	}
+
+	SrecRecordIterator<SrecReader> end() {
+		return SrecRecordIterator<SrecReader>();
+	}
+
+	/**
+	 * @brief Get the number of the last line read (1-based)
+	 * @return Line number, 0 before the first call to next()
+	 */
+	size_t line_number() const {
+		return lines.line_number();
+	}
+
+	/**
+	 * @brief Attach statistics to update while reading
+	 *
+	 * Stream reads are charged to SrecStats::Phase::READ and the buffer
+	 * size is tracked as the peak buffer; records are counted as by
+	 * SrecMappedReader::set_stats().
+	 *
+	 * @param statistics Statistics to update, or nullptr to stop
+	 */
+	void set_stats(SrecStats *statistics) {
+		stats = statistics;
+		lines.set_stats(statistics);
+	}
+
+private:
+	bool refill();
+
+	std::istream &input;
+	size_t block_size;
+	std::vector<char> buffer;
+	size_t filled{0};   // characters in the buffer
+	size_t complete{0}; // characters up to the last complete line
+	bool end_of_input{false};
+	uint64_t max_text{0}; // characters that may be read, from the limits
+	uint64_t read_total{0};
+	SrecStats *stats{nullptr};
+	SrecMappedReader lines;
+};
+
+/**
+ * @brief Call a function for every record in a stream
+ *
+ * Templated counterpart of SrecStreamParser::parse_stream(): the callback
+ * is called directly, not through std::function, and receives a view
+ * instead of a freshly copied ParsedRecord.
+ *
+ * @param input Input stream containing S-record data
+ * @param callback Callable taking const ParsedRecordView & and returning
+ *        true to continue or false to stop
+ * @param validate_checksums Whether to validate checksums (default: true)
+ * @throws SrecParseException on parsing errors
+ * @throws SrecValidationException on validation failures
+ * @throws SrecFileException on stream read errors
+ */
+template <typename Callback>
+void for_each_record(std::istream &input, Callback &&callback, bool validate_checksums = true) {
+	SrecReader reader(input, validate_checksums);
+	SrecStreamParser::ParsedRecordView record{};
+	while (reader.next(record)) {
+		if (!callback(static_cast<const SrecStreamParser::ParsedRecordView &>(record))) {
+			return;
+		}
+	}
+}
+
+} // namespace tierone::srec
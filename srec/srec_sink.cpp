@@ -0,0 +1,398 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include "srec_sink.h"
+
+namespace tierone::srec {
+
+namespace {
+
+#if defined(SREC_HAVE_FD_SINK)
+
+// Write every byte described by 'vectors', retrying partial writes
+bool write_vectors(const int fd, iovec *vectors, int count) {
+	while (count > 0) {
+		const ssize_t written = ::writev(fd, vectors, count);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		auto remaining = static_cast<size_t>(written);
+		while (count > 0 && remaining >= vectors->iov_len) {
+			remaining -= vectors->iov_len;
+			++vectors;
+			--count;
+		}
+		if (count > 0) {
+			vectors->iov_base = static_cast<char *>(vectors->iov_base) + remaining;
+			vectors->iov_len -= remaining;
+		}
+	}
+	return true;
+}
+
+#endif
+
+} // namespace
+
+SrecFileSink::SrecFileSink(const std::string &file_name, const size_t buffer_size)
+	: filename(file_name),
+	  buffer(std::max<size_t>(buffer_size, 1))
+{
+#if defined(SREC_HAVE_FD_SINK)
+	fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+	seekable = fd >= 0;
+#else
+	stream = std::fopen(filename.c_str(), "wb");
+#endif
+}
+
+#if defined(SREC_HAVE_FD_SINK)
+SrecFileSink::SrecFileSink(const int file_descriptor, const bool take_ownership, const size_t buffer_size)
+	: buffer(std::max<size_t>(buffer_size, 1)),
+	  fd(file_descriptor),
+	  owns_fd(take_ownership)
+{
+	// Patching needs a regular position and pwrite() ignores it under O_APPEND
+	const int flags = ::fcntl(fd, F_GETFL);
+	base_offset = ::lseek(fd, 0, SEEK_CUR);
+	seekable = flags >= 0 && (flags & O_APPEND) == 0 && base_offset >= 0;
+}
+#endif
+
+SrecFileSink::~SrecFileSink() {
+	try {
+		close();
+	} catch (const SrecException &) {
+		// Destructors must not throw; call close() to observe errors
+	}
+}
+
+void SrecFileSink::write(const char *data, const size_t length) {
+	if (length <= buffer.size() - used) {
+		std::memcpy(buffer.data() + used, data, length);
+		used += length;
+		return;
+	}
+	write_through(data, length);
+}
+
+void SrecFileSink::write_through(const char *data, const size_t length) {
+	if (!is_open()) {
+		throw SrecFileException("File is not open", filename);
+	}
+#if defined(SREC_HAVE_FD_SINK)
+	// Send the buffered data and the new data in one call
+	iovec vectors[2] = {{buffer.data(), used}, {const_cast<char *>(data), length}};
+	const size_t total = used + length;
+	used = 0;
+	if (!write_vectors(fd, vectors, 2)) {
+		throw SrecFileException("Failed to write output file", filename);
+	}
+	flushed += total;
+#else
+	flush();
+	if (std::fwrite(data, 1, length, stream) != length) {
+		throw SrecFileException("Failed to write output file", filename);
+	}
+	flushed += length;
+#endif
+}
+
+void SrecFileSink::flush() {
+	if (used == 0) {
+		return;
+	}
+	if (!is_open()) {
+		throw SrecFileException("File is not open", filename);
+	}
+	const size_t count = used;
+	used = 0;
+#if defined(SREC_HAVE_FD_SINK)
+	iovec vector{buffer.data(), count};
+	if (!write_vectors(fd, &vector, 1)) {
+		throw SrecFileException("Failed to write output file", filename);
+	}
+#else
+	if (std::fwrite(buffer.data(), 1, count, stream) != count || std::fflush(stream) != 0) {
+		throw SrecFileException("Failed to write output file", filename);
+	}
+#endif
+	flushed += count;
+}
+
+void SrecFileSink::sync() {
+	flush();
+#if defined(SREC_HAVE_FD_SINK)
+	if (fd >= 0 && ::fsync(fd) != 0 && errno != EINVAL) {
+		throw SrecFileException("Failed to sync output file", filename);
+	}
+#else
+	if (stream && std::fflush(stream) != 0) {
+		throw SrecFileException("Failed to sync output file", filename);
+	}
+#endif
+}
+
+void SrecFileSink::close() {
+	if (!is_open()) {
+		return;
+	}
+	bool failed = false;
+	try {
+		flush();
+	} catch (const SrecFileException &) {
+		failed = true;
+	}
+#if defined(SREC_HAVE_FD_SINK)
+	if (owns_fd && ::close(fd) != 0) {
+		failed = true;
+	}
+	fd = -1;
+#else
+	if (std::fclose(stream) != 0) {
+		failed = true;
+	}
+	stream = nullptr;
+#endif
+	if (failed) {
+		throw SrecFileException("Failed to write output file", filename);
+	}
+}
+
+bool SrecFileSink::can_patch() const {
+#if defined(SREC_HAVE_FD_SINK)
+	return is_open() && seekable;
+#else
+	return is_open();
+#endif
+}
+
+void SrecFileSink::patch(const size_t offset, const char *data, const size_t length) {
+	if (!can_patch()) {
+		throw SrecFileException("Output does not support patching", filename);
+	}
+	if (offset > flushed + used || length > flushed + used - offset) {
+		throw SrecFileException("Patch range has not been written", filename);
+	}
+
+	// Characters still in the buffer are patched in memory
+	const size_t file_length = (offset < flushed) ? std::min(length, flushed - offset) : 0;
+	if (file_length < length) {
+		std::memcpy(buffer.data() + (offset + file_length - flushed), data + file_length, length - file_length);
+	}
+	if (file_length == 0) {
+		return;
+	}
+
+#if defined(SREC_HAVE_FD_SINK)
+	size_t done = 0;
+	while (done < file_length) {
+		const ssize_t written = ::pwrite(fd, data + done, file_length - done,
+		                                 base_offset + static_cast<off_t>(offset + done));
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw SrecFileException("Failed to patch output file", filename);
+		}
+		done += static_cast<size_t>(written);
+	}
+#else
+	if (std::fflush(stream) != 0 ||
+	    std::fseek(stream, static_cast<long>(offset), SEEK_SET) != 0 ||
+	    std::fwrite(data, 1, file_length, stream) != file_length ||
+	    std::fseek(stream, 0, SEEK_END) != 0) {
+		throw SrecFileException("Failed to patch output file", filename);
+	}
+#endif
+}
+
+bool SrecFileSink::is_open() const {
+#if defined(SREC_HAVE_FD_SINK)
+	return fd >= 0;
+#else
+	return stream != nullptr;
+#endif
+}
+
+SrecAsyncSink::SrecAsyncSink(std::unique_ptr<SrecSink> target, const size_t buffer_size)
+	: inner(std::move(target))
+{
+	const size_t size = std::max<size_t>(buffer_size, 1);
+	active.reserve(size);
+	pending.reserve(size);
+	io_thread = std::thread([this] { io_loop(); });
+}
+
+SrecAsyncSink::~SrecAsyncSink() {
+	try {
+		close();
+	} catch (const SrecException &) {
+		// Destructors must not throw; call close() to observe errors
+	}
+	if (io_thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		changed.notify_all();
+		io_thread.join();
+	}
+}
+
+void SrecAsyncSink::io_loop() {
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+		changed.wait(lock, [this] { return busy || stop; });
+		if (!busy) {
+			return;
+		}
+		// The producer does not touch 'pending' while busy is set
+		lock.unlock();
+		try {
+			inner->write(pending.data(), pending.size());
+		} catch (...) {
+			lock.lock();
+			error = std::current_exception();
+			busy = false;
+			changed.notify_all();
+			continue;
+		}
+		lock.lock();
+		busy = false;
+		changed.notify_all();
+	}
+}
+
+void SrecAsyncSink::wait_idle() {
+	std::unique_lock<std::mutex> lock(mutex);
+	changed.wait(lock, [this] { return !busy; });
+	if (error) {
+		std::exception_ptr failure = error;
+		error = nullptr;
+		std::rethrow_exception(failure);
+	}
+}
+
+void SrecAsyncSink::submit() {
+	wait_idle();
+	if (active.empty()) {
+		return;
+	}
+	pending.swap(active);
+	active.clear();
+	submitted += pending.size();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		busy = true;
+	}
+	changed.notify_all();
+}
+
+void SrecAsyncSink::write(const char *data, const size_t length) {
+	if (!is_open()) {
+		throw SrecFileException("File is not open");
+	}
+	size_t done = 0;
+	while (done < length) {
+		if (active.size() == active.capacity()) {
+			submit();
+		}
+		const size_t count = std::min(length - done, active.capacity() - active.size());
+		active.insert(active.end(), data + done, data + done + count);
+		done += count;
+	}
+}
+
+void SrecAsyncSink::flush() {
+	submit();
+	wait_idle();
+	inner->flush();
+}
+
+void SrecAsyncSink::sync() {
+	submit();
+	wait_idle();
+	inner->sync();
+}
+
+void SrecAsyncSink::close() {
+	if (closed) {
+		return;
+	}
+	closed = true;
+	bool failed = false;
+	try {
+		submit();
+		wait_idle();
+	} catch (const SrecException &) {
+		failed = true;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	changed.notify_all();
+	if (io_thread.joinable()) {
+		io_thread.join();
+	}
+	inner->close();
+	if (failed) {
+		throw SrecFileException("Failed to write output file");
+	}
+}
+
+bool SrecAsyncSink::is_open() const {
+	return !closed && inner->is_open();
+}
+
+bool SrecAsyncSink::can_patch() const {
+	return !closed && inner->can_patch();
+}
+
+void SrecAsyncSink::patch(const size_t offset, const char *data, const size_t length) {
+	if (!can_patch()) {
+		throw SrecFileException("Output does not support patching");
+	}
+	if (offset > submitted + active.size() || length > submitted + active.size() - offset) {
+		throw SrecFileException("Patch range has not been written");
+	}
+
+	// Characters not yet submitted are patched in the active buffer
+	const size_t inner_length = (offset < submitted) ? std::min(length, submitted - offset) : 0;
+	if (inner_length < length) {
+		std::memcpy(active.data() + (offset + inner_length - submitted), data + inner_length, length - inner_length);
+	}
+	if (inner_length > 0) {
+		wait_idle();
+		inner->patch(offset, data, inner_length);
+	}
+}
+
+} // namespace tierone::srec
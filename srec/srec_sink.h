@@ -0,0 +1,306 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "srec_exceptions.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SREC_HAVE_FD_SINK 1
+#include <sys/types.h>
+#endif
+
+namespace tierone::srec {
+
+/**
+ * @brief When buffered output is pushed to the operating system
+ */
+enum class FlushPolicy {
+	ON_CLOSE,  ///< Flush when the buffer fills up and on close (default)
+	PER_RECORD ///< Flush after every record, for readers tailing the output
+};
+
+/**
+ * @brief Destination for formatted S-record text
+ *
+ * Sinks receive whole lines and decide when they reach their backing
+ * storage. Nothing written is guaranteed to be visible to other readers
+ * until flush() or close() returns.
+ *
+ * @note Implementations are not thread-safe
+ */
+class SrecSink {
+public:
+	virtual ~SrecSink() = default;
+
+	/**
+	 * @brief Append characters to the output
+	 * @param data Characters to write
+	 * @param length Number of characters
+	 * @throws SrecFileException on write errors
+	 */
+	virtual void write(const char *data, size_t length) = 0;
+
+	/**
+	 * @brief Push buffered output to the backing storage
+	 * @throws SrecFileException on write errors
+	 */
+	virtual void flush() = 0;
+
+	/**
+	 * @brief Flush and ask the backing storage to make the data durable
+	 * @throws SrecFileException on write errors
+	 */
+	virtual void sync() {
+		flush();
+	}
+
+	/**
+	 * @brief Flush and release the backing storage
+	 * @throws SrecFileException on write errors
+	 */
+	virtual void close() = 0;
+
+	/**
+	 * @brief Check whether the sink accepts output
+	 * @return true if open
+	 */
+	virtual bool is_open() const = 0;
+
+	/**
+	 * @brief Check whether already written output can be overwritten
+	 * @return true if patch() is supported
+	 */
+	virtual bool can_patch() const {
+		return false;
+	}
+
+	/**
+	 * @brief Overwrite characters that were written earlier
+	 * @param offset Position of the first character, counted from the first
+	 *               character written to this sink
+	 * @param data Replacement characters
+	 * @param length Number of characters; the whole range must have been written
+	 * @throws SrecFileException if patching is unsupported or fails
+	 */
+	virtual void patch(size_t /*offset*/, const char * /*data*/, size_t /*length*/) {
+		throw SrecFileException("Output does not support patching");
+	}
+};
+
+/**
+ * @brief File sink with a large user-space buffer
+ *
+ * Output is collected in a buffer and written with a single system call
+ * when it fills up. Writes larger than the free space are combined with
+ * the buffered data using writev() instead of being copied. On platforms
+ * without POSIX file descriptors a stdio stream is used as the backend.
+ */
+class SrecFileSink : public SrecSink {
+public:
+	/// Default size of the user-space buffer
+	static constexpr size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+
+	/**
+	 * @brief Create or truncate a file for writing
+	 * @param filename Path to the output file
+	 * @param buffer_size Size of the user-space buffer (default: 256 KiB)
+	 * @note Check is_open() to see whether the file could be opened
+	 */
+	explicit SrecFileSink(const std::string &filename, size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+#if defined(SREC_HAVE_FD_SINK)
+	/**
+	 * @brief Write to an already open file descriptor
+	 * @param fd Open, writable file descriptor
+	 * @param take_ownership Whether close() should close the descriptor
+	 * @param buffer_size Size of the user-space buffer (default: 256 KiB)
+	 */
+	SrecFileSink(int fd, bool take_ownership, size_t buffer_size = DEFAULT_BUFFER_SIZE);
+#endif
+
+	/**
+	 * @brief Destructor - flushes and closes, ignoring errors
+	 */
+	~SrecFileSink() override;
+
+	SrecFileSink(const SrecFileSink &) = delete;
+	SrecFileSink &operator=(const SrecFileSink &) = delete;
+
+	void write(const char *data, size_t length) override;
+	void flush() override;
+	void sync() override;
+	void close() override;
+	bool is_open() const override;
+	bool can_patch() const override;
+	void patch(size_t offset, const char *data, size_t length) override;
+
+	/**
+	 * @brief Get the file name
+	 * @return Filename as provided to constructor, empty for descriptors
+	 */
+	const std::string &getFilename() const {
+		return filename;
+	}
+
+private:
+	void write_through(const char *data, size_t length);
+
+	std::string filename;
+	std::vector<char> buffer;
+	size_t used{0};
+	size_t flushed{0}; // characters already handed to the backend
+#if defined(SREC_HAVE_FD_SINK)
+	int fd{-1};
+	bool owns_fd{true};
+	bool seekable{false};
+	off_t base_offset{0}; // file position of the first character
+#else
+	std::FILE *stream{nullptr};
+#endif
+};
+
+/**
+ * @brief Sink that collects the output in memory
+ */
+class SrecMemorySink : public SrecSink {
+public:
+	SrecMemorySink() = default;
+
+	/**
+	 * @brief Create a sink with preallocated capacity
+	 * @param capacity Number of characters to reserve
+	 */
+	explicit SrecMemorySink(size_t capacity) {
+		text.reserve(capacity);
+	}
+
+	void write(const char *data, size_t length) override {
+		text.append(data, length);
+	}
+
+	void flush() override {}
+
+	void close() override {
+		open = false;
+	}
+
+	bool is_open() const override {
+		return open;
+	}
+
+	bool can_patch() const override {
+		return true;
+	}
+
+	void patch(size_t offset, const char *data, size_t length) override {
+		if (offset > text.size() || length > text.size() - offset) {
+			throw SrecFileException("Patch range has not been written");
+		}
+		text.replace(offset, length, data, length);
+	}
+
+	/**
+	 * @brief Get the collected output
+	 * @return All characters written so far
+	 */
+	const std::string &str() const {
+		return text;
+	}
+
+	/**
+	 * @brief Move the collected output out of the sink
+	 * @return All characters written so far; the sink is left empty
+	 */
+	std::string take() {
+		std::string result;
+		result.swap(text);
+		return result;
+	}
+
+private:
+	std::string text;
+	bool open{true};
+};
+
+/**
+ * @brief Sink that writes to another sink on a background thread
+ *
+ * Output is collected in one buffer while the previous buffer is being
+ * written by the I/O thread, so formatting and writing overlap. write()
+ * only blocks when a full buffer is ready before the previous one has
+ * been written. Errors of the background writes are thrown from the next
+ * write(), flush() or close().
+ *
+ * @note This class is not thread-safe; the I/O thread is internal to it
+ */
+class SrecAsyncSink : public SrecSink {
+public:
+	/// Default size of each of the two buffers
+	static constexpr size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+
+	/**
+	 * @brief Write to another sink in the background
+	 * @param target Sink receiving the output
+	 * @param buffer_size Size of each of the two buffers (default: 256 KiB)
+	 */
+	explicit SrecAsyncSink(std::unique_ptr<SrecSink> target, size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+	/**
+	 * @brief Destructor - flushes and closes, ignoring errors
+	 */
+	~SrecAsyncSink() override;
+
+	SrecAsyncSink(const SrecAsyncSink &) = delete;
+	SrecAsyncSink &operator=(const SrecAsyncSink &) = delete;
+
+	void write(const char *data, size_t length) override;
+	void flush() override;
+	void sync() override;
+	void close() override;
+	bool is_open() const override;
+	bool can_patch() const override;
+	void patch(size_t offset, const char *data, size_t length) override;
+
+private:
+	void submit();
+	void wait_idle();
+	void io_loop();
+
+	std::unique_ptr<SrecSink> inner;
+	std::vector<char> active;  // filled by write()
+	std::vector<char> pending; // being written by the I/O thread
+	size_t submitted{0};       // characters handed to the I/O thread
+	bool busy{false};
+	bool stop{false};
+	bool closed{false};
+	std::exception_ptr error;
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::thread io_thread;
+};
+
+} // namespace tierone::srec
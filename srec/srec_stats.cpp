@@ -0,0 +1,99 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iomanip>
+#include <string>
+
+#include "srec_stats.h"
+
+namespace tierone::srec {
+
+namespace {
+
+// Record type names, in Srec::Type order
+constexpr std::array<const char *, SrecStats::TYPE_COUNT> TYPE_NAMES = {
+	"S0", "S1", "S2", "S3", "S5", "S6", "S7", "S8", "S9"
+};
+
+} // namespace
+
+uint64_t SrecStats::total_records() const {
+	uint64_t total = 0;
+	for (const uint64_t count : records) {
+		total += count;
+	}
+	return total;
+}
+
+void SrecStats::merge(const SrecStats &other) {
+	bytes_in += other.bytes_in;
+	bytes_out += other.bytes_out;
+	for (size_t i = 0; i < TYPE_COUNT; ++i) {
+		records[i] += other.records[i];
+	}
+	for (size_t i = 0; i < PHASE_COUNT; ++i) {
+		elapsed[i] += other.elapsed[i];
+	}
+	note_buffer(other.peak_buffer_bytes);
+}
+
+void SrecStats::print(std::ostream &output) const {
+	const std::ios::fmtflags flags = output.flags();
+	output << "Statistics:\n";
+	if (!ENABLED) {
+		output << "  not available (built with SREC_ENABLE_STATS=0)\n";
+		return;
+	}
+	output << "  bytes in:    " << bytes_in << "\n";
+	output << "  bytes out:   " << bytes_out << "\n";
+	output << "  records:     " << total_records();
+	const char *separator = " (";
+	for (size_t i = 0; i < TYPE_COUNT; ++i) {
+		if (records[i] > 0) {
+			output << separator << TYPE_NAMES[i] << " " << records[i];
+			separator = ", ";
+		}
+	}
+	output << (total_records() > 0 ? ")\n" : "\n");
+	output << "  peak buffer: " << peak_buffer_bytes << " bytes\n";
+	output << std::fixed << std::setprecision(3);
+	for (size_t i = 0; i < PHASE_COUNT; ++i) {
+		const auto phase = static_cast<Phase>(i);
+		const double milliseconds = std::chrono::duration<double, std::milli>(time(phase)).count();
+		output << "  " << std::left << std::setw(13) << (std::string(phase_name(phase)) + ":") << std::right
+		       << milliseconds << " ms\n";
+	}
+	output.flags(flags);
+}
+
+const char *SrecStats::phase_name(const Phase phase) {
+	switch (phase) {
+		case Phase::READ:
+			return "read";
+		case Phase::DECODE:
+			return "decode";
+		case Phase::FORMAT:
+			return "format";
+		case Phase::CHECKSUM:
+			return "checksum";
+		case Phase::WRITE:
+			return "write";
+		default:
+			return "unknown";
+	}
+}
+
+} // namespace tierone::srec
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Set to 0 to compile the instrumentation out of the library
+ *
+ * SrecStats keeps its interface, but nothing is recorded and the hooks in
+ * the readers, writers and converters reduce to constant-false branches.
+ */
+#if !defined(SREC_ENABLE_STATS)
+#define SREC_ENABLE_STATS 1
+#endif
+
+namespace tierone::srec {
+
+/**
+ * @brief Counters and phase timings of a parse or conversion
+ *
+ * Attach an instance to a reader, an SrecFile or a converter to find out
+ * where the time goes. Timings are wall-clock time measured on the thread
+ * doing the work; where several threads contribute (see
+ * SrecParallelVerifier) they are summed, i.e. CPU time.
+ *
+ * @note Not thread-safe; give every thread its own instance and merge()
+ */
+struct SrecStats {
+	/// Whether the library was built with instrumentation
+	static constexpr bool ENABLED = SREC_ENABLE_STATS != 0;
+
+	/// Clock used for all timings
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief Timed phases
+	 */
+	enum class Phase {
+		READ,     ///< Waiting for input
+		DECODE,   ///< Parsing records, including checksum validation
+		FORMAT,   ///< Formatting data records
+		CHECKSUM, ///< CRC32 over the data
+		WRITE     ///< Handing output to the sink or file
+	};
+
+	/// Number of Phase values
+	static constexpr size_t PHASE_COUNT = 5;
+
+	/// Number of Srec::Type values
+	static constexpr size_t TYPE_COUNT = 9;
+
+	uint64_t bytes_in{0};                                 ///< Input bytes consumed
+	uint64_t bytes_out{0};                                ///< Output bytes produced
+	std::array<uint64_t, TYPE_COUNT> records{};           ///< Records read or written, indexed by Srec::Type
+	std::array<Clock::duration, PHASE_COUNT> elapsed{};   ///< Time per phase, indexed by Phase
+	size_t peak_buffer_bytes{0};                          ///< Largest I/O buffer memory in use at once
+
+	/**
+	 * @brief Get the time spent in a phase
+	 * @param phase Phase to look up
+	 * @return Accumulated time
+	 */
+	Clock::duration time(const Phase phase) const {
+		return elapsed[static_cast<size_t>(phase)];
+	}
+
+	/**
+	 * @brief Add time to a phase
+	 * @param phase Phase to charge
+	 * @param duration Time spent
+	 */
+	void add_time(const Phase phase, const Clock::duration duration) {
+		elapsed[static_cast<size_t>(phase)] += duration;
+	}
+
+	/**
+	 * @brief Record the size of an I/O buffer in use
+	 * @param bytes Buffer memory in bytes
+	 */
+	void note_buffer(const size_t bytes) {
+		peak_buffer_bytes = std::max(peak_buffer_bytes, bytes);
+	}
+
+	/**
+	 * @brief Count records of one type
+	 * @param type Srec::Type of the records (a template so this header stands alone)
+	 * @param count Number of records
+	 */
+	template <typename RecordType>
+	void count_record(const RecordType type, const uint64_t count = 1) {
+		records[static_cast<size_t>(type)] += count;
+	}
+
+	/**
+	 * @brief Get the number of records of all types
+	 * @return Sum of records
+	 */
+	uint64_t total_records() const;
+
+	/**
+	 * @brief Add the counters and timings of another instance
+	 *
+	 * The peak buffer becomes the larger of the two.
+	 *
+	 * @param other Statistics to add
+	 */
+	void merge(const SrecStats &other);
+
+	/**
+	 * @brief Reset all counters and timings to zero
+	 */
+	void reset() {
+		*this = SrecStats();
+	}
+
+	/**
+	 * @brief Write a human-readable report
+	 * @param output Stream to write to
+	 */
+	void print(std::ostream &output) const;
+
+	/**
+	 * @brief Get a printable name for a phase
+	 * @param phase Phase to name
+	 * @return Phase name, e.g. "decode"
+	 */
+	static const char *phase_name(Phase phase);
+};
+
+/**
+ * @brief Scoped timer charging its lifetime to a phase
+ *
+ * Does nothing if the statistics pointer is null or instrumentation is
+ * compiled out, so call sites need no checks of their own.
+ */
+class SrecStatsTimer {
+public:
+	/**
+	 * @brief Start timing
+	 * @param stats Statistics to charge, or nullptr
+	 * @param phase Phase to charge
+	 */
+	SrecStatsTimer(SrecStats *stats, const SrecStats::Phase phase)
+		: target(SrecStats::ENABLED ? stats : nullptr),
+		  timed(phase)
+	{
+		if (SrecStats::ENABLED && target) {
+			start = SrecStats::Clock::now();
+		}
+	}
+
+	~SrecStatsTimer() {
+		stop();
+	}
+
+	SrecStatsTimer(const SrecStatsTimer &) = delete;
+	SrecStatsTimer &operator=(const SrecStatsTimer &) = delete;
+
+	/**
+	 * @brief Stop timing early; later calls and the destructor do nothing
+	 */
+	void stop() {
+		if (SrecStats::ENABLED && target) {
+			target->add_time(timed, SrecStats::Clock::now() - start);
+			target = nullptr;
+		}
+	}
+
+private:
+	SrecStats *target;
+	SrecStats::Phase timed;
+	SrecStats::Clock::time_point start{};
+};
+
+} // namespace tierone::srec
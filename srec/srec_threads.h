@@ -0,0 +1,86 @@
+/*
+ * Copyright 2025 TierOne Software
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Internal threading helpers. Not installed.
+
+#include <thread>
+#include <vector>
+
+namespace tierone::srec::detail {
+
+/**
+ * @brief Turn a user supplied thread count into an actual one
+ * @param requested Requested number of threads, 0 for one per hardware thread
+ * @return Number of threads to use (at least 1)
+ */
+inline unsigned resolve_thread_count(unsigned requested) {
+	if (requested != 0) {
+		return requested;
+	}
+	const unsigned hardware = std::thread::hardware_concurrency();
+	return hardware != 0 ? hardware : 1;
+}
+
+/**
+ * @brief Fixed group of threads all running the same worker function
+ *
+ * The worker is expected to pull its tasks from shared state (typically an
+ * atomic task index) and return when there is nothing left. Threads are
+ * joined on destruction, so the group can live on the stack of the function
+ * that owns the shared state. Callers that may leave that function early
+ * must signal the workers to stop before the group is destroyed.
+ */
+class WorkerThreads {
+public:
+	WorkerThreads() = default;
+
+	/**
+	 * @brief Start threads running the worker function
+	 * @param count Number of threads to start
+	 * @param worker Function each thread runs
+	 * @throws std::system_error if a thread cannot be started; threads that
+	 *         did start keep running until joined
+	 */
+	template <typename Function>
+	void start(unsigned count, const Function &worker) {
+		threads.reserve(threads.size() + count);
+		for (unsigned i = 0; i < count; ++i) {
+			threads.emplace_back(worker);
+		}
+	}
+
+	~WorkerThreads() {
+		join();
+	}
+
+	WorkerThreads(const WorkerThreads &) = delete;
+	WorkerThreads &operator=(const WorkerThreads &) = delete;
+
+	void join() {
+		for (auto &thread : threads) {
+			if (thread.joinable()) {
+				thread.join();
+			}
+		}
+	}
+
+private:
+	std::vector<std::thread> threads;
+};
+
+} // namespace tierone::srec::detail
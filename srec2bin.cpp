@@ -17,9 +17,47 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include "argparse.hpp"
 #include "srec/srec.h"
+#include "srec/srec_batch.h"
+#include "srec/srec_binary.h"
+
+namespace {
+
+// Convert a batch of files
+int convert_batch(const std::vector<tierone::srec::SrecBatchJob> &jobs, const unsigned threads, const uint8_t fill,
+                  const bool want_stats) {
+	tierone::srec::SrecBatchRunner runner(threads);
+	std::vector<tierone::srec::SrecStats> stats(runner.workers());
+	const size_t failures = runner.run(jobs.size(), [&](const size_t index, const unsigned worker) {
+		const auto &job = jobs[index];
+		const std::string output = job.output.empty()
+			? tierone::srec::SrecBatchRunner::replace_extension(job.input, ".bin") : job.output;
+		tierone::srec::SrecBinaryOptions options;
+		options.fill_byte = fill;
+		options.stats = want_stats ? &stats[worker] : nullptr;
+		tierone::srec::SrecBinaryConverter::convert(job.input, output, options);
+		return tierone::srec::SrecBatchResult{true, output};
+	}, [&](const size_t index, const tierone::srec::SrecBatchResult &result) {
+		if (result.ok) {
+			std::cout << jobs[index].input << ": OK -> " << result.message << std::endl;
+		} else {
+			std::cout << jobs[index].input << ": FAILED: " << result.message << std::endl;
+		}
+	});
+	std::cout << (jobs.size() - failures) << " of " << jobs.size() << " files converted" << std::endl;
+	if (want_stats) {
+		for (size_t i = 1; i < stats.size(); ++i) {
+			stats[0].merge(stats[i]);
+		}
+		stats[0].print(std::cerr);
+	}
+	return failures == 0 ? 0 : 1;
+}
+
+} // namespace
 
 
 int main(int argc, char *argv[]) {
@@ -30,6 +68,25 @@ int main(int argc, char *argv[]) {
 		.help("Input file in SREC format");
 	program.add_argument("-o", "--output")
 		.help("Output file in binary format");
+	program.add_argument("inputs")
+		.help("Input files converted in one batch, each to <name>.bin")
+		.remaining();
+	program.add_argument("-m", "--manifest")
+		.help("File listing batch inputs, one per line, each optionally followed by a tab and its output");
+	program.add_argument("-t", "--threads")
+		.help("Batch worker threads, 0 for one per CPU (default)")
+		.default_value(0)
+		.nargs(1)
+		.scan<'i', int>();
+	program.add_argument("-f", "--fill")
+		.help("Byte value for addresses not covered by any record, 0-255")
+		.default_value(0)
+		.nargs(1)
+		.scan<'i', int>();
+	program.add_argument("--stats")
+		.help("Print byte, record and timing statistics to stderr")
+		.default_value(false)
+		.implicit_value(true);
 
 	// Parse arguments
 	try {
@@ -41,6 +98,42 @@ int main(int argc, char *argv[]) {
 		return 1;
 	}
 
+	const bool want_stats = program.get<bool>("--stats");
+	const int fill = program.get<int>("--fill");
+	if (fill < 0 || fill > 255) {
+		std::cerr << "Fill byte must be between 0 and 255" << std::endl;
+		return 1;
+	}
+
+	// Collect batch jobs
+	std::vector<tierone::srec::SrecBatchJob> jobs;
+	if (const auto listed = program.present<std::vector<std::string>>("inputs")) {
+		for (const auto &name : *listed) {
+			jobs.push_back({name, std::string()});
+		}
+	}
+	if (const auto manifest = program.present("--manifest")) {
+		try {
+			const auto listed = tierone::srec::SrecBatchRunner::read_manifest(*manifest);
+			jobs.insert(jobs.end(), listed.begin(), listed.end());
+		} catch (const std::exception &err) {
+			std::cerr << err.what() << std::endl;
+			return 1;
+		}
+	}
+	if (!jobs.empty()) {
+		if (program.is_used("--output")) {
+			std::cerr << "--output does not support batch mode; list outputs in a manifest" << std::endl;
+			return 1;
+		}
+		const int threads = program.get<int>("--threads");
+		if (threads < 0) {
+			std::cerr << "Invalid thread count" << std::endl;
+			return 1;
+		}
+		return convert_batch(jobs, static_cast<unsigned>(threads), static_cast<uint8_t>(fill), want_stats);
+	}
+
 	// Check if input file is specified
 	if (!program.present("-i")) {
 		std::cerr << "Input file is not specified" << std::endl;
@@ -58,10 +151,18 @@ int main(int argc, char *argv[]) {
 	std::string input_file = program.get<std::string>("-i");
 	std::string output_file = program.get<std::string>("-o");
 
-    try {
-		tierone::srec::convert_srec_to_bin(input_file, output_file);
+	tierone::srec::SrecStats stats;
+	try {
+		tierone::srec::SrecBinaryOptions options;
+		options.fill_byte = static_cast<uint8_t>(fill);
+		options.stats = want_stats ? &stats : nullptr;
+		tierone::srec::SrecBinaryConverter::convert(input_file, output_file, options);
 	} catch (const std::exception &err) {
 		std::cerr << "Error converting SREC file: " << err.what() << std::endl;
+		return 1;
+	}
+	if (want_stats) {
+		stats.print(std::cerr);
 	}
 
 	return 0;
@@ -14,21 +14,200 @@
  * limitations under the License.
  */
 
+#include <cstdint>
+#include <cstdio>
 #include <iostream>
-#include <fstream>
+#include <optional>
 #include <string>
 #include <vector>
-#include <cstdint>
 
 #include "argparse.hpp"
-#include "srec/crc32.h"
+#include "srec/srec_batch.h"
+#include "srec/srec_metadata.h"
+#include "srec/srec_parallel.h"
+
+namespace {
+
+std::string hex32(const uint32_t value) {
+	char text[11];
+	std::snprintf(text, sizeof(text), "0x%08X", static_cast<unsigned>(value));
+	return text;
+}
+
+// Quote a string for JSON output
+std::string json_string(const std::string &text) {
+	std::string quoted = "\"";
+	for (const char c : text) {
+		switch (c) {
+			case '"':
+				quoted += "\\\"";
+				break;
+			case '\\':
+				quoted += "\\\\";
+				break;
+			case '\n':
+				quoted += "\\n";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					char escape[7];
+					std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(c));
+					quoted += escape;
+				} else {
+					quoted += c;
+				}
+				break;
+		}
+	}
+	return quoted + "\"";
+}
+
+// One line of JSON describing the check, for scripts gating on many files
+void print_json(const std::string &filename, const tierone::srec::SrecVerifyResult &result, const bool passed,
+                const std::string &error) {
+	std::cout << "{\"file\":" << json_string(filename)
+	          << ",\"status\":\"" << (!error.empty() ? "error" : (passed ? "pass" : "fail")) << "\"";
+	if (error.empty()) {
+		std::cout << ",\"records\":" << result.records
+		          << ",\"data_records\":" << result.data_records
+		          << ",\"data_bytes\":" << result.data_bytes
+		          << ",\"crc\":\"" << hex32(result.crc) << "\""
+		          << ",\"stored_crc\":" << (result.stored_crc ? "\"" + hex32(*result.stored_crc) + "\"" : "null")
+		          << ",\"crc_ok\":" << (result.crc_matches() ? "true" : "false")
+		          << ",\"count\":" << (result.stored_count ? std::to_string(*result.stored_count) : "null")
+		          << ",\"count_ok\":" << (result.count_matches() ? "true" : "false");
+	} else {
+		std::cout << ",\"error\":" << json_string(error);
+	}
+	std::cout << "}" << std::endl;
+}
+
+// First failed check, or an empty string if the file passed
+std::string failed_check(const tierone::srec::SrecVerifyResult &result) {
+	if (!result.count_matches()) {
+		return "Record count does not match";
+	}
+	if (!result.stored_crc) {
+		return "No CRC header found";
+	}
+	if (!result.crc_matches()) {
+		return "CRC does not match";
+	}
+	return std::string();
+}
+
+// Check many files on a pool of workers, one verification per worker at a time
+int check_batch(const std::vector<std::string> &files, const unsigned threads, const bool json,
+                const bool want_stats) {
+	tierone::srec::SrecBatchRunner runner(threads);
+	std::vector<tierone::srec::SrecVerifyResult> results(files.size());
+	std::vector<char> verified(files.size()); // not vector<bool>: written from several threads
+	std::vector<tierone::srec::SrecStats> stats(runner.workers());
+
+	const size_t failures = runner.run(files.size(), [&](const size_t index, const unsigned worker) {
+		tierone::srec::SrecParallelVerifier::Options options;
+		options.threads = 1;
+		options.stats = want_stats ? &stats[worker] : nullptr;
+		results[index] = tierone::srec::SrecParallelVerifier::verify_file(files[index], options);
+		verified[index] = 1;
+		const std::string problem = failed_check(results[index]);
+		return tierone::srec::SrecBatchResult{problem.empty(), problem};
+	}, [&](const size_t index, const tierone::srec::SrecBatchResult &result) {
+		// Files that could not be verified at all are errors, e.g. a bad record
+		const bool error = verified[index] == 0;
+		if (json) {
+			print_json(files[index], results[index], result.ok, error ? result.message : "");
+		} else if (result.ok) {
+			std::cout << files[index] << ": OK" << std::endl;
+		} else {
+			std::cout << files[index] << ": FAILED: " << result.message << std::endl;
+		}
+	});
+
+	if (!json) {
+		std::cout << (files.size() - failures) << " of " << files.size() << " files passed" << std::endl;
+	}
+	if (want_stats) {
+		for (size_t i = 1; i < stats.size(); ++i) {
+			stats[0].merge(stats[i]);
+		}
+		stats[0].print(std::cerr);
+	}
+	return failures == 0 ? 0 : 1;
+}
+
+// Print the catalog metadata of files without verifying them
+int print_info(const std::vector<std::string> &files, const bool json) {
+	int status = 0;
+	for (const auto &file : files) {
+		tierone::srec::SrecMetadata info;
+		try {
+			info = tierone::srec::SrecMetadataScanner::scan_file(file);
+		} catch (const std::exception &err) {
+			if (json) {
+				std::cout << "{\"file\":" << json_string(file) << ",\"status\":\"error\",\"error\":"
+				          << json_string(err.what()) << "}" << std::endl;
+			} else {
+				std::cout << file << ": ERROR: " << err.what() << std::endl;
+			}
+			status = 1;
+			continue;
+		}
+		// A CRC header holds no text
+		const std::string header = info.crc ? std::string() : info.header_text();
+		// Last data address, as the range is printed in both formats
+		const auto last = static_cast<uint32_t>(info.end_address - (info.end_address > info.start_address ? 1 : 0));
+		if (json) {
+			std::cout << "{\"file\":" << json_string(file)
+			          << ",\"header\":" << json_string(header)
+			          << ",\"crc\":" << (info.crc ? json_string(hex32(*info.crc)) : "null")
+			          << ",\"count\":" << (info.record_count ? std::to_string(*info.record_count) : "null")
+			          << ",\"entry_point\":" << (info.entry_point ? json_string(hex32(*info.entry_point)) : "null")
+			          << ",\"start\":" << json_string(hex32(info.start_address))
+			          << ",\"end\":" << json_string(hex32(last))
+			          << ",\"data_records\":" << info.data_records
+			          << ",\"data_bytes\":" << info.data_bytes << "}" << std::endl;
+		} else {
+			std::cout << file << ":" << std::endl;
+			std::cout << "  Header:        " << header << std::endl;
+			std::cout << "  CRC:           " << (info.crc ? hex32(*info.crc) : "none") << std::endl;
+			std::cout << "  Record count:  " << (info.record_count ? std::to_string(*info.record_count) : "none")
+			          << std::endl;
+			std::cout << "  Entry point:   " << (info.entry_point ? hex32(*info.entry_point) : "none") << std::endl;
+			std::cout << "  Address range: " << hex32(info.start_address) << "-" << hex32(last) << std::endl;
+			std::cout << "  Data:          " << info.data_records << " records, " << info.data_bytes << " bytes"
+			          << std::endl;
+		}
+	}
+	return status;
+}
+
+} // namespace
 
 int main(int argc, char *argv[]) {
 
 	// Define arguments
 	argparse::ArgumentParser program("sreccheck");
-	program.add_argument("file").help("SREC file to check");
+	program.add_argument("files").help("SREC files to check").remaining();
+	program.add_argument("-m", "--manifest").help("File listing SREC files to check, one per line");
 	program.add_argument("-v", "--verbose").help("Verbose mode").default_value(false).implicit_value(true);
+	program.add_argument("-t", "--threads")
+		.help("Verification threads, 0 for one per CPU; batch worker threads, one per CPU unless given")
+		.default_value(1)
+		.nargs(1)
+		.scan<'i', int>();
+	program.add_argument("-j", "--json")
+		.help("Print a one-line JSON summary")
+		.default_value(false)
+		.implicit_value(true);
+	program.add_argument("--stats")
+		.help("Print byte, record and timing statistics to stderr")
+		.default_value(false)
+		.implicit_value(true);
+	program.add_argument("-I", "--info")
+		.help("Print header, CRC, count, entry point and address range without verifying")
+		.default_value(false)
+		.implicit_value(true);
 
 	// Parse arguments
 	try {
@@ -40,79 +219,98 @@ int main(int argc, char *argv[]) {
 		return 1;
 	}
 
-	// Check if file is specified
-	std::string srecfilename;
-	try {
-		srecfilename = program.get<std::string>("file");
-	} catch (const std::exception &err) {
+	// Collect the files to check
+	std::vector<std::string> files;
+	if (const auto listed = program.present<std::vector<std::string>>("files")) {
+		files = *listed;
+	}
+	const auto manifest = program.present("--manifest");
+	if (manifest) {
+		try {
+			for (const auto &job : tierone::srec::SrecBatchRunner::read_manifest(*manifest)) {
+				files.push_back(job.input);
+			}
+		} catch (const std::exception &err) {
+			std::cerr << err.what() << std::endl;
+			return 1;
+		}
+	}
+	if (files.empty()) {
 		std::cerr << "No file specified" << std::endl;
-		std::cerr << err.what() << std::endl;
 		std::cerr << program;
 		return 1;
 	}
 
-	// Open file
-	std::ifstream srecfile(srecfilename);
-	if (!srecfile.is_open()) {
-		std::cerr << "Failed to open file" << std::endl;
+	// Get thread count
+	const int threads = program.get<int>("--threads");
+	if (threads < 0) {
+		std::cerr << "Invalid thread count" << std::endl;
 		return 1;
 	}
+	const bool verbose = program.get<bool>("verbose");
+	const bool json = program.get<bool>("--json");
+	const bool want_stats = program.get<bool>("--stats");
+	if (program.get<bool>("--info")) {
+		return print_info(files, json);
+	}
+	if (files.size() > 1 || manifest) {
+		return check_batch(files, program.is_used("--threads") ? static_cast<unsigned>(threads) : 0, json,
+		                   want_stats);
+	}
+	const std::string &srecfilename = files.front();
 
-	unsigned long found_crc = 0;
-	unsigned long sum = 0; // calculated CRC
-	std::string line;
-	std::vector<uint8_t> buff;
-
-	while (std::getline(srecfile, line)) {
-		if (line[0] == 'S') {
-			if (line[1] == '0') {
-				// read the CRC, bytes 8-15
-				try {
-					found_crc = std::stoul(line.substr(8, 8), nullptr, 16);
-				} catch (const std::out_of_range &err) {
-					std::cerr << "Failed to parse CRC" << std::endl;
-					std::cerr << err.what() << std::endl;
-					return 1;
-				}
-				continue;
-			}
-
-			// determine the index to start at
-			unsigned int start;
-			if (line[1] == '1') {
-				start = 4 /* S1 + byte count */ + 4 /* address */;
-			} else if (line[1] == '2') {
-				start = 4 /* S2 + byte count */ + 6 /* address */;
-			} else if (line[1] == '3') {
-				start = 4 /* S3 + byte count */ + 8 /* address */;
-			} else {
-				// not an S1/S2/S3 record, skip
-				continue;
-			}
-
-			buff.clear();
-			for (unsigned int i = start; i < line.size()-2/*skip checksum*/; i += 2) {
-				buff.push_back(static_cast<uint8_t>(std::stoul(line.substr(i, 2), nullptr, 16)));
-			}
-			sum = tierone::srec::xcrc32(buff.data(), buff.size(), sum);
+	// Check record checksums, CRC and record count in one pass
+	tierone::srec::SrecParallelVerifier::Options options;
+	options.threads = static_cast<unsigned>(threads);
+	tierone::srec::SrecStats stats;
+	if (want_stats) {
+		options.stats = &stats;
+	}
+	tierone::srec::SrecVerifyResult result;
+	try {
+		result = tierone::srec::SrecParallelVerifier::verify_file(srecfilename, options);
+		if (want_stats) {
+			stats.print(std::cerr);
+		}
+	} catch (const std::exception &err) {
+		if (json) {
+			print_json(srecfilename, result, false, err.what());
+		} else {
+			std::cerr << "Failed to check file: " << err.what() << std::endl;
 		}
+		return 1;
 	}
 
-	// Print results, if verbose flag is set
-	if (program.get<bool>("verbose")) {
-		std::cout << "Found CRC:       0x" << std::uppercase << std::hex << found_crc << std::endl;
-		std::cout << "Calculated CRC:  0x" << std::uppercase << std::hex << sum << std::endl;
+	const bool passed = result.crc_matches() && result.count_matches();
+	if (json) {
+		print_json(srecfilename, result, passed, "");
+		return passed ? 0 : 1;
 	}
-	if (found_crc == sum) {
-		if (program.get<bool>("verbose")) {
-			std::cout << "CRC matches" << std::endl;
+
+	// Print results, if verbose flag is set
+	if (verbose) {
+		std::cout << "Records:         " << result.records << " (" << result.data_records << " data, "
+		          << result.data_bytes << " bytes)" << std::endl;
+		if (result.stored_count) {
+			std::cout << "Record count:    " << *result.stored_count << ", counted " << result.counted_records
+			          << std::endl;
 		}
-		return 0;
-	} else {
+		std::cout << "Found CRC:       " << (result.stored_crc ? hex32(*result.stored_crc) : "none") << std::endl;
+		std::cout << "Calculated CRC:  " << hex32(result.crc) << std::endl;
+	}
+	if (!result.count_matches()) {
+		std::cout << "Record count does not match" << std::endl;
+	}
+	if (!result.stored_crc) {
+		std::cout << "No CRC header found" << std::endl;
+	} else if (!result.crc_matches()) {
 		std::cout << "CRC does not match" << std::endl;
-		if (program.get<bool>("verbose")) {
-			std::cerr << "CRC check failed. Expected: " << std::hex << found_crc << ", got 0x" << sum << std::endl;
+		if (verbose) {
+			std::cerr << "CRC check failed. Expected: " << hex32(*result.stored_crc) << ", got "
+			          << hex32(result.crc) << std::endl;
 		}
-		return 1;
+	} else if (verbose) {
+		std::cout << "CRC matches" << std::endl;
 	}
+	return passed ? 0 : 1;
 }
@@ -24,9 +24,36 @@
 #include <random>
 #include <algorithm>
 #include <cstdio>
+#include <filesystem>
+#include <array>
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
 
 #include "srec/srec.h"
 #include "srec/crc32.h"
+#include "srec/srec_arena.h"
+#include "srec/srec_batch.h"
+#include "srec/srec_binary.h"
+#include "srec/srec_buffer.h"
+#include "srec/srec_codec.h"
+#include "srec/srec_compress.h"
+#include "srec/srec_crc.h"
+#include "srec/srec_hex.h"
+#include "srec/srec_image.h"
+#include "srec/srec_incremental.h"
+#include "srec/srec_index.h"
+#include "srec/srec_mapped.h"
+#include "srec/srec_merge.h"
+#include "srec/srec_metadata.h"
+#include "srec/srec_parallel.h"
+#include "srec/srec_reader.h"
+#include "srec/srec_sink.h"
+#include "srec/srec_stats.h"
 
 // Test the ASCIIToHexString function
 TEST_CASE( "ASCIIToHexString", "[ASCIIToHexString]" ) {
@@ -443,6 +470,97 @@ TEST_CASE("Srec9 execution address (16-bit)", "[Srec9]") {
     }
 }
 
+// Test the allocation-free record formatter
+TEST_CASE("format_record writes into caller buffer", "[format_record]") {
+    std::array<char, tierone::srec::MAX_RECORD_LINE_LENGTH> line{};
+
+    SECTION("matches record classes for every type") {
+        std::vector<uint8_t> data{0x01, 0x02, 0x03};
+        auto format = [&line](tierone::srec::Srec::Type type, uint32_t address, const std::vector<uint8_t> &bytes) {
+            size_t length = tierone::srec::format_record(type, address, bytes.data(), bytes.size(), line.data());
+            return std::string(line.data(), length);
+        };
+
+        REQUIRE(format(tierone::srec::Srec::Type::S1, 0x1000, data) == "S1061000010203E3");
+        REQUIRE(format(tierone::srec::Srec::Type::S2, 0x123456, data) == tierone::srec::Srec2(0x123456, data).toString());
+        REQUIRE(format(tierone::srec::Srec::Type::S3, 0x12345678, data) == tierone::srec::Srec3(0x12345678, data).toString());
+        REQUIRE(format(tierone::srec::Srec::Type::S0, 0, data) == tierone::srec::Srec0(data).toString());
+        REQUIRE(format(tierone::srec::Srec::Type::S5, 0x1234, {}) == tierone::srec::Srec5(0x1234).toString());
+        REQUIRE(format(tierone::srec::Srec::Type::S6, 0x123456, {}) == tierone::srec::Srec6(0x123456).toString());
+        REQUIRE(format(tierone::srec::Srec::Type::S7, 0x12345678, {}) == tierone::srec::Srec7(0x12345678).toString());
+        REQUIRE(format(tierone::srec::Srec::Type::S8, 0x123456, {}) == tierone::srec::Srec8(0x123456).toString());
+        REQUIRE(format(tierone::srec::Srec::Type::S9, 0x1234, {}) == tierone::srec::Srec9(0x1234).toString());
+    }
+
+    SECTION("maximum size record") {
+        std::vector<uint8_t> data(252, 0xA5);
+        size_t length = tierone::srec::format_record(tierone::srec::Srec::Type::S1, 0xFFFF, data.data(), data.size(), line.data());
+        REQUIRE(length == tierone::srec::MAX_RECORD_LINE_LENGTH);
+        REQUIRE(std::string(line.data(), length) == tierone::srec::Srec1(0xFFFF, data).toString());
+    }
+
+    SECTION("validation") {
+        std::vector<uint8_t> data(253, 0x00);
+        REQUIRE_THROWS_AS(tierone::srec::format_record(tierone::srec::Srec::Type::S1, 0, data.data(), data.size(), line.data()),
+                          tierone::srec::SrecValidationException);
+        REQUIRE_THROWS_AS(tierone::srec::format_record(tierone::srec::Srec::Type::S1, 0x10000, nullptr, 0, line.data()),
+                          tierone::srec::SrecAddressException);
+        REQUIRE_THROWS_AS(tierone::srec::format_record(tierone::srec::Srec::Type::S2, 0x1000000, nullptr, 0, line.data()),
+                          tierone::srec::SrecAddressException);
+        REQUIRE_NOTHROW(tierone::srec::format_record(tierone::srec::Srec::Type::S3, 0xFFFFFFFF, nullptr, 0, line.data()));
+    }
+}
+
+// Test the hex codec kernels against the scalar reference
+TEST_CASE("Hex codec kernels", "[hex]") {
+    using tierone::srec::HexKernel;
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<> dis(0, 255);
+
+    for (const auto kernel : {HexKernel::SCALAR, HexKernel::SSE41, HexKernel::AVX2, HexKernel::NEON}) {
+        if (!tierone::srec::hex_kernel_supported(kernel)) {
+            continue;
+        }
+        INFO("kernel: " << tierone::srec::hex_kernel_name(kernel));
+
+        for (const size_t count : {0U, 1U, 7U, 8U, 15U, 16U, 17U, 31U, 32U, 33U, 64U, 100U, 252U}) {
+            std::vector<uint8_t> bytes(count);
+            uint32_t expected_sum = 0;
+            for (auto &byte : bytes) {
+                byte = static_cast<uint8_t>(dis(gen));
+                expected_sum += byte;
+            }
+
+            std::string hex(count * 2, '\0');
+            REQUIRE(tierone::srec::hex_encode(kernel, bytes.data(), count, hex.data()) == expected_sum);
+            REQUIRE(hex == tierone::srec::ASCIIToHexString(std::string(bytes.begin(), bytes.end())));
+
+            std::vector<uint8_t> decoded(count);
+            uint32_t sum = 0;
+            REQUIRE(tierone::srec::hex_decode(kernel, hex.data(), count, decoded.data(), sum));
+            REQUIRE(decoded == bytes);
+            REQUIRE(sum == expected_sum);
+
+            // lower case is accepted as well
+            std::string lower = hex;
+            std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+            REQUIRE(tierone::srec::hex_decode(kernel, lower.data(), count, decoded.data(), sum));
+            REQUIRE(decoded == bytes);
+
+            // every position must be validated
+            for (size_t i = 0; i < hex.size(); ++i) {
+                for (char bad : {'G', 'g', '/', ':', '@', '`', ' ', '\x80', '\xC1'}) {
+                    std::string corrupt = hex;
+                    corrupt[i] = bad;
+                    REQUIRE_FALSE(tierone::srec::hex_decode(kernel, corrupt.data(), count, decoded.data(), sum));
+                }
+            }
+        }
+    }
+
+    REQUIRE(tierone::srec::hex_kernel_supported(tierone::srec::hex_active_kernel()));
+}
+
 // Test SrecFile class
 TEST_CASE("SrecFile operations", "[SrecFile]") {
     // Create a temporary file for testing
@@ -1153,4 +1271,2684 @@ TEST_CASE("SrecStreamParser - file parsing", "[streaming]") {
             tierone::srec::SrecFileException
         );
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("SrecMappedReader", "[mapped]") {
+    using tierone::srec::SrecMappedReader;
+    using tierone::srec::SrecStreamParser;
+
+    const std::string text =
+        "S00F000068656C6C6F202020202000003C\r\n"
+        "\n"
+        "S1061000010203E3\r\n"
+        "S1061020040506BA  \n"
+        "S9030000FC";
+
+    SECTION("Read records from memory") {
+        SrecMappedReader reader(text.data(), text.size());
+        SrecMappedReader::ParsedRecordView record{};
+
+        REQUIRE(reader.next(record));
+        REQUIRE(record.type == tierone::srec::Srec::Type::S0);
+        REQUIRE(record.line_number == 1);
+
+        REQUIRE(reader.next(record));
+        REQUIRE(record.type == tierone::srec::Srec::Type::S1);
+        REQUIRE(record.address == 0x1000);
+        REQUIRE(record.length == 3);
+        REQUIRE(record.data[0] == 0x01);
+        REQUIRE(record.data[2] == 0x03);
+        REQUIRE(record.checksum_valid);
+        REQUIRE(record.line_number == 3);
+
+        REQUIRE(reader.next(record));
+        REQUIRE(record.address == 0x1020);
+        REQUIRE(record.line_number == 4);
+
+        REQUIRE(reader.next(record));
+        REQUIRE(record.type == tierone::srec::Srec::Type::S9);
+        REQUIRE(record.line_number == 5);
+
+        REQUIRE_FALSE(reader.next(record));
+        REQUIRE(reader.offset() == text.size());
+    }
+
+    SECTION("Decode payloads into caller memory") {
+        SrecMappedReader reader(text.data(), text.size());
+        SrecMappedReader::ParsedRecordView record{};
+        std::vector<uint8_t> arena(4 * SrecStreamParser::MAX_RECORD_DATA_SIZE);
+        uint8_t *cursor = arena.data();
+
+        while (reader.next(record, cursor)) {
+            REQUIRE(record.data == cursor);
+            cursor += record.length;
+        }
+        // Header text followed by both data payloads
+        REQUIRE(static_cast<size_t>(cursor - arena.data()) == 12 + 3 + 3);
+        REQUIRE(arena[12] == 0x01);
+        REQUIRE(arena[17] == 0x06);
+    }
+
+    SECTION("Errors report the offending line") {
+        const std::string bad = "S1061000010203E3\n\nS10610200405G6BA\n";
+        SrecMappedReader reader(bad.data(), bad.size());
+        SrecMappedReader::ParsedRecordView record{};
+        REQUIRE(reader.next(record));
+        try {
+            reader.next(record);
+            FAIL("Expected a parse error");
+        } catch (const tierone::srec::SrecParseException &e) {
+            REQUIRE(e.getLineNumber() == 3);
+            REQUIRE(e.getColumn() == 13);
+        }
+    }
+
+    SECTION("Read records from a file") {
+        const std::string test_file = "test_mapped_reader.srec";
+        {
+            std::ofstream file(test_file, std::ios::binary);
+            REQUIRE(file.is_open());
+            file << text;
+        }
+
+        std::vector<SrecStreamParser::ParsedRecord> records;
+        SrecMappedReader reader(test_file);
+        reader.parse([&records](const SrecStreamParser::ParsedRecord &record) -> bool {
+            records.push_back(record);
+            return true;
+        });
+
+        REQUIRE(records.size() == 4);
+        REQUIRE(records[1].data == std::vector<uint8_t>{0x01, 0x02, 0x03});
+        REQUIRE(records[2].line_number == 4);
+
+        std::remove(test_file.c_str());
+    }
+
+    SECTION("Empty and missing files") {
+        const std::string test_file = "test_mapped_empty.srec";
+        { std::ofstream file(test_file); }
+        SrecMappedReader reader(test_file);
+        SrecMappedReader::ParsedRecordView record{};
+        REQUIRE_FALSE(reader.next(record));
+        std::remove(test_file.c_str());
+
+        REQUIRE_THROWS_AS(SrecMappedReader("nonexistent_file.srec"), tierone::srec::SrecFileException);
+    }
+}
+
+TEST_CASE("SrecParallelParser", "[parallel]") {
+    using tierone::srec::SrecParallelParser;
+    using tierone::srec::SrecStreamParser;
+
+    // Build a few hundred records with blank lines mixed in
+    std::string text = "S00F000068656C6C6F202020202000003C\n";
+    std::array<char, tierone::srec::MAX_RECORD_LINE_LENGTH + 1> line{};
+    std::array<uint8_t, 16> payload{};
+    for (uint32_t i = 0; i < 300; ++i) {
+        for (size_t j = 0; j < payload.size(); ++j) {
+            payload[j] = static_cast<uint8_t>(i + j);
+        }
+        const size_t length = tierone::srec::format_record(tierone::srec::Srec::Type::S1,
+            i * 16, payload.data(), payload.size(), line.data());
+        text.append(line.data(), length);
+        text += (i % 7 == 0) ? "\r\n\n" : "\n";
+    }
+    text += "S9030000FC\n";
+
+    std::vector<SrecStreamParser::ParsedRecord> expected;
+    std::istringstream stream(text);
+    SrecStreamParser::parse_stream(stream, [&expected](const SrecStreamParser::ParsedRecord &record) {
+        expected.push_back(record);
+        return true;
+    });
+
+    SrecParallelParser::Options options;
+    options.threads = 4;
+    options.chunk_size = 256;
+
+    SECTION("Records arrive in file order with sequential line numbers") {
+        std::vector<SrecStreamParser::ParsedRecord> records;
+        SrecParallelParser::parse_buffer(text.data(), text.size(),
+            [&records](const SrecStreamParser::ParsedRecord &record) {
+                records.push_back(record);
+                return true;
+            }, options);
+
+        REQUIRE(records.size() == expected.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            REQUIRE(records[i].type == expected[i].type);
+            REQUIRE(records[i].address == expected[i].address);
+            REQUIRE(records[i].data == expected[i].data);
+            REQUIRE(records[i].line_number == expected[i].line_number);
+        }
+    }
+
+    SECTION("Callback can stop parsing") {
+        size_t count = 0;
+        SrecParallelParser::parse_buffer_views(text.data(), text.size(),
+            [&count](const SrecStreamParser::ParsedRecordView &) {
+                return ++count < 100;
+            }, options);
+        REQUIRE(count == 100);
+    }
+
+    SECTION("First error is reported deterministically") {
+        // Corrupt a late line first, then an earlier one in a different chunk
+        std::string bad = text;
+        const size_t late = bad.find("S113", bad.size() / 2);
+        bad[late + 10] = 'X';
+        const size_t early = bad.find("S113", bad.size() / 4);
+        bad[early + 10] = 'X';
+        const auto early_line = static_cast<size_t>(std::count(bad.begin(), bad.begin() + static_cast<std::ptrdiff_t>(early), '\n')) + 1;
+
+        for (int run = 0; run < 5; ++run) {
+            size_t delivered = 0;
+            try {
+                SrecParallelParser::parse_buffer_views(bad.data(), bad.size(),
+                    [&delivered](const SrecStreamParser::ParsedRecordView &) {
+                        ++delivered;
+                        return true;
+                    }, options);
+                FAIL("Expected a parse error");
+            } catch (const tierone::srec::SrecParseException &e) {
+                REQUIRE(e.getLineNumber() == early_line);
+                REQUIRE(e.getColumn() == 11);
+            }
+            // Everything before the bad line was delivered
+            size_t before = 0;
+            while (before < expected.size() && expected[before].line_number < early_line) {
+                ++before;
+            }
+            REQUIRE(delivered == before);
+        }
+    }
+
+    SECTION("Parse file with a single thread") {
+        const std::string test_file = "test_parallel_parse.srec";
+        {
+            std::ofstream file(test_file, std::ios::binary);
+            REQUIRE(file.is_open());
+            file << text;
+        }
+        options.threads = 1;
+        size_t count = 0;
+        SrecParallelParser::parse_file(test_file, [&count](const SrecStreamParser::ParsedRecord &) {
+            ++count;
+            return true;
+        }, options);
+        REQUIRE(count == expected.size());
+        std::remove(test_file.c_str());
+    }
+}
+
+TEST_CASE("SrecMemoryImage", "[image]") {
+    using tierone::srec::SrecMemoryImage;
+
+    SECTION("Adjacent and overlapping writes coalesce") {
+        SrecMemoryImage image;
+        image.write(0x1000, {0x01, 0x02});
+        image.write(0x1002, {0x03, 0x04});
+        REQUIRE(image.segments().size() == 1);
+
+        image.write(0x2000, {0xAA});
+        image.write(0x0FFE, {0xEE, 0xFF});
+        REQUIRE(image.segments().size() == 2);
+        REQUIRE(image.start_address() == 0x0FFE);
+
+        // Bridges both segments and overwrites 0x1003
+        std::vector<uint8_t> bridge(0x2000 - 0x1003, 0x55);
+        image.write(0x1003, bridge);
+        REQUIRE(image.segments().size() == 1);
+        REQUIRE(image.data_size() == 0x2001 - 0x0FFE);
+        REQUIRE(image.end_address() == 0x2001);
+
+        const uint8_t *bytes = image.find(0x0FFE, 6);
+        REQUIRE(bytes != nullptr);
+        REQUIRE(bytes[0] == 0xEE);
+        REQUIRE(bytes[4] == 0x03);
+        REQUIRE(bytes[5] == 0x55);
+        REQUIRE(image.find(0x2000, 1)[0] == 0xAA);
+        REQUIRE_FALSE(image.contains(0x2000, 2));
+    }
+
+    SECTION("Gaps are filled on export") {
+        SrecMemoryImage image;
+        image.set_fill_byte(0xFF);
+        image.write(0x0104, {0x04, 0x05});
+        image.write(0x0100, {0x00, 0x01});
+
+        REQUIRE(image.to_binary() == std::vector<uint8_t>{0x00, 0x01, 0xFF, 0xFF, 0x04, 0x05});
+
+        std::array<uint8_t, 4> window{};
+        REQUIRE(image.read(0x0101, window.data(), window.size()) == 2);
+        REQUIRE(window == std::array<uint8_t, 4>{0x01, 0xFF, 0xFF, 0x04});
+
+        std::ostringstream output;
+        image.write_binary(output);
+        REQUIRE(output.str() == std::string("\x00\x01\xFF\xFF\x04\x05", 6));
+    }
+
+    SECTION("Writes past the address space are rejected") {
+        SrecMemoryImage image;
+        REQUIRE_NOTHROW(image.write(0xFFFFFFFE, {0x01, 0x02}));
+        REQUIRE_THROWS_AS(image.write(0xFFFFFFFF, {0x01, 0x02}), tierone::srec::SrecAddressException);
+    }
+
+    SECTION("srec to binary honours record addresses") {
+        const std::string input_file = "test_image_input.srec";
+        const std::string output_file = "test_image_output.bin";
+        {
+            std::ofstream file(input_file);
+            REQUIRE(file.is_open());
+            file << "S0030000FC\n";
+            file << "S1061020040506BA\n"; // out of order, after a gap
+            file << "S1061000010203E3\n";
+            file << "S9031000EC\n";
+        }
+
+        SrecMemoryImage image;
+        image.load_file(input_file);
+        REQUIRE(image.segments().size() == 2);
+        REQUIRE(image.execution_address() == 0x1000);
+
+        tierone::srec::convert_srec_to_bin(input_file, output_file, 0xFF);
+        std::ifstream result(output_file, std::ios::binary);
+        const std::vector<uint8_t> binary((std::istreambuf_iterator<char>(result)), std::istreambuf_iterator<char>());
+        REQUIRE(binary.size() == 0x23);
+        REQUIRE(binary[0] == 0x01);
+        REQUIRE(binary[3] == 0xFF);
+        REQUIRE(binary[0x20] == 0x04);
+        REQUIRE(binary[0x22] == 0x06);
+
+        std::remove(input_file.c_str());
+        std::remove(output_file.c_str());
+    }
+}
+
+TEST_CASE("SrecFile output sinks", "[sink]") {
+    using tierone::srec::SrecFile;
+    using tierone::srec::FlushPolicy;
+
+    auto file_contents = [](const std::string &name) {
+        std::ifstream file(name, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+
+    SECTION("Memory sink collects the records") {
+        auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *memory = sink.get();
+        SrecFile sf(std::move(sink), SrecFile::AddressSize::BITS16, 0x1000);
+        REQUIRE(sf.is_open());
+        sf.write_record_payload(std::vector<uint8_t>{0x01, 0x02, 0x03});
+        sf.write_record_count();
+        sf.write_record_termination();
+        sf.close();
+        REQUIRE_FALSE(sf.is_open());
+        REQUIRE(memory->str() == "S1061000010203E3\nS5030001FB\nS9031000EC\n");
+    }
+
+    SECTION("Flush policy controls when records reach the file") {
+        const std::string filename = "test_sink_policy.srec";
+        const std::vector<uint8_t> data{0x01, 0x02, 0x03};
+        {
+            SrecFile sf(filename, SrecFile::AddressSize::BITS16, 0x1000);
+            REQUIRE(sf.flush_policy() == FlushPolicy::ON_CLOSE);
+            sf.write_record_payload(data);
+            REQUIRE(file_contents(filename).empty());
+            sf.flush();
+            REQUIRE(file_contents(filename) == "S1061000010203E3\n");
+        }
+        {
+            SrecFile sf(filename, SrecFile::AddressSize::BITS16, 0x1000, FlushPolicy::PER_RECORD);
+            sf.write_record_payload(data);
+            REQUIRE(file_contents(filename) == "S1061000010203E3\n");
+        }
+        std::remove(filename.c_str());
+    }
+
+    SECTION("Writes larger than the buffer go straight through") {
+        const std::string filename = "test_sink_small.srec";
+        {
+            tierone::srec::SrecFileSink sink(filename, 16);
+            REQUIRE(sink.is_open());
+            sink.write("0123456789", 10);
+            sink.write("abcdefghijklmnopqrstuvwxyz", 26);
+            sink.write("!", 1);
+            REQUIRE(file_contents(filename) == "0123456789abcdefghijklmnopqrstuvwxyz");
+            sink.close();
+        }
+        REQUIRE(file_contents(filename) == "0123456789abcdefghijklmnopqrstuvwxyz!");
+        std::remove(filename.c_str());
+    }
+
+    SECTION("Unwritable paths leave the file closed") {
+        SrecFile sf("nonexistent_dir/out.srec", SrecFile::AddressSize::BITS32);
+        REQUIRE_FALSE(sf.is_open());
+        REQUIRE_THROWS_AS(sf.write_record_termination(), tierone::srec::SrecFileException);
+    }
+}
+
+TEST_CASE("Single-pass CRC header", "[checksum]") {
+    using tierone::srec::SrecFile;
+
+    // A sink that cannot seek back, like a pipe
+    class AppendOnlySink : public tierone::srec::SrecMemorySink {
+    public:
+        bool can_patch() const override { return false; }
+    };
+
+    const std::string bin_file = "test_crc_header.bin";
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+    {
+        std::ofstream file(bin_file, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+    const unsigned int crc = tierone::srec::xcrc32(data.data(), data.size(), 0);
+
+    std::array<char, tierone::srec::MAX_RECORD_LINE_LENGTH> line{};
+    const std::array<uint8_t, 5> crc_bytes{static_cast<uint8_t>(crc >> 24), static_cast<uint8_t>(crc >> 16),
+                                           static_cast<uint8_t>(crc >> 8), static_cast<uint8_t>(crc), 0};
+    const std::string expected_header(line.data(), tierone::srec::format_record(
+        tierone::srec::Srec::Type::S0, 0, crc_bytes.data(), crc_bytes.size(), line.data()));
+
+    // Convert into a memory sink and return the text
+    auto convert_to = [&](auto sink) {
+        auto *memory = sink.get();
+        std::ifstream input(bin_file, std::ios::binary);
+        SrecFile sf(std::move(sink), SrecFile::AddressSize::BITS32);
+        tierone::srec::convert_bin_to_srec(input, sf, true);
+        return memory->str();
+    };
+
+    SECTION("Reserved header is patched in place") {
+        const std::string text = convert_to(std::make_unique<tierone::srec::SrecMemorySink>());
+        REQUIRE(text.substr(0, expected_header.size() + 1) == expected_header + "\n");
+    }
+
+    SECTION("Unpatchable output gets the CRC computed up front") {
+        const std::string text = convert_to(std::make_unique<AppendOnlySink>());
+        REQUIRE(text.substr(0, expected_header.size() + 1) == expected_header + "\n");
+
+        // Same records as the patched conversion
+        REQUIRE(text == convert_to(std::make_unique<tierone::srec::SrecMemorySink>()));
+    }
+
+    SECTION("File output is patched without a temporary file") {
+        const std::string srec_file = "test_crc_header.srec";
+        {
+            std::ifstream input(bin_file, std::ios::binary);
+            SrecFile sf(srec_file, SrecFile::AddressSize::BITS32);
+            tierone::srec::convert_bin_to_srec(input, sf, true);
+        }
+        std::ifstream tmp(srec_file + ".tmp");
+        REQUIRE_FALSE(tmp.is_open());
+
+        std::ifstream result(srec_file);
+        std::string first;
+        std::getline(result, first);
+        REQUIRE(first == expected_header);
+
+        std::ifstream input(bin_file, std::ios::binary);
+        const std::string stream_file = "test_crc_header_stream.srec";
+        tierone::srec::SrecStreamConverter::convert_stream(input, stream_file,
+            SrecFile::AddressSize::BITS32, 0, true);
+        std::ifstream streamed(stream_file);
+        std::getline(streamed, first);
+        REQUIRE(first == expected_header);
+
+        std::remove(srec_file.c_str());
+        std::remove(stream_file.c_str());
+    }
+
+    SECTION("Patching requires a reserved header") {
+        SrecFile sf(std::make_unique<tierone::srec::SrecMemorySink>(), SrecFile::AddressSize::BITS16);
+        REQUIRE_THROWS_AS(sf.write_checksum_header(0), tierone::srec::SrecFileException);
+        SrecFile append_only(std::make_unique<AppendOnlySink>(), SrecFile::AddressSize::BITS16);
+        REQUIRE_THROWS_AS(append_only.reserve_checksum_header(), tierone::srec::SrecFileException);
+    }
+
+    std::remove(bin_file.c_str());
+}
+
+TEST_CASE("CRC32 kernels and combine", "[CRC32]") {
+    using tierone::srec::CrcKernel;
+
+    // The original one-byte-at-a-time loop
+    auto reference = [](const uint8_t *buf, size_t len, unsigned int crc) {
+        while (len--) {
+            crc = (crc << 8) ^ tierone::srec::crc32_table[((crc >> 24) ^ *buf++) & 0xff];
+        }
+        return crc;
+    };
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<> dis(0, 255);
+    std::vector<uint8_t> data(4096 + 64);
+    for (auto &byte : data) {
+        byte = static_cast<uint8_t>(dis(gen));
+    }
+
+    SECTION("Every kernel matches the reference") {
+        const std::vector<size_t> lengths{0, 1, 3, 7, 8, 15, 16, 17, 63, 64, 127, 128, 129, 191, 255, 256, 1000, 4096};
+        for (const auto kernel : {CrcKernel::TABLE, CrcKernel::SLICING8, CrcKernel::SLICING16, CrcKernel::CLMUL, CrcKernel::PMULL}) {
+            if (!tierone::srec::crc_kernel_supported(kernel)) {
+                continue;
+            }
+            INFO("kernel " << tierone::srec::crc_kernel_name(kernel));
+            for (const size_t length : lengths) {
+                for (const size_t offset : {size_t{0}, size_t{1}, size_t{5}}) {
+                    for (const unsigned int init : {0u, 0xFFFFFFFFu, 0x12345678u}) {
+                        REQUIRE(tierone::srec::crc32_update(kernel, data.data() + offset, length, init) ==
+                                reference(data.data() + offset, length, init));
+                    }
+                }
+            }
+        }
+        REQUIRE(tierone::srec::crc_kernel_supported(tierone::srec::crc_active_kernel()));
+        REQUIRE(tierone::srec::xcrc32(data.data(), 4096, 0) == reference(data.data(), 4096, 0));
+    }
+
+    SECTION("Combine merges independently computed blocks") {
+        for (const size_t split : {size_t{0}, size_t{1}, size_t{100}, size_t{2048}, size_t{4095}, size_t{4096}}) {
+            const unsigned int init = 0xA5A5A5A5u;
+            const uint32_t crc_a = tierone::srec::xcrc32(data.data(), split, init);
+            const uint32_t crc_b = tierone::srec::xcrc32(data.data() + split, 4096 - split, 0);
+            REQUIRE(tierone::srec::xcrc32_combine(crc_a, crc_b, 4096 - split) == reference(data.data(), 4096, init));
+        }
+    }
+}
+
+TEST_CASE("SrecParallelConverter", "[parallel]") {
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<> dis(0, 255);
+    std::string binary(40000, '\0'); // fits the 16-bit address space
+    for (auto &c : binary) {
+        c = static_cast<char>(dis(gen));
+    }
+
+    auto convert = [&binary](tierone::srec::SrecFile::AddressSize size, unsigned threads, size_t block_size,
+                             uint32_t &crc) {
+        auto memory = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *sink = memory.get();
+        tierone::srec::SrecFile sfile(std::move(memory), size, 0x100);
+        std::istringstream input(binary);
+        if (threads == 1) {
+            std::vector<uint8_t> buffer(sfile.max_data_bytes_per_record());
+            crc = 0;
+            while (input.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size())) ||
+                   input.gcount() > 0) {
+                const auto count = static_cast<size_t>(input.gcount());
+                sfile.write_record_payload(buffer.data(), count);
+                crc = tierone::srec::xcrc32(buffer.data(), count, crc);
+            }
+        } else {
+            tierone::srec::SrecParallelConverter::Options options;
+            options.threads = threads;
+            options.block_size = block_size;
+            crc = tierone::srec::SrecParallelConverter::write_data_records(input, sfile, options);
+        }
+        sfile.write_record_count();
+        sfile.write_record_termination();
+        return sink->str();
+    };
+
+    SECTION("Output matches sequential conversion") {
+        for (const auto size : {tierone::srec::SrecFile::AddressSize::BITS16,
+                                tierone::srec::SrecFile::AddressSize::BITS24,
+                                tierone::srec::SrecFile::AddressSize::BITS32}) {
+            uint32_t expected_crc = 0;
+            const std::string expected = convert(size, 1, 0, expected_crc);
+            for (const unsigned threads : {2u, 4u}) {
+                for (const size_t block_size : {size_t{1}, size_t{1000}, size_t{1024 * 1024}}) {
+                    uint32_t crc = 0;
+                    REQUIRE(convert(size, threads, block_size, crc) == expected);
+                    REQUIRE(crc == expected_crc);
+                }
+            }
+        }
+    }
+
+    SECTION("Address overflow is reported in order") {
+        auto memory = std::make_unique<tierone::srec::SrecMemorySink>();
+        tierone::srec::SrecFile sfile(std::move(memory), tierone::srec::SrecFile::AddressSize::BITS16, 0xFF00);
+        std::istringstream input(binary);
+        tierone::srec::SrecParallelConverter::Options options;
+        options.threads = 3;
+        options.block_size = 64;
+        REQUIRE_THROWS_AS(tierone::srec::SrecParallelConverter::write_data_records(input, sfile, options),
+                          tierone::srec::SrecAddressException);
+        // The two records below 0x10000 were written, as sequentially
+        REQUIRE(sfile.next_address() == 0xFF00 + 2 * sfile.max_data_bytes_per_record());
+    }
+
+    SECTION("Progress callback can cancel") {
+        auto memory = std::make_unique<tierone::srec::SrecMemorySink>();
+        tierone::srec::SrecFile sfile(std::move(memory), tierone::srec::SrecFile::AddressSize::BITS32);
+        std::istringstream input(binary);
+        tierone::srec::SrecParallelConverter::Options options;
+        options.threads = 2;
+        options.block_size = 4096;
+        size_t calls = 0;
+        REQUIRE_THROWS_AS(tierone::srec::SrecParallelConverter::write_data_records(
+                              input, sfile, options, [&calls](size_t, size_t) { return ++calls < 3; }),
+                          tierone::srec::SrecValidationException);
+        REQUIRE(calls == 3);
+    }
+}
+
+TEST_CASE("SrecView and record moves", "[srec]") {
+    const std::vector<uint8_t> payload{0x01, 0x02, 0x03};
+
+    SECTION("View formats like the owning record") {
+        tierone::srec::Srec1 rec(0x1000, payload);
+        const tierone::srec::SrecView view = rec.view();
+        REQUIRE(view.type == tierone::srec::Srec::Type::S1);
+        REQUIRE(view.address == 0x1000);
+        REQUIRE(view.data == rec.getData().data());
+        REQUIRE(view.length == 3);
+        REQUIRE(view.to_string() == "S1061000010203E3");
+        REQUIRE(rec.toString() == "S1061000010203E3");
+        REQUIRE(view.checksum() == 0xE3);
+
+        std::array<char, tierone::srec::MAX_RECORD_LINE_LENGTH> line;
+        REQUIRE(std::string(line.data(), view.format(line.data())) == "S1061000010203E3");
+
+        REQUIRE(tierone::srec::Srec9(0x1000).view().to_string() == "S9031000EC");
+        REQUIRE(tierone::srec::Srec5(1).view().to_string() == "S5030001FB");
+        REQUIRE(tierone::srec::Srec0(std::vector<uint8_t>{}).view().to_string() == "S0030000FC");
+    }
+
+    SECTION("Views compare payload bytes") {
+        const std::vector<uint8_t> copy = payload;
+        const tierone::srec::SrecView a{tierone::srec::Srec::Type::S1, 0x1000, payload.data(), payload.size()};
+        const tierone::srec::SrecView b{tierone::srec::Srec::Type::S1, 0x1000, copy.data(), copy.size()};
+        REQUIRE(a == b);
+        REQUIRE_FALSE(a != b);
+        REQUIRE(a != tierone::srec::SrecView{tierone::srec::Srec::Type::S1, 0x1001, copy.data(), copy.size()});
+        REQUIRE(a != tierone::srec::SrecView{tierone::srec::Srec::Type::S2, 0x1000, copy.data(), copy.size()});
+        REQUIRE(a != tierone::srec::SrecView{tierone::srec::Srec::Type::S1, 0x1000, copy.data(), 2});
+
+        const auto parsed = tierone::srec::SrecStreamParser::parse_line("S1061000010203E3");
+        REQUIRE(parsed.view() == a);
+    }
+
+    SECTION("Payloads are moved, not copied") {
+        std::vector<uint8_t> data(200, 0xAA);
+        const uint8_t *storage = data.data();
+        tierone::srec::Srec3 rec(0x20000000, std::move(data));
+        REQUIRE(rec.getData().data() == storage);
+
+        tierone::srec::Srec3 moved(std::move(rec));
+        REQUIRE(moved.getData().data() == storage);
+        REQUIRE(moved.view().address == 0x20000000);
+
+        tierone::srec::Srec3 copied(moved);
+        REQUIRE(copied.getData() == moved.getData());
+        REQUIRE(copied.getData().data() != storage);
+        REQUIRE_THROWS_AS(tierone::srec::Srec1(0x10000, std::vector<uint8_t>{1}), tierone::srec::SrecAddressException);
+    }
+}
+
+TEST_CASE("RecordCodec", "[codec]") {
+    using tierone::srec::SrecFile;
+
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<> dis(0, 255);
+    std::array<char, tierone::srec::MAX_RECORD_LINE_LENGTH> line;
+    std::array<uint8_t, tierone::srec::SrecStreamParser::MAX_RECORD_DATA_SIZE> payload;
+
+    auto check = [&](auto codec) {
+        using Codec = decltype(codec);
+        const auto selected = tierone::srec::with_record_codec(Codec::ADDRESS_SIZE, [](auto c) { return c.ADDRESS_LENGTH; });
+        REQUIRE(selected == Codec::ADDRESS_LENGTH);
+        REQUIRE(SrecFile("", Codec::ADDRESS_SIZE).max_data_bytes_per_record() == Codec::MAX_PAYLOAD);
+        REQUIRE(tierone::srec::data_record_parser(Codec::DATA_TYPE) == &Codec::parse_data);
+
+        for (size_t length = 0; length <= Codec::MAX_PAYLOAD; length += 7) {
+            std::vector<uint8_t> data(length);
+            for (auto &byte : data) {
+                byte = static_cast<uint8_t>(dis(gen));
+            }
+            const auto address = static_cast<uint32_t>(gen()) & Codec::MAX_ADDRESS;
+
+            const std::string expected =
+                tierone::srec::SrecView{Codec::DATA_TYPE, address, data.data(), data.size()}.to_string();
+            const std::string formatted(line.data(), Codec::format_data(address, data.data(), data.size(), line.data()));
+            REQUIRE(formatted == expected);
+
+            tierone::srec::SrecStreamParser::ParsedRecordView record{};
+            REQUIRE(Codec::parse_data(formatted, 9, true, payload.data(), record));
+            const auto reference = tierone::srec::SrecStreamParser::parse_line(formatted, 9, true);
+            REQUIRE(record.type == reference.type);
+            REQUIRE(record.address == reference.address);
+            REQUIRE(record.checksum == reference.checksum);
+            REQUIRE(record.line_number == 9);
+            REQUIRE(record.checksum_valid);
+            REQUIRE(std::vector<uint8_t>(record.data, record.data + record.length) == reference.data);
+        }
+
+        const std::string termination(line.data(), Codec::format_termination(0x42, line.data()));
+        REQUIRE(termination == tierone::srec::SrecView{Codec::TERMINATION_TYPE, 0x42, nullptr, 0}.to_string());
+
+        // Anything out of the ordinary is left to SrecStreamParser::parse_line
+        const uint8_t sample_data[] = {0x01, 0x02, 0x03};
+        const std::string sample(line.data(), Codec::format_data(0x10, sample_data, 3, line.data()));
+        tierone::srec::SrecStreamParser::ParsedRecordView record{};
+        std::string bad_checksum = sample;
+        bad_checksum.back() = bad_checksum.back() == '0' ? '1' : '0';
+        REQUIRE_FALSE(Codec::parse_data(bad_checksum, 1, true, payload.data(), record));
+        REQUIRE(Codec::parse_data(bad_checksum, 1, false, payload.data(), record));
+        REQUIRE_FALSE(Codec::parse_data(termination, 1, true, payload.data(), record));
+        REQUIRE_FALSE(Codec::parse_data(sample + "00", 1, true, payload.data(), record));
+        std::string bad_hex = sample;
+        bad_hex[bad_hex.size() / 2] = 'G';
+        REQUIRE_FALSE(Codec::parse_data(bad_hex, 1, true, payload.data(), record));
+    };
+
+    check(tierone::srec::RecordCodec<SrecFile::AddressSize::BITS16>{});
+    check(tierone::srec::RecordCodec<SrecFile::AddressSize::BITS24>{});
+    check(tierone::srec::RecordCodec<SrecFile::AddressSize::BITS32>{});
+
+    REQUIRE_THROWS_AS(tierone::srec::RecordCodec<SrecFile::AddressSize::BITS16>::format_data(0x10000, nullptr, 0, line.data()),
+                      tierone::srec::SrecAddressException);
+    REQUIRE(tierone::srec::data_record_parser(tierone::srec::Srec::Type::S9) == nullptr);
+}
+
+TEST_CASE("SrecFile batch writes", "[batch]") {
+    using tierone::srec::SrecFile;
+
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<> dis(0, 255);
+    std::vector<uint8_t> data(10000);
+    for (auto &byte : data) {
+        byte = static_cast<uint8_t>(dis(gen));
+    }
+
+    auto make_file = [](SrecFile::AddressSize size, uint32_t start, tierone::srec::SrecMemorySink *&sink,
+                        tierone::srec::FlushPolicy policy = tierone::srec::FlushPolicy::ON_CLOSE) {
+        auto memory = std::make_unique<tierone::srec::SrecMemorySink>();
+        sink = memory.get();
+        return std::make_unique<SrecFile>(std::move(memory), size, start, policy);
+    };
+
+    SECTION("write_data matches per-record writes") {
+        for (const auto size : {SrecFile::AddressSize::BITS16, SrecFile::AddressSize::BITS24, SrecFile::AddressSize::BITS32}) {
+            for (const auto policy : {tierone::srec::FlushPolicy::ON_CLOSE, tierone::srec::FlushPolicy::PER_RECORD}) {
+                tierone::srec::SrecMemorySink *expected_sink = nullptr;
+                auto expected = make_file(size, 0x100, expected_sink);
+                const size_t record_size = expected->max_data_bytes_per_record();
+                for (size_t offset = 0; offset < data.size(); offset += record_size) {
+                    expected->write_record_payload(data.data() + offset, std::min(record_size, data.size() - offset));
+                }
+                expected->write_record_count();
+
+                tierone::srec::SrecMemorySink *actual_sink = nullptr;
+                auto actual = make_file(size, 0x100, actual_sink, policy);
+                actual->write_data(data.data(), 1000);
+                actual->write_data(data.data() + 1000, 0);
+                actual->write_data(data.data() + 1000, data.size() - 1000);
+                actual->write_record_count();
+
+                // 1000 is not a multiple of the record size, so compare from a clean split
+                tierone::srec::SrecMemorySink *single_sink = nullptr;
+                auto single = make_file(size, 0x100, single_sink, policy);
+                single->write_data(data.data(), data.size());
+                single->write_record_count();
+                REQUIRE(single_sink->str() == expected_sink->str());
+                REQUIRE(single->next_address() == expected->next_address());
+                REQUIRE(actual->next_address() == expected->next_address());
+            }
+        }
+    }
+
+    SECTION("write_segments leaves gaps and is checked up front") {
+        tierone::srec::SrecMemorySink *sink = nullptr;
+        auto sfile = make_file(SrecFile::AddressSize::BITS16, 0, sink);
+        const std::vector<tierone::srec::SrecSegment> segments{
+            {0x1000, data.data(), 3}, {0x2000, data.data() + 3, 0}, {0x3000, data.data() + 3, 300}};
+        sfile->write_segments(segments);
+        REQUIRE(sfile->next_address() == 0x3000 + 300);
+
+        std::vector<uint32_t> addresses;
+        std::istringstream text(sink->str());
+        tierone::srec::SrecStreamParser::parse_stream(text, [&](const auto &record) {
+            addresses.push_back(record.address);
+            return true;
+        });
+        REQUIRE(addresses == std::vector<uint32_t>{0x1000, 0x3000, 0x3000 + 249});
+
+        const size_t written = sink->str().size();
+        const std::vector<tierone::srec::SrecSegment> too_high{{0x4000, data.data(), 10}, {0xFFFF, data.data(), 300}};
+        REQUIRE_THROWS_AS(sfile->write_segments(too_high), tierone::srec::SrecAddressException);
+        REQUIRE(sink->str().size() == written);
+
+        auto wide = make_file(SrecFile::AddressSize::BITS32, 0xFFFFFF00u, sink);
+        REQUIRE_THROWS_AS(wide->write_data(data.data(), 0x100), tierone::srec::SrecAddressException);
+        REQUIRE(sink->str().empty());
+    }
+}
+
+TEST_CASE("SrecReader", "[reader]") {
+    using tierone::srec::SrecReader;
+    using tierone::srec::SrecStreamParser;
+
+    const std::string text = "S0030000FC\r\n\nS1061000010203E3\r\n  \nS5030001FB\nS9031000EC";
+
+    std::vector<SrecStreamParser::ParsedRecord> expected;
+    {
+        tierone::srec::SrecMappedReader mapped(text.data(), text.size());
+        SrecStreamParser::ParsedRecordView view{};
+        while (mapped.next(view)) {
+            SrecStreamParser::ParsedRecord record;
+            view.copy_to(record);
+            expected.push_back(record);
+        }
+    }
+    REQUIRE(expected.size() == 4);
+
+    auto same = [](const SrecStreamParser::ParsedRecordView &view, const SrecStreamParser::ParsedRecord &record) {
+        return view.type == record.type && view.address == record.address &&
+               std::vector<uint8_t>(view.data, view.data + view.length) == record.data &&
+               view.line_number == record.line_number && view.checksum_valid == record.checksum_valid;
+    };
+
+    SECTION("Every block size yields the same records") {
+        for (const size_t block_size : {size_t{1}, size_t{5}, size_t{11}, size_t{64}, SrecReader::DEFAULT_BLOCK_SIZE}) {
+            std::istringstream input(text);
+            SrecReader reader(input, true, block_size);
+            SrecStreamParser::ParsedRecordView view{};
+            size_t count = 0;
+            while (reader.next(view)) {
+                REQUIRE(count < expected.size());
+                REQUIRE(same(view, expected[count]));
+                ++count;
+            }
+            REQUIRE(count == expected.size());
+            REQUIRE(reader.line_number() == 6);
+            REQUIRE_FALSE(reader.next(view));
+        }
+    }
+
+    SECTION("Range-for and for_each_record") {
+        std::istringstream input(text);
+        SrecReader reader(input);
+        size_t count = 0;
+        for (const auto &record : reader) {
+            REQUIRE(same(record, expected[count]));
+            ++count;
+        }
+        REQUIRE(count == expected.size());
+
+        std::istringstream again(text);
+        std::vector<uint32_t> addresses;
+        tierone::srec::for_each_record(again, [&](const SrecStreamParser::ParsedRecordView &record) {
+            addresses.push_back(record.address);
+            return record.type != tierone::srec::Srec::Type::S1;
+        });
+        REQUIRE(addresses == std::vector<uint32_t>{0, 0x1000});
+
+        tierone::srec::SrecMappedReader mapped(text.data(), text.size());
+        count = 0;
+        for (const auto &record : mapped) {
+            REQUIRE(same(record, expected[count]));
+            ++count;
+        }
+        REQUIRE(count == expected.size());
+    }
+
+    SECTION("Errors carry the line number") {
+        for (const size_t block_size : {size_t{3}, SrecReader::DEFAULT_BLOCK_SIZE}) {
+            std::istringstream input("S0030000FC\n\nS1061000010203E4\n");
+            SrecReader reader(input, true, block_size);
+            SrecStreamParser::ParsedRecordView view{};
+            REQUIRE(reader.next(view));
+            try {
+                reader.next(view);
+                FAIL("Expected a checksum error");
+            } catch (const tierone::srec::SrecException &e) {
+                REQUIRE(reader.line_number() == 3);
+            }
+
+            std::istringstream garbage("S0030000FC\nnot a record\n");
+            size_t seen = 0;
+            try {
+                SrecStreamParser::parse_stream(garbage, [&](const auto &) {
+                    ++seen;
+                    return true;
+                });
+                FAIL("Expected a parse error");
+            } catch (const tierone::srec::SrecParseException &e) {
+                REQUIRE(e.getLineNumber() == 2);
+            }
+            REQUIRE(seen == 1);
+        }
+    }
+}
+
+TEST_CASE("SrecIndexedReader", "[index]") {
+    using tierone::srec::SrecFile;
+    using tierone::srec::SrecIndex;
+    using tierone::srec::SrecIndexedReader;
+
+    const std::string srec_file = "test_index.s37";
+    std::mt19937 gen(15);
+    std::uniform_int_distribution<> dis(0, 255);
+    std::vector<uint8_t> data(20000);
+    for (auto &byte : data) {
+        byte = static_cast<uint8_t>(dis(gen));
+    }
+
+    // Three runs with a gap, plus a later record overwriting part of the first run
+    {
+        SrecFile sfile(srec_file, SrecFile::AddressSize::BITS32, 0x08000000);
+        sfile.write_header(std::vector<std::string>{"index"});
+        sfile.write_data(data.data(), 8000);
+        sfile.set_next_address(0x08010000);
+        sfile.write_data(data.data() + 8000, 12000);
+        sfile.set_next_address(0x08000100);
+        sfile.write_data(data.data() + 100, 16);
+        sfile.write_record_count();
+    }
+    std::remove(SrecIndex::sidecar_path(srec_file).c_str());
+
+    tierone::srec::SrecMemoryImage image;
+    image.load_file(srec_file);
+
+    SECTION("Reads match a full scan") {
+        const SrecIndex index = SrecIndex::build(srec_file, true, 4);
+        REQUIRE(index.entries().size() > 3);
+        REQUIRE(index.is_current(srec_file));
+
+        SrecIndexedReader reader(srec_file, index);
+        std::uniform_int_distribution<uint32_t> offset(0, 0x18000);
+        std::uniform_int_distribution<size_t> size(0, 3000);
+        for (int i = 0; i < 200; ++i) {
+            const uint32_t address = 0x07FFF000 + offset(gen);
+            const size_t length = size(gen);
+            std::vector<uint8_t> expected(length);
+            std::vector<uint8_t> actual(length);
+            const size_t expected_defined = image.read(address, expected.data(), length);
+            REQUIRE(reader.read(address, actual.data(), length) == expected_defined);
+            REQUIRE(actual == expected);
+        }
+        REQUIRE(reader.read(0x08000100, 16) == std::vector<uint8_t>(data.begin() + 100, data.begin() + 116));
+    }
+
+    SECTION("Side-car is saved, reloaded and invalidated") {
+        const std::string sidecar = SrecIndex::sidecar_path(srec_file);
+        {
+            SrecIndexedReader reader(srec_file);
+            REQUIRE(reader.read(0x08010000, 4) == std::vector<uint8_t>(data.begin() + 8000, data.begin() + 8004));
+        }
+        const SrecIndex loaded = SrecIndex::load(sidecar);
+        REQUIRE(loaded.entries() == SrecIndex::build(srec_file).entries());
+        REQUIRE(loaded.source_size() == SrecIndex::build(srec_file).source_size());
+
+        // A damaged side-car is rejected
+        {
+            std::fstream damage(sidecar, std::ios::binary | std::ios::in | std::ios::out);
+            damage.seekp(40);
+            damage.put('\x7F');
+        }
+        REQUIRE_THROWS_AS(SrecIndex::load(sidecar), tierone::srec::SrecFileException);
+
+        // Growing the file makes the index stale
+        SrecIndexedReader reader(srec_file, loaded);
+        {
+            std::ofstream append(srec_file, std::ios::binary | std::ios::app);
+            append << "S5030001FB\n";
+        }
+        REQUIRE_FALSE(reader.is_current());
+        REQUIRE_THROWS_AS(reader.read(0x08000000, 16), tierone::srec::SrecFileException);
+        REQUIRE_THROWS_AS(SrecIndexedReader(srec_file, loaded), tierone::srec::SrecFileException);
+
+        // open() notices and rebuilds
+        SrecIndexedReader rebuilt(srec_file);
+        REQUIRE(rebuilt.read(0x08000000, 16) == std::vector<uint8_t>(data.begin(), data.begin() + 16));
+        REQUIRE(SrecIndex::load(sidecar).is_current(srec_file));
+        std::remove(sidecar.c_str());
+    }
+
+    std::remove(srec_file.c_str());
+}
+
+TEST_CASE("SrecParallelVerifier", "[verify]") {
+    using tierone::srec::SrecParallelVerifier;
+
+    std::mt19937 gen(16);
+    std::uniform_int_distribution<> dis(0, 255);
+    std::vector<uint8_t> data(50000);
+    for (auto &byte : data) {
+        byte = static_cast<uint8_t>(dis(gen));
+    }
+    const uint32_t crc = tierone::srec::xcrc32(data.data(), data.size(), 0);
+
+    std::string text;
+    {
+        auto memory = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *sink = memory.get();
+        tierone::srec::SrecFile sfile(std::move(memory), tierone::srec::SrecFile::AddressSize::BITS24);
+        sfile.reserve_checksum_header();
+        sfile.write_data(data.data(), data.size());
+        sfile.write_record_count();
+        sfile.write_checksum_header(crc);
+        text = sink->str();
+    }
+
+    SECTION("Results do not depend on threads or chunking") {
+        for (const unsigned threads : {1u, 2u, 4u}) {
+            for (const size_t chunk_size : {size_t{1}, size_t{700}, size_t{1024 * 1024}}) {
+                SrecParallelVerifier::Options options;
+                options.threads = threads;
+                options.chunk_size = chunk_size;
+                const auto result = SrecParallelVerifier::verify_buffer(text.data(), text.size(), options);
+                REQUIRE(result.crc == crc);
+                REQUIRE(result.crc_matches());
+                REQUIRE(result.count_matches());
+                REQUIRE(result.data_bytes == data.size());
+                REQUIRE(result.records == result.data_records + 2);
+                REQUIRE(result.stored_count == result.data_records);
+            }
+        }
+    }
+
+    SECTION("Mismatches and errors are reported") {
+        std::string wrong_count = text;
+        const size_t count_line = wrong_count.find("\nS503") + 1;
+        REQUIRE(count_line != 0);
+        const auto count = tierone::srec::SrecParallelVerifier::verify_buffer(text.data(), text.size());
+        const std::string fake = tierone::srec::SrecView{tierone::srec::Srec::Type::S5,
+                                                         static_cast<uint32_t>(count.data_records + 1), nullptr, 0}
+                                     .to_string();
+        wrong_count.replace(count_line, fake.size(), fake);
+        const auto miscounted = SrecParallelVerifier::verify_buffer(wrong_count.data(), wrong_count.size());
+        REQUIRE_FALSE(miscounted.count_matches());
+        REQUIRE(miscounted.crc_matches());
+
+        // Without a CRC header the check cannot pass
+        const std::string plain = "S0030000FC\nS1061000010203E3\nS9031000EC\n";
+        const auto no_header = SrecParallelVerifier::verify_buffer(plain.data(), plain.size());
+        REQUIRE_FALSE(no_header.stored_crc);
+        REQUIRE_FALSE(no_header.crc_matches());
+
+        // A text header is not a CRC header, for the metadata scanner either
+        const std::string name = "MYFIRMWARE";
+        const std::string named = tierone::srec::SrecView{tierone::srec::Srec::Type::S0, 0,
+                                                          reinterpret_cast<const uint8_t *>(name.data()), name.size()}
+                                      .to_string() + "\n" + plain.substr(plain.find('\n') + 1);
+        const auto text_header = SrecParallelVerifier::verify_buffer(named.data(), named.size());
+        REQUIRE_FALSE(text_header.stored_crc);
+        const auto metadata = tierone::srec::SrecMetadataScanner::scan(named.data(), named.size());
+        REQUIRE_FALSE(metadata.crc);
+        REQUIRE(metadata.header_text() == name);
+
+        std::string corrupt = text;
+        const size_t line_start = corrupt.find('\n', corrupt.size() / 2) + 1;
+        corrupt[line_start + 20] = corrupt[line_start + 20] == '0' ? '1' : '0';
+        const auto line_begin = corrupt.begin() + static_cast<std::ptrdiff_t>(line_start);
+        const size_t bad_line = static_cast<size_t>(std::count(corrupt.begin(), line_begin, '\n')) + 1;
+        for (const unsigned threads : {1u, 3u}) {
+            SrecParallelVerifier::Options options;
+            options.threads = threads;
+            options.chunk_size = 512;
+            try {
+                SrecParallelVerifier::verify_buffer(corrupt.data(), corrupt.size(), options);
+                FAIL("Expected a checksum error");
+            } catch (const tierone::srec::SrecValidationException &e) {
+                REQUIRE(std::string(e.what()).find("line " + std::to_string(bad_line) + ":") != std::string::npos);
+            }
+        }
+    }
+}
+
+TEST_CASE("SrecBatchRunner", "[batch]") {
+    using tierone::srec::SrecBatchResult;
+    using tierone::srec::SrecBatchRunner;
+
+    SECTION("Results are reported in job order") {
+        for (const unsigned threads : {1u, 4u}) {
+            SrecBatchRunner runner(threads);
+            REQUIRE(runner.workers() == threads);
+            std::vector<size_t> reported;
+            std::atomic<bool> bad_worker{false}; // Catch assertions are not thread-safe
+            const size_t failures = runner.run(50, [&](const size_t index, const unsigned worker) {
+                if (worker >= runner.workers()) {
+                    bad_worker = true;
+                }
+                if (index % 7 == 3) {
+                    throw std::runtime_error("job " + std::to_string(index));
+                }
+                return SrecBatchResult{index % 10 != 5, std::to_string(index)};
+            }, [&](const size_t index, const SrecBatchResult &result) {
+                reported.push_back(index);
+                if (index % 7 == 3) {
+                    REQUIRE_FALSE(result.ok);
+                    REQUIRE(result.message == "job " + std::to_string(index));
+                } else {
+                    REQUIRE(result.ok == (index % 10 != 5));
+                }
+            });
+            REQUIRE_FALSE(bad_worker);
+            REQUIRE(failures == 7 + 5 - 1); // 45 fails both ways
+            std::vector<size_t> expected(50);
+            for (size_t i = 0; i < expected.size(); ++i) {
+                expected[i] = i;
+            }
+            REQUIRE(reported == expected);
+        }
+    }
+
+    SECTION("Manifests and output names") {
+        std::istringstream manifest("# firmware\n  a.bin \r\n\nb.s37\tout/b.bin\n\n");
+        const auto jobs = SrecBatchRunner::read_manifest(manifest);
+        REQUIRE(jobs.size() == 2);
+        REQUIRE(jobs[0].input == "a.bin");
+        REQUIRE(jobs[0].output.empty());
+        REQUIRE(jobs[1].input == "b.s37");
+        REQUIRE(jobs[1].output == "out/b.bin");
+        REQUIRE_THROWS_AS(SrecBatchRunner::read_manifest("no_such_manifest.txt"), tierone::srec::SrecFileException);
+
+        REQUIRE(SrecBatchRunner::replace_extension("dir/app.bin", ".srec") == "dir/app.srec");
+        REQUIRE(SrecBatchRunner::replace_extension("dir.v2/app", ".srec") == "dir.v2/app.srec");
+        REQUIRE(SrecBatchRunner::replace_extension(".hidden", ".bin") == ".hidden.bin");
+    }
+}
+
+TEST_CASE("SrecRecordArena and SrecRecordTable", "[arena]") {
+    using tierone::srec::SrecStreamParser;
+
+    std::mt19937 gen(18);
+    std::uniform_int_distribution<> dis(0, 255);
+    std::vector<uint8_t> data(30000);
+    for (auto &byte : data) {
+        byte = static_cast<uint8_t>(dis(gen));
+    }
+    std::string text;
+    {
+        auto memory = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *sink = memory.get();
+        tierone::srec::SrecFile sfile(std::move(memory), tierone::srec::SrecFile::AddressSize::BITS32, 0x1000);
+        sfile.write_header(std::vector<std::string>{"arena"});
+        sfile.write_data(data.data(), data.size());
+        sfile.write_record_count();
+        text = sink->str();
+    }
+
+    std::vector<SrecStreamParser::ParsedRecord> expected;
+    std::istringstream input(text);
+    SrecStreamParser::parse_stream(input, [&](const auto &record) {
+        expected.push_back(record);
+        return true;
+    });
+
+    SECTION("Arena payloads stay valid until cleared") {
+        tierone::srec::SrecRecordArena arena(1000);
+        std::vector<SrecStreamParser::ParsedRecordView> records;
+        tierone::srec::SrecMappedReader reader(text.data(), text.size());
+        SrecStreamParser::ParsedRecordView record{};
+        while (reader.next(record, arena.prepare(SrecStreamParser::MAX_RECORD_DATA_SIZE))) {
+            arena.commit(record.length);
+            records.push_back(record);
+        }
+        REQUIRE(records.size() == expected.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            REQUIRE(std::vector<uint8_t>(records[i].data, records[i].data + records[i].length) == expected[i].data);
+        }
+        REQUIRE(arena.bytes_used() == data.size() + expected[0].data.size());
+
+        // Cleared blocks are reused rather than reallocated
+        const size_t capacity = arena.capacity();
+        arena.clear();
+        REQUIRE(arena.bytes_used() == 0);
+        const auto &owned = expected[1];
+        const auto stored = arena.store(SrecStreamParser::ParsedRecordView{
+            owned.type, owned.address, owned.data.data(), owned.data.size(), owned.checksum, true, owned.line_number});
+        REQUIRE(arena.capacity() == capacity);
+        REQUIRE(std::vector<uint8_t>(stored.data, stored.data + stored.length) == owned.data);
+        uint8_t *large = arena.allocate(5000);
+        REQUIRE(large != nullptr);
+        REQUIRE(arena.capacity() >= capacity + 5000);
+        arena.release();
+        REQUIRE(arena.capacity() == 0);
+    }
+
+    SECTION("Tables hold a file's records as arrays") {
+        const std::string filename = "test_table.s37";
+        {
+            std::ofstream out(filename, std::ios::binary);
+            out << text;
+        }
+        tierone::srec::SrecRecordTable from_file;
+        from_file.load_file(filename);
+        std::remove(filename.c_str());
+
+        tierone::srec::SrecRecordTable from_stream;
+        std::istringstream stream(text);
+        from_stream.load(stream);
+
+        for (const auto *table : {&from_file, &from_stream}) {
+            REQUIRE(table->size() == expected.size());
+            REQUIRE(table->payload().size() == data.size() + expected[0].data.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                const auto record = (*table)[i];
+                REQUIRE(record.type == expected[i].type);
+                REQUIRE(record.address == expected[i].address);
+                REQUIRE(record.line_number == expected[i].line_number);
+                REQUIRE(record.checksum_valid);
+                REQUIRE(std::vector<uint8_t>(record.data, record.data + record.length) == expected[i].data);
+            }
+        }
+
+        // Payloads of data records are one contiguous copy of the input
+        const size_t first_data = 1;
+        const auto payload_start = static_cast<std::ptrdiff_t>(from_file.offsets()[first_data]);
+        REQUIRE(std::equal(data.begin(), data.end(), from_file.payload().begin() + payload_start));
+        REQUIRE(from_file.addresses()[first_data] == 0x1000);
+
+        from_file.clear();
+        REQUIRE(from_file.empty());
+    }
+}
+
+TEST_CASE("Asynchronous stream conversion", "[async]") {
+    using tierone::srec::SrecFile;
+    using tierone::srec::SrecStreamConverter;
+
+    std::mt19937 gen(19);
+    std::uniform_int_distribution<> dis(0, 255);
+    std::string data(40000, '\0');
+    for (auto &byte : data) {
+        byte = static_cast<char>(dis(gen));
+    }
+
+    auto read_file = [](const std::string &name) {
+        std::ifstream in(name, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+
+    SECTION("Output and progress match convert_stream") {
+        const std::string sync_file = "test_sync.srec";
+        const std::string async_file = "test_async.srec";
+        for (const auto size : {SrecFile::AddressSize::BITS16, SrecFile::AddressSize::BITS32}) {
+            for (const size_t buffer_size : {size_t{100}, size_t{1000}, size_t{65536}}) {
+                for (const bool checksum : {false, true}) {
+                    std::vector<size_t> sync_progress;
+                    std::vector<size_t> async_progress;
+                    std::istringstream sync_input(data);
+                    SrecStreamConverter::convert_stream(sync_input, sync_file, size, 0x100, checksum,
+                        [&](size_t done, size_t total) {
+                            REQUIRE(total == data.size());
+                            sync_progress.push_back(done);
+                            return true;
+                        }, buffer_size);
+                    std::istringstream async_input(data);
+                    SrecStreamConverter::convert_stream_async(async_input, async_file, size, 0x100, checksum,
+                        [&](size_t done, size_t) {
+                            async_progress.push_back(done);
+                            return true;
+                        }, buffer_size, 2);
+                    REQUIRE(read_file(async_file) == read_file(sync_file));
+                    REQUIRE(async_progress == sync_progress);
+                }
+            }
+        }
+        std::remove(sync_file.c_str());
+        std::remove(async_file.c_str());
+    }
+
+    SECTION("Cancellation stops at the same record") {
+        const std::string async_file = "test_async_cancel.srec";
+        std::istringstream input(data);
+        size_t calls = 0;
+        try {
+            SrecStreamConverter::convert_stream_async(input, async_file, SrecFile::AddressSize::BITS32, 0, false,
+                [&](size_t done, size_t) {
+                    ++calls;
+                    return done < 10000;
+                }, 1000);
+            FAIL("Expected the conversion to be cancelled");
+        } catch (const tierone::srec::SrecValidationException &e) {
+            REQUIRE(e.getErrorType() == tierone::srec::SrecValidationException::ValidationError::USER_CANCELLED);
+        }
+        REQUIRE(calls == 10000 / 245 + 1);
+        std::remove(async_file.c_str());
+    }
+
+    SECTION("SrecAsyncSink writes and patches in order") {
+        auto memory = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *target = memory.get();
+        tierone::srec::SrecAsyncSink sink(std::move(memory), 16);
+        for (int i = 0; i < 100; ++i) {
+            const std::string line = "line " + std::to_string(i) + "\n";
+            sink.write(line.data(), line.size());
+        }
+        REQUIRE(sink.can_patch());
+        sink.patch(0, "LINE", 4);
+        sink.flush();
+        std::string expected;
+        for (int i = 0; i < 100; ++i) {
+            expected += "line " + std::to_string(i) + "\n";
+        }
+        expected.replace(0, 4, "LINE");
+        REQUIRE(target->str() == expected);
+        sink.patch(expected.size() - 3, "99!", 3);
+        REQUIRE(target->str().substr(expected.size() - 3) == "99!");
+        sink.close();
+        REQUIRE_FALSE(sink.is_open());
+    }
+}
+
+TEST_CASE("SrecLimits", "[limits]") {
+    using tierone::srec::SrecFile;
+    using tierone::srec::SrecLimits;
+    using tierone::srec::SrecValidationException;
+
+    const std::vector<uint8_t> data(245 * 4, 0x5A);
+    auto is_too_large = [](const SrecValidationException &e) {
+        return e.getErrorType() == SrecValidationException::ValidationError::DATA_TOO_LARGE;
+    };
+
+    SECTION("Presets") {
+        REQUIRE(SrecLimits().max_records == 1000000);
+        REQUIRE(SrecLimits::safe().max_file_size == UINT64_MAX);
+        REQUIRE(SrecLimits::strict().max_records == SrecLimits::safe().max_records);
+        REQUIRE(SrecLimits::strict().max_file_size == 100 * 1024 * 1024);
+        REQUIRE(SrecLimits::large().max_records == 0xFFFFFF);
+        REQUIRE(SrecLimits::large().max_file_size == UINT64_MAX);
+        REQUIRE(SrecLimits::unlimited().max_records == UINT64_MAX);
+        auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+        SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32);
+        REQUIRE(sfile.limits().max_records == SrecLimits::safe().max_records);
+    }
+
+    SECTION("Record count limit") {
+        auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *memory = sink.get();
+        SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32, 0,
+                       tierone::srec::FlushPolicy::ON_CLOSE, SrecLimits{4, UINT64_MAX});
+        sfile.write_data(data.data(), 245 * 3);
+        sfile.write_record_payload(data.data(), 10);
+        const std::string written = memory->str();
+        try {
+            sfile.write_record_payload(data.data(), 1);
+            FAIL("Expected the record limit to be enforced");
+        } catch (const SrecValidationException &e) {
+            REQUIRE(is_too_large(e));
+        }
+        REQUIRE_THROWS_AS(sfile.write_data(data.data(), 1), SrecValidationException);
+        REQUIRE(memory->str() == written);
+
+        // A larger limit lets the same file grow
+        sfile.set_limits(SrecLimits::large());
+        sfile.write_data(data.data(), data.size());
+        REQUIRE(memory->str().size() > written.size());
+    }
+
+    SECTION("File size limit is checked before writing") {
+        // Four full S3 records of 15 + 2 * 245 characters each
+        const uint64_t exact = 4 * (15 + (2 * 245));
+        {
+            auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+            auto *memory = sink.get();
+            SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32, 0,
+                           tierone::srec::FlushPolicy::ON_CLOSE, SrecLimits{UINT64_MAX, exact});
+            sfile.write_data(data.data(), data.size());
+            REQUIRE(memory->str().size() == exact);
+            REQUIRE_THROWS_AS(sfile.write_record_payload(data.data(), 1), SrecValidationException);
+        }
+        {
+            auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+            auto *memory = sink.get();
+            SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32, 0,
+                           tierone::srec::FlushPolicy::ON_CLOSE, SrecLimits{UINT64_MAX, exact - 1});
+            REQUIRE_THROWS_AS(sfile.write_data(data.data(), data.size()), SrecValidationException);
+            const tierone::srec::SrecSegment segments[] = {{0x1000, data.data(), 245 * 2},
+                                                           {0x8000, data.data(), 245 * 2}};
+            REQUIRE_THROWS_AS(sfile.write_segments(segments, 2), SrecValidationException);
+            REQUIRE(memory->str().empty());
+        }
+    }
+
+    SECTION("Converter passes the limits on") {
+        const std::string file = "test_limits.srec";
+        std::istringstream input(std::string(data.begin(), data.end()));
+        REQUIRE_THROWS_AS(tierone::srec::SrecStreamConverter::convert_stream(input, file,
+                              SrecFile::AddressSize::BITS32, 0, false, nullptr, 65536, SrecLimits{3, UINT64_MAX}),
+                          SrecValidationException);
+        std::istringstream again(std::string(data.begin(), data.end()));
+        tierone::srec::SrecStreamConverter::convert_stream_async(again, file, SrecFile::AddressSize::BITS32, 0,
+                                                                 false, nullptr, 65536, 3, SrecLimits{4, UINT64_MAX});
+        std::remove(file.c_str());
+    }
+
+    SECTION("Readers enforce limits") {
+        std::string text;
+        {
+            auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+            auto *memory = sink.get();
+            SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32);
+            sfile.write_header(std::vector<std::string>{"limits"});
+            sfile.write_data(data.data(), data.size());
+            sfile.write_record_count();
+            sfile.write_record_termination();
+            text = memory->str();
+        }
+
+        // Parsing is unlimited unless asked
+        size_t records = 0;
+        std::istringstream input(text);
+        tierone::srec::SrecStreamParser::parse_stream(input, [&](const auto &) { return ++records, true; });
+        REQUIRE(records == 7);
+
+        std::istringstream counted(text);
+        tierone::srec::SrecReader reader(counted, true, 100, SrecLimits{3, UINT64_MAX});
+        tierone::srec::SrecReader::ParsedRecordView view{};
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(reader.next(view));
+        }
+        try {
+            reader.next(view);
+            FAIL("Expected the record limit to be enforced");
+        } catch (const SrecValidationException &e) {
+            REQUIRE(is_too_large(e));
+            REQUIRE(std::string(e.what()).find("line 5") != std::string::npos);
+        }
+
+        std::istringstream sized(text);
+        REQUIRE_THROWS_AS(tierone::srec::SrecStreamParser::parse_stream(sized, [](const auto &) { return true; },
+                              true, SrecLimits{UINT64_MAX, text.size() - 1}),
+                          SrecValidationException);
+
+        std::istringstream unterminated(std::string(1000, 'S'));
+        tierone::srec::SrecReader long_line(unterminated, true, 16, SrecLimits{UINT64_MAX, 100});
+        REQUIRE_THROWS_AS(long_line.next(view), SrecValidationException);
+
+        tierone::srec::SrecMappedReader mapped(text.data(), text.size());
+        REQUIRE_THROWS_AS(mapped.set_limits(SrecLimits{UINT64_MAX, 10}), SrecValidationException);
+    }
+}
+
+TEST_CASE("SrecStats", "[stats]") {
+    using tierone::srec::Srec;
+    using tierone::srec::SrecFile;
+    using tierone::srec::SrecStats;
+
+    if (!SrecStats::ENABLED) {
+        SUCCEED("Instrumentation is compiled out");
+        return;
+    }
+
+    std::mt19937 gen(21);
+    std::uniform_int_distribution<> dis(0, 255);
+    std::string data(20000, '\0');
+    for (auto &byte : data) {
+        byte = static_cast<char>(dis(gen));
+    }
+    const std::string file = "test_stats.srec";
+
+    SECTION("Converter and parser agree on the file") {
+        SrecStats written;
+        std::istringstream input(data);
+        tierone::srec::SrecStreamConverter::convert_stream(input, file, SrecFile::AddressSize::BITS24, 0, true,
+                                                           nullptr, 65536, tierone::srec::SrecLimits(), &written);
+        std::ifstream in(file, std::ios::binary);
+        const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        REQUIRE(written.bytes_in == data.size());
+        REQUIRE(written.bytes_out == text.size());
+        const uint64_t data_records = (data.size() + 246) / 247;
+        REQUIRE(written.records[static_cast<size_t>(Srec::Type::S2)] == data_records);
+        REQUIRE(written.records[static_cast<size_t>(Srec::Type::S0)] == 1);
+        REQUIRE(written.records[static_cast<size_t>(Srec::Type::S8)] == 1);
+        REQUIRE(written.total_records() == data_records + 3);
+        REQUIRE(written.peak_buffer_bytes > 0);
+        REQUIRE(written.time(SrecStats::Phase::FORMAT).count() > 0);
+        REQUIRE(written.time(SrecStats::Phase::CHECKSUM).count() > 0);
+
+        SrecStats parsed;
+        std::istringstream srec(text);
+        tierone::srec::SrecStreamParser::parse_stream(srec, [](const auto &) { return true; }, true,
+                                                      tierone::srec::SrecLimits::unlimited(), &parsed);
+        REQUIRE(parsed.bytes_in == text.size());
+        REQUIRE(parsed.records == written.records);
+        REQUIRE(parsed.time(SrecStats::Phase::DECODE).count() > 0);
+
+        SrecStats verified;
+        tierone::srec::SrecParallelVerifier::Options options;
+        options.threads = 2;
+        options.chunk_size = 1024;
+        options.stats = &verified;
+        REQUIRE(tierone::srec::SrecParallelVerifier::verify_file(file, options).crc_matches());
+        REQUIRE(verified.bytes_in == text.size());
+        REQUIRE(verified.records == written.records);
+
+        parsed.merge(verified);
+        REQUIRE(parsed.bytes_in == 2 * text.size());
+        std::ostringstream report;
+        parsed.print(report);
+        REQUIRE(report.str().find("S2 " + std::to_string(2 * data_records)) != std::string::npos);
+        REQUIRE(report.str().find("decode:") != std::string::npos);
+        parsed.reset();
+        REQUIRE(parsed.total_records() == 0);
+        std::remove(file.c_str());
+    }
+
+    SECTION("SrecFile counts batched and single records") {
+        SrecStats stats;
+        auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *memory = sink.get();
+        SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS16);
+        sfile.set_stats(&stats);
+        REQUIRE(sfile.stats() == &stats);
+        const auto *bytes = reinterpret_cast<const uint8_t *>(data.data());
+        sfile.write_data(bytes, 1000);
+        sfile.write_record_payload(bytes, 10);
+        sfile.write_record_termination();
+        REQUIRE(stats.records[static_cast<size_t>(Srec::Type::S1)] == (1000 + 248) / 249 + 1);
+        REQUIRE(stats.records[static_cast<size_t>(Srec::Type::S9)] == 1);
+        REQUIRE(stats.bytes_out == memory->str().size());
+
+        // Detached statistics and null timers record nothing
+        sfile.set_stats(nullptr);
+        sfile.write_data(bytes, 1000);
+        REQUIRE(stats.bytes_out < memory->str().size());
+        {
+            tierone::srec::SrecStatsTimer timer(nullptr, SrecStats::Phase::READ);
+        }
+    }
+}
+
+TEST_CASE("SrecMerger", "[merge]") {
+    using tierone::srec::SrecFile;
+    using tierone::srec::SrecMerger;
+    using tierone::srec::SrecOverlapPolicy;
+
+    // Build an S3 file from (address, length, byte value) ranges
+    auto make_srec = [](const std::vector<std::array<uint32_t, 3>> &ranges, uint32_t entry) {
+        auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *memory = sink.get();
+        SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32, entry);
+        sfile.write_header(std::vector<std::string>{"merge"});
+        for (const auto &range : ranges) {
+            const std::vector<uint8_t> bytes(range[1], static_cast<uint8_t>(range[2]));
+            const tierone::srec::SrecSegment segment{range[0], bytes.data(), bytes.size()};
+            sfile.write_segments(&segment, 1);
+        }
+        sfile.write_record_count();
+        sfile.write_record_termination();
+        return memory->str();
+    };
+    auto merge = [](const std::vector<std::string> &inputs, SrecOverlapPolicy policy, std::string &text) {
+        SrecMerger merger({policy});
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            merger.add_buffer(inputs[i].data(), inputs[i].size(), "input" + std::to_string(i));
+        }
+        auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *memory = sink.get();
+        SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32);
+        const auto result = merger.write(sfile);
+        sfile.write_record_termination();
+        text = memory->str();
+        return result;
+    };
+    auto image_of = [](const std::string &text) {
+        tierone::srec::SrecMemoryImage image;
+        std::istringstream input(text);
+        image.load(input);
+        return image;
+    };
+
+    const std::string boot = make_srec({{0x0000, 1000, 0xB0}, {0x2000, 100, 0xB1}}, 0x100);
+    const std::string app = make_srec({{0x1000, 3000, 0xA0}}, 0x1000);
+    const std::string cal = make_srec({{0x1100, 16, 0xC0}, {0x3000, 500, 0xC1}}, 0);
+
+    SECTION("Disjoint inputs are interleaved in address order") {
+        std::string text;
+        const auto result = merge({boot, make_srec({{0x1000, 100, 0xA0}, {0x5000, 10, 0xA1}}, 0x1000)},
+                                  SrecOverlapPolicy::ERROR, text);
+        REQUIRE(result.output_bytes == 1210);
+        REQUIRE(result.overlap_bytes() == 0);
+        REQUIRE(result.segments == 4);
+        REQUIRE(result.entry_point == 0x100u);
+        const auto image = image_of(text);
+        REQUIRE(image.segments().size() == 4);
+        REQUIRE(image.execution_address() == 0x100u);
+        REQUIRE(image.data_size() == 1210);
+    }
+
+    SECTION("Error policy reports the overlap") {
+        std::string text;
+        try {
+            merge({boot, app, cal}, SrecOverlapPolicy::ERROR, text);
+            FAIL("Expected an overlap error");
+        } catch (const tierone::srec::SrecValidationException &e) {
+            REQUIRE(e.getErrorType() == tierone::srec::SrecValidationException::ValidationError::INVALID_ADDRESS);
+            REQUIRE(std::string(e.what()).find("0x00001100 between input1, input2") != std::string::npos);
+        }
+    }
+
+    SECTION("First and last wins match an in-memory overlay") {
+        for (const auto policy : {SrecOverlapPolicy::FIRST_WINS, SrecOverlapPolicy::LAST_WINS}) {
+            std::vector<std::string> inputs = {boot, app, cal};
+            std::string text;
+            const auto result = merge(inputs, policy, text);
+
+            // Overlaying in reverse priority order gives the expected image
+            if (policy == SrecOverlapPolicy::FIRST_WINS) {
+                std::reverse(inputs.begin(), inputs.end());
+            }
+            tierone::srec::SrecMemoryImage expected;
+            for (const auto &input : inputs) {
+                std::istringstream stream(input);
+                expected.load(stream);
+            }
+            const auto merged = image_of(text);
+            REQUIRE(merged.to_binary() == expected.to_binary());
+            REQUIRE(merged.start_address() == expected.start_address());
+            REQUIRE(result.output_bytes == expected.data_size());
+            REQUIRE(result.input_bytes == 1000 + 100 + 3000 + 16 + 500);
+            REQUIRE(result.entry_point == (policy == SrecOverlapPolicy::FIRST_WINS ? 0x100u : 0u));
+        }
+    }
+
+    SECTION("Output records match writing the image directly") {
+        std::string text;
+        merge({boot, app}, SrecOverlapPolicy::LAST_WINS, text);
+        tierone::srec::SrecMemoryImage expected;
+        for (const auto &input : {boot, app}) {
+            std::istringstream stream(input);
+            expected.load(stream);
+        }
+        auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *memory = sink.get();
+        SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32, 0x1000);
+        std::vector<tierone::srec::SrecSegment> segments;
+        for (const auto &[address, bytes] : expected.segments()) {
+            segments.push_back({address, bytes.data(), bytes.size()});
+        }
+        sfile.write_segments(segments.data(), segments.size());
+        sfile.write_record_termination();
+        REQUIRE(text == memory->str());
+    }
+
+    SECTION("Many small segments") {
+        std::vector<std::array<uint32_t, 3>> even;
+        std::vector<std::array<uint32_t, 3>> odd;
+        for (uint32_t i = 0; i < 20000; ++i) {
+            ((i % 2) ? odd : even).push_back({i * 16, 12, i % 2});
+        }
+        std::string text;
+        const auto result = merge({make_srec(even, 0), make_srec(odd, 0)}, SrecOverlapPolicy::ERROR, text);
+        REQUIRE(result.segments == 20000);
+        REQUIRE(result.input_records == 20000);
+        REQUIRE(image_of(text).data_size() == 20000 * 12);
+    }
+
+    SECTION("Unordered input and files") {
+        const std::string unordered = make_srec({{0x2000, 10, 1}, {0x1000, 10, 2}}, 0);
+        std::string text;
+        REQUIRE_THROWS_AS(merge({unordered}, SrecOverlapPolicy::LAST_WINS, text),
+                          tierone::srec::SrecValidationException);
+
+        const std::vector<std::string> files = {"test_merge_a.srec", "test_merge_b.srec"};
+        for (size_t i = 0; i < files.size(); ++i) {
+            std::ofstream(files[i], std::ios::binary) << (i == 0 ? boot : app);
+        }
+        const std::string output = "test_merge_out.srec";
+        tierone::srec::SrecMergeOptions options;
+        options.overlap = SrecOverlapPolicy::LAST_WINS;
+        SrecMerger::merge_files(files, output, SrecFile::AddressSize::BITS24, options);
+        tierone::srec::SrecMemoryImage image;
+        image.load_file(output);
+        REQUIRE(image.execution_address() == 0x1000u);
+        REQUIRE(*image.find(0x0000, 1) == 0xB0);
+        REQUIRE(*image.find(0x2000, 1) == 0xB1);
+        for (const auto &file : files) {
+            std::remove(file.c_str());
+        }
+        std::remove(output.c_str());
+    }
+}
+
+TEST_CASE("SrecIncrementalConverter", "[incremental]") {
+    using tierone::srec::SrecFile;
+    using tierone::srec::SrecIncrementalConverter;
+
+    const std::string old_bin = "test_incremental_old.bin";
+    const std::string old_srec = "test_incremental_old.srec";
+    const std::string new_bin = "test_incremental_new.bin";
+    const std::string new_srec = "test_incremental_new.srec";
+    const std::string full_srec = "test_incremental_full.srec";
+
+    auto write_bytes = [](const std::string &name, const std::vector<uint8_t> &bytes) {
+        std::ofstream file(name, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    };
+    auto read_text = [](const std::string &name) {
+        std::ifstream file(name, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    auto full_conversion = [](const std::string &input, const std::string &output, SrecFile::AddressSize size,
+                              bool checksum) {
+        std::ifstream in(input, std::ios::binary);
+        SrecFile sf(output, size, 0x1000);
+        tierone::srec::convert_bin_to_srec(in, sf, checksum);
+        sf.close();
+    };
+
+    std::mt19937 rng(23);
+    std::vector<uint8_t> base(100000);
+    for (auto &byte : base) {
+        byte = static_cast<uint8_t>(rng());
+    }
+
+    SrecIncrementalConverter::Options options;
+    options.start_address = 0x1000;
+    options.block_records = 16;
+
+    for (const bool checksum : {false, true}) {
+        for (const auto size : {SrecFile::AddressSize::BITS24, SrecFile::AddressSize::BITS32}) {
+            options.want_checksum = checksum;
+            options.address_size = size;
+            write_bytes(old_bin, base);
+            full_conversion(old_bin, old_srec, size, checksum);
+
+            SECTION("Patched input reuses all other blocks " + std::to_string(checksum) +
+                    std::to_string(static_cast<int>(size))) {
+                std::vector<uint8_t> patched = base;
+                patched[50000] ^= 0xFF;
+                patched[99999] ^= 0x01;
+                write_bytes(new_bin, patched);
+                const auto result = SrecIncrementalConverter::convert(new_bin, old_bin, old_srec, new_srec, options);
+                full_conversion(new_bin, full_srec, size, checksum);
+                REQUIRE(read_text(new_srec) == read_text(full_srec));
+                REQUIRE(result.incremental);
+                REQUIRE(result.crc_updated == checksum);
+                REQUIRE(result.reused_blocks == result.blocks - 2);
+                if (checksum) {
+                    REQUIRE(result.crc == tierone::srec::xcrc32(patched.data(), static_cast<unsigned long>(patched.size()), 0));
+                }
+            }
+
+            SECTION("Grown and shrunk inputs " + std::to_string(checksum) + std::to_string(static_cast<int>(size))) {
+                for (const size_t length : {size_t{120000}, size_t{60001}, size_t{0}}) {
+                    std::vector<uint8_t> resized(base.begin(), base.begin() + static_cast<std::ptrdiff_t>(std::min(length, base.size())));
+                    resized.resize(length, 0x5A);
+                    write_bytes(new_bin, resized);
+                    const auto result = SrecIncrementalConverter::convert(new_bin, old_bin, old_srec, new_srec, options);
+                    full_conversion(new_bin, full_srec, size, checksum);
+                    REQUIRE(read_text(new_srec) == read_text(full_srec));
+                    REQUIRE(result.incremental);
+                    REQUIRE_FALSE(result.crc_updated);
+                    if (length > 0) {
+                        REQUIRE(result.reused_blocks > 0);
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("Unusable previous output falls back to a full conversion") {
+        options.want_checksum = true;
+        options.address_size = SrecFile::AddressSize::BITS32;
+        write_bytes(old_bin, base);
+        write_bytes(new_bin, base);
+        full_conversion(old_bin, old_srec, SrecFile::AddressSize::BITS24, true);
+        auto result = SrecIncrementalConverter::convert(new_bin, old_bin, old_srec, new_srec, options);
+        full_conversion(new_bin, full_srec, SrecFile::AddressSize::BITS32, true);
+        REQUIRE(read_text(new_srec) == read_text(full_srec));
+        REQUIRE_FALSE(result.incremental);
+        REQUIRE(result.reused_blocks == 0);
+
+        result = SrecIncrementalConverter::convert(new_bin, "test_incremental_missing.bin", old_srec, new_srec, options);
+        REQUIRE(read_text(new_srec) == read_text(full_srec));
+        REQUIRE_FALSE(result.incremental);
+
+        // Same layout but other records, e.g. another start address: spot checks reject every block
+        options.start_address = 0x2000;
+        full_conversion(old_bin, old_srec, SrecFile::AddressSize::BITS32, true);
+        result = SrecIncrementalConverter::convert(new_bin, old_bin, old_srec, new_srec, options);
+        REQUIRE(result.incremental);
+        REQUIRE(result.reused_blocks == 0);
+        REQUIRE(result.crc == tierone::srec::xcrc32(base.data(), static_cast<unsigned long>(base.size()), 0));
+    }
+
+    SECTION("Output may not overwrite the previous output") {
+        write_bytes(new_bin, base);
+        REQUIRE_THROWS_AS(SrecIncrementalConverter::convert(new_bin, old_bin, old_srec, old_srec, options),
+                          tierone::srec::SrecFileException);
+    }
+
+    for (const auto &file : {old_bin, old_srec, new_bin, new_srec, full_srec}) {
+        std::remove(file.c_str());
+    }
+}
+
+TEST_CASE("SrecBinaryConverter", "[binary]") {
+    using tierone::srec::SrecBinaryConverter;
+    using tierone::srec::SrecFile;
+    using tierone::srec::SrecMemoryImage;
+
+    const std::string srec_file = "test_binary.srec";
+    const std::string bin_file = "test_binary.bin";
+    const std::string expected_file = "test_binary_expected.bin";
+
+    auto read_bytes = [](const std::string &name) {
+        std::ifstream file(name, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    auto write_srec = [&srec_file](const std::vector<std::pair<uint32_t, std::vector<uint8_t>>> &segments) {
+        auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *memory = sink.get();
+        SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32);
+        sfile.write_header(std::vector<std::string>{"binary"});
+        for (const auto &[address, bytes] : segments) {
+            const tierone::srec::SrecSegment segment{address, bytes.data(), bytes.size()};
+            sfile.write_segments(&segment, 1);
+        }
+        sfile.write_record_count();
+        sfile.write_record_termination();
+        std::ofstream(srec_file, std::ios::binary) << memory->str();
+    };
+
+    std::mt19937 rng(24);
+    auto random_bytes = [&rng](size_t length) {
+        std::vector<uint8_t> bytes(length);
+        for (auto &byte : bytes) {
+            byte = static_cast<uint8_t>(rng());
+        }
+        return bytes;
+    };
+
+    SECTION("Output matches the in-memory image for unordered and overlapping records") {
+        write_srec({{0x20000, random_bytes(5000)}, {0x1000, random_bytes(3000)}, {0x1800, random_bytes(100)},
+                    {0x200000, random_bytes(10)}, {0x1F000, random_bytes(4200)}});
+        for (const uint8_t fill : {uint8_t{0x00}, uint8_t{0xFF}}) {
+            SrecMemoryImage image;
+            image.set_fill_byte(fill);
+            image.load_file(srec_file);
+            image.write_binary_file(expected_file);
+
+            SrecBinaryConverter::Options options;
+            options.fill_byte = fill;
+            const auto result = SrecBinaryConverter::convert(srec_file, bin_file, options);
+            REQUIRE(read_bytes(bin_file) == read_bytes(expected_file));
+            REQUIRE(result.start_address == 0x1000);
+            REQUIRE(result.size == 0x20000A - 0x1000);
+            REQUIRE(result.data_bytes == image.data_size());
+            REQUIRE_FALSE(result.indexed);
+            if (fill == 0) {
+                REQUIRE(result.hole_bytes == 0x200000 - (0x20000 + 5000) + (0x1F000 - 0x1000 - 3000));
+            } else {
+                REQUIRE(result.hole_bytes == 0);
+            }
+        }
+    }
+
+    SECTION("Large gaps stay holes") {
+        const auto head = random_bytes(1000);
+        const auto tail = random_bytes(1000);
+        write_srec({{0x0, head}, {0x10000000, tail}});
+        const auto result = SrecBinaryConverter::convert(srec_file, bin_file);
+        REQUIRE(std::filesystem::file_size(bin_file) == 0x10000000 + 1000);
+        REQUIRE(result.hole_bytes == 0x10000000 - 1000);
+        std::ifstream binary(bin_file, std::ios::binary);
+        std::vector<uint8_t> bytes(1000);
+        binary.seekg(0x10000000);
+        binary.read(reinterpret_cast<char *>(bytes.data()), 1000);
+        REQUIRE(bytes == tail);
+        binary.seekg(0x8000000);
+        binary.read(reinterpret_cast<char *>(bytes.data()), 1000);
+        REQUIRE(std::all_of(bytes.begin(), bytes.end(), [](uint8_t byte) { return byte == 0; }));
+    }
+
+    SECTION("Extent is taken from a current side-car index") {
+        write_srec({{0x4000, random_bytes(2000)}, {0x100, random_bytes(700)}});
+        tierone::srec::SrecIndex::build(srec_file).save(tierone::srec::SrecIndex::sidecar_path(srec_file));
+        const auto result = SrecBinaryConverter::convert(srec_file, bin_file);
+        REQUIRE(result.indexed);
+        tierone::srec::convert_srec_to_bin(srec_file, expected_file);
+        SrecMemoryImage image;
+        image.load_file(srec_file);
+        REQUIRE(read_bytes(bin_file) == image.to_binary());
+        std::remove(tierone::srec::SrecIndex::sidecar_path(srec_file).c_str());
+    }
+
+    SECTION("Failed conversion removes the output") {
+        std::ofstream(srec_file, std::ios::binary) << "S1061000010203E3\nS1061003040506FF\n";
+        REQUIRE_THROWS_AS(SrecBinaryConverter::convert(srec_file, bin_file), tierone::srec::SrecValidationException);
+        REQUIRE_FALSE(std::filesystem::exists(bin_file));
+    }
+
+    SECTION("Files without data give an empty output") {
+        std::ofstream(srec_file, std::ios::binary) << "S0030000FC\nS9031000EC\n";
+        const auto result = SrecBinaryConverter::convert(srec_file, bin_file);
+        REQUIRE(result.size == 0);
+        REQUIRE(std::filesystem::file_size(bin_file) == 0);
+    }
+
+    for (const auto &file : {srec_file, bin_file, expected_file}) {
+        std::remove(file.c_str());
+    }
+}
+
+TEST_CASE("SrecMetadataScanner", "[metadata]") {
+    using tierone::srec::Srec;
+    using tierone::srec::SrecFile;
+    using tierone::srec::SrecMetadataScanner;
+
+    SECTION("Record fields are read without the payload") {
+        tierone::srec::SrecRecordFields fields;
+        REQUIRE(tierone::srec::peek_record_fields("S2080123450102ZZZZ", fields));
+        REQUIRE(fields.type == Srec::Type::S2);
+        REQUIRE(fields.address == 0x012345);
+        REQUIRE(fields.length == 4);
+        REQUIRE(tierone::srec::peek_record_fields("S5030003F9", fields));
+        REQUIRE(fields.type == Srec::Type::S5);
+        REQUIRE(fields.address == 3);
+        REQUIRE_FALSE(tierone::srec::peek_record_fields("S4030003F9", fields));
+        REQUIRE_FALSE(tierone::srec::peek_record_fields("S1020000", fields));
+        REQUIRE_FALSE(tierone::srec::peek_record_fields("S1G30000", fields));
+    }
+
+    // A checksummed file as bin2srec writes it, plus a gap and an out-of-order record
+    std::vector<uint8_t> data(20000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+    auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+    auto *memory = sink.get();
+    SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32, 0x8000);
+    sfile.write_header(std::vector<uint8_t>{0x12, 0x34, 0x56, 0x78, 0x00});
+    sfile.write_data(data.data(), data.size());
+    const tierone::srec::SrecSegment high{0x100000, data.data(), 100};
+    const tierone::srec::SrecSegment low{0x1000, data.data(), 10};
+    sfile.write_segments(&high, 1);
+    sfile.write_segments(&low, 1);
+    sfile.set_execution_address(0x8004);
+    sfile.write_record_count();
+    sfile.write_record_termination();
+    const std::string text = memory->str();
+
+    SECTION("Full scan") {
+        const auto info = SrecMetadataScanner::scan(text.data(), text.size());
+        REQUIRE(info.crc == 0x12345678u);
+        REQUIRE(info.record_count == 84u);
+        REQUIRE(info.entry_point == 0x8004u);
+        REQUIRE(info.data_type == Srec::Type::S3);
+        REQUIRE(info.start_address == 0x1000);
+        REQUIRE(info.end_address == 0x100000 + 100);
+        REQUIRE(info.data_records == 84);
+        REQUIRE(info.data_bytes == 20110);
+        REQUIRE(info.scanned);
+    }
+
+    SECTION("Head and tail only") {
+        SrecMetadataScanner::Options options;
+        options.scan_data = false;
+        const auto info = SrecMetadataScanner::scan(text.data(), text.size(), options);
+        REQUIRE(info.crc == 0x12345678u);
+        REQUIRE(info.record_count == 84u);
+        REQUIRE(info.entry_point == 0x8004u);
+        REQUIRE_FALSE(info.scanned);
+        REQUIRE(info.data_records == 0);
+        // Range of the first record and of the tail's records
+        REQUIRE(info.start_address == 0x1000);
+        REQUIRE(info.end_address == 0x100000 + 100);
+
+        options.tail_bytes = text.size() * 2;
+        REQUIRE(SrecMetadataScanner::scan(text.data(), text.size(), options).scanned);
+    }
+
+    SECTION("Header text and invalid records") {
+        const std::string named = "S00F000068656C6C6F202020202000003C\nS1051000AABB00\n";
+        auto info = SrecMetadataScanner::scan(named.data(), named.size());
+        REQUIRE(info.header_text() == "hello     ");
+        REQUIRE_FALSE(info.crc);
+        REQUIRE(info.data_bytes == 2);
+        REQUIRE_FALSE(info.record_count);
+
+        const std::string broken = "S1051000AABB00\nXYZ\n";
+        REQUIRE_THROWS_AS(SrecMetadataScanner::scan(broken.data(), broken.size()), tierone::srec::SrecParseException);
+    }
+}
+
+TEST_CASE("Compressed S-record files", "[compress]") {
+    using tierone::srec::SrecCompressedSink;
+    using tierone::srec::SrecCompression;
+    using tierone::srec::SrecDecompressStream;
+    using tierone::srec::SrecFile;
+
+    const std::string plain_file = "test_compress.srec";
+    const std::string gz_file = "test_compress.srec.gz";
+
+    std::vector<uint8_t> data(300000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>((i * 13) ^ (i >> 9));
+    }
+    auto write_srec = [&data](SrecFile &sfile) {
+        sfile.write_header(std::vector<std::string>{"compress"});
+        sfile.write_data(data.data(), data.size());
+        sfile.write_record_count();
+        sfile.write_record_termination();
+        sfile.close();
+    };
+    std::string text;
+    {
+        auto memory = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *text_sink = memory.get();
+        SrecFile sfile(std::move(memory), SrecFile::AddressSize::BITS32, 0x1000);
+        write_srec(sfile);
+        text = text_sink->str();
+    }
+    std::ofstream(plain_file, std::ios::binary) << text;
+
+    REQUIRE(tierone::srec::compression_for_filename(gz_file) == SrecCompression::GZIP);
+    REQUIRE(tierone::srec::compression_for_filename("image.s19.zst") == SrecCompression::ZSTD);
+    REQUIRE(tierone::srec::compression_for_filename(plain_file) == SrecCompression::NONE);
+
+    SECTION("Plain files pass through") {
+        REQUIRE(tierone::srec::detect_compression(plain_file) == SrecCompression::NONE);
+        SrecDecompressStream input(plain_file, 1000, 2);
+        REQUIRE(input.format() == SrecCompression::NONE);
+        REQUIRE(SrecDecompressStream::read_file(plain_file) == text);
+    }
+
+    if (tierone::srec::compression_supported(SrecCompression::ZSTD)) {
+        const std::string zst_file = "test_compress.srec.zst";
+        {
+            SrecFile sfile(tierone::srec::open_output_sink(zst_file), SrecFile::AddressSize::BITS32, 0x1000);
+            write_srec(sfile);
+        }
+        REQUIRE(tierone::srec::detect_compression(zst_file) == SrecCompression::ZSTD);
+        REQUIRE(SrecDecompressStream::read_file(zst_file) == text);
+        std::filesystem::resize_file(zst_file, std::filesystem::file_size(zst_file) - 10);
+        REQUIRE_THROWS_AS(SrecDecompressStream::read_file(zst_file), tierone::srec::SrecFileException);
+        std::filesystem::remove(zst_file);
+    }
+
+    if (!tierone::srec::compression_supported(SrecCompression::GZIP)) {
+        REQUIRE_THROWS_AS(tierone::srec::open_output_sink(gz_file), tierone::srec::SrecFileException);
+        std::filesystem::remove(plain_file);
+        return;
+    }
+
+    {
+        SrecFile sfile(tierone::srec::open_output_sink(gz_file), SrecFile::AddressSize::BITS32, 0x1000);
+        write_srec(sfile);
+    }
+    REQUIRE(tierone::srec::detect_compression(gz_file) == SrecCompression::GZIP);
+    REQUIRE(std::filesystem::file_size(gz_file) < text.size() / 2);
+
+    SECTION("Round trip") {
+        REQUIRE(SrecDecompressStream::read_file(gz_file) == text);
+
+        size_t bytes = 0;
+        tierone::srec::SrecStreamParser::parse_file(gz_file, [&bytes](const auto &record) {
+            bytes += record.type == tierone::srec::Srec::Type::S3 ? record.data.size() : 0;
+            return true;
+        });
+        REQUIRE(bytes == data.size());
+
+        REQUIRE(tierone::srec::SrecParallelVerifier::verify_file(gz_file).data_bytes == data.size());
+        REQUIRE(tierone::srec::SrecMetadataScanner::scan_file(gz_file).end_address == 0x1000 + data.size());
+
+        const std::string bin_file = "test_compress.bin";
+        const auto result = tierone::srec::SrecBinaryConverter::convert(gz_file, bin_file);
+        REQUIRE(result.size == data.size());
+        std::ifstream bin(bin_file, std::ios::binary);
+        REQUIRE(std::vector<uint8_t>(std::istreambuf_iterator<char>(bin), std::istreambuf_iterator<char>()) == data);
+        bin.close();
+        std::filesystem::remove(bin_file);
+    }
+
+    SECTION("Flushed and concatenated streams") {
+        auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *compressed = sink.get();
+        SrecCompressedSink gzip(std::move(sink), SrecCompression::GZIP, 1);
+        gzip.write(text.data(), 1000);
+        gzip.flush();
+        REQUIRE(gzip.compressed_bytes() > 0);
+        gzip.write(text.data() + 1000, text.size() - 1000);
+        gzip.close();
+
+        // Two gzip members read as one stream, as with gunzip
+        const std::string member = compressed->str();
+        std::ofstream(gz_file, std::ios::binary | std::ios::trunc) << member << member;
+        REQUIRE(SrecDecompressStream::read_file(gz_file) == text + text);
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    SECTION("Checksum of an input that cannot be seeked") {
+        // A pipe holding less than its buffer, so the writer never waits for the reader
+        const std::string fifo = "test_compress.fifo";
+        std::filesystem::remove(fifo);
+        REQUIRE(::mkfifo(fifo.c_str(), 0600) == 0);
+        std::thread writer([&fifo, &data] {
+            std::ofstream(fifo, std::ios::binary).write(reinterpret_cast<const char *>(data.data()), 4096);
+        });
+        std::ifstream input(fifo, std::ios::binary);
+        writer.join();
+
+        // The compressed output can neither be patched nor rewritten afterwards
+        SrecFile sfile(tierone::srec::open_output_sink(gz_file), SrecFile::AddressSize::BITS32);
+        REQUIRE_THROWS_AS(tierone::srec::convert_bin_to_srec(input, sfile, true), tierone::srec::SrecFileException);
+        REQUIRE_THROWS_AS(tierone::srec::write_checksum(sfile, 0), std::ios_base::failure);
+        REQUIRE_FALSE(std::filesystem::exists(".tmp"));
+        std::filesystem::remove(fifo);
+    }
+#endif
+
+    SECTION("Truncated data") {
+        std::filesystem::resize_file(gz_file, std::filesystem::file_size(gz_file) / 2);
+        REQUIRE_THROWS_AS(SrecDecompressStream::read_file(gz_file), tierone::srec::SrecFileException);
+        REQUIRE_THROWS_AS(tierone::srec::SrecParallelVerifier::verify_file(gz_file), tierone::srec::SrecFileException);
+    }
+
+    std::filesystem::remove(plain_file);
+    std::filesystem::remove(gz_file);
+}
+
+TEST_CASE("SrecBufferConverter", "[buffer]") {
+    using tierone::srec::SrecBufferConverter;
+    using tierone::srec::SrecFile;
+
+    std::vector<uint8_t> data(100000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>((i * 31) >> 3);
+    }
+
+    SECTION("Sizes are exact") {
+        for (const auto size : {SrecFile::AddressSize::BITS16, SrecFile::AddressSize::BITS24,
+                                SrecFile::AddressSize::BITS32}) {
+            for (const size_t length : {size_t{0}, size_t{1}, size_t{245}, size_t{249}, size_t{250}, size_t{65535}}) {
+                tierone::srec::SrecTextOptions options;
+                options.address_size = size;
+                options.want_checksum = (length % 2) == 0;
+                const std::string text = SrecBufferConverter::to_srec(data.data(), length, options);
+                REQUIRE(text.size() == SrecBufferConverter::srec_size(length, options));
+            }
+        }
+        // More than 0xFFFF records need an S6 count record
+        std::vector<uint8_t> large(size_t{0x10000} * 247);
+        tierone::srec::SrecTextOptions options;
+        options.address_size = SrecFile::AddressSize::BITS24;
+        options.limits = tierone::srec::SrecLimits::large();
+        const std::string text = SrecBufferConverter::to_srec(large.data(), large.size(), options);
+        REQUIRE(text.size() == SrecBufferConverter::srec_size(large.size(), options));
+        REQUIRE(text.find("\nS6") != std::string::npos);
+    }
+
+    SECTION("Same text as the file conversion") {
+        const std::string bin_file = "test_buffer.bin";
+        const std::string srec_file = "test_buffer.srec";
+        std::ofstream(bin_file, std::ios::binary).write(reinterpret_cast<const char *>(data.data()),
+                                                        static_cast<std::streamsize>(data.size()));
+        {
+            std::ifstream input(bin_file, std::ios::binary);
+            SrecFile sfile(srec_file, SrecFile::AddressSize::BITS24);
+            tierone::srec::convert_bin_to_srec(input, sfile, true);
+        }
+        std::ifstream file(srec_file, std::ios::binary);
+        const std::string expected((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+
+        tierone::srec::SrecTextOptions options;
+        options.address_size = SrecFile::AddressSize::BITS24;
+        options.want_checksum = true;
+        REQUIRE(SrecBufferConverter::to_srec(data.data(), data.size(), options) == expected);
+
+        std::vector<char> buffer(expected.size());
+        REQUIRE(SrecBufferConverter::to_srec(data.data(), data.size(), buffer.data(), buffer.size(), options) ==
+                expected.size());
+        REQUIRE(std::string(buffer.begin(), buffer.end()) == expected);
+        REQUIRE_THROWS_AS(SrecBufferConverter::to_srec(data.data(), data.size(), buffer.data(), buffer.size() - 1,
+                                                       options),
+                          tierone::srec::SrecFileException);
+
+        std::filesystem::remove(bin_file);
+        std::filesystem::remove(srec_file);
+    }
+
+    SECTION("Text to binary and image") {
+        tierone::srec::SrecTextOptions options;
+        options.start_address = 0x2000;
+        const std::string text = SrecBufferConverter::to_srec(data.data(), data.size(), options);
+
+        const auto extent = SrecBufferConverter::binary_extent(text.data(), text.size());
+        REQUIRE(extent.start_address == 0x2000);
+        REQUIRE(extent.size == data.size());
+        REQUIRE(SrecBufferConverter::to_binary(text.data(), text.size()) == data);
+
+        std::vector<uint8_t> small(10);
+        REQUIRE_THROWS_AS(SrecBufferConverter::to_binary(text.data(), text.size(), extent, small.data(), small.size()),
+                          tierone::srec::SrecFileException);
+
+        const auto image = SrecBufferConverter::to_image(text.data(), text.size());
+        REQUIRE(image.start_address() == 0x2000);
+        REQUIRE(image.data_size() == data.size());
+        REQUIRE(image.to_binary() == data);
+
+        // Gaps take the fill byte
+        const std::string gapped = "S1051000AABB85\nS1051004CCDD3D\n";
+        tierone::srec::SrecImageOptions fill;
+        fill.fill_byte = 0xFF;
+        REQUIRE(SrecBufferConverter::to_binary(gapped.data(), gapped.size(), fill) ==
+                std::vector<uint8_t>{0xAA, 0xBB, 0xFF, 0xFF, 0xCC, 0xDD});
+        REQUIRE(SrecBufferConverter::to_binary("", 0).empty());
+    }
+}
+
+TEST_CASE("SrecFile record layout", "[layout]") {
+    using tierone::srec::SrecFile;
+    using tierone::srec::SrecLayout;
+
+    std::vector<uint8_t> data(5000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 3 + 1);
+    }
+    auto read_text = [](const std::string &name) {
+        std::ifstream file(name, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    auto split_lines = [](const std::string &text) {
+        std::vector<std::string> lines;
+        size_t start = 0;
+        for (size_t end = text.find('\n'); end != std::string::npos; end = text.find('\n', start)) {
+            lines.push_back(text.substr(start, end + 1 - start));
+            start = end + 1;
+        }
+        return lines;
+    };
+    auto write_memory = [&data](const SrecLayout &layout, const uint32_t start) {
+        auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *memory = sink.get();
+        SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32, start);
+        sfile.set_layout(layout);
+        sfile.write_data(data.data(), data.size());
+        sfile.write_record_count();
+        sfile.write_record_termination();
+        return memory->str();
+    };
+
+    SECTION("Record length and alignment") {
+        SrecLayout layout;
+        layout.record_length = 32;
+        const auto lines = split_lines(write_memory(layout, 0x1010));
+        REQUIRE(lines.size() == (data.size() + 31) / 32 + 2);
+        REQUIRE(lines[0].substr(0, 12) == "S32500001010");
+        REQUIRE(lines[1].substr(0, 12) == "S32500001030");
+
+        layout.align = true;
+        const auto aligned = split_lines(write_memory(layout, 0x1010));
+        REQUIRE(aligned[0].substr(0, 12) == "S31500001010"); // 16 bytes up to the boundary
+        REQUIRE(aligned[1].substr(0, 12) == "S32500001020");
+        REQUIRE(aligned.size() == 1 + (data.size() - 16 + 31) / 32 + 2);
+
+        SrecFile sfile(std::make_unique<tierone::srec::SrecMemorySink>(), SrecFile::AddressSize::BITS32, 0x1010);
+        sfile.set_layout(layout);
+        REQUIRE(sfile.max_data_bytes_per_record() == 32);
+        REQUIRE(sfile.next_record_length() == 16);
+        REQUIRE(sfile.count_data_records(0x1010, data.size()) == aligned.size() - 2);
+
+        layout.record_length = 246;
+        REQUIRE_THROWS_AS(sfile.set_layout(layout), tierone::srec::SrecValidationException);
+    }
+
+    SECTION("CRLF and fixed stride") {
+        SrecLayout layout;
+        layout.record_length = 32;
+        layout.align = true;
+        layout.line_ending = tierone::srec::LineEnding::CRLF;
+        layout.fixed_stride = true;
+        const std::string text = write_memory(layout, 0x1010);
+        const auto lines = split_lines(text);
+        const size_t stride = 6 + 8 + 64 + 2;
+        for (size_t i = 0; i + 2 < lines.size(); ++i) {
+            REQUIRE(lines[i].size() == stride);
+            REQUIRE(lines[i].substr(stride - 2) == "\r\n");
+        }
+        REQUIRE(lines.back() == "S70500001010DA\r\n");
+
+        // Record N is at N times the stride, and the text reads back unchanged
+        const std::string record = text.substr(10 * stride, stride);
+        REQUIRE(record.substr(0, 12) == "S32500001140");
+        tierone::srec::SrecMemoryImage image;
+        std::istringstream input(text);
+        image.load(input);
+        REQUIRE(image.start_address() == 0x1010);
+        REQUIRE(image.to_binary() == data);
+    }
+
+    SECTION("Converters agree on the layout") {
+        SrecLayout layout;
+        layout.record_length = 40;
+        layout.align = true;
+        layout.line_ending = tierone::srec::LineEnding::CRLF;
+        layout.fixed_stride = true;
+        const std::string expected = write_memory(layout, 0x1010);
+
+        const std::string bin_file = "test_layout.bin";
+        const std::string srec_file = "test_layout.srec";
+        std::ofstream(bin_file, std::ios::binary).write(reinterpret_cast<const char *>(data.data()),
+                                                        static_cast<std::streamsize>(data.size()));
+        for (const unsigned threads : {1u, 4u}) {
+            std::ifstream input(bin_file, std::ios::binary);
+            SrecFile sfile(srec_file, SrecFile::AddressSize::BITS32, 0x1010);
+            sfile.set_layout(layout);
+            tierone::srec::SrecParallelConvertOptions options;
+            options.block_size = 1000;
+            if (threads == 1) {
+                tierone::srec::convert_bin_to_srec(input, sfile, false, threads);
+            } else {
+                tierone::srec::SrecParallelConverter::write_data_records(input, sfile, options);
+                sfile.write_record_count();
+                sfile.write_record_termination();
+                sfile.close();
+            }
+            REQUIRE(read_text(srec_file) == expected);
+        }
+        for (const size_t buffer_size : {size_t{100}, size_t{65536}}) {
+            std::ifstream input(bin_file, std::ios::binary);
+            tierone::srec::SrecStreamConverter::convert_stream(input, srec_file, SrecFile::AddressSize::BITS32, 0x1010,
+                                                               false, nullptr, buffer_size, tierone::srec::SrecLimits(),
+                                                               nullptr, layout);
+            REQUIRE(read_text(srec_file) == expected);
+            std::ifstream async_input(bin_file, std::ios::binary);
+            tierone::srec::SrecStreamConverter::convert_stream_async(async_input, srec_file,
+                                                                     SrecFile::AddressSize::BITS32, 0x1010, false,
+                                                                     nullptr, buffer_size, 3,
+                                                                     tierone::srec::SrecLimits(), nullptr, layout);
+            REQUIRE(read_text(srec_file) == expected);
+        }
+
+        tierone::srec::SrecTextOptions options;
+        options.start_address = 0x1010;
+        options.layout = layout;
+        REQUIRE(tierone::srec::SrecBufferConverter::to_srec(data.data(), data.size(), options) == expected);
+        REQUIRE(tierone::srec::SrecBufferConverter::srec_size(data.size(), options) == expected.size());
+        options.want_checksum = true;
+        REQUIRE(tierone::srec::SrecBufferConverter::to_srec(data.data(), data.size(), options).size() ==
+                tierone::srec::SrecBufferConverter::srec_size(data.size(), options));
+
+        std::filesystem::remove(bin_file);
+        std::filesystem::remove(srec_file);
+    }
+}
+
+TEST_CASE("Non-throwing line parser", "[parse]") {
+    using tierone::srec::SrecParseError;
+    using tierone::srec::SrecParseResult;
+    using tierone::srec::SrecStreamParser;
+
+    std::array<uint8_t, SrecStreamParser::MAX_RECORD_DATA_SIZE> payload{};
+    SrecStreamParser::ParsedRecordView record{};
+
+    SECTION("Valid records") {
+        const SrecParseResult result = SrecStreamParser::try_parse_line("S1061000010203E3", 7, true, payload.data(), record);
+        REQUIRE(result.ok());
+        REQUIRE(result.line == 7);
+        REQUIRE(record.type == tierone::srec::Srec::Type::S1);
+        REQUIRE(record.address == 0x1000);
+        REQUIRE(record.length == 3);
+        REQUIRE(record.data == payload.data());
+        REQUIRE(payload[2] == 0x03);
+        REQUIRE(record.checksum_valid);
+
+        // A wrong checksum passes when checksums are not validated
+        REQUIRE(SrecStreamParser::try_parse_line("S1061000010203E4", 1, false, payload.data(), record).ok());
+    }
+
+    SECTION("Errors report kind, line and column") {
+        struct Case {
+            const char *line;
+            SrecParseError error;
+            size_t column;
+        };
+        const std::vector<Case> cases = {
+            {"", SrecParseError::NOT_A_RECORD, 0},
+            {"X1061000010203E3", SrecParseError::NOT_A_RECORD, 0},
+            {"S106", SrecParseError::TOO_SHORT, 0},
+            {"S4061000010203E3", SrecParseError::INVALID_TYPE, 2},
+            {"S1G61000010203E3", SrecParseError::INVALID_HEX, 3},
+            {"S10610000102G3E3", SrecParseError::INVALID_HEX, 13},
+            {"S1061000010203", SrecParseError::LENGTH_MISMATCH, 0},
+            {"S10210EF", SrecParseError::COUNT_TOO_SMALL, 3},
+            {"S1061000010203E4", SrecParseError::CHECKSUM_MISMATCH, 15},
+        };
+        for (const Case &c : cases) {
+            INFO(c.line);
+            const SrecParseResult result = SrecStreamParser::try_parse_line(c.line, 5, true, payload.data(), record);
+            REQUIRE(result.error == c.error);
+            REQUIRE(result.line == 5);
+            REQUIRE(result.column == c.column);
+        }
+
+        // Bad characters are found anywhere in a long record
+        std::string line = tierone::srec::Srec3(0x10000000, std::vector<uint8_t>(245, 0x5A)).toString();
+        for (const size_t position : {size_t{4}, size_t{60}, size_t{68}, size_t{300}, line.size() - 2, line.size() - 1}) {
+            std::string bad = line;
+            bad[position] = 'x';
+            const SrecParseResult result = SrecStreamParser::try_parse_line(bad, 1, true, payload.data(), record);
+            REQUIRE(result.error == SrecParseError::INVALID_HEX);
+            REQUIRE(result.column == position + 1);
+            REQUIRE(result.actual == 'x');
+        }
+    }
+
+    SECTION("The throwing API wraps the result") {
+        try {
+            SrecStreamParser::parse_line("S10610000102G3E3", 4, true, payload.data(), record);
+            FAIL("Expected a parse error");
+        } catch (const tierone::srec::SrecParseException &e) {
+            REQUIRE(e.getLineNumber() == 4);
+            REQUIRE(e.getColumn() == 13);
+            REQUIRE(std::string(e.what()).find("Invalid hex character: G") != std::string::npos);
+        }
+        try {
+            SrecStreamParser::parse_line("S1061000010203E4", 9, true, payload.data(), record);
+            FAIL("Expected a checksum error");
+        } catch (const tierone::srec::SrecValidationException &e) {
+            REQUIRE(e.getErrorType() == tierone::srec::SrecValidationException::ValidationError::CHECKSUM_MISMATCH);
+            REQUIRE(std::string(e.what()) == "Checksum validation failed on line 9: expected 0xE3, got 0xE4");
+        }
+        try {
+            SrecStreamParser::parse_line("S1061000010203", 2);
+            FAIL("Expected a length error");
+        } catch (const tierone::srec::SrecParseException &e) {
+            REQUIRE(std::string(e.what()).find("expected 16, got 14") != std::string::npos);
+        }
+    }
+
+    SECTION("Readers skip rejected lines") {
+        const std::string text = "S1061000010203E3\nS1061003040506D7\r\nS1G61000010203E3\n\nS1061006070809CB\n";
+        tierone::srec::SrecMappedReader mapped(text.data(), text.size());
+        std::istringstream stream(text);
+        tierone::srec::SrecReader reader(stream, true, 8);
+        for (int pass = 0; pass < 2; ++pass) {
+            std::vector<uint32_t> addresses;
+            std::vector<size_t> bad_lines;
+            SrecParseResult result;
+            for (;;) {
+                const bool found = pass == 0 ? mapped.try_next(record, result) : reader.try_next(record, result);
+                if (found) {
+                    addresses.push_back(record.address);
+                } else if (!result.ok()) {
+                    bad_lines.push_back(result.line);
+                    REQUIRE(result.error == SrecParseError::INVALID_HEX);
+                } else {
+                    break;
+                }
+            }
+            REQUIRE(addresses == std::vector<uint32_t>{0x1000, 0x1003, 0x1006});
+            REQUIRE(bad_lines == std::vector<size_t>{3});
+        }
+    }
+
+    SECTION("Damaged lines never read or write out of bounds") {
+        std::mt19937 gen(29);
+        const std::string alphabet = "0123456789ABCDEFabcdefSGZ \t\r";
+        for (int i = 0; i < 20000; ++i) {
+            std::vector<uint8_t> data(gen() % 253);
+            for (auto &byte : data) {
+                byte = static_cast<uint8_t>(gen());
+            }
+            // The data cut to the most a record type holds
+            auto truncated = [&data](const size_t longest) {
+                const auto end = data.begin() + static_cast<std::ptrdiff_t>(std::min(data.size(), longest));
+                return std::vector<uint8_t>(data.begin(), end);
+            };
+            std::string line;
+            switch (gen() % 3) {
+                case 0:
+                    line = tierone::srec::Srec1(static_cast<uint16_t>(gen()), truncated(252)).toString();
+                    break;
+                case 1:
+                    line = tierone::srec::Srec2(gen() & 0xFFFFFF, truncated(251)).toString();
+                    break;
+                default:
+                    line = tierone::srec::Srec3(static_cast<uint32_t>(gen()), truncated(250)).toString();
+                    break;
+            }
+            for (unsigned edits = gen() % 4; edits > 0 && !line.empty(); --edits) {
+                const size_t position = gen() % line.size();
+                switch (gen() % 3) {
+                    case 0:
+                        line[position] = alphabet[gen() % alphabet.size()];
+                        break;
+                    case 1:
+                        line.erase(position, 1 + gen() % 4);
+                        break;
+                    default:
+                        line.resize(position);
+                        break;
+                }
+            }
+
+            // Exactly sized copies, so the sanitizers see any overrun
+            const std::unique_ptr<char[]> text(new char[line.size() + 1]);
+            std::memcpy(text.get(), line.data(), line.size());
+            const std::unique_ptr<uint8_t[]> out(new uint8_t[SrecStreamParser::MAX_RECORD_DATA_SIZE]);
+            const std::string_view view(text.get(), line.size());
+            const SrecParseResult result = SrecStreamParser::try_parse_line(view, 1, true, out.get(), record);
+            REQUIRE(result.column <= line.size());
+            bool threw = false;
+            try {
+                SrecStreamParser::parse_line(view, 1, true, payload.data(), record);
+            } catch (const tierone::srec::SrecException &) {
+                threw = true;
+            }
+            REQUIRE(threw == !result.ok());
+        }
+    }
+}
+
+TEST_CASE("SrecFile fill skipping", "[fill]") {
+    using tierone::srec::SrecFile;
+    using tierone::srec::SrecFillCrc;
+    using tierone::srec::SrecFillSkip;
+    using tierone::srec::SrecLayout;
+
+    // Erased flash around and between three blocks of code
+    std::vector<uint8_t> data(4096, 0xFF);
+    for (const auto &[begin, end] : {std::pair<size_t, size_t>{120, 200}, {1000, 1010}, {1021, 2000}}) {
+        for (size_t i = begin; i < end; ++i) {
+            data[i] = static_cast<uint8_t>(i * 7 + 3);
+        }
+    }
+    data[1500] = 0xFF; // runs shorter than a record are kept
+    SrecLayout layout;
+    layout.record_length = 32;
+    SrecFillSkip skip;
+    skip.enabled = true;
+
+    // A sink that cannot be patched, so the CRC is computed up front
+    class TextSink : public tierone::srec::SrecSink {
+    public:
+        explicit TextSink(std::string &output) : text(output) {}
+        void write(const char *data, size_t length) override { text.append(data, length); }
+        void flush() override {}
+        void close() override { open = false; }
+        bool is_open() const override { return open; }
+
+    private:
+        std::string &text;
+        bool open{true};
+    };
+
+    auto read_text = [](const std::string &name) {
+        std::ifstream file(name, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    auto write_memory = [&](const SrecFillSkip &fill, const uint32_t start) {
+        auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+        auto *memory = sink.get();
+        SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS32, start);
+        sfile.set_layout(layout);
+        sfile.set_skip_fill(fill);
+        sfile.write_data(data.data(), data.size());
+        sfile.write_record_count();
+        sfile.write_record_termination();
+        return memory->str();
+    };
+
+    SECTION("Fill is left out of the records") {
+        const std::string text = write_memory(skip, 0x1000);
+        std::istringstream input(text);
+        tierone::srec::SrecReader reader(input);
+        tierone::srec::SrecStreamParser::ParsedRecordView record{};
+        size_t data_records = 0;
+        uint32_t count = 0;
+        while (reader.next(record)) {
+            if (record.type == tierone::srec::Srec::Type::S5) {
+                count = record.address;
+            }
+            if (record.type != tierone::srec::Srec::Type::S3) {
+                continue;
+            }
+            ++data_records;
+            REQUIRE(record.length > 0);
+            const size_t offset = record.address - 0x1000;
+            REQUIRE(std::equal(record.data, record.data + record.length, data.begin() + static_cast<long>(offset)));
+            const size_t lead = static_cast<size_t>(std::find_if(record.data, record.data + record.length,
+                                                                 [](uint8_t b) { return b != 0xFF; }) - record.data);
+            REQUIRE(lead < skip.min_run);
+        }
+        REQUIRE(count == data_records);
+        REQUIRE(data_records < (data.size() + 31) / 32);
+
+        // The first record starts at the code, cut from its slot
+        REQUIRE(text.substr(0, 12) == "S30D00001078");
+
+        // Loading with the same fill byte gives back the image between the first and last code
+        tierone::srec::SrecMemoryImage image;
+        image.set_fill_byte(0xFF);
+        std::istringstream again(text);
+        image.load(again);
+        REQUIRE(image.start_address() == 0x1000 + 120);
+        REQUIRE(image.end_address() == 0x1000 + 2000);
+        REQUIRE(image.to_binary() == std::vector<uint8_t>(data.begin() + 120, data.begin() + 2000));
+
+        // Without skipping, and with runs too long to cut, every record is written
+        const size_t all = (data.size() + 31) / 32 + 2;
+        REQUIRE(std::count(text.begin(), text.end(), '\n') < static_cast<long>(all));
+        const std::string plain = write_memory(SrecFillSkip(), 0x1000);
+        REQUIRE(std::count(plain.begin(), plain.end(), '\n') == static_cast<long>(all));
+        SrecFillSkip long_runs = skip;
+        long_runs.min_run = 33;
+        const std::string kept = write_memory(long_runs, 0x1000);
+        REQUIRE(kept.substr(0, 12) == "S32500001060"); // whole slot kept
+        REQUIRE(std::count(kept.begin(), kept.end(), '\n') < static_cast<long>(all)); // all-fill still skipped
+
+        // Other fill bytes
+        SrecFillSkip zeros = skip;
+        zeros.fill_byte = 0;
+        REQUIRE(write_memory(zeros, 0x1000) == plain);
+    }
+
+    SECTION("Records keep their fill at the end of the address space") {
+        // The second record starts at 0xFFF9; its fill would move it to 0x1000F
+        std::vector<uint8_t> top(0x110, 0xFF);
+        top[0] = 0x12;
+        top[0x10F] = 0x34;
+        auto write_top = [&top, &skip](const bool per_record) {
+            auto sink = std::make_unique<tierone::srec::SrecMemorySink>();
+            auto *memory = sink.get();
+            SrecFile sfile(std::move(sink), SrecFile::AddressSize::BITS16, 0xFF00);
+            sfile.set_skip_fill(skip);
+            if (per_record) {
+                for (size_t offset = 0; offset < top.size();) {
+                    const size_t length = std::min(sfile.next_record_length(), top.size() - offset);
+                    sfile.write_record_payload(top.data() + offset, length);
+                    offset += length;
+                }
+            } else {
+                sfile.write_data(top.data(), top.size());
+            }
+            sfile.write_record_termination();
+            return memory->str();
+        };
+        const std::string text = write_top(false);
+        REQUIRE(write_top(true) == text);
+        REQUIRE(text.substr(0, 10) == "S104FF0012");
+        REQUIRE(text.find("\nS11AFFF9") != std::string::npos); // whole 23-byte record
+
+        tierone::srec::SrecMemoryImage image;
+        image.set_fill_byte(0xFF);
+        std::istringstream input(text);
+        image.load(input);
+        REQUIRE(image.start_address() == 0xFF00);
+        REQUIRE(image.to_binary() == top);
+    }
+
+    SECTION("Converters agree and the CRC verifies") {
+        const std::string bin_file = "test_fill.bin";
+        const std::string srec_file = "test_fill.srec";
+        std::ofstream(bin_file, std::ios::binary).write(reinterpret_cast<const char *>(data.data()),
+                                                        static_cast<std::streamsize>(data.size()));
+
+        for (const SrecFillCrc crc : {SrecFillCrc::EMITTED, SrecFillCrc::IMAGE}) {
+            SrecFillSkip fill = skip;
+            fill.crc = crc;
+            std::string expected;
+            for (const unsigned threads : {1u, 4u}) {
+                std::ifstream input(bin_file, std::ios::binary);
+                SrecFile sfile(srec_file, SrecFile::AddressSize::BITS32, 0x1010);
+                sfile.set_layout(layout);
+                sfile.set_skip_fill(fill);
+                tierone::srec::convert_bin_to_srec(input, sfile, true, threads);
+                const std::string text = read_text(srec_file);
+                if (expected.empty()) {
+                    expected = text;
+                }
+                REQUIRE(text == expected);
+            }
+
+            // Computed ahead of time for a sink that cannot be patched
+            std::string upfront;
+            {
+                std::ifstream input(bin_file, std::ios::binary);
+                SrecFile sfile(std::make_unique<TextSink>(upfront), SrecFile::AddressSize::BITS32, 0x1010);
+                sfile.set_layout(layout);
+                sfile.set_skip_fill(fill);
+                tierone::srec::convert_bin_to_srec(input, sfile, true, 1);
+            }
+            REQUIRE(upfront == expected);
+
+            for (const size_t buffer_size : {size_t{20}, size_t{65536}}) {
+                std::ifstream input(bin_file, std::ios::binary);
+                tierone::srec::SrecStreamConverter::convert_stream(input, srec_file, SrecFile::AddressSize::BITS32,
+                                                                   0x1010, true, nullptr, buffer_size,
+                                                                   tierone::srec::SrecLimits(), nullptr, layout, fill);
+                const std::string text = read_text(srec_file);
+                std::ifstream async_input(bin_file, std::ios::binary);
+                tierone::srec::SrecStreamConverter::convert_stream_async(async_input, srec_file,
+                                                                         SrecFile::AddressSize::BITS32, 0x1010, true,
+                                                                         nullptr, buffer_size, 3,
+                                                                         tierone::srec::SrecLimits(), nullptr, layout,
+                                                                         fill);
+                REQUIRE(read_text(srec_file) == text);
+                if (buffer_size == 65536) {
+                    REQUIRE(text == expected);
+                }
+            }
+
+            const auto result = tierone::srec::SrecParallelVerifier::verify_buffer(expected.data(), expected.size());
+            REQUIRE(result.stored_crc);
+            REQUIRE(result.stored_count == result.data_records);
+            if (crc == SrecFillCrc::EMITTED) {
+                REQUIRE(result.crc_matches());
+            } else {
+                REQUIRE(*result.stored_crc == tierone::srec::crc32_update(data.data(), data.size(), 0));
+                REQUIRE_FALSE(result.crc_matches());
+            }
+        }
+
+        std::filesystem::remove(bin_file);
+        std::filesystem::remove(srec_file);
+    }
+}